@@ -45,6 +45,14 @@
 #  include <sys/stat.h>
 #endif
 
+#if (defined __LINUX && !defined __TMS)
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  define HAVE_FMAP
+#endif
+
 /*#define USE_MMAP        / * Use mmap routines to map whole file to memory before compression, needs type caddr_t (not ANSI nor POSIX) */
 
 #ifndef DLP_PRINTF_BUFSIZE
@@ -657,4 +665,130 @@ char* dlp_fullpath(char* lpsAbsPath, const char* lpsRelPath, INT32 nMaxLen)
 }
 #endif
 
+/**
+ * Maps a file into memory. The operating system pages the file content in on
+ * demand, so files larger than the physical memory can be mapped. If
+ * <code>bWrite</code> is <code>TRUE</code>, the file is created if necessary,
+ * extended to at least <code>nSize</code> bytes and changes of the mapped
+ * memory are written back to the file. Otherwise the file is mapped
+ * copy-on-write: the memory may be changed, but changes are not written to the
+ * file.
+ *
+ * @param lpsFilename
+ *          Name of file to map.
+ * @param nSize
+ *          Minimal size of the mapping in bytes, 0 to map the entire file.
+ * @param bWrite
+ *          Write changes back to the file.
+ * @return A pointer to the mapping descriptor or <code>NULL</code> in case of
+ *         errors or if memory mapped files are not supported on this platform.
+ *         The caller must release the descriptor by {@link dlp_fmap_close}.
+ */
+DLP_FMAP* dlp_fmap_open(const char* lpsFilename, INT64 nSize, BOOL bWrite)
+{
+#ifdef HAVE_FMAP
+  DLP_FMAP*   lpMap = NULL;                                                     /* New mapping descriptor            */
+  struct stat st;                                                               /* File status                       */
+  INT32       nFd   = -1;                                                       /* File descriptor                   */
+
+  if (!lpsFilename || nSize<0) return NULL;                                     /* Check arguments                   */
+  nFd = open(lpsFilename,bWrite ? O_RDWR|O_CREAT : O_RDONLY,0666);              /* Open file                         */
+  if (nFd<0) return NULL;                                                       /* Failed                            */
+  if (fstat(nFd,&st)!=0) { close(nFd); return NULL; }                           /* Get file size                     */
+  if ((INT64)st.st_size>nSize) nSize = (INT64)st.st_size;                       /* Map at least the entire file      */
+  if ((INT64)st.st_size<nSize)                                                  /* File too short                    */
+    if (!bWrite || ftruncate(nFd,(off_t)nSize)!=0) { close(nFd); return NULL; } /*   Extend (only if writable)       */
+  if (nSize==0) { close(nFd); return NULL; }                                    /* Cannot map empty files            */
+
+  lpMap = (DLP_FMAP*)dlp_calloc(1,sizeof(DLP_FMAP));                            /* Create descriptor                 */
+  if (!lpMap) { close(nFd); return NULL; }                                      /* Out of memory                     */
+  lpMap->m_lpData = (BYTE*)mmap(NULL,(size_t)nSize,PROT_READ|PROT_WRITE,        /* Map file                          */
+    bWrite ? MAP_SHARED : MAP_PRIVATE,nFd,0);                                   /* |                                 */
+  if ((void*)lpMap->m_lpData==MAP_FAILED)                                       /* Failed                            */
+  {                                                                             /* >>                                */
+    close(nFd);                                                                 /*   Close file                      */
+    dlp_free(lpMap);                                                            /*   Destroy descriptor              */
+    return NULL;                                                                /*   Fail                            */
+  }                                                                             /* <<                                */
+  lpMap->m_nSize  = nSize;                                                      /* Remember size                     */
+  lpMap->m_nFd    = nFd;                                                        /* Remember file descriptor          */
+  lpMap->m_bWrite = bWrite;                                                     /* Remember mode                     */
+  return lpMap;                                                                 /* Return descriptor                 */
+#else
+  return NULL;                                                                  /* Not supported on this platform    */
+#endif
+}
+
+/**
+ * Changes the size of a writable file mapping. The file is extended or
+ * truncated accordingly. The start address of the mapping may change, the
+ * content is not copied.
+ *
+ * @param lpMap
+ *          Pointer to the mapping descriptor.
+ * @param nSize
+ *          New size in bytes (&gt;0).
+ * @return <code>O_K</code> if successful, a (negative) error code otherwise.
+ */
+INT16 dlp_fmap_resize(DLP_FMAP* lpMap, INT64 nSize)
+{
+#ifdef HAVE_FMAP
+  void* lpData = NULL;                                                          /* New start address                 */
+
+  if (!lpMap || !lpMap->m_bWrite || nSize<=0) return NOT_EXEC;                  /* Check arguments                   */
+  if (nSize==lpMap->m_nSize) return O_K;                                        /* Nothing to be done                */
+  if (ftruncate(lpMap->m_nFd,(off_t)nSize)!=0) return NOT_EXEC;                 /* Resize file                       */
+  lpData = mremap(lpMap->m_lpData,(size_t)lpMap->m_nSize,(size_t)nSize,         /* Resize mapping                    */
+    MREMAP_MAYMOVE);                                                            /* |                                 */
+  if (lpData==MAP_FAILED) return NOT_EXEC;                                      /* Failed                            */
+  lpMap->m_lpData = (BYTE*)lpData;                                              /* Store new start address           */
+  lpMap->m_nSize  = nSize;                                                      /* Store new size                    */
+  return O_K;                                                                   /* Ok                                */
+#else
+  return NOT_EXEC;                                                              /* Not supported on this platform    */
+#endif
+}
+
+/**
+ * Writes changes of a writable file mapping to the file.
+ *
+ * @param lpMap
+ *          Pointer to the mapping descriptor.
+ * @return <code>O_K</code> if successful, a (negative) error code otherwise.
+ */
+INT16 dlp_fmap_sync(DLP_FMAP* lpMap)
+{
+#ifdef HAVE_FMAP
+  if (!lpMap) return NOT_EXEC;
+  if (!lpMap->m_bWrite) return O_K;
+  return msync(lpMap->m_lpData,(size_t)lpMap->m_nSize,MS_SYNC)==0 ? O_K : NOT_EXEC;
+#else
+  return NOT_EXEC;
+#endif
+}
+
+/**
+ * Unmaps a file, closes it and destroys the mapping descriptor.
+ *
+ * @param lpMap
+ *          Pointer to the mapping descriptor.
+ * @param nTruncate
+ *          If not negative, a writable file is truncated to this size in bytes
+ *          after unmapping.
+ * @return <code>O_K</code> if successful, a (negative) error code otherwise.
+ */
+INT16 dlp_fmap_close(DLP_FMAP* lpMap, INT64 nTruncate)
+{
+  INT16 nErr = O_K;
+  if (!lpMap) return NOT_EXEC;
+#ifdef HAVE_FMAP
+  if (munmap(lpMap->m_lpData,(size_t)lpMap->m_nSize)!=0) nErr = NOT_EXEC;
+  if (lpMap->m_bWrite && nTruncate>=0)
+    if (ftruncate(lpMap->m_nFd,(off_t)nTruncate)!=0) nErr = NOT_EXEC;
+  close(lpMap->m_nFd);
+#endif
+  dlp_free(lpMap);
+  return nErr;
+}
+
 /* EOF */
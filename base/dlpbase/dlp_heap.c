@@ -63,6 +63,40 @@ int __dlp_compkeys(const void* lpKey1, const void* lpKey2, void* lpHint)
 static hash_t* __xalloc       = NULL;
 static INT32    __xalloc_flags = 0;
 
+/* The allocation list is shared by all threads (tasks of the worker pool
+   allocate concurrently, see dlp_thread.c) */
+#ifdef HAVE_PTHREAD
+static MUTEXHANDLE __xalloc_mtx = PTHREAD_MUTEX_INITIALIZER;
+#define XALLOC_LOCK   dlp_lock_mutex(&__xalloc_mtx)
+#define XALLOC_UNLOCK dlp_unlock_mutex(&__xalloc_mtx)
+#else
+#define XALLOC_LOCK
+#define XALLOC_UNLOCK
+#endif
+
+#ifndef __NOXALLOC
+/**
+ * Removes a memory object from the allocation list. The caller must hold the
+ * allocation list lock.
+ *
+ * @param lpMemblock Pointer to the memory object
+ * @return TRUE if the object was found, FALSE otherwise
+ */
+static BOOL __dlp_xalloc_remove(const void* lpMemblock)
+{
+  hnode_t*     hn;                                                              /* Hash node                         */
+  alloclist_t* li;                                                              /* XAlloc list entry                 */
+
+  hn = hash_lookup(__xalloc,lpMemblock);                                        /* Find object in allocation list    */
+  if (!hn) return FALSE;                                                        /* Object NOT found                  */
+  li = (alloclist_t*)hnode_get(hn);                                             /* Get XAlloc list entry             */
+  DLPASSERT(hnode_getkey(hn)==lpMemblock);                                      /* ... which is the object pointer   */
+  hash_scan_delfree(__xalloc,hn);                                               /* Remove hash node                  */
+  free(li);                                                                     /* Free XAlloc list entry            */
+  return TRUE;                                                                  /* Ok                                */
+}
+#endif
+
 /**
  * Starts the XAlloc heap manager.
  *
@@ -217,15 +251,14 @@ void dlp_xalloc_register_object
   dlp_strncpy(li->lpsClassname   ,lpsClassname   ,L_NAMES  );
   dlp_strncpy(li->lpsInstancename,lpsInstancename,4*L_NAMES);
 
+  XALLOC_LOCK;
 #ifdef _DEBUG
-  if (hash_lookup(__xalloc,lpMemblock))
-  {
+  if (__dlp_xalloc_remove(lpMemblock))
     printf("\n*** xalloc: ERROR - Pointer 0x%p already registered (%s:%d)",   /*   Hard coded error message        */
       lpMemblock,__FILE__,(int)__LINE__);                                            /*   |                               */
-    dlp_xalloc_unregister_object(lpMemblock);
-  }
 #endif
   hash_alloc_insert(__xalloc,lpMemblock,li);
+  XALLOC_UNLOCK;
 #endif
 }
 
@@ -241,22 +274,14 @@ void dlp_xalloc_register_object
 void dlp_xalloc_unregister_object(const void* lpMemblock)
 {
 #ifndef __NOXALLOC
-  hnode_t*     hn;                                                              /* Hash node                         */
-  const void*  key;                                                             /* Hash key                          */
-  alloclist_t* li;                                                              /* XAlloc list entry                 */
+  BOOL bFound;                                                                  /* Object found in allocation list   */
 
   if (!__xalloc) return;                                                        /* XAlloc not started (or failed)    */
 
-  hn = hash_lookup(__xalloc,lpMemblock);                                        /* Find object in allocation list    */
-  if (hn)                                                                       /* Object found                      */
-  {                                                                             /* >>                                */
-    li  = (alloclist_t*)hnode_get(hn);                                          /*   Get XAlloc list entry           */
-    key = hnode_getkey(hn);                                                     /*   Get hash key                    */
-    DLPASSERT(key==lpMemblock);                                                 /*   ... which is the object pointer */
-    hash_scan_delfree(__xalloc,hn);                                             /*   Remove hash node                */
-    free(li);                                                                   /*   Free XAlloc list entry          */
-  }                                                                             /* <<                                */
-  else                                                                          /* Object NOT found                  */
+  XALLOC_LOCK;                                                                  /* Lock allocation list              */
+  bFound = __dlp_xalloc_remove(lpMemblock);                                     /* Remove object from list           */
+  XALLOC_UNLOCK;                                                                /* Unlock allocation list            */
+  if (!bFound)                                                                  /* Object NOT found                  */
   {                                                                             /* >>                                */
     printf("\n*** xalloc: ERROR - Pointer 0x%p not found in xalloc (%s:%d)",    /*   Hard coded error message        */
       lpMemblock,__FILE__,(int)__LINE__);                                            /*   |                               */
@@ -282,8 +307,13 @@ BOOL dlp_xalloc_find_object(const void* lpMemblock)
   fprintf(stderr,"__NOXALLOC defined => you should not use dlp_xalloc_find_object\n");
   return NULL;
 #else
+  BOOL bFound;                                                                  /* Object found in allocation list   */
+
   if (!__xalloc) return TRUE;                                                   /* XAlloc not started (or failed)    */
-  return hash_lookup(__xalloc,lpMemblock)!=NULL;                                /* Find object in allocation list    */
+  XALLOC_LOCK;                                                                  /* Lock allocation list              */
+  bFound = hash_lookup(__xalloc,lpMemblock)!=NULL;                              /* Find object in allocation list    */
+  XALLOC_UNLOCK;                                                                /* Unlock allocation list            */
+  return bFound;                                                                /* Return result                     */
 #endif
 }
 
@@ -310,9 +340,14 @@ alloclist_t* dlp_xalloc_find_object_ex(const void* lpMemblock)
 
   if (!__xalloc) return NULL;                                                   /* XAlloc not started (or failed)    */
 
-  if (!(hn = hash_lookup(__xalloc,lpMemblock))) return NULL;                    /* Find object in allocation list    */
-  li = (alloclist_t*)hnode_get(hn);                                             /* Get XAlloc list entry             */
-  DLPASSERT(hnode_getkey(hn)==lpMemblock);                                      /* ... which is the object pointer   */
+  XALLOC_LOCK;                                                                  /* Lock allocation list              */
+  if ((hn = hash_lookup(__xalloc,lpMemblock))!=NULL)                            /* Find object in allocation list    */
+  {                                                                             /* >>                                */
+    li = (alloclist_t*)hnode_get(hn);                                           /*   Get XAlloc list entry           */
+    DLPASSERT(hnode_getkey(hn)==lpMemblock);                                    /*   ... which is the object pointer */
+  }                                                                             /* <<                                */
+  else li = NULL;                                                               /* Object NOT found                  */
+  XALLOC_UNLOCK;                                                                /* Unlock allocation list            */
   return li;                                                                    /* Return XAlloxc list entry         */
 #endif
 }
@@ -331,15 +366,19 @@ size_t dlp_size(const void* lpMemblock)
 #else
   alloclist_t* li;
   hnode_t*     hn;
+  size_t       nSize = 0;
 
   if (!__xalloc       ) return 0; /* XAlloc not started (or failed): ok, but do nothing */
   if (lpMemblock==NULL) return 0;
 
-  hn = hash_lookup(__xalloc,lpMemblock);
-  if (!hn) return 0;
-
-  li = (alloclist_t*)hnode_get(hn);
-  return (li->nNum*li->nSize);
+  XALLOC_LOCK;
+  if ((hn = hash_lookup(__xalloc,lpMemblock))!=NULL)
+  {
+    li    = (alloclist_t*)hnode_get(hn);
+    nSize = li->nNum*li->nSize;
+  }
+  XALLOC_UNLOCK;
+  return nSize;
 #endif
 }
 
@@ -356,8 +395,13 @@ BOOL dlp_in_xalloc(const void* lpMemblock)
   fprintf(stderr,"__NOXALLOC defined => you should not use dlp_in_xalloc\n");
   return NULL;
 #else
+  BOOL bFound;
+
   if (!__xalloc) return FALSE; /* XAlloc not started (or failed): thus memblock is "not in list" */
-  return hash_lookup(__xalloc,lpMemblock)!=NULL;
+  XALLOC_LOCK;
+  bFound = hash_lookup(__xalloc,lpMemblock)!=NULL;
+  XALLOC_UNLOCK;
+  return bFound;
 #endif
 }
 
@@ -27,15 +27,16 @@
 #include "dlp_kernel.h"
 #include "dlp_base.h"
 
-hash_t *dlpsort_hash=NULL;
-int(*dlpsort_cmp)(const void *, const void *);
-size_t dlpsort_size;
-size_t dlpsort_keysize;
+/* Sorting state (one per thread, tasks of the worker pool sort concurrently) */
+static DLP_THREADLOCAL hash_t *dlpsort_hash=NULL;
+static DLP_THREADLOCAL int(*dlpsort_cmp)(const void *, const void *);
+static DLP_THREADLOCAL size_t dlpsort_size;
+static DLP_THREADLOCAL size_t dlpsort_keysize;
 
 #define KEYSIZE 64
 static const void *dlpsort_keyfnc(const void *key,unsigned char *buf)
 {
-  static unsigned char statbuf[KEYSIZE+1];
+  static DLP_THREADLOCAL unsigned char statbuf[KEYSIZE+1];
   const unsigned char *str = key;
   size_t i;
   if(!buf) buf=statbuf;
@@ -72,7 +73,7 @@ static int dlpsort_hashcmpfnc(const void *key1, const void *key2, void *context)
  * This is done by a hash map which references the old element indicies.
  * Warning: if no memory can be allocated the algorithm will fall back to unstable qsort.
  * Warning: in case of the hash collision the sorting algorithm is not stable any more.
- * Warning: the sorting algorithm is not thread secure if called it should fall back to unstable qsort.
+ * Note: the sorting state is thread-local, concurrent calls from different threads are stable.
  * TODO: someone should implement an own stable sorting algorithm.
  */
 void dlpsort(void *base, size_t nmemb, size_t size, int(*compar)(const void *, const void *))
@@ -27,14 +27,15 @@
 #include "dlp_kernel.h"
 #include "dlp_base.h"
 
-/* Static variables */
-static char __a_buffer[4096];
+/* Static variables (one buffer per thread where supported, dlp_malloc uses it
+   to register allocations made by tasks of the worker pool) */
+static DLP_THREADLOCAL char __a_buffer[4096];
 
 /**
  * Get a pointer to a static 4096 bytes char buffer. This buffer is
- * allocated by the kernel. The pointer may be stored for later use.
- * However, there is no guarantee that the content of the buffer has
- * not changed.
+ * allocated by the kernel (one per thread). The pointer may be stored for
+ * later use. However, there is no guarantee that the content of the buffer
+ * has not changed.
  *
  * @return A pointer to a static 4096 byte character buffer
  */
@@ -165,4 +165,394 @@ UINT64 dlp_time()
   return (UINT64)nTime;
 }
 
+/* -- Worker pool and parallel-for -- */
+
+/**
+ * One queued task of the worker pool.
+ */
+typedef struct dlp_task
+{
+  DLP_TASKFUNC     lpFunc;                                                      /* Task function                     */
+  void*            lpArg;                                                       /* Argument to task function         */
+  DLP_TGROUP*      lpGroup;                                                     /* Task group (may be NULL)          */
+  struct dlp_task* lpNext;                                                      /* Next task in queue                */
+} DLP_TASK;
+
+/**
+ * Shared state of one parallel-for loop.
+ */
+typedef struct dlp_pfor
+{
+  DLP_PFORFUNC     lpFunc;                                                      /* Loop body                         */
+  void*            lpArg;                                                       /* Argument to loop body             */
+  INT32            nFirst;                                                      /* First index                       */
+  INT32            nCount;                                                      /* Number of indices                 */
+  INT32            nGrain;                                                      /* Indices per chunk                 */
+  INT32            nChunks;                                                     /* Number of chunks                  */
+  INT32            nNext;                                                       /* Next unclaimed chunk              */
+#ifdef HAVE_PTHREAD
+  MUTEXHANDLE      hMtx;                                                        /* Guards nNext (this loop only)     */
+#endif
+} DLP_PFOR;
+
+/* Worker pool state (all fields except __tpool_nthreads are guarded by
+   __tpool_mtx, __tpool_nthreads is guarded by __tpool_nmtx) */
+static INT32         __tpool_nthreads = -1;                                     /* Configured number of threads      */
+static INT32         __tpool_nworkers = 0;                                      /* Number of running workers         */
+static BOOL          __tpool_bstop    = FALSE;                                  /* Workers shall exit                */
+static DLP_TASK*     __tpool_head     = NULL;                                   /* First queued task                 */
+static DLP_TASK*     __tpool_tail     = NULL;                                   /* Last queued task                  */
+#ifdef HAVE_PTHREAD
+static MUTEXHANDLE   __tpool_mtx      = PTHREAD_MUTEX_INITIALIZER;              /* Pool mutex                        */
+static MUTEXHANDLE   __tpool_nmtx     = PTHREAD_MUTEX_INITIALIZER;              /* Thread count mutex                */
+static CONDHANDLE    __tpool_work     = PTHREAD_COND_INITIALIZER;               /* Signalled on new tasks            */
+static CONDHANDLE    __tpool_done     = PTHREAD_COND_INITIALIZER;               /* Signalled on finished groups      */
+static THREADHANDLE* __tpool_threads  = NULL;                                   /* Worker thread handles             */
+#endif
+
+/**
+ * Returns the number of threads the worker pool uses (including the calling
+ * thread). The default is taken from the build configuration macro
+ * <code>__DLP_NTHREADS</code> (see dlp_config.h); if it is not defined or 0,
+ * the number of online processors is used.
+ *
+ * @return The number of threads (at least 1)
+ * @see dlp_tpool_set_nthreads
+ */
+INT32 dlp_tpool_get_nthreads()
+{
+  INT32 nThreads = 0;
+
+#ifdef HAVE_PTHREAD
+  dlp_lock_mutex(&__tpool_nmtx);
+#endif
+  if (__tpool_nthreads<0)
+  {
+#if (defined __DLP_NTHREADS && __DLP_NTHREADS>0)
+    __tpool_nthreads = __DLP_NTHREADS;
+#elif (defined HAVE_PTHREAD && defined _SC_NPROCESSORS_ONLN)
+    __tpool_nthreads = (INT32)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    __tpool_nthreads = 1;
+#endif
+    if (__tpool_nthreads<1) __tpool_nthreads = 1;
+  }
+  nThreads = __tpool_nthreads;
+#ifdef HAVE_PTHREAD
+  dlp_unlock_mutex(&__tpool_nmtx);
+#endif
+  return nThreads;
+}
+
+/**
+ * Stops all workers of the pool. Pending tasks are executed before the
+ * workers exit. The pool is restarted on demand.
+ */
+void dlp_tpool_done()
+{
+#ifdef HAVE_PTHREAD
+  INT32 i = 0;
+
+  dlp_lock_mutex(&__tpool_mtx);
+  if (!__tpool_nworkers) { dlp_unlock_mutex(&__tpool_mtx); return; }
+  __tpool_bstop = TRUE;
+  dlp_broadcast_cond(&__tpool_work);
+  dlp_unlock_mutex(&__tpool_mtx);
+  for (i=0; i<__tpool_nworkers; i++) dlp_join_thread(__tpool_threads[i]);
+  free(__tpool_threads);
+  __tpool_threads  = NULL;
+  __tpool_nworkers = 0;
+  __tpool_bstop    = FALSE;
+#endif
+}
+
+/**
+ * Sets the number of threads the worker pool uses (including the calling
+ * thread). Running workers are stopped; the pool is restarted with the new
+ * size on demand. The function must not be called from within a task.
+ *
+ * @param nThreads The number of threads, 1 disables multithreading, values
+ *                 less than 1 restore the default
+ * @see dlp_tpool_get_nthreads
+ */
+void dlp_tpool_set_nthreads(INT32 nThreads)
+{
+  dlp_tpool_done();
+#ifdef HAVE_PTHREAD
+  dlp_lock_mutex(&__tpool_nmtx);
+#endif
+  __tpool_nthreads = nThreads>0 ? nThreads : -1;
+#ifdef HAVE_PTHREAD
+  dlp_unlock_mutex(&__tpool_nmtx);
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+
+/**
+ * Finishes a task: updates its group and frees it. The caller must hold the
+ * pool mutex.
+ */
+static void dlp_tpool_finish(DLP_TASK* lpTask)
+{
+  if (lpTask->lpGroup && --lpTask->lpGroup->nPending==0)
+    dlp_broadcast_cond(&__tpool_done);
+  free(lpTask);
+}
+
+/**
+ * Removes the first task from the queue. The caller must hold the pool mutex.
+ */
+static DLP_TASK* dlp_tpool_pop()
+{
+  DLP_TASK* lpTask = __tpool_head;
+  if (!lpTask) return NULL;
+  __tpool_head = lpTask->lpNext;
+  if (!__tpool_head) __tpool_tail = NULL;
+  return lpTask;
+}
+
+/**
+ * Root function of the worker threads.
+ */
+static void* dlp_tpool_worker(void* lpArg)
+{
+  DLP_TASK* lpTask = NULL;
+
+  dlp_lock_mutex(&__tpool_mtx);
+  for (;;)
+  {
+    while (!__tpool_head && !__tpool_bstop) dlp_wait_cond(&__tpool_work,&__tpool_mtx);
+    if (!(lpTask=dlp_tpool_pop())) break;
+    dlp_unlock_mutex(&__tpool_mtx);
+    lpTask->lpFunc(lpTask->lpArg);
+    dlp_lock_mutex(&__tpool_mtx);
+    dlp_tpool_finish(lpTask);
+  }
+  dlp_unlock_mutex(&__tpool_mtx);
+  return NULL;
+}
+
+/**
+ * Starts the workers if not running. The caller must hold the pool mutex
+ * (which may be held while taking the thread count mutex, but not vice
+ * versa).
+ */
+static INT16 dlp_tpool_start()
+{
+  INT32 nWorkers = dlp_tpool_get_nthreads()-1;
+  if (__tpool_nworkers || nWorkers<1) return O_K;
+  __tpool_threads = (THREADHANDLE*)calloc(nWorkers,sizeof(THREADHANDLE));
+  if (!__tpool_threads) return NOT_EXEC;
+  for (__tpool_nworkers=0; __tpool_nworkers<nWorkers; __tpool_nworkers++)
+    if (pthread_create(&__tpool_threads[__tpool_nworkers],NULL,dlp_tpool_worker,NULL))
+      break;
+  return __tpool_nworkers ? O_K : NOT_EXEC;
+}
+
+#endif /* #ifdef HAVE_PTHREAD */
+
+/**
+ * Initializes a task group.
+ *
+ * @param lpGroup Pointer to the task group (typically a local variable)
+ * @see dlp_tgroup_run
+ * @see dlp_tgroup_wait
+ */
+void dlp_tgroup_init(DLP_TGROUP* lpGroup)
+{
+  if (lpGroup) lpGroup->nPending = 0;
+}
+
+/**
+ * Runs a task in the worker pool. If the pool has no workers, the task is
+ * executed immediately in the calling thread.
+ *
+ * <p><b>Note:</b> Tasks run concurrently. <code>dlp_malloc</code> and
+ * friends may be used and instances may be created and destroyed, but tasks
+ * must not report errors through the (not thread safe) error handling of the
+ * kernel. Return error codes to the caller instead.</p>
+ *
+ * @param lpGroup Task group to add the task to (may be NULL)
+ * @param lpFunc  Task function
+ * @param lpArg   Argument to task function
+ * @return O_K if successful, NOT_EXEC otherwise
+ * @see dlp_tgroup_wait
+ */
+INT16 dlp_tgroup_run(DLP_TGROUP* lpGroup, DLP_TASKFUNC lpFunc, void* lpArg)
+{
+#ifdef HAVE_PTHREAD
+  DLP_TASK* lpTask = NULL;
+#endif
+
+  if (!lpFunc) return NOT_EXEC;
+#ifdef HAVE_PTHREAD
+  dlp_lock_mutex(&__tpool_mtx);
+  if (dlp_tpool_start()==O_K && __tpool_nworkers)
+    lpTask = (DLP_TASK*)calloc(1,sizeof(DLP_TASK));
+  if (lpTask)
+  {
+    lpTask->lpFunc  = lpFunc;
+    lpTask->lpArg   = lpArg;
+    lpTask->lpGroup = lpGroup;
+    if (lpGroup) lpGroup->nPending++;
+    if (__tpool_tail) __tpool_tail->lpNext = lpTask; else __tpool_head = lpTask;
+    __tpool_tail = lpTask;
+    dlp_signal_cond(&__tpool_work);
+    dlp_unlock_mutex(&__tpool_mtx);
+    return O_K;
+  }
+  dlp_unlock_mutex(&__tpool_mtx);
+#endif
+  lpFunc(lpArg);
+  return O_K;
+}
+
+/**
+ * Waits until all tasks of a group are finished. The calling thread executes
+ * queued tasks while waiting.
+ *
+ * @param lpGroup The task group
+ * @see dlp_tgroup_run
+ */
+void dlp_tgroup_wait(DLP_TGROUP* lpGroup)
+{
+#ifdef HAVE_PTHREAD
+  DLP_TASK* lpTask = NULL;
+
+  if (!lpGroup) return;
+  dlp_lock_mutex(&__tpool_mtx);
+  while (lpGroup->nPending>0)
+  {
+    if ((lpTask=dlp_tpool_pop())!=NULL)
+    {
+      dlp_unlock_mutex(&__tpool_mtx);
+      lpTask->lpFunc(lpTask->lpArg);
+      dlp_lock_mutex(&__tpool_mtx);
+      dlp_tpool_finish(lpTask);
+    }
+    else dlp_wait_cond(&__tpool_done,&__tpool_mtx);
+  }
+  dlp_unlock_mutex(&__tpool_mtx);
+#endif
+}
+
+/**
+ * Executes the chunks of a parallel-for loop until none is left.
+ */
+static void dlp_pfor_task(void* lpArg)
+{
+  DLP_PFOR* lpPfor  = (DLP_PFOR*)lpArg;
+  INT32     nChunk  = 0;
+  INT32     nFirst  = 0;
+  INT32     nEnd    = 0;
+
+  for (;;)
+  {
+#ifdef HAVE_PTHREAD
+    dlp_lock_mutex(&lpPfor->hMtx);
+    nChunk = lpPfor->nNext++;
+    dlp_unlock_mutex(&lpPfor->hMtx);
+#else
+    nChunk = lpPfor->nNext++;
+#endif
+    if (nChunk>=lpPfor->nChunks) return;
+    nFirst = lpPfor->nFirst+nChunk*lpPfor->nGrain;
+    nEnd   = MIN(nFirst+lpPfor->nGrain,lpPfor->nFirst+lpPfor->nCount);
+    lpPfor->lpFunc(lpPfor->lpArg,nFirst,nEnd,nChunk);
+  }
+}
+
+/**
+ * Parallel-for loop over the index range <code>nFirst</code> ...
+ * <code>nFirst+nCount-1</code>. The range is split into chunks of
+ * <code>nGrain</code> indices which are distributed over the worker pool. The
+ * loop body is called once per chunk as
+ * <pre>lpFunc(lpArg,nFirstIdx,nEndIdx,nChunk)</pre>
+ * where <code>nEndIdx</code> is exclusive. The function returns after all
+ * chunks have been processed.
+ *
+ * <p>The partitioning depends only on <code>nCount</code> and
+ * <code>nGrain</code>, never on the number of threads. Loop bodies which write
+ * disjoint results or store per-chunk partial results (indexed by
+ * <code>nChunk</code>) that the caller combines in chunk order therefore
+ * produce identical results for any thread count.</p>
+ *
+ * <p><b>Note:</b> The loop body may use <code>dlp_malloc</code> and friends,
+ * but must neither create instances nor report errors through the error
+ * handling of the kernel. Create instances beforehand, store error codes per
+ * chunk and let the caller report them.</p>
+ *
+ * @param nFirst  First index
+ * @param nCount  Number of indices
+ * @param nGrain  Number of indices per chunk, values less than 1 select
+ *                <code>nCount/64</code> (at least 1)
+ * @param lpFunc  Loop body
+ * @param lpArg   Argument to loop body
+ * @return The number of chunks or NOT_EXEC on errors
+ * @see dlp_pfor_nchunks
+ */
+INT32 dlp_parallel_for
+(
+  INT32        nFirst,
+  INT32        nCount,
+  INT32        nGrain,
+  DLP_PFORFUNC lpFunc,
+  void*        lpArg
+)
+{
+  DLP_PFOR   rPfor;
+  DLP_TGROUP rGroup;
+  INT32      nTasks = 0;
+  INT32      i      = 0;
+
+  if (!lpFunc ) return NOT_EXEC;
+  if (nCount<1) return 0;
+
+  rPfor.lpFunc  = lpFunc;
+  rPfor.lpArg   = lpArg;
+  rPfor.nFirst  = nFirst;
+  rPfor.nCount  = nCount;
+  rPfor.nGrain  = nGrain>0 ? nGrain : MAX(nCount/64,1);
+  rPfor.nChunks = dlp_pfor_nchunks(nCount,nGrain);
+  rPfor.nNext   = 0;
+
+  /* Serial execution (one thread or one chunk) */
+  nTasks = MIN(dlp_tpool_get_nthreads(),rPfor.nChunks)-1;
+  if (nTasks<1)
+  {
+    for (i=0; i<rPfor.nChunks; i++)
+      lpFunc(lpArg,nFirst+i*rPfor.nGrain,MIN(nFirst+(i+1)*rPfor.nGrain,nFirst+nCount),i);
+    return rPfor.nChunks;
+  }
+
+  /* Parallel execution (the calling thread takes part) */
+#ifdef HAVE_PTHREAD
+  if (dlp_create_mutex(&rPfor.hMtx)!=O_K) return NOT_EXEC;
+#endif
+  dlp_tgroup_init(&rGroup);
+  for (i=0; i<nTasks; i++) dlp_tgroup_run(&rGroup,dlp_pfor_task,&rPfor);
+  dlp_pfor_task(&rPfor);
+  dlp_tgroup_wait(&rGroup);
+#ifdef HAVE_PTHREAD
+  dlp_destroy_mutex(&rPfor.hMtx);
+#endif
+  return rPfor.nChunks;
+}
+
+/**
+ * Returns the number of chunks dlp_parallel_for will split a range into. Use
+ * this function to allocate per-chunk partial results.
+ *
+ * @param nCount  Number of indices
+ * @param nGrain  Number of indices per chunk (see dlp_parallel_for)
+ * @return The number of chunks
+ */
+INT32 dlp_pfor_nchunks(INT32 nCount, INT32 nGrain)
+{
+  if (nCount<1) return 0;
+  if (nGrain<1) nGrain = MAX(nCount/64,1);
+  return (nCount+nGrain-1)/nGrain;
+}
+
 /* EOF */
@@ -48,6 +48,9 @@ static INT32        __nXClassRegistry    = 0;    /* The class registry
 static LPF_FORMEX  __FormExFunc         = NULL; /* Pointer to std.formula interpretation func. */
 static CDlpObject* __iFormExInst        = NULL; /* Pointer to std.formula interpreter instance */
 static UINT64      __nSerialNum         = 1;    /* Next free serial number for objects         */
+#ifdef HAVE_PTHREAD
+static MUTEXHANDLE __nSerialNumMtx      = PTHREAD_MUTEX_INITIALIZER; /* Guards __nSerialNum    */
+#endif
 
 /**
  * Returns a pointer to the specified static field of CDlpObject.
@@ -842,12 +845,21 @@ void CDlpObject_ErrorLog()
 }
 
 /**
- * Returns next serial number
+ * Returns next serial number (instances may be created by tasks of the worker
+ * pool, see dlp_thread.c)
  */
 UINT64 CDlpObject_GetNextSerialNum()
 {
+  UINT64 nSerialNum;
+#ifdef HAVE_PTHREAD
+  BOOL   bLocked = (dlp_lock_mutex(&__nSerialNumMtx)==O_K);
+#endif
   if(!__nSerialNum) __nSerialNum++;
-  return __nSerialNum++;
+  nSerialNum = __nSerialNum++;
+#ifdef HAVE_PTHREAD
+  if (bLocked) dlp_unlock_mutex(&__nSerialNumMtx);
+#endif
+  return nSerialNum;
 }
 
 /* EOF */
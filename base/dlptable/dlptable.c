@@ -98,6 +98,8 @@ INT16 CDlpTable_Constructor(CDlpTable* _this)
   _this->m_rtext          = NULL;
   _this->m_vrtext         = NULL;
   _this->m_theDataPointer = NULL;
+  _this->m_bColmajor      = FALSE;
+  _this->m_lpFmap         = NULL;
 
   return O_K;
 }
@@ -142,7 +144,9 @@ INT16 CDlpTable_SReset(CDlpTable* _this)
   if(!_this) return NOT_EXEC;
 
   /* Reset data content */
-  if(_this->m_theDataPointer)
+  if(_this->m_lpFmap)
+    CDlpTable_Unmap(_this,FALSE);
+  else if(_this->m_theDataPointer)
   {
     dlp_free(_this->m_theDataPointer);
     _this->m_theDataPointer = NULL;
@@ -222,9 +226,7 @@ INT16 CDlpTable_Copy(CDlpTable* _this, CDlpTable* lpiSrc, INT32 nFirstRec, INT32
   if(CDlpTable_Scopy(_this,lpiSrc)  !=O_K) return NOT_EXEC;
   if(CDlpTable_Allocate(_this,nRecs)!=O_K) return NOT_EXEC;
 
-  dlp_memmove(_this->m_theDataPointer,
-              lpiSrc->m_theDataPointer + ((INT64)_this->m_reclen * (INT64)nFirstRec),
-              (INT64)nRecs * (INT64)_this->m_reclen);
+  CDlpTable_CopyRecs(_this,0,lpiSrc,nFirstRec,nRecs);
 
   if((nFirstRec + nRecs) > CDlpTable_GetNRecs(lpiSrc))
     CDlpTable_SetNRecs(_this,CDlpTable_GetNRecs(lpiSrc) - nFirstRec);
@@ -272,7 +274,7 @@ INT16 CDlpTable_InsertNcomps(CDlpTable* _this, const char* lpsName, INT16 nType,
   INT32          nOldRln   = 0;
   INT32          nOffset   = 0;
   BYTE*          lpNewData = NULL;
-  BYTE*          lpData    = _this->m_theDataPointer;
+  BYTE*          lpData    = NULL;
   SDlpTableComp* newComp   = NULL;
 
   /* Verify */
@@ -280,6 +282,10 @@ INT16 CDlpTable_InsertNcomps(CDlpTable* _this, const char* lpsName, INT16 nType,
   if (!lpsName               ) return NOT_EXEC;
   if (nComps <= 0            ) return O_K;
 
+  /* Structure of mapped tables cannot be changed in place */
+  if (_this->m_lpFmap && CDlpTable_Unmap(_this,TRUE)!=O_K) return NOT_EXEC;
+  lpData = _this->m_theDataPointer;
+
   /* Save old record size */
   nOldRln = _this->m_reclen;
 
@@ -342,13 +348,23 @@ INT16 CDlpTable_InsertNcomps(CDlpTable* _this, const char* lpsName, INT16 nType,
     for(i=0               ; i<nInsertAt   ; i++) nSize1 += CDlpTable_GetCompSize(_this,i);
     for(i=nInsertAt+nComps; i<_this->m_dim; i++) nSize2 += CDlpTable_GetCompSize(_this,i);
 
-    dlp_memmove(lpNewData,lpData,nSize1);
-
-    for(i=1;i<_this->m_maxrec;i++)
+    if (_this->m_bColmajor)
+    {
+      /* Column-major: move leading and trailing columns as two blocks */
+      dlp_memmove(lpNewData,lpData,(size_t)nSize1*_this->m_maxrec);
+      dlp_memmove(lpNewData+(size_t)(nReclen-nSize2)*_this->m_maxrec,
+        lpData+(size_t)(nOldRln-nSize2)*_this->m_maxrec,(size_t)nSize2*_this->m_maxrec);
+    }
+    else
     {
-      dlp_memmove(lpNewData+(size_t)i*nReclen-nSize2,lpData+(size_t)i*nOldRln-nSize2,nSize1+nSize2);
+      dlp_memmove(lpNewData,lpData,nSize1);
+
+      for(i=1;i<_this->m_maxrec;i++)
+      {
+        dlp_memmove(lpNewData+(size_t)i*nReclen-nSize2,lpData+(size_t)i*nOldRln-nSize2,nSize1+nSize2);
+      }
+      dlp_memmove(lpNewData+(size_t)nNRecs*nReclen-nSize2,lpData+(size_t)nNRecs*nOldRln-nSize2,nSize2);
     }
-    dlp_memmove(lpNewData+(size_t)nNRecs*nReclen-nSize2,lpData+(size_t)nNRecs*nOldRln-nSize2,nSize2);
 
     dlp_free(lpData);
     _this->m_theDataPointer=lpNewData;
@@ -486,7 +502,9 @@ INT16 CDlpTable_AllocateUninitialized(CDlpTable* _this, INT32 nRecs)
   if(!_this->m_compDescrList) return NOT_EXEC;
   if(nRecs<0) nRecs = 0;
 
-  if(_this->m_theDataPointer)
+  if(_this->m_lpFmap)
+    CDlpTable_Unmap(_this,FALSE);
+  else if(_this->m_theDataPointer)
   {
     dlp_free(_this->m_theDataPointer);
     _this->m_theDataPointer = NULL;
@@ -580,6 +598,16 @@ INT16 CDlpTable_Alloc(CDlpTable* _this, INT32 nRecs)
   return nRetval;
 }
 
+/*
+ * Returns the byte offset of the first record in a table file for the
+ * component structure of _this.
+ */
+static INT64 CDlpTable_MapDataOfs(CDlpTable* _this)
+{
+  INT64 nOfs = sizeof(SDlpTableMapHdr) + (INT64)_this->m_dim*sizeof(SDlpTableComp);
+  return (nOfs+CDLPTABLE_MAPALIGN-1)/CDLPTABLE_MAPALIGN*CDLPTABLE_MAPALIGN;
+}
+
 /**
  * Increases or decreases the capacity of the table to the given number of
  * records. The method preserves the structure and the data content of the
@@ -594,6 +622,8 @@ INT16 CDlpTable_Alloc(CDlpTable* _this, INT32 nRecs)
 INT16 CDlpTable_Realloc(CDlpTable* _this, INT32 nRecs)
 {
   BYTE* lpNewDataPtr = NULL;
+  INT32 nC           = 0;
+  INT32 nCopy        = 0;
 
   if(!_this                  ) return NOT_EXEC;
   if(!_this->m_compDescrList ) return NOT_EXEC;
@@ -603,8 +633,44 @@ INT16 CDlpTable_Realloc(CDlpTable* _this, INT32 nRecs)
   if(nRecs == _this->m_nrec  ) return O_K;
   if(_this->m_reclen == 0    ) return NOT_EXEC;
 
-  lpNewDataPtr = (BYTE*)dlp_realloc(_this->m_theDataPointer,nRecs,_this->m_reclen);
-  if(!lpNewDataPtr) return NOT_EXEC;
+  if (_this->m_lpFmap)
+  {
+    /* Mapped: resize the file, the content is not copied */
+    if (_this->m_lpFmap->m_bWrite)
+    {
+      if (dlp_fmap_resize(_this->m_lpFmap,CDlpTable_MapDataOfs(_this)+(INT64)nRecs*(INT64)_this->m_reclen)!=O_K)
+        return NOT_EXEC;
+      _this->m_theDataPointer = _this->m_lpFmap->m_lpData + CDlpTable_MapDataOfs(_this);
+      _this->m_maxrec = nRecs;
+      if(_this->m_nrec>nRecs) _this->m_nrec = nRecs;
+      return O_K;
+    }
+
+    /* Read-only mapping: continue in memory */
+    if (CDlpTable_Unmap(_this,TRUE)!=O_K) return NOT_EXEC;
+    if (!_this->m_theDataPointer) return CDlpTable_Alloc(_this,nRecs);
+  }
+
+  if (_this->m_bColmajor)
+  {
+    /* Column-major: each column moves to its new start address */
+    lpNewDataPtr = (BYTE*)dlp_calloc((size_t)nRecs*_this->m_reclen,sizeof(BYTE));
+    if(!lpNewDataPtr) return NOT_EXEC;
+    nCopy = MIN(nRecs,_this->m_maxrec);
+    for (nC=0; nC<_this->m_dim; nC++)
+      dlp_memmove
+      (
+        lpNewDataPtr + (size_t)_this->m_compDescrList[nC].offset*(size_t)nRecs,
+        _this->m_theDataPointer + (size_t)_this->m_compDescrList[nC].offset*(size_t)_this->m_maxrec,
+        (size_t)nCopy*(size_t)_this->m_compDescrList[nC].size
+      );
+    dlp_free(_this->m_theDataPointer);
+  }
+  else
+  {
+    lpNewDataPtr = (BYTE*)dlp_realloc(_this->m_theDataPointer,nRecs,_this->m_reclen);
+    if(!lpNewDataPtr) return NOT_EXEC;
+  }
 
   _this->m_maxrec = nRecs;
   if(_this->m_nrec>nRecs) _this->m_nrec = nRecs;
@@ -618,6 +684,77 @@ INT16 CDlpTable_Realloc(CDlpTable* _this, INT32 nRecs)
   return O_K;
 }
 
+/**
+ * Switches the memory layout of the table between row-major (records stored
+ * contiguously, the default) and column-major (components stored contiguously).
+ * The method preserves the structure and the data content of the table. In
+ * column-major layout, component nComp occupies the memory block starting at
+ * offset(nComp)*m_maxrec and successive cells of a component are
+ * CDlpTable_GetCompSize bytes apart.
+ *
+ * <p>Cell access through CDlpTable_XAddr, the fetch and store methods and the
+ * table management methods work in both layouts. Code which steps through the
+ * memory block by the record length must use CDlpTable_GetCompStride instead
+ * or requires row-major layout.</p>
+ *
+ * @param _this     Pointer to CDlpTable instance
+ * @param bColmajor TRUE for column-major, FALSE for row-major layout
+ * @return O_K if successfull, a negative error code otherwise
+ */
+INT16 CDlpTable_SetColmajor(CDlpTable* _this, BOOL bColmajor)
+{
+  INT32 nC    = 0;
+  INT32 nR    = 0;
+  INT64 nSize = 0;
+  BYTE* lpNew = NULL;
+  BYTE* lpRow = NULL;
+  BYTE* lpCol = NULL;
+
+  if(!_this                  ) return NOT_EXEC;
+  bColmajor = bColmajor ? TRUE : FALSE;
+  if(_this->m_bColmajor==bColmajor) return O_K;
+  if(!_this->m_compDescrList ) { _this->m_bColmajor=bColmajor; return O_K; }
+  if(_this->m_lpFmap && CDlpTable_Unmap(_this,TRUE)!=O_K) return NOT_EXEC;
+
+  /* Rearrange data (layouts are identical for less than two components) */
+  if(_this->m_theDataPointer && _this->m_maxrec>0 && _this->m_dim>1)
+  {
+    lpNew = (BYTE*)dlp_malloc((size_t)_this->m_maxrec*(size_t)_this->m_reclen);
+    if(!lpNew) return NOT_EXEC;
+
+    for (nC=0; nC<_this->m_dim; nC++)
+    {
+      nSize = _this->m_compDescrList[nC].size;
+      lpRow = (bColmajor ? _this->m_theDataPointer : lpNew) + _this->m_compDescrList[nC].offset;
+      lpCol = (bColmajor ? lpNew : _this->m_theDataPointer) +
+              _this->m_compDescrList[nC].offset*(INT64)_this->m_maxrec;
+      if (bColmajor)
+        for (nR=0; nR<_this->m_maxrec; nR++, lpRow+=_this->m_reclen, lpCol+=nSize)
+          memcpy(lpCol,lpRow,nSize);
+      else
+        for (nR=0; nR<_this->m_maxrec; nR++, lpRow+=_this->m_reclen, lpCol+=nSize)
+          memcpy(lpRow,lpCol,nSize);
+    }
+
+    dlp_free(_this->m_theDataPointer);
+    _this->m_theDataPointer = lpNew;
+  }
+
+  _this->m_bColmajor = bColmajor;
+  return O_K;
+}
+
+/**
+ * Returns TRUE if the table is stored in column-major layout, FALSE otherwise.
+ *
+ * @param _this Pointer to CDlpTable instance
+ * @see CDlpTable_SetColmajor
+ */
+BOOL CDlpTable_IsColmajor(CDlpTable* _this)
+{
+  return _this ? _this->m_bColmajor : FALSE;
+}
+
 /**
  * Appends nRecs valid records to the end of the table and returns the record
  * index of the first new record. If nRealloc is greater than 0, the table's
@@ -673,6 +810,8 @@ INT32 CDlpTable_InsertRecs(CDlpTable* _this, INT32 nInsertAt, INT32 nRecs, INT32
   INT32 nR   = -1;       /* Index of first appended record */
   INT32 nRl  = 0;        /* Record length in bytes         */
   INT64 nXXR = 0;        /* Capacity after reallocation    */
+  INT32 nC   = 0;        /* Current component              */
+  INT64 nSz  = 0;        /* Component size in bytes        */
 
   if ((nR=CDlpTable_AddRecs(_this,nRecs,nRealloc))<0) return -1;
   if (nInsertAt< 0 ) nInsertAt=0;
@@ -681,7 +820,21 @@ INT32 CDlpTable_InsertRecs(CDlpTable* _this, INT32 nInsertAt, INT32 nRecs, INT32
   nXXR = CDlpTable_GetMaxRecs(_this);
   nRl  = CDlpTable_GetRecLen (_this);
 
-  if (nRl>0)
+  if (nRl>0 && _this->m_bColmajor)
+  {
+    for (nC=0; nC<_this->m_dim; nC++)
+    {
+      nSz = _this->m_compDescrList[nC].size;
+      dlp_memmove
+      (
+        CDlpTable_XAddr(_this,nInsertAt+nRecs,nC),
+        CDlpTable_XAddr(_this,nInsertAt      ,nC),
+        (nXXR-nInsertAt-nRecs)*nSz
+      );
+      dlp_memset(CDlpTable_XAddr(_this,nInsertAt,nC),0,(INT64)nRecs*nSz);
+    }
+  }
+  else if (nRl>0)
   {
     dlp_memmove
     (
@@ -695,6 +848,263 @@ INT32 CDlpTable_InsertRecs(CDlpTable* _this, INT32 nInsertAt, INT32 nRecs, INT32
   return nInsertAt;
 }
 
+/**
+ * Copies nRecs records from lpiSrc (starting at record nFirstRec) into this
+ * table (starting at record nInsertAt), overwriting the present content. Both
+ * tables must have the same component structure but may have different memory
+ * layouts (see CDlpTable_SetColmajor). Source and destination may be the same
+ * table. The method copies at most as many records as fit into the capacities
+ * of both tables and does not change the number of valid records.
+ *
+ * @param _this     Pointer to destination instance (this)
+ * @param nInsertAt First destination record
+ * @param lpiSrc    Pointer to source instance
+ * @param nFirstRec First source record
+ * @param nRecs     Number of records to copy
+ * @return O_K if successfull, a negative error code otherwise
+ */
+INT16 CDlpTable_CopyRecs
+(
+  CDlpTable* _this,
+  INT32      nInsertAt,
+  CDlpTable* lpiSrc,
+  INT32      nFirstRec,
+  INT32      nRecs
+)
+{
+  INT32 nC  = 0;
+  INT32 nR  = 0;
+  INT32 nSd = 0;
+  INT32 nSs = 0;
+  INT64 nSz = 0;
+  BYTE* lpD = NULL;
+  BYTE* lpS = NULL;
+
+  if (!_this || !lpiSrc                                     ) return NOT_EXEC;
+  if (!_this->m_theDataPointer || !lpiSrc->m_theDataPointer ) return NOT_EXEC;
+  if (_this->m_dim!=lpiSrc->m_dim                           ) return NOT_EXEC;
+  if (_this->m_reclen!=lpiSrc->m_reclen                     ) return NOT_EXEC;
+  if (nInsertAt<0 || nFirstRec<0                            ) return NOT_EXEC;
+  if (nInsertAt+nRecs>_this->m_maxrec ) nRecs = _this->m_maxrec-nInsertAt;
+  if (nFirstRec+nRecs>lpiSrc->m_maxrec) nRecs = lpiSrc->m_maxrec-nFirstRec;
+  if (nRecs<=0) return O_K;
+
+  /* Both row-major: one block */
+  if (!_this->m_bColmajor && !lpiSrc->m_bColmajor)
+  {
+    dlp_memmove
+    (
+      _this->m_theDataPointer + (INT64)nInsertAt*(INT64)_this->m_reclen,
+      lpiSrc->m_theDataPointer + (INT64)nFirstRec*(INT64)lpiSrc->m_reclen,
+      (INT64)nRecs*(INT64)_this->m_reclen
+    );
+    return O_K;
+  }
+
+  /* Otherwise component by component */
+  for (nC=0; nC<_this->m_dim; nC++)
+  {
+    nSz = _this->m_compDescrList[nC].size;
+    lpD = CDlpTable_XAddr(_this,nInsertAt,nC);
+    lpS = CDlpTable_XAddr(lpiSrc,nFirstRec,nC);
+    if (_this->m_bColmajor && lpiSrc->m_bColmajor)
+      dlp_memmove(lpD,lpS,(INT64)nRecs*nSz);
+    else
+    {
+      nSd = CDlpTable_GetCompStride(_this,nC);
+      nSs = CDlpTable_GetCompStride(lpiSrc,nC);
+      for (nR=0; nR<nRecs; nR++, lpD+=nSd, lpS+=nSs)
+        memcpy(lpD,lpS,nSz);
+    }
+  }
+
+  return O_K;
+}
+
+/**
+ * Writes the table to a file which can be mapped into memory by
+ * CDlpTable_Map. The file contains a header (SDlpTableMapHdr), the component
+ * descriptors and the valid records in row-major layout. The file format is
+ * specific to the platform (byte order and type sizes).
+ *
+ * @param _this       Pointer to CDlpTable instance
+ * @param lpsFilename Name of file to write
+ * @return O_K if successfull, a negative error code otherwise
+ */
+INT16 CDlpTable_MapExport(CDlpTable* _this, const char* lpsFilename)
+{
+  SDlpTableMapHdr hdr;
+  FILE*           lpF   = NULL;
+  BYTE*           lpRec = NULL;
+  INT64           nPos  = 0;
+  INT32           nR    = 0;
+  INT32           nC    = 0;
+  BOOL            bOk   = TRUE;
+
+  if (!_this || !lpsFilename || !_this->m_compDescrList) return NOT_EXEC;
+  if (_this->m_dim<=0 || _this->m_reclen<=0            ) return NOT_EXEC;
+
+  dlp_memset(&hdr,0,sizeof(SDlpTableMapHdr));
+  memcpy(hdr.lpsMagic,CDLPTABLE_MAPMAGIC,8);
+  hdr.nDim     = _this->m_dim;
+  hdr.nReclen  = _this->m_reclen;
+  hdr.nRecs    = _this->m_nrec;
+  hdr.nDataOfs = CDlpTable_MapDataOfs(_this);
+  hdr.nFsr     = _this->m_fsr;
+  hdr.nZf      = _this->m_zf;
+  hdr.nOfs     = _this->m_ofs;
+
+  if (!(lpF = fopen(lpsFilename,"wb"))) return NOT_EXEC;
+  bOk = bOk && fwrite(&hdr,sizeof(SDlpTableMapHdr),1,lpF)==1;
+  bOk = bOk && fwrite(_this->m_compDescrList,sizeof(SDlpTableComp),_this->m_dim,lpF)==(size_t)_this->m_dim;
+  for (nPos=sizeof(SDlpTableMapHdr)+(INT64)_this->m_dim*sizeof(SDlpTableComp); bOk && nPos<hdr.nDataOfs; nPos++)
+    bOk = fputc(0,lpF)!=EOF;
+  if (!_this->m_bColmajor)
+  {
+    if (_this->m_nrec>0)
+      bOk = bOk && fwrite(_this->m_theDataPointer,_this->m_reclen,_this->m_nrec,lpF)==(size_t)_this->m_nrec;
+  }
+  else
+  {
+    /* Column-major: gather records */
+    lpRec = (BYTE*)dlp_malloc(_this->m_reclen);
+    if (!lpRec) bOk = FALSE;
+    for (nR=0; bOk && nR<_this->m_nrec; nR++)
+    {
+      for (nC=0; nC<_this->m_dim; nC++)
+        memcpy(lpRec+_this->m_compDescrList[nC].offset,CDlpTable_XAddr(_this,nR,nC),
+          (size_t)_this->m_compDescrList[nC].size);
+      bOk = fwrite(lpRec,_this->m_reclen,1,lpF)==1;
+    }
+    dlp_free(lpRec);
+  }
+  if (fclose(lpF)!=0) bOk = FALSE;
+  return bOk ? O_K : NOT_EXEC;
+}
+
+/**
+ * Maps a table file written by CDlpTable_MapExport into memory and makes it
+ * the content of this table. The operating system pages records in on demand,
+ * so tables larger than the physical memory can be processed. Mapped tables
+ * are always stored in row-major layout.
+ *
+ * <p>If bWrite is TRUE, changes are written back to the file and
+ * CDlpTable_Realloc (and therefore CDlpTable_AddRecs) grows or shrinks the
+ * file without copying the content. Otherwise the file is mapped
+ * copy-on-write and the table continues in memory when reallocated.
+ * Methods changing the component structure copy the content to memory before.
+ * </p>
+ *
+ * @param _this       Pointer to CDlpTable instance
+ * @param lpsFilename Name of table file
+ * @param bWrite      Map file for writing
+ * @return O_K if successfull, a negative error code otherwise
+ * @see CDlpTable_Unmap
+ */
+INT16 CDlpTable_Map(CDlpTable* _this, const char* lpsFilename, BOOL bWrite)
+{
+  SDlpTableMapHdr hdr;
+  FILE*           lpF   = NULL;
+  DLP_FMAP*       lpMap = NULL;
+  BOOL            bOk   = TRUE;
+
+  if (!_this || !lpsFilename) return NOT_EXEC;
+
+  /* Read header and component structure */
+  if (!(lpF = fopen(lpsFilename,"rb"))) return NOT_EXEC;
+  bOk = fread(&hdr,sizeof(SDlpTableMapHdr),1,lpF)==1;
+  bOk = bOk && memcmp(hdr.lpsMagic,CDLPTABLE_MAPMAGIC,8)==0;
+  bOk = bOk && hdr.nDim>0 && hdr.nReclen>0 && hdr.nRecs>=0;
+  if (bOk)
+  {
+    CDlpTable_Reset(_this);
+    dlp_free(_this->m_compDescrList);
+    _this->m_compDescrList = (SDlpTableComp*)dlp_calloc(hdr.nDim+COMP_ALLOC,sizeof(SDlpTableComp));
+    bOk = _this->m_compDescrList &&
+      fread(_this->m_compDescrList,sizeof(SDlpTableComp),hdr.nDim,lpF)==(size_t)hdr.nDim;
+    if (_this->m_compDescrList)
+    {
+      _this->m_dim    = hdr.nDim;
+      _this->m_maxdim = hdr.nDim+COMP_ALLOC;
+      _this->m_reclen = CDlpTable_GetRecLen(_this);
+    }
+  }
+  fclose(lpF);
+  if (!bOk || _this->m_reclen!=hdr.nReclen || CDlpTable_MapDataOfs(_this)!=hdr.nDataOfs)
+  {
+    CDlpTable_SReset(_this);
+    return NOT_EXEC;
+  }
+
+  /* Map file */
+  lpMap = dlp_fmap_open(lpsFilename,hdr.nDataOfs+hdr.nRecs*hdr.nReclen,bWrite);
+  if (!lpMap) { CDlpTable_SReset(_this); return NOT_EXEC; }
+  _this->m_lpFmap         = lpMap;
+  _this->m_theDataPointer = lpMap->m_lpData+hdr.nDataOfs;
+  _this->m_maxrec         = (INT32)((lpMap->m_nSize-hdr.nDataOfs)/hdr.nReclen);
+  _this->m_nrec           = (INT32)hdr.nRecs;
+  _this->m_bColmajor      = FALSE;
+  _this->m_fsr            = hdr.nFsr;
+  _this->m_zf             = hdr.nZf;
+  _this->m_ofs            = hdr.nOfs;
+
+  return O_K;
+}
+
+/**
+ * Releases the file mapping of a table mapped by CDlpTable_Map. The number of
+ * valid records is written to a writable table file and the file is truncated
+ * to the valid records. If bKeep is TRUE, the valid records are copied to
+ * memory before, otherwise the table loses its data content (but keeps its
+ * component structure). The method does nothing if the table is not mapped.
+ *
+ * @param _this Pointer to CDlpTable instance
+ * @param bKeep Copy the data content to memory
+ * @return O_K if successfull, a negative error code otherwise
+ */
+INT16 CDlpTable_Unmap(CDlpTable* _this, BOOL bKeep)
+{
+  DLP_FMAP* lpMap  = NULL;
+  BYTE*     lpData = NULL;
+  INT64     nDOfs  = 0;
+
+  if (!_this        ) return NOT_EXEC;
+  if (!_this->m_lpFmap) return O_K;
+
+  lpMap = _this->m_lpFmap;
+  nDOfs = CDlpTable_MapDataOfs(_this);
+  if (bKeep && _this->m_nrec>0)
+  {
+    lpData = (BYTE*)dlp_malloc((size_t)_this->m_nrec*(size_t)_this->m_reclen);
+    if (!lpData) return NOT_EXEC;
+    dlp_memmove(lpData,_this->m_theDataPointer,(size_t)_this->m_nrec*(size_t)_this->m_reclen);
+  }
+
+  if (lpMap->m_bWrite)
+  {
+    ((SDlpTableMapHdr*)lpMap->m_lpData)->nRecs = _this->m_nrec;
+    dlp_fmap_sync(lpMap);
+  }
+  dlp_fmap_close(lpMap,nDOfs+(INT64)_this->m_nrec*(INT64)_this->m_reclen);
+
+  _this->m_lpFmap         = NULL;
+  _this->m_theDataPointer = lpData;
+  if (!lpData) _this->m_nrec = 0;
+  _this->m_maxrec         = _this->m_nrec;
+  return O_K;
+}
+
+/**
+ * Determines if the table content is mapped from a file.
+ *
+ * @param _this Pointer to CDlpTable instance
+ * @see CDlpTable_Map
+ */
+BOOL CDlpTable_IsMapped(CDlpTable* _this)
+{
+  return _this && _this->m_lpFmap ? TRUE : FALSE;
+}
+
 /**
  * Clear table (set all cells to zero), the structure of the table
  * remains unchanged
@@ -707,7 +1117,14 @@ INT16 CDlpTable_Clear(CDlpTable* _this)
   if(_this->m_compDescrList==NULL) return NOT_EXEC;
   if(!_this->m_theDataPointer) return NOT_EXEC;
 
-  dlp_memset(_this->m_theDataPointer,0,_this->m_nrec*(size_t)_this->m_reclen);
+  if(_this->m_bColmajor)
+  {
+    INT32 nC;
+    for (nC=0; nC<_this->m_dim; nC++)
+      dlp_memset(CDlpTable_XAddr(_this,0,nC),0,_this->m_nrec*(size_t)_this->m_compDescrList[nC].size);
+  }
+  else
+    dlp_memset(_this->m_theDataPointer,0,_this->m_nrec*(size_t)_this->m_reclen);
 
   return O_K;
 }
@@ -834,6 +1251,23 @@ INT64 CDlpTable_GetCompOffset(CDlpTable* _this, INT32 nComp)
   return _this->m_compDescrList[nComp].offset;
 }
 
+/**
+ * Returns the distance (in bytes) between two successive cells of one
+ * component, i.e. the record length in row-major layout or the component size
+ * in column-major layout (see CDlpTable_SetColmajor).
+ *
+ * @param _this Pointer to CDlpTable instance
+ * @param nComp Index of component
+ */
+INT32 CDlpTable_GetCompStride(CDlpTable* _this, INT32 nComp)
+{
+  if (_this->m_compDescrList==NULL) return 0;
+  if (nComp <0                    ) return 0;
+  if (nComp>=_this->m_dim         ) return 0;
+  if (_this->m_bColmajor) return (INT32)_this->m_compDescrList[nComp].size;
+  return _this->m_reclen;
+}
+
 /**
  * Returns the type of one component of the table.
  *
@@ -978,6 +1412,10 @@ BYTE* CDlpTable_XAddr(CDlpTable* _this, INT32 nRec, INT32 nComp)
 
   if((nRec>=0)&&(nRec<_this->m_maxrec)&&(nComp>=0)&&(nComp<_this->m_dim))
   {
+    if (_this->m_bColmajor)
+      return _this->m_theDataPointer                                        +
+             (INT64)_this->m_compDescrList[nComp].offset*(INT64)_this->m_maxrec +
+             (INT64)nRec*(INT64)_this->m_compDescrList[nComp].size;
     return _this->m_theDataPointer             +
            (INT64)nRec*(INT64)_this->m_reclen  +
            (INT64)_this->m_compDescrList[nComp].offset;
@@ -1030,7 +1468,10 @@ COMPLEX64 CDlpTable_Cfetch(CDlpTable* _this, INT32 nRec, INT32 nComp)
 
   c = &_this->m_compDescrList[nComp];
   t = c->ctype;
-  p = _this->m_theDataPointer+(size_t)nRec*(size_t)_this->m_reclen+(size_t)c->offset;
+  if (_this->m_bColmajor)
+    p = _this->m_theDataPointer+(size_t)c->offset*(size_t)_this->m_maxrec+(size_t)nRec*(size_t)c->size;
+  else
+    p = _this->m_theDataPointer+(size_t)nRec*(size_t)_this->m_reclen+(size_t)c->offset;
 
   return dlp_fetch(p,t);
 }
@@ -1085,7 +1526,10 @@ INT16 CDlpTable_Cstore(CDlpTable* _this, COMPLEX64 nVal, INT32 nRec, INT32 nComp
 
   c = &_this->m_compDescrList[nComp];
   t = c->ctype;
-  p = _this->m_theDataPointer+(INT64)nRec*(INT64)_this->m_reclen+(INT64)c->offset;
+  if (_this->m_bColmajor)
+    p = _this->m_theDataPointer+(INT64)c->offset*(INT64)_this->m_maxrec+(INT64)nRec*(INT64)c->size;
+  else
+    p = _this->m_theDataPointer+(INT64)nRec*(INT64)_this->m_reclen+(INT64)c->offset;
 
   return dlp_store(nVal,p,t);
 }
@@ -1231,12 +1675,7 @@ INT16 CDlpTable_DeleteRecs
   if (nFirstRec+nRecs>lpiSrc->m_nrec) nRecs = lpiSrc->m_nrec-nFirstRec;
   if (nRecs<=0                      ) return O_K;
   CDlpTable_Copy(_this,lpiSrc,0,lpiSrc->m_maxrec);
-  dlp_memmove
-  (
-    _this->m_theDataPointer + nFirstRec*(size_t)_this->m_reclen,
-    _this->m_theDataPointer + (nFirstRec+nRecs)*(size_t)_this->m_reclen,
-    ((size_t)lpiSrc->m_maxrec-nFirstRec-nRecs)*(size_t)_this->m_reclen
-  );
+  CDlpTable_CopyRecs(_this,nFirstRec,_this,nFirstRec+nRecs,lpiSrc->m_maxrec-nFirstRec-nRecs);
   _this->m_nrec = lpiSrc->m_nrec-nRecs;
   return O_K;
 }
@@ -1274,6 +1713,7 @@ INT16 CDlpTable_DeleteComps(CDlpTable* _this, CDlpTable* lpiSrc, INT32 nFirstCom
   if(nTo <= nFirstComp || nTo > lpiSrc->m_dim     ) return O_K;
 
   CDlpTable_Copy(_this,lpiSrc,0,lpiSrc->m_nrec);
+  if(_this->m_lpFmap && CDlpTable_Unmap(_this,TRUE)!=O_K) return NOT_EXEC;
 
   for(i=0         ; i<nFirstComp  ; i++) nSize1+=CDlpTable_GetCompSize(_this,i);
   for(i=nFirstComp; i<nTo         ; i++) nSize2+=CDlpTable_GetCompSize(_this,i);
@@ -1288,22 +1728,36 @@ INT16 CDlpTable_DeleteComps(CDlpTable* _this, CDlpTable* lpiSrc, INT32 nFirstCom
     lpNewDataPtr = (BYTE*)dlp_malloc((size_t)_this->m_maxrec * (size_t)nNewRecLen * sizeof(BYTE));
     if(!lpNewDataPtr) return NOT_EXEC;
 
-    dlp_memmove(lpNewDataPtr, _this->m_theDataPointer, nSize1);
-
-    for(i=1; i<_this->m_maxrec; i++)
+    if (_this->m_bColmajor)
+    {
+      /* Column-major: move leading and trailing columns as two blocks */
+      dlp_memmove(lpNewDataPtr, _this->m_theDataPointer, (size_t)nSize1 * (size_t)_this->m_maxrec);
       dlp_memmove
       (
-        lpNewDataPtr + (size_t)i * (size_t)nNewRecLen - (size_t)nSize3,
-        _this->m_theDataPointer + (size_t)i * (size_t)_this->m_reclen - (size_t)nSize3,
-        nNewRecLen
+        lpNewDataPtr + (size_t)nSize1 * (size_t)_this->m_maxrec,
+        _this->m_theDataPointer + (size_t)(nSize1+nSize2) * (size_t)_this->m_maxrec,
+        (size_t)nSize3 * (size_t)_this->m_maxrec
       );
+    }
+    else
+    {
+      dlp_memmove(lpNewDataPtr, _this->m_theDataPointer, nSize1);
 
-    dlp_memmove
-    (
-      lpNewDataPtr + (size_t)_this->m_maxrec * (size_t)nNewRecLen - (size_t)nSize3,
-      _this->m_theDataPointer + (size_t)_this->m_maxrec * (size_t)_this->m_reclen - (size_t)nSize3,
-      nSize3
-    );
+      for(i=1; i<_this->m_maxrec; i++)
+        dlp_memmove
+        (
+          lpNewDataPtr + (size_t)i * (size_t)nNewRecLen - (size_t)nSize3,
+          _this->m_theDataPointer + (size_t)i * (size_t)_this->m_reclen - (size_t)nSize3,
+          nNewRecLen
+        );
+
+      dlp_memmove
+      (
+        lpNewDataPtr + (size_t)_this->m_maxrec * (size_t)nNewRecLen - (size_t)nSize3,
+        _this->m_theDataPointer + (size_t)_this->m_maxrec * (size_t)_this->m_reclen - (size_t)nSize3,
+        nSize3
+      );
+    }
 
     dlp_free(_this->m_theDataPointer);
     _this->m_theDataPointer = lpNewDataPtr;
@@ -1352,13 +1806,31 @@ INT16 CDlpTable_Join(CDlpTable* _this, CDlpTable* lpiSrc)
   BYTE* lpTs   = NULL;                                                          /* This read pointer                 */
   BYTE* lpSs   = NULL;                                                          /* Source read pointer               */
   BYTE* lpData = NULL;                                                          /* The new data pointer              */
+  BOOL  bCmT   = FALSE;                                                         /* This table is column-major        */
+  BOOL  bCmS   = FALSE;                                                         /* Source table is column-major      */
 
   /* Validation */                                                              /* --------------------------------- */
   if (!_this                  || !lpiSrc                 ) return NOT_EXEC;     /* This and source pointer           */
   if (!_this->m_compDescrList || !lpiSrc->m_compDescrList) return NOT_EXEC;     /* This and src. comp. descr. arrays */
+  if (_this->m_bColmajor || lpiSrc->m_bColmajor)                                /* Column-major layout involved      */
+  {                                                                             /* >>                                */
+    bCmT = _this->m_bColmajor;                                                  /*   Remember layout of this         */
+    bCmS = lpiSrc->m_bColmajor;                                                 /*   Remember layout of source       */
+    if (CDlpTable_SetColmajor(lpiSrc,FALSE)!=O_K) return NOT_EXEC;              /*   Join in row-major layout        */
+    if (CDlpTable_SetColmajor(_this ,FALSE)!=O_K)                               /*   |                               */
+    {                                                                           /*   >> (Failed)                     */
+      CDlpTable_SetColmajor(lpiSrc,bCmS);                                       /*     Restore layout of source      */
+      return NOT_EXEC;                                                          /*     Fail                          */
+    }                                                                           /*   <<                              */
+    nXRD = CDlpTable_Join(_this,lpiSrc);                                        /*   |                               */
+    if (CDlpTable_SetColmajor(lpiSrc,bCmS)!=O_K) nXRD=NOT_EXEC;                 /*   Restore layouts                 */
+    if (CDlpTable_SetColmajor(_this ,bCmT)!=O_K) nXRD=NOT_EXEC;                 /*   |                               */
+    return (INT16)nXRD;                                                         /*   Return result of join           */
+  }                                                                             /* <<                                */
   if (CDlpTable_IsEmpty(lpiSrc)                          ) return O_K;          /* Src. empty -> nothing to be done  */
   if (CDlpTable_IsEmpty(_this))                                                 /* This table empty                  */
     return CDlpTable_Copy(_this,lpiSrc,0,lpiSrc->m_nrec);                       /*   Copy source                     */
+  if (_this->m_lpFmap && CDlpTable_Unmap(_this,TRUE)!=O_K) return NOT_EXEC;     /* Mapped -> continue in memory      */
 
   /* Initialize */                                                              /* --------------------------------- */
   nXRD   = _this->m_nrec;                                                       /* Number of this and dest. records  */
@@ -1533,12 +2005,7 @@ INT16 CDlpTable_CatEx(CDlpTable* _this, CDlpTable* lpiSrc, INT32 nFirstRec, INT3
   if(bIdentical)
   {
     IFCHECK printf("\n Source and destination instance have the same number and types, the operation is performed fast using dlp_memmove.");
-    dlp_memmove
-    (
-      _this->m_theDataPointer+(nNRecOld*(size_t)_this->m_reclen),
-      lpiSrc->m_theDataPointer+(nFirstRec*(size_t)lpiSrc->m_reclen),
-      nCount*(size_t)lpiSrc->m_reclen
-    );
+    CDlpTable_CopyRecs(_this,nNRecOld,lpiSrc,nFirstRec,nCount);
   }
   else
   {
@@ -1634,6 +2101,8 @@ INT16 CDlpTable_Descr(CDlpTable* _this)
   printf("valid record number   : %13ld\n"         ,(  long)_this->m_nrec                  );
   printf("record components     : %13ld\n"         ,(  long)_this->m_dim                   );
   printf("record bytes          : %13ld\n"         ,(  long)_this->m_reclen                );
+  printf("memory layout         : %13s\n"         ,_this->m_bColmajor?"column-major":"row-major");
+  printf("memory mapped         : %13s\n"         ,_this->m_lpFmap?(_this->m_lpFmap->m_bWrite?"read-write":"copy-on-write"):"no");
   printf("descr0                : %13.8f\n"        ,(double)_this->m_descr0                );
   printf("descr1                : %13.8f\n"        ,(double)_this->m_descr1                );
   printf("descr2                : %13.8f\n"        ,(double)_this->m_descr2                );
@@ -661,14 +661,10 @@ INT16 CDN3Stream_NextObject(CDN3Stream* _this)
   return TRUE;
 }
 
-/**
- * Serialize dlpTable instance.
- *
- * @param _this  This instance
- * @param lpiSrc Pointer to table to serialize
- * @return O_K if successful, an error code otherwise
+/*
+ * Serializes a row-major table, see CDN3Stream_SerializeTable.
  */
-INT16 CDN3Stream_SerializeTable(CDN3Stream* _this, CDlpTable* lpiSrc)
+static INT16 _CDN3Stream_SerializeTable(CDN3Stream* _this, CDlpTable* lpiSrc)
 {
   if(!_this                                ) return NOT_EXEC;
   if(!lpiSrc                               ) return NOT_EXEC;
@@ -756,25 +752,10 @@ INT16 CDN3Stream_SerializeTable(CDN3Stream* _this, CDlpTable* lpiSrc)
   return O_K;
 }
 
-/**
- * Deserializes a table (instance of class CDlpTable) from the Dnorm 3 stream.
- *
- * <h3>Notes</h3>
- * <ul>
- *   <li>The fields <code>m_nKnr</code> and <code>m_nRnr</code> must be set to
- *       select class and realization numbers prior to calling this method.</li>
- * </ul>
- *
- * @param _this  This instance
- * @param lpiDst Pointer to table to deserialize
- * @return <p><code>O_K</code> if successful, an error code otherwise:</p>
- * <table>
- *   <tr><th>Value</th><th>Error code</th><th>Description</th></tr>
- *   <tr><td>-2</td><td>-</td><td>Out of memory</td></tr>
- *   <tr><td>-1</td><td><code>NOT_EXEC</code></td><td>Other errors</td></tr>
- * </table>
+/*
+ * Deserializes into a row-major table, see CDN3Stream_DeserializeTable.
  */
-INT16 CDN3Stream_DeserializeTable(CDN3Stream* _this, CDlpTable* lpiDst)
+static INT16 _CDN3Stream_DeserializeTable(CDN3Stream* _this, CDlpTable* lpiDst)
 {
   INT32 nRLnDn = 0;
   INT32 nRec   = 0;
@@ -868,6 +849,57 @@ INT16 CDN3Stream_DeserializeTable(CDN3Stream* _this, CDlpTable* lpiDst)
   return O_K;
 }
 
+/**
+ * Serialize dlpTable instance. Dnorm 3 files store records contiguously, a
+ * column-major table is temporarily converted to row-major layout.
+ *
+ * @param _this  This instance
+ * @param lpiSrc Pointer to table to serialize
+ * @return O_K if successful, an error code otherwise
+ */
+INT16 CDN3Stream_SerializeTable(CDN3Stream* _this, CDlpTable* lpiSrc)
+{
+  INT16 nErr = O_K;
+  BOOL  bCm  = CDlpTable_IsColmajor(lpiSrc);
+
+  if (bCm && NOK(CDlpTable_SetColmajor(lpiSrc,FALSE))) return NOT_EXEC;
+  nErr = _CDN3Stream_SerializeTable(_this,lpiSrc);
+  if (bCm) CDlpTable_SetColmajor(lpiSrc,TRUE);
+  return nErr;
+}
+
+/**
+ * Deserializes a table (instance of class CDlpTable) from the Dnorm 3 stream.
+ *
+ * The memory layout of <code>lpiDst</code> (see CDlpTable_SetColmajor) is
+ * preserved.
+ *
+ * <h3>Notes</h3>
+ * <ul>
+ *   <li>The fields <code>m_nKnr</code> and <code>m_nRnr</code> must be set to
+ *       select class and realization numbers prior to calling this method.</li>
+ * </ul>
+ *
+ * @param _this  This instance
+ * @param lpiDst Pointer to table to deserialize
+ * @return <p><code>O_K</code> if successful, an error code otherwise:</p>
+ * <table>
+ *   <tr><th>Value</th><th>Error code</th><th>Description</th></tr>
+ *   <tr><td>-2</td><td>-</td><td>Out of memory</td></tr>
+ *   <tr><td>-1</td><td><code>NOT_EXEC</code></td><td>Other errors</td></tr>
+ * </table>
+ */
+INT16 CDN3Stream_DeserializeTable(CDN3Stream* _this, CDlpTable* lpiDst)
+{
+  INT16 nErr = O_K;
+  BOOL  bCm  = CDlpTable_IsColmajor(lpiDst);
+
+  if (bCm) CDlpTable_SetColmajor(lpiDst,FALSE);
+  nErr = _CDN3Stream_DeserializeTable(_this,lpiDst);
+  if (bCm && NOK(CDlpTable_SetColmajor(lpiDst,TRUE))) return -2;
+  return nErr;
+}
+
 /**
  * Read DNorm parameter structure.
  *
@@ -96,6 +96,7 @@ void CData_Destructor(CDlpObject* __this)
   UNREMAP_FIELD("nrec"  );
   UNREMAP_FIELD("maxrec");
   UNREMAP_FIELD("reclen");
+  UNREMAP_FIELD("colmajor");
   UNREMAP_FIELD("descr0");
   UNREMAP_FIELD("descr1");
   UNREMAP_FIELD("descr2");
@@ -163,6 +164,8 @@ INT16 CData_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_METHOD("-join","",LPMF(CData,OnJoin),"Appends components",0,"<data iSrc> <data this>","")
 	REGISTER_METHOD("-lookup","",LPMF(CData,OnLookup),"One dimensional table lookup.",0,"<data idSel> <int nIcSel> <data idTab> <int nIcTab> <int nCount> <data this>","{ ... }")
 	REGISTER_METHOD("-lookup_2","",LPMF(CData,OnLookup2),"2-dim. lookup transformation",0,"<data sel1> <int j1> <data sel2> <int j2> <data tab> <data this>","{...}")
+	REGISTER_METHOD("-map","",LPMF(CData,OnMap),"Maps a table file into memory.",0,"<string sFilename> <data this>","")
+	REGISTER_METHOD("-map_export","",LPMF(CData,OnMapExport),"Writes the data content to a mappable table file.",0,"<string sFilename> <data this>","")
 	REGISTER_METHOD("-mark","",LPMF(CData,OnMark),"Mark n records/blocks/components starting from jx.",0,"<int jx> <int n> <data this>","")
 	REGISTER_METHOD("-pfetch","",LPMF(CData,OnPfetch),"Fetches one pointer",0,"<int nIRec> <int nIComp> <data this>","")
 	REGISTER_METHOD("-print","",LPMF(CData,OnPrint),"Print data content",0,"<data this>","")
@@ -180,6 +183,7 @@ INT16 CData_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_METHOD("-select","",LPMF(CData,OnSelect),"Copies components, records, blocks or marked elements",0,"<data idSrc> <int nFirst> <int nCount> <data this>","")
 	REGISTER_METHOD("-set_cname","",LPMF(CData,OnSetCname),"Sets the name of one component",0,"<int nIComp> <string sCName> <data this>","")
 	REGISTER_METHOD("-set_cnames","",LPMF(CData,OnSetCnames),"Sets component names from a table",0,"<data iTable> <int nIComp> <data this>","")
+	REGISTER_METHOD("-set_colmajor","",LPMF(CData,OnSetColmajor),"Switches the memory layout between row- and column-major.",0,"<BOOL bColmajor> <data this>","")
 	REGISTER_METHOD("-sfetch","",LPMF(CData,OnSfetch),"Fetches one string",0,"<int nIRec> <int nIComp> <data this>","")
 	REGISTER_METHOD("-shift","",LPMF(CData,OnShift),"Shift n records/blocks/components.",0,"<data iSrc> <int nCount> <data this>","")
 	REGISTER_METHOD("-sortdown","",LPMF(CData,OnSortdown),"Sort data using comp. j as sort index in descending order.",0,"<data x> <int j> <data this>","")
@@ -189,6 +193,7 @@ INT16 CData_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_METHOD("-store","",LPMF(CData,OnStore),"Stores one value.",0,"<val> <int nIr> <comp> <data this>","")
 	REGISTER_METHOD("-strop","",LPMF(CData,OnStrop),"Executes string operation y=op(x,s)",0,"<data iSrc> <string sParam> <string sOpname> <data this>","")
 	REGISTER_METHOD("-tconvert","",LPMF(CData,OnTconvert),"Copies and convert numeric components",0,"<data idSrc> <short nCType> <data this>","")
+	REGISTER_METHOD("-unmap","",LPMF(CData,OnUnmap),"Detaches a mapped table file.",0,"<data this>","")
 	REGISTER_METHOD("-unmark","",LPMF(CData,OnUnmark),"Clear all markings.",0,"<data this>","")
 	REGISTER_METHOD("-xfetch","",LPMF(CData,OnXfetch),"Fetches components, records or blocks.",0,"<first> <int nCount> <data this>","")
 	REGISTER_METHOD("-xstore","",LPMF(CData,OnXstore),"Stores several components, records or blocks of a data           instance to another data instance at a specified position.",0,"<data idScr> <int nFirst> <int nCount> <pos> <data this>","")
@@ -208,11 +213,13 @@ INT16 CData_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_OPTION("/noise","",LPMV(m_bNoise),NULL,"Generate noise",0)
 	REGISTER_OPTION("/numeric","",LPMV(m_bNumeric),NULL,"Sort strings numeric.",0)
 	REGISTER_OPTION("/nz","",LPMV(m_bNz),NULL,"Print zeros as '-'",0)
+	REGISTER_OPTION("/rdonly","",LPMV(m_bRdonly),NULL,"Map file read-only (copy-on-write).",0)
 	REGISTER_OPTION("/rec","",LPMV(m_bRec),NULL,"Record mode",0)
 
 	/* Register fields */
 	REGISTER_FIELD("cinc","",LPMV(m_nCinc),NULL,"Distance between subsequent components in physical units.",0,3008,1,"double",(FLOAT64)0.)
 	REGISTER_FIELD("cofs","",LPMV(m_nCofs),NULL,"Offset of first component in physical units.",0,3008,1,"double",(FLOAT64)0.)
+	REGISTER_FIELD("colmajor","",NULL,NULL,"Column-major memory layout",FF_NOSET | FF_NOSAVE,1000,1,"bool",(BOOL)0)
 	REGISTER_FIELD("cunit","",LPMV(m_lpCunit),NULL,"Physical unit of component axis",0,10,10,"char[10]","")
 	REGISTER_FIELD("descr0","",NULL,NULL,"User data description 0",0,3008,1,"double",(FLOAT64)0.)
 	REGISTER_FIELD("descr1","",NULL,NULL,"User data description 1",0,3008,1,"double",(FLOAT64)0.)
@@ -288,6 +295,7 @@ INT16 CData_Init(CDlpObject* __this, BOOL bCallVirtual)
     REMAP_FIELD("nrec"  , _this->m_lpTable->m_nrec  );
     REMAP_FIELD("maxrec", _this->m_lpTable->m_maxrec);
     REMAP_FIELD("reclen", _this->m_lpTable->m_reclen);
+    REMAP_FIELD("colmajor", _this->m_lpTable->m_bColmajor);
     REMAP_FIELD("descr0", _this->m_lpTable->m_descr0);
     REMAP_FIELD("descr1", _this->m_lpTable->m_descr1);
     REMAP_FIELD("descr2", _this->m_lpTable->m_descr2);
@@ -1020,6 +1028,7 @@ INT16 CData_ResetAllOptions(CDlpObject* __this, BOOL bInit)
 	_this->m_bNoise = FALSE;
 	_this->m_bNumeric = FALSE;
 	_this->m_bNz = FALSE;
+	_this->m_bRdonly = FALSE;
 	_this->m_bRec = FALSE;
 	/*}}CGEN_RESETALLOPTIONS*/
 	}
@@ -1629,6 +1638,38 @@ INT16 CData_OnLookup2(CDlpObject* __this)
 	return __nErr;
 }
 
+INT16 CData_OnMap(CDlpObject* __this)
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	INT16 __nErr    = O_K;
+	INT32  __nErrCnt = 0;
+	char* sFilename;
+	GET_THIS_VIRTUAL_RV(CData,NOT_EXEC);
+	MIC_CHECK;
+	__nErrCnt = CDlpObject_GetErrorCount();
+	sFilename = MIC_GET_S(1,0);
+	if (CDlpObject_GetErrorCount()>__nErrCnt) return NOT_EXEC;
+	__nErr = CData_Map(_this, sFilename);
+	return __nErr;
+}
+
+INT16 CData_OnMapExport(CDlpObject* __this)
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	INT16 __nErr    = O_K;
+	INT32  __nErrCnt = 0;
+	char* sFilename;
+	GET_THIS_VIRTUAL_RV(CData,NOT_EXEC);
+	MIC_CHECK;
+	__nErrCnt = CDlpObject_GetErrorCount();
+	sFilename = MIC_GET_S(1,0);
+	if (CDlpObject_GetErrorCount()>__nErrCnt) return NOT_EXEC;
+	__nErr = CData_MapExport(_this, sFilename);
+	return __nErr;
+}
+
 INT16 CData_OnMark(CDlpObject* __this)
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -1937,6 +1978,22 @@ INT16 CData_OnSetCnames(CDlpObject* __this)
 	return __nErr;
 }
 
+INT16 CData_OnSetColmajor(CDlpObject* __this)
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	INT16 __nErr    = O_K;
+	INT32  __nErrCnt = 0;
+	BOOL bColmajor;
+	GET_THIS_VIRTUAL_RV(CData,NOT_EXEC);
+	MIC_CHECK;
+	__nErrCnt = CDlpObject_GetErrorCount();
+	bColmajor = MIC_GET_B(1,0);
+	if (CDlpObject_GetErrorCount()>__nErrCnt) return NOT_EXEC;
+	__nErr = CData_SetColmajor(_this, bColmajor);
+	return __nErr;
+}
+
 INT16 CData_OnSfetch(CDlpObject* __this)
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -2103,6 +2160,20 @@ INT16 CData_OnTconvert(CDlpObject* __this)
 	return __nErr;
 }
 
+INT16 CData_OnUnmap(CDlpObject* __this)
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	INT16 __nErr    = O_K;
+	INT32  __nErrCnt = 0;
+	GET_THIS_VIRTUAL_RV(CData,NOT_EXEC);
+	MIC_CHECK;
+	__nErrCnt = CDlpObject_GetErrorCount();
+	if (CDlpObject_GetErrorCount()>__nErrCnt) return NOT_EXEC;
+	__nErr = CData_Unmap(_this);
+	return __nErr;
+}
+
 INT16 CData_OnUnmark(CDlpObject* __this)
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -2586,6 +2657,20 @@ INT16 CData::OnLookup2()
 	return CData_OnLookup2(this);
 }
 
+INT16 CData::OnMap()
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	return CData_OnMap(this);
+}
+
+INT16 CData::OnMapExport()
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	return CData_OnMapExport(this);
+}
+
 INT16 CData::OnMark()
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -2705,6 +2790,13 @@ INT16 CData::OnSetCnames()
 	return CData_OnSetCnames(this);
 }
 
+INT16 CData::OnSetColmajor()
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	return CData_OnSetColmajor(this);
+}
+
 INT16 CData::OnSfetch()
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -2768,6 +2860,13 @@ INT16 CData::OnTconvert()
 	return CData_OnTconvert(this);
 }
 
+INT16 CData::OnUnmap()
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	return CData_OnUnmap(this);
+}
+
 INT16 CData::OnUnmark()
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -2874,6 +2973,41 @@ INT16 CData::Realloc(INT32 nRecs)
 	return CData_Realloc(this, nRecs);
 }
 
+INT16 CData::SetColmajor(BOOL bColmajor)
+{
+	return CData_SetColmajor(this, bColmajor);
+}
+
+BOOL CData::IsColmajor()
+{
+	return CData_IsColmajor(this);
+}
+
+INT16 CData::Rowmajor()
+{
+	return CData_Rowmajor(this);
+}
+
+INT16 CData::MapExport(const char* sFilename)
+{
+	return CData_MapExport(this, sFilename);
+}
+
+INT16 CData::Map(const char* sFilename)
+{
+	return CData_Map(this, sFilename);
+}
+
+INT16 CData::Unmap()
+{
+	return CData_Unmap(this);
+}
+
+BOOL CData::IsMapped()
+{
+	return CData_IsMapped(this);
+}
+
 INT32 CData::AddRecs(INT32 nRecs, INT32 nRealloc)
 {
 	return CData_AddRecs(this, nRecs, nRealloc);
@@ -2949,6 +3083,11 @@ INT32 CData::GetCompOffset(INT32 nComp)
 	return CData_GetCompOffset(this, nComp);
 }
 
+INT32 CData::GetCompStride(INT32 nComp)
+{
+	return CData_GetCompStride(this, nComp);
+}
+
 INT32 CData::GetRecLen()
 {
 	return CData_GetRecLen(this);
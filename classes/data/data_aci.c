@@ -133,6 +133,112 @@ INT16 CGEN_PUBLIC CData_Realloc(CData* _this, INT32 nRecs)
   return CDlpTable_Realloc(_this->m_lpTable,nRecs);
 }
 
+/**
+ * Switches the memory layout of the data content between row-major (default)
+ * and column-major. The data content is preserved.
+ *
+ * ATTENTION: After changing the layout ALL pointers into the
+ *            data content become invalid!
+ *
+ * @param _this     This instance
+ * @param bColmajor TRUE for column-major, FALSE for row-major layout
+ * @return O_K of successfull, an error code otherwise
+ * @see CData_GetCompStride
+ */
+INT16 CGEN_PUBLIC CData_SetColmajor(CData* _this, BOOL bColmajor)
+{
+  CHECK_THIS_RV(NOT_EXEC);
+  return CDlpTable_SetColmajor(_this->m_lpTable,bColmajor);
+}
+
+/**
+ * Determines if the data content is stored in column-major layout.
+ *
+ * @param _this This instance
+ * @return TRUE if the data content is stored column-major, FALSE otherwise
+ */
+BOOL CGEN_PUBLIC CData_IsColmajor(CData* _this)
+{
+  CHECK_THIS_RV(FALSE);
+  return CDlpTable_IsColmajor(_this->m_lpTable);
+}
+
+/**
+ * Converts the data content to row-major layout if it is stored column-major.
+ * Methods which step through the data content by the record length or access
+ * entire records as vectors call this function for their data arguments.
+ *
+ * @param _this This instance, may be <code>NULL</code>
+ * @return O_K if the instance is <code>NULL</code> or (now) row-major, an
+ *         error code otherwise
+ * @see CData_SetColmajor
+ */
+INT16 CGEN_PUBLIC CData_Rowmajor(CData* _this)
+{
+  if (!_this || !CData_IsColmajor(_this)) return O_K;
+  return CData_SetColmajor(_this,FALSE);
+}
+
+/**
+ * Writes the data content to a file which can be mapped by CData_Map.
+ *
+ * @param _this       This instance
+ * @param sFilename   Name of file to write
+ * @return O_K if successful, a (negative) error code otherwise
+ * @see CDlpTable_MapExport
+ */
+INT16 CGEN_PUBLIC CData_MapExport(CData* _this, const char* sFilename)
+{
+  CHECK_THIS_RV(NOT_EXEC);
+  if (CDlpTable_MapExport(_this->m_lpTable,sFilename)!=O_K)
+    return IERROR(_this,ERR_FILEOPEN,sFilename,"writing",0);
+  return O_K;
+}
+
+/**
+ * Maps a table file written by CData_MapExport into memory. The file is mapped
+ * writable unless the option /rdonly is set.
+ *
+ * @param _this       This instance
+ * @param sFilename   Name of file to map
+ * @return O_K if successful, a (negative) error code otherwise
+ * @see CDlpTable_Map
+ */
+INT16 CGEN_PUBLIC CData_Map(CData* _this, const char* sFilename)
+{
+  CHECK_THIS_RV(NOT_EXEC);
+  if (CDlpTable_Map(_this->m_lpTable,sFilename,!_this->m_bRdonly)!=O_K)
+    return IERROR(_this,ERR_FILEOPEN,sFilename,"mapping",0);
+  return O_K;
+}
+
+/**
+ * Detaches this instance from a mapped table file and resets it.
+ *
+ * @param _this This instance
+ * @return O_K if successful, a (negative) error code otherwise
+ * @see CDlpTable_Unmap
+ */
+INT16 CGEN_PUBLIC CData_Unmap(CData* _this)
+{
+  CHECK_THIS_RV(NOT_EXEC);
+  if (!CDlpTable_IsMapped(_this->m_lpTable)) return O_K;
+  CDlpTable_Unmap(_this->m_lpTable,FALSE);
+  return CData_Reset(BASEINST(_this),TRUE);
+}
+
+/**
+ * Determines if the data content is mapped from a file.
+ *
+ * @param _this This instance
+ * @return TRUE if the data content is memory mapped, FALSE otherwise
+ */
+BOOL CGEN_PUBLIC CData_IsMapped(CData* _this)
+{
+  CHECK_THIS_RV(FALSE);
+  return CDlpTable_IsMapped(_this->m_lpTable);
+}
+
 /**
  * Appends nRecs valid records to the end of the table and returns the record
  * index of the first new record. If nRealloc is greater than 0, the table's
@@ -395,6 +501,21 @@ INT32 CGEN_PUBLIC CData_GetCompOffset(CData* _this, INT32 nComp)
   return CDlpTable_GetCompOffset(_this->m_lpTable, nComp);
 }
 
+/**
+ * Returns the distance in bytes between two successive cells of component
+ * nComp. This is the record length for row-major and the component size for
+ * column-major instances (see CData_SetColmajor).
+ *
+ * @param _this This instance
+ * @param nComp The zero-based index of the component in question
+ * @return The stride (in bytes) of component nComp
+ */
+INT32 CGEN_PUBLIC CData_GetCompStride(CData* _this, INT32 nComp)
+{
+  CHECK_THIS_RV(0);
+  return CDlpTable_GetCompStride(_this->m_lpTable, nComp);
+}
+
 /**
  * Returns the length of one record of the data instance in bytes.
  * This length is equal to the sum of all component sizes (see
@@ -436,7 +557,10 @@ INT32 CGEN_PUBLIC CData_FindRec(CData* _this, INT32 nComp, char* sWhat)
  */
 INT32 CGEN_PUBLIC CData_CcompFetch(CData* _this, COMPLEX64* dBuffer, INT32 nComp, INT32 nMaxRecs)
 {
-  INT32 i = 0;
+  INT32 i    = 0;
+  INT32 nStr = 0;
+  INT16 nTyp = 0;
+  BYTE* lpC  = NULL;
 
   CHECK_THIS_RV(0);
 
@@ -448,7 +572,10 @@ INT32 CGEN_PUBLIC CData_CcompFetch(CData* _this, COMPLEX64* dBuffer, INT32 nComp
 
   nMaxRecs=((nMaxRecs>CData_GetMaxRecs(_this))?CData_GetMaxRecs(_this):nMaxRecs);
 
-  for(i=0;i<nMaxRecs;i++) *(dBuffer+i)=CData_Cfetch(_this,i,nComp);
+  nStr=CData_GetCompStride(_this,nComp);
+  nTyp=CData_GetCompType(_this,nComp);
+  for(i=0,lpC=CData_XAddr(_this,0,nComp);i<nMaxRecs;i++,lpC+=nStr)
+    dBuffer[i]=dlp_fetch(lpC,nTyp);
 
   /* HACK: This is not the number of actually fetched values!!! (??) */
   return nMaxRecs;
@@ -465,7 +592,10 @@ INT32 CGEN_PUBLIC CData_CcompFetch(CData* _this, COMPLEX64* dBuffer, INT32 nComp
  */
 INT32 CGEN_PUBLIC CData_DcompFetch(CData* _this, FLOAT64* dBuffer, INT32 nComp, INT32 nMaxRecs)
 {
-  INT32 i = 0;
+  INT32 i    = 0;
+  INT32 nStr = 0;
+  INT16 nTyp = 0;
+  BYTE* lpC  = NULL;
 
   CHECK_THIS_RV(0);
 
@@ -477,7 +607,13 @@ INT32 CGEN_PUBLIC CData_DcompFetch(CData* _this, FLOAT64* dBuffer, INT32 nComp,
 
   nMaxRecs=((nMaxRecs>CData_GetMaxRecs(_this))?CData_GetMaxRecs(_this):nMaxRecs);
 
-  for(i=0;i<nMaxRecs;i++) *(dBuffer+i)=CData_Dfetch(_this,i,nComp);
+  nStr=CData_GetCompStride(_this,nComp);
+  nTyp=CData_GetCompType(_this,nComp);
+  if (nTyp==T_DOUBLE && nStr==sizeof(FLOAT64))
+    dlp_memmove(dBuffer,CData_XAddr(_this,0,nComp),nMaxRecs*sizeof(FLOAT64));
+  else
+    for(i=0,lpC=CData_XAddr(_this,0,nComp);i<nMaxRecs;i++,lpC+=nStr)
+      dBuffer[i]=dlp_fetch(lpC,nTyp).x;
 
   /* HACK: This is not the number of actually fetched values!!! (??) */
   return nMaxRecs;
@@ -494,7 +630,10 @@ INT32 CGEN_PUBLIC CData_DcompFetch(CData* _this, FLOAT64* dBuffer, INT32 nComp,
  */
 INT32 CGEN_PUBLIC CData_CcompStore(CData* _this, COMPLEX64* dBuffer, INT32 nComp, INT32 nMaxRecs)
 {
-  INT32 i = 0;
+  INT32 i    = 0;
+  INT32 nStr = 0;
+  INT16 nTyp = 0;
+  BYTE* lpC  = NULL;
 
   CHECK_THIS_RV(0);
 
@@ -506,7 +645,10 @@ INT32 CGEN_PUBLIC CData_CcompStore(CData* _this, COMPLEX64* dBuffer, INT32 nComp
 
   nMaxRecs=((nMaxRecs>CData_GetMaxRecs(_this))?CData_GetMaxRecs(_this):nMaxRecs);
 
-  for(i=0;i<nMaxRecs;i++) CData_Cstore(_this,dBuffer[i],i,nComp);
+  nStr=CData_GetCompStride(_this,nComp);
+  nTyp=CData_GetCompType(_this,nComp);
+  for(i=0,lpC=CData_XAddr(_this,0,nComp);i<nMaxRecs;i++,lpC+=nStr)
+    dlp_store(dBuffer[i],lpC,nTyp);
 
   /* HACK: This is not the number of actually stored values!!! (??) */
   return nMaxRecs;
@@ -523,7 +665,10 @@ INT32 CGEN_PUBLIC CData_CcompStore(CData* _this, COMPLEX64* dBuffer, INT32 nComp
  */
 INT32 CGEN_PUBLIC CData_DcompStore(CData* _this, FLOAT64* dBuffer, INT32 nComp, INT32 nMaxRecs)
 {
-  INT32 i = 0;
+  INT32 i    = 0;
+  INT32 nStr = 0;
+  INT16 nTyp = 0;
+  BYTE* lpC  = NULL;
 
   CHECK_THIS_RV(0);
 
@@ -535,7 +680,13 @@ INT32 CGEN_PUBLIC CData_DcompStore(CData* _this, FLOAT64* dBuffer, INT32 nComp,
 
   nMaxRecs=((nMaxRecs>CData_GetMaxRecs(_this))?CData_GetMaxRecs(_this):nMaxRecs);
 
-  for(i=0;i<nMaxRecs;i++) CData_Dstore(_this,dBuffer[i],i,nComp);
+  nStr=CData_GetCompStride(_this,nComp);
+  nTyp=CData_GetCompType(_this,nComp);
+  if (nTyp==T_DOUBLE && nStr==sizeof(FLOAT64))
+    dlp_memmove(CData_XAddr(_this,0,nComp),dBuffer,nMaxRecs*sizeof(FLOAT64));
+  else
+    for(i=0,lpC=CData_XAddr(_this,0,nComp);i<nMaxRecs;i++,lpC+=nStr)
+      dlp_store(CMPLX(dBuffer[i]),lpC,nTyp);
 
   /* HACK: This is not the number of actually stored values!!! (??) */
   return nMaxRecs;
@@ -965,7 +1116,7 @@ INT32 CGEN_PUBLIC CData_DijFetch(CData* _this, FLOAT64* dBuffer, INT32 nRec, INT
   if (dlp_is_numeric_type_code(nTypeCode)!=TRUE)    return 0;
 
   lpData    = CData_XAddr(_this,nRec,nComp);
-  nBlockLen = CData_GetRecLen(_this) * CData_GetNRecsPerBlock(_this);
+  nBlockLen = CData_GetCompStride(_this,nComp) * CData_GetNRecsPerBlock(_this);
   nBlocks   = CData_GetNBlocks(_this);
 
   if (nBlocks > nMaxBlocks) nBlocks = nMaxBlocks;
@@ -1001,7 +1152,7 @@ INT32 CGEN_PUBLIC CData_CijFetch(CData* _this, COMPLEX64* dBuffer, INT32 nRec, I
   if (dlp_is_numeric_type_code(nTypeCode)!=TRUE)    return 0;
 
   lpData    = CData_XAddr(_this,nRec,nComp);
-  nBlockLen = CData_GetRecLen(_this) * CData_GetNRecsPerBlock(_this);
+  nBlockLen = CData_GetCompStride(_this,nComp) * CData_GetNRecsPerBlock(_this);
   nBlocks   = CData_GetNBlocks(_this);
 
   if (nBlocks > nMaxBlocks) nBlocks = nMaxBlocks;
@@ -1092,12 +1243,7 @@ INT16 CGEN_PUBLIC CData_SelectRecs(CData* _this, data* iSrc, INT32 from, INT32 c
   CData_AllocateUninitialized(_this,count);
 
     /* Move data */
-  dlp_memmove
-  (
-      CData_XAddr(_this,0,0),
-      CData_XAddr(iSrc,from,0),
-      count*CData_GetRecLen(_this)
-  );
+  CDlpTable_CopyRecs(_this->m_lpTable,0,iSrc->m_lpTable,from,count);
 
   DESTROYVIRTUAL(iSrc,_this);
 
@@ -1131,17 +1277,11 @@ INT16 CGEN_PUBLIC CData_SelectBlocks(CData* _this, data* iSrc, INT32 from, INT32
   if(_this!=iSrc)
   {
     INT32 nRecPerBlock = 0;
-    BYTE* lpSrc       = NULL;
-    BYTE* lpDest      = NULL;
 
     nRecPerBlock = CData_GetNRecsPerBlock(iSrc);
     CData_Scopy(_this, iSrc);
     CData_AllocateUninitialized(_this,count*nRecPerBlock);
-
-    lpSrc  = CData_XAddr(iSrc,from*nRecPerBlock,0);
-    lpDest = CData_XAddr(_this,0,0);
-
-    dlp_memmove(lpDest,lpSrc,count*nRecPerBlock*CData_GetRecLen(iSrc));
+    CDlpTable_CopyRecs(_this->m_lpTable,0,iSrc->m_lpTable,from*nRecPerBlock,count*nRecPerBlock);
     CData_SetNBlocks(_this,count);
 
     DLP_CHECK_MEMINTEGRITY;
@@ -1212,8 +1352,6 @@ INT16 CGEN_PUBLIC CData_DeleteRecs(CData* _this, INT32 from, INT32 count)
 INT16 CGEN_PUBLIC CData_DeleteBlocks(CData* _this, INT32 from, INT32 count)
 {
   INT32  nBLen  = 0;
-  BYTE* lpSrc  = NULL;
-  BYTE* lpDest = NULL;
 
   CHECK_THIS_RV(NOT_EXEC);
 
@@ -1221,10 +1359,8 @@ INT16 CGEN_PUBLIC CData_DeleteBlocks(CData* _this, INT32 from, INT32 count)
 
   nBLen = CData_GetNRecsPerBlock(_this);
 
-  lpDest = CData_XAddr(_this,from*nBLen,0);
-  lpSrc  = CData_XAddr(_this,(from+count)*nBLen,0);
-
-  dlp_memmove(lpDest,lpSrc,(CData_GetNRecs(_this)-(from+count)*nBLen)*CData_GetRecLen(_this));
+  CDlpTable_CopyRecs(_this->m_lpTable,from*nBLen,_this->m_lpTable,(from+count)*nBLen,
+    CData_GetNRecs(_this)-(from+count)*nBLen);
 
   CData_SetNRecs(_this,CData_GetNRecs(_this)-(count*nBLen));
   CData_SetNBlocks(_this,CData_GetNBlocks(_this)-count);
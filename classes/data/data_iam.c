@@ -336,6 +336,7 @@ INT16 CGEN_PUBLIC CData_Fill(CData* _this, COMPLEX64 dStart, COMPLEX64 dDelta)
 INT16 CGEN_PUBLIC CData_Lookup(CData* _this, data* dSel, INT32 nSelComp, data *dTab, INT32 nTabComp, INT32 nCount)
 {
   INT32 i                    = 0;
+  INT32 j                    = 0;
   INT32 nTo                  = 0;
   INT32 nIdx                 = 0;
   INT32 nRecs                = 0;
@@ -386,7 +387,12 @@ INT16 CGEN_PUBLIC CData_Lookup(CData* _this, data* dSel, INT32 nSelComp, data *d
     nIdx=(INT32)CData_Dfetch(dSel,i,nSelComp);
     if (nIdx > -1 && nIdx < nTabLen)
     {
-      dlp_memmove(CData_XAddr(_this,nTo,0),CData_XAddr(dTab,nIdx,nTabComp),nRecln);
+      if (CData_IsColmajor(_this) || CData_IsColmajor(dTab))
+        for (j=0; j<nCount; j++)
+          dlp_memmove(CData_XAddr(_this,nTo,j),CData_XAddr(dTab,nIdx,nTabComp+j),
+            CData_GetCompSize(_this,j));
+      else
+        dlp_memmove(CData_XAddr(_this,nTo,0),CData_XAddr(dTab,nIdx,nTabComp),nRecln);
     }
     else if (dlp_strlen(lpsInit)>0) CData_InitializeRecordEx(_this,lpsInit,i,0);
   }
@@ -1178,8 +1184,11 @@ BOOL CGEN_PUBLIC CData_Xstore(CData* _this,CData* idSrc, INT32 nFirst, INT32 nCo
   {
     if(_this->m_bRec)
     {
-      dlp_memmove(CData_XAddr(_this,nPos,0),CData_XAddr(idSrc,nFirst,0),
-        nCount*CData_GetRecLen(idSrc));
+      if (CData_IsColmajor(_this) || CData_IsColmajor(idSrc))
+        CDlpTable_CopyRecs(_this->m_lpTable,nPos,idSrc->m_lpTable,nFirst,nCount);
+      else
+        dlp_memmove(CData_XAddr(_this,nPos,0),CData_XAddr(idSrc,nFirst,0),
+          nCount*CData_GetRecLen(idSrc));
       /* MWX 2006-02-15: Would not copy strings 'n stuff!
       buffer=(FLOAT64*)dlp_calloc(nCount*CData_GetNComps(idSrc),sizeof(FLOAT64));
       for(i=0;i<nCount;i++)
@@ -1285,19 +1294,16 @@ BOOL CGEN_PUBLIC CData_Reshape(CData* _this, CData* iSrc, INT32 nRec, INT32 nCom
   {
     INT32  j      = 0;
     INT32  nSum   = 0;
-    char *lpDest = NULL;
 
     CData_AddNcomps(_this,nTypeCode,nComp);
     CData_AllocateUninitialized(_this,nRec);
-
-    lpDest = (char*)CData_XAddr(_this,0,0);
-    DLPASSERT(lpDest);
+    DLPASSERT(CData_XAddr(_this,0,0));
 
     for(j=0;j<nComps&&(nSum<nRec*nComp);j++)
     {
       for(i=0;i<nRecs&&(nSum<nRec*nComp);i++)
       {
-        dlp_strncpy(lpDest+(nSum*nTypeCode*sizeof(char)),(char*)CData_XAddr(iSrc,i,j),nTypeCode);
+        dlp_strncpy((char*)CData_XAddr(_this,nSum/nComp,nSum%nComp),(char*)CData_XAddr(iSrc,i,j),nTypeCode);
         nSum++;
       }
     }
@@ -1348,6 +1354,7 @@ INT16 CGEN_PUBLIC CData_Shift(CData* _this, CData* iSrc, INT32 nCount)
   INT32   nSize  = 0;
   BYTE*  lpSrc  = NULL;
   BYTE*  lpDest = NULL;
+  BOOL   bCm    = FALSE;
 
   CHECK_THIS_RV(NOT_EXEC);
   if (!iSrc)
@@ -1366,6 +1373,9 @@ INT16 CGEN_PUBLIC CData_Shift(CData* _this, CData* iSrc, INT32 nCount)
   /* shift mode */
   if(_this->m_bRec)
   {
+    /* Shift whole records in row-major layout */
+    if ((bCm=CData_IsColmajor(_this)) && CData_SetColmajor(_this,FALSE)!=O_K)
+      return IERROR(_this,ERR_NOMEM,0,0,0);
     if(nCount>0)
     {
       nSize  = CData_GetRecLen(_this)*(CData_GetNRecs(_this)-nCount);
@@ -1383,6 +1393,8 @@ INT16 CGEN_PUBLIC CData_Shift(CData* _this, CData* iSrc, INT32 nCount)
       dlp_memmove(lpDest,lpSrc,nSize);
       memset(CData_XAddr(_this,CData_GetNRecs(_this)-nCount,0),0,CData_GetRecLen(_this)*nCount);
     }
+    if (bCm && CData_SetColmajor(_this,TRUE)!=O_K)
+      return IERROR(_this,ERR_NOMEM,0,0,0);
 
     DLP_CHECK_MEMINTEGRITY;
   }
@@ -1406,6 +1418,7 @@ INT16 CGEN_PUBLIC CData_Rotate(CData* _this, CData* iSrc, INT32 nCount)
   BYTE*  lpSrc  = NULL;
   BYTE*  lpDest = NULL;
   void*  lpTmp  = NULL;
+  BOOL   bCm    = FALSE;
 
   CHECK_THIS_RV(NOT_EXEC);
   if(!iSrc || nCount==0) return NOT_EXEC;
@@ -1416,10 +1429,13 @@ INT16 CGEN_PUBLIC CData_Rotate(CData* _this, CData* iSrc, INT32 nCount)
   /* shift mode */
   if(_this->m_bRec)
   {
+    /* Rotate whole records in row-major layout */
+    if ((bCm=CData_IsColmajor(_this)) && CData_SetColmajor(_this,FALSE)!=O_K)
+      return IERROR(_this,ERR_NOMEM,0,0,0);
     if(nCount>0)
     {
       lpTmp  = dlp_malloc(CData_GetRecLen(_this)*nCount);
-      if (!lpTmp) return IERROR(_this,ERR_NOMEM,0,0,0);
+      if (!lpTmp) { CData_SetColmajor(_this,bCm); return IERROR(_this,ERR_NOMEM,0,0,0); }
       lpSrc  = CData_XAddr(_this, CData_GetNRecs(_this)-nCount, 0);
       dlp_memmove(lpTmp, lpSrc, CData_GetRecLen(_this)*nCount);
       nSize  = CData_GetRecLen(_this)*(CData_GetNRecs(_this)-nCount);
@@ -1433,7 +1449,7 @@ INT16 CGEN_PUBLIC CData_Rotate(CData* _this, CData* iSrc, INT32 nCount)
     {
       nCount = -nCount;
       lpTmp  = dlp_malloc(CData_GetRecLen(_this)*nCount);
-      if (!lpTmp) return IERROR(_this,ERR_NOMEM,0,0,0);
+      if (!lpTmp) { CData_SetColmajor(_this,bCm); return IERROR(_this,ERR_NOMEM,0,0,0); }
       lpDest = CData_XAddr(_this, 0, 0);
       dlp_memmove(lpTmp, lpDest, CData_GetRecLen(_this)*nCount);
       nSize  = CData_GetRecLen(_this)*(CData_GetNRecs(_this)-nCount);
@@ -1443,6 +1459,8 @@ INT16 CGEN_PUBLIC CData_Rotate(CData* _this, CData* iSrc, INT32 nCount)
       dlp_memmove(lpDest, lpTmp, CData_GetRecLen(_this)*nCount);
       dlp_free(lpTmp);
     }
+    if (bCm && CData_SetColmajor(_this,TRUE)!=O_K)
+      return IERROR(_this,ERR_NOMEM,0,0,0);
     DLP_CHECK_MEMINTEGRITY;
   }
   else
@@ -47,7 +47,7 @@ INT16 CGEN_PROTECTED CData_Scalop_C(CData* _this, COMPLEX64 nConst, INT16 nOpcod
   /* Local variables */
   INT32 nR    = 0;                     /* Current record               */
   INT32 nXR   = 0;                     /* Number of records            */
-  INT32 nRl   = 0;                     /* Record length                */
+  INT32 nRl   = 0;                     /* Stride of component          */
   INT16 nType = T_IGNORE;              /* Component data type          */
   BYTE* lpC   = NULL;                  /* Pointer to current data cell */
 
@@ -63,7 +63,7 @@ INT16 CGEN_PROTECTED CData_Scalop_C(CData* _this, COMPLEX64 nConst, INT16 nOpcod
 
   /* Operate */
   nXR = CData_GetNRecs(_this);
-  nRl = CData_GetRecLen(_this);
+  nRl = CData_GetCompStride(_this,nComp);
   switch (nType)
   {
   case T_UCHAR  : __CSO(    UINT8); break;
@@ -1242,7 +1242,7 @@ INT16 CGEN_PRIVATE CData_ExpandComp
   /* do expand */
   lpFrom  = CData_XAddr(idSrc,0,nIcE);
   nRlnNew = CData_GetRecLen(_this);
-  nRln    = CData_GetRecLen(idSrc);
+  nRln    = CData_GetCompStride(idSrc,nIcE);
 
   for (i=0; i<nRecs; i++)
   {
@@ -1513,6 +1513,8 @@ int cf_strnum_down(const void* a, const void* b)
 INT16 CGEN_PUBLIC CData_SortInt(CData* _this, CData* iSrc, CData* iIdx, INT32 nComp, INT16 nMode)
 {
   BOOL bNumeric = _this->m_bNumeric;
+  BOOL bColmajor = FALSE;
+  INT16 nErr = O_K;
   int (*compfunc)(const void* a, const void* b) = NULL;
 
   CHECK_THIS_RV(NOT_EXEC);
@@ -1563,7 +1565,13 @@ INT16 CGEN_PUBLIC CData_SortInt(CData* _this, CData* iSrc, CData* iIdx, INT32 nC
     break;
   }
 
-  /* sort data using qsort (stdlib) */
+  /* sort data using qsort (stdlib), records must be contiguous */
+  bColmajor = CData_IsColmajor(_this);
+  if (bColmajor && CData_SetColmajor(_this,FALSE)!=O_K)
+  {
+    DESTROYVIRTUAL(iSrc,_this);
+    return IERROR(_this,ERR_NOMEM,0,0,0);
+  }
   dlpsort(_this->m_lpTable->m_theDataPointer,CData_GetNRecs(_this),CData_GetRecLen(_this),compfunc);
 
   /* remove index component */
@@ -1573,11 +1581,12 @@ INT16 CGEN_PUBLIC CData_SortInt(CData* _this, CData* iSrc, CData* iIdx, INT32 nC
     CData_Delete(_this,_this,1,1);
   }
   CData_Delete(_this,_this,0,1);
+  if (bColmajor && CData_SetColmajor(_this,TRUE)!=O_K) nErr=IERROR(_this,ERR_NOMEM,0,0,0);
 
   /* Cleanup */
   DESTROYVIRTUAL(iSrc,_this);
 
-  return O_K;
+  return nErr;
 }
 
 INT32 CGEN_PRIVATE CData_ChecksumInt(CData* _this, char *sAlgo, INT32 nIc)
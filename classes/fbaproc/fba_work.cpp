@@ -62,6 +62,11 @@ INT16 CGEN_PUBLIC CFBAproc::Analyze(data *idSignal, data *idPitch, data *idReal,
     IERROR(this,FBA_BADPITCH,idPitch->m_lpInstanceName,0,0);
     return NOT_EXEC;
   }
+  // Feature vectors are written record by record
+  if (CData_Rowmajor(idReal) != O_K || CData_Rowmajor(idImag) != O_K) {
+    IERROR(this,ERR_NOMEM,0,0,0);
+    return NOT_EXEC;
+  }
 
   InitBuffers();
 
@@ -995,6 +995,21 @@ INT16 CDlpFile::LibsndfileExport(const char* sFilename, CDlpObject* iSrc, const
 	return CDlpFile_LibsndfileExport(this, sFilename, iSrc, sFiletype);
 }
 
+CFILE_SNDSTREAM* CDlpFile::Snd_Init(const char* sFilename, INT32 nChannel)
+{
+	return CDlpFile_Snd_Init(this, sFilename, nChannel);
+}
+
+INT32 CDlpFile::Snd_Read(CFILE_SNDSTREAM* lpSS, FLOAT32* lpBuf, INT32 nSamples)
+{
+	return CDlpFile_Snd_Read(lpSS, lpBuf, nSamples);
+}
+
+void CDlpFile::Snd_Done(CFILE_SNDSTREAM* lpSS)
+{
+	CDlpFile_Snd_Done(lpSS);
+}
+
 INT16 CDlpFile::ImportPhDToData(const char* sFilename, CDlpObject* iDest, const char* sFiletype)
 {
 	return CDlpFile_ImportPhDToData(this, sFilename, iDest, sFiletype);
@@ -61,9 +61,202 @@ typedef struct PMARKEN
 static INT16 get_nextUInt16(FILE* lpFile,UINT16 *lpBuf16,INT16 bInit,INT16 nMode);
 char* file_strtok(char *strToken, const char *strDelimit);
 
+/* Static helpers of the ASCII import */
+#define FILE_ASCII_BUFLEN 0x100000                                              /* Initial size of read buffer       */
+#define FILE_ASCII_MINREC 1024                                                  /* Initial record capacity           */
+
+/**
+ * Column descriptor of the ASCII import. Holds everything needed to write a
+ * cell straight into the record buffer of the destination table.
+ */
+typedef struct tag_FILE_ASCII_COL
+{
+  INT32 nOfs;                                                                   /* Byte offset in record             */
+  INT16 nType;                                                                  /* Component type code               */
+  BOOL  bSym;                                                                   /* Symbolic component                */
+  BOOL  bFlt;                                                                   /* Floating point component          */
+  INT32 nSLen;                                                                  /* Longest string read (symbolic)    */
+} FILE_ASCII_COL;
+
+/**
+ * Fast scanner for plain decimal numbers (<code>[+-]ddd[.ddd][e[+-]ddd]</code>)
+ * used by the ASCII import. The function accepts only numbers which can be
+ * converted exactly (at most 15 significant digits and a decimal exponent not
+ * exceeding 22), so the result is identical to the one of <code>strtod</code>.
+ * Everything else (complex numbers, <code>nan</code>, <code>inf</code>, hex
+ * numbers, long mantissas, ...) is left to {@link dlp_sscanc}.
+ *
+ * @param lpsStr
+ *          The (zero-terminated) token to scan
+ * @param cDec
+ *          Additional decimal point character (e.g. <code>','</code>), 0 for
+ *          none
+ * @param lpnDst
+ *          Pointer to a buffer to be filled with the result
+ * @return <code>O_K</code> if the token was scanned completely,
+ *         <code>NOT_EXEC</code> otherwise
+ */
+static INT16 file_ascii_scand(const char* lpsStr, char cDec, FLOAT64* lpnDst)
+{
+  static const FLOAT64 lpP10[23] =
+  {
+    1E0 ,1E1 ,1E2 ,1E3 ,1E4 ,1E5 ,1E6 ,1E7 ,1E8 ,1E9 ,1E10,1E11,
+    1E12,1E13,1E14,1E15,1E16,1E17,1E18,1E19,1E20,1E21,1E22
+  };
+  const char* tx    = lpsStr;                                                   /* Current character                 */
+  UINT64      nMan  = 0;                                                        /* Mantissa                          */
+  INT32       nSig  = 0;                                                        /* Number of significant digits      */
+  INT32       nDig  = 0;                                                        /* Number of digits in mantissa      */
+  INT32       nExp  = 0;                                                        /* Decimal exponent                  */
+  INT32       nXe   = 0;                                                        /* Explicit exponent                 */
+  BOOL        bNeg  = FALSE;                                                    /* Negative number                   */
+  BOOL        bXneg = FALSE;                                                    /* Negative explicit exponent        */
+  BOOL        bDec  = FALSE;                                                    /* Decimal point seen                */
+
+  while (*tx==' ' || *tx=='\t') tx++;                                           /* Skip leading white spaces         */
+  if      (*tx=='-') { bNeg=TRUE; tx++; }                                       /* Sign                              */
+  else if (*tx=='+') tx++;                                                      /* |                                 */
+  for (;;tx++)                                                                  /* Scan mantissa >>                  */
+  {                                                                             /* |                                 */
+    if (*tx>='0' && *tx<='9')                                                   /*   Digit                           */
+    {                                                                           /*   >>                              */
+      nDig++;                                                                   /*     Count digits                  */
+      if (nSig==0 && *tx=='0') { if (bDec) nExp--; continue; }                  /*     Leading zero                  */
+      if (++nSig>15) return NOT_EXEC;                                           /*     Too long for exact conversion */
+      nMan = nMan*10 + (UINT64)(*tx-'0');                                       /*     Accumulate                    */
+      if (bDec) nExp--;                                                         /*     Fractional digit              */
+    }                                                                           /*   <<                              */
+    else if (!bDec && (*tx=='.' || (cDec && *tx==cDec))) bDec=TRUE;             /*   Decimal point                   */
+    else break;                                                                 /*   Something else                  */
+  }                                                                             /* <<                                */
+  if (nDig==0) return NOT_EXEC;                                                 /* No digits at all                  */
+  if (*tx=='e' || *tx=='E')                                                     /* Explicit exponent >>              */
+  {                                                                             /* |                                 */
+    tx++;                                                                       /*   Skip 'e'                        */
+    if      (*tx=='-') { bXneg=TRUE; tx++; }                                    /*   Sign                            */
+    else if (*tx=='+') tx++;                                                    /*   |                               */
+    if (*tx<'0' || *tx>'9') return NOT_EXEC;                                    /*   Need at least one digit         */
+    for (; *tx>='0' && *tx<='9'; tx++)                                          /*   Scan exponent                   */
+      if ((nXe = nXe*10 + (*tx-'0'))>9999) return NOT_EXEC;                     /*     Way out of range              */
+    nExp += bXneg ? -nXe : nXe;                                                 /*   Add to decimal exponent         */
+  }                                                                             /* <<                                */
+  if (*tx!='\0') return NOT_EXEC;                                               /* Trailing garbage                  */
+
+  if (nMan==0) *lpnDst = 0.;                                                    /* Zero                              */
+  else if (nExp<-22 || nExp>22) return NOT_EXEC;                                /* No exact conversion               */
+  else if (nExp<0) *lpnDst = (FLOAT64)nMan/lpP10[-nExp];                        /* Negative exponent                 */
+  else             *lpnDst = (FLOAT64)nMan*lpP10[nExp];                         /* Non-negative exponent             */
+  if (bNeg) *lpnDst = -*lpnDst;                                                 /* Apply sign                        */
+  return O_K;                                                                   /* Ok                                */
+}
+
+/**
+ * Gets the next token from a line of an ASCII file. In contrast to
+ * <code>strtok</code> and {@link file_strtok} the function keeps no static
+ * state.
+ *
+ * @param lplpsPos
+ *          Pointer to the current position in the line, will be advanced
+ * @param lpDlm
+ *          Delimiter table (256 entries, non-zero for delimiter characters)
+ * @param bEmptyCells
+ *          If <code>TRUE</code>, every delimiter separates a cell (like
+ *          {@link file_strtok}), otherwise sequences of delimiters are skipped
+ *          (like <code>strtok</code>)
+ * @return A pointer to the (zero-terminated) token or <code>NULL</code> if
+ *         there are no more tokens
+ */
+static char* file_ascii_nexttok(char** lplpsPos, const BYTE* lpDlm, BOOL bEmptyCells)
+{
+  char* tx = *lplpsPos;
+  char* lpsTok;
+
+  if (!bEmptyCells) while (*tx && lpDlm[(BYTE)*tx]) tx++;                       /* Skip leading delimiters           */
+  if (!*tx) { *lplpsPos=tx; return NULL; }                                      /* No (more) tokens                  */
+  for (lpsTok=tx; *tx && !lpDlm[(BYTE)*tx]; tx++) {}                            /* Find end of token                 */
+  if (*tx) *tx++='\0';                                                          /* Terminate token                   */
+  *lplpsPos = tx;                                                               /* Continue after delimiter          */
+  return lpsTok;                                                                /* Return token                      */
+}
+
+/**
+ * Determines if a line of an ASCII file is to be imported, i.e. it is not
+ * empty, not a comment and matches the line filter.
+ */
+static BOOL file_ascii_isdataline(CDlpFile* _this, const char* lpsLine)
+{
+  const char* tx;
+
+  if (_this->m_lpsComment[0] && strstr(lpsLine,_this->m_lpsComment)==lpsLine)
+    return FALSE;
+  if (_this->m_lpsLineFlt[0] && strstr(lpsLine,_this->m_lpsLineFlt)!=lpsLine)
+    return FALSE;
+  for (tx=lpsLine; *tx && iswspace(*tx); tx++) {}
+  return *tx ? TRUE : FALSE;
+}
+
+/**
+ * Creates the components of the destination table from the first data line
+ * of an ASCII file.
+ */
+static INT16 file_ascii_scancomps
+(
+  CDlpFile*   _this,
+  CData*      dDest,
+  const char* lpsLine,
+  const BYTE* lpDlm,
+  BOOL        bEmptyCells
+)
+{
+  char*     lpsBuf = NULL;
+  char*     lpsPos = NULL;
+  char*     lpCol  = NULL;
+  COMPLEX64 nBuf   = CMPLX(0.0);
+  INT32     nNCtr  = 0;
+  INT32     nDCtr  = 0;
+  INT32     nSCtr  = 0;
+  char      lpsName[L_NAMES];
+
+  lpsBuf = (char*)dlp_malloc((dlp_strlen(lpsLine)+1)*sizeof(char));
+  if (!lpsBuf) return IERROR(_this,ERR_NOMEM,0,0,0);
+  dlp_strcpy(lpsBuf,lpsLine);
+  dlp_strtrimleft(lpsBuf);
+  dlp_strtrimright(lpsBuf);
+
+  for (lpsPos=lpsBuf; (lpCol=file_ascii_nexttok(&lpsPos,lpDlm,bEmptyCells))!=NULL; )
+  {
+    if (!_this->m_bStrings && dlp_sscanc(lpCol,&nBuf)==O_K)
+    {
+      if (strstr(lpCol,".") || strstr(lpCol,","))
+      {
+        sprintf(lpsName,"d%03d",(int)(++nDCtr));
+        CData_AddComp(dDest,lpsName,(nBuf.y==0)?T_DOUBLE:T_COMPLEX);
+      }
+      else
+      {
+        sprintf(lpsName,"n%03d",(int)(++nNCtr));
+        CData_AddComp(dDest,lpsName,T_LONG);
+      }
+    }
+    else
+    {
+      sprintf(lpsName,"s%03d",(int)(++nSCtr));
+      CData_AddComp(dDest,lpsName,255);
+    }
+  }
+
+  dlp_free(lpsBuf);
+  return O_K;
+}
+
 /**
  * Import of ASCII files.
  *
+ * <p>The file is read in a single pass through a large buffer. Cells are
+ * scanned by {@link file_ascii_scand} (falling back to {@link dlp_sscanc} for
+ * anything but plain decimal numbers) and written directly into the record
+ * buffer of the destination table. The table grows geometrically.</p>
+ *
  * @param sFilename    Name of file to import.
  * @param iDest        Instance where to save imported data.
  * @param sFiletype    Type of file to import.
@@ -77,210 +270,223 @@ INT16 CGEN_PROTECTED CDlpFile_ImportAsciiToData
   const char* sFiletype
 )
 {
-  INT16     bSCAN       = FALSE;
-  INT16     bEmptyCells = FALSE;                                                /* Watch EVERY delimiter (e.g. CSV)  */
-  INT16     nRetV       = 0;
-  INT32     i           = 0;
-  INT32     j           = 0;
-  INT32     nLines      = 0;
-  INT32     nComps      = 0;
-  INT32     nLRead      = 0;
-  INT32     nMaxL       = L_INPUTLINE;
-  COMPLEX64 nBuf        = CMPLX(0.0);
-  UINT32*   lpSLen      = NULL;
-  FILE*     lpFile      = NULL;
-  CData*    dDest       = NULL;
-  CData*    dVirt1      = NULL;
-  CData*    dVirt2      = NULL;
-  char*     lpCol       = NULL;
-  char*     tx          = NULL;
-  char*     lpLine      = NULL;
-  char      lpBuf[L_INPUTLINE];
-  char      sSep[10];
+  BOOL            bSCAN       = FALSE;
+  BOOL            bEmptyCells = FALSE;                                          /* Watch EVERY delimiter (e.g. CSV)  */
+  BOOL            bEOF        = FALSE;
+  BOOL            bStop       = FALSE;
+  INT32           i           = 0;
+  INT32           j           = 0;
+  INT32           nComps      = 0;
+  INT32           nLRead      = 0;
+  INT32           nMaxRecs    = 0;
+  INT32           nMaxRead    = -1;
+  INT32           nReclen     = 0;
+  size_t          nBufLen     = FILE_ASCII_BUFLEN;
+  INT64           nFileLen    = 0;
+  INT64           nEst        = 0;
+  size_t          nFill       = 0;
+  size_t          nSLen       = 0;
+  FLOAT64         nVal        = 0.;
+  COMPLEX64       nBuf        = CMPLX(0.0);
+  FILE_ASCII_COL* lpCols      = NULL;
+  FILE*           lpFile      = NULL;
+  CData*          dDest       = NULL;
+  CData*          dVirt1      = NULL;
+  BYTE*           lpRec       = NULL;
+  char*           lpBuf       = NULL;
+  char*           lpNewBuf    = NULL;
+  char*           lpLine      = NULL;
+  char*           lpEol       = NULL;
+  char*           lpsPos      = NULL;
+  char*           lpCol       = NULL;
+  char*           tx          = NULL;
+  BYTE            lpDlm[256];
 
   /* get pointer to derived instance */
   dDest = AS(CData,iDest);
   DLPASSERT(dDest);
 
   /* open file */
-  lpFile = fopen(sFilename,"rt");
+  lpFile = fopen(sFilename,"rb");
   if (!lpFile) return IERROR(_this,ERR_FILEOPEN,sFilename,"reading",0);
-
-  /* initial line buffer */
-  lpLine = (char*)dlp_calloc(L_INPUTLINE+1, sizeof(char));
-
-  /* Determine number of lines and size of line buffer */
-  nLines=0;j=0;
-  while (fgets(lpLine,L_INPUTLINE+1,lpFile)!= NULL && !ferror(lpFile))
-  {
-    i=dlp_strlen(lpLine);
-    j+=i;
-    if ((i>0 && (lpLine[i-1]=='\n' || lpLine[i-1]=='\r')) || feof(lpFile))
-    {
-      if (j>nMaxL) nMaxL=j+1;
-      nLines++;
-      j=0;
-    }
-  }
-
-  /* resize line buffer if necessary */
-  if(nMaxL>L_INPUTLINE)
-    lpLine = (char*)dlp_realloc(lpLine,nMaxL+1,sizeof(char));
+  if (fseek(lpFile,0,SEEK_END)==0) nFileLen = (INT64)ftell(lpFile);
+  fseek(lpFile,0,SEEK_SET);
 
   /* determine field separator from file type */
-  if      (strcmp(sFiletype,"csv"   )==0) { bEmptyCells=TRUE; strcpy(sSep,","); }
-  else if (strcmp(sFiletype,"csv_de")==0) { bEmptyCells=TRUE; strcpy(sSep,";"); }
-  else strcpy(sSep,_this->m_lpsSep);
+  dlp_memset(lpDlm,0,256);
+  if      (strcmp(sFiletype,"csv"   )==0) { bEmptyCells=TRUE; lpDlm[(BYTE)',']=1; }
+  else if (strcmp(sFiletype,"csv_de")==0) { bEmptyCells=TRUE; lpDlm[(BYTE)';']=1; }
+  else for (tx=_this->m_lpsSep; *tx; tx++) lpDlm[(BYTE)*tx]=1;
 
-  /* /////////////////////////////////////////////////////////////////////////////// */
-  /* if no components defined determine number and type of columns in file to import */
-  /* /////////////////////////////////////////////////////////////////////////////// */
+  /* initial read buffer */
+  lpBuf = (char*)dlp_malloc((nBufLen+1)*sizeof(char));
+  if (!lpBuf) { fclose(lpFile); return IERROR(_this,ERR_NOMEM,0,0,0); }
 
-  if(CData_GetNComps(dDest) == 0)
-  {
-    char* lpCol  = NULL;
-    INT32  nNCtr  = 0;
-    INT32  nDCtr  = 0;
-    INT32  nSCtr  = 0;
-    bSCAN = TRUE;
+  bSCAN  = (CData_GetNComps(dDest)==0);
+  nComps = CData_GetNComps(dDest);
+  if (!bSCAN && CData_GetNRecs(dDest)>0) nMaxRead = CData_GetNRecs(dDest);     /* Read as many lines as records     */
 
-    fseek(lpFile,0,SEEK_SET);
+  /* ////////////////////////// */
+  /* read file                  */
+  /* ////////////////////////// */
 
-    /* read first line that is not a comment */
-    do
+  for (nFill=0; (!bEOF || nFill>0) && !bStop; )
+  {
+    /* refill buffer (grow it if a single line does not fit) */
+    if (!bEOF)
     {
-      if(NULL == fgets(lpLine,nMaxL,lpFile)) break;
-      dlp_strtrimleft(lpLine);
-      dlp_strtrimright(lpLine);
+      if (nFill==nBufLen)
+      {
+        lpNewBuf = (char*)dlp_realloc(lpBuf,2*nBufLen+1,sizeof(char));
+        if (!lpNewBuf)
+        {
+          IERROR(_this,ERR_NOMEM,0,0,0);
+          bStop = TRUE;
+          break;
+        }
+        lpBuf    = lpNewBuf;
+        nBufLen *= 2;
+      }
+      nFill += fread(lpBuf+nFill,sizeof(char),nBufLen-nFill,lpFile);
+      if (nFill<nBufLen) bEOF = TRUE;
     }
-    while
-    (
-      !dlp_strlen(lpLine) ||
-      (dlp_strlen(_this->m_lpsComment) && (lpLine == strstr(lpLine,_this->m_lpsComment))) ||
-      (dlp_strlen(_this->m_lpsLineFlt) && (lpLine != strstr(lpLine,_this->m_lpsLineFlt)))
-    );
-
-    /* scan columns and create components in target instance */
-    lpCol = bEmptyCells ? file_strtok(lpLine,sSep) : strtok(lpLine,sSep);
+    lpBuf[nFill] = '\0';
 
-    for(i=0; lpCol != NULL; i++)
+    /* process all complete lines in buffer (and the rest at end of file) */
+    for (lpLine=lpBuf; lpLine<lpBuf+nFill; lpLine=lpEol+1)
     {
-      /* try to read field as double */
-      if (!_this->m_bStrings && dlp_sscanc(lpCol,&nBuf)==O_K)
+      lpEol = (char*)memchr(lpLine,'\n',lpBuf+nFill-lpLine);
+      if (!lpEol)
       {
-        if (strstr(lpCol,".") || strstr(lpCol,","))
+        if (!bEOF) break;
+        lpEol = lpBuf+nFill;
+      }
+      *lpEol = '\0';
+
+      /* trim trailing line break */
+      for (tx=lpEol-1; tx>=lpLine && *tx=='\r'; tx--) *tx='\0';
+
+      /* skip comments, lines not matching the line filter and empty lines */
+      if (!file_ascii_isdataline(_this,lpLine)) continue;
+
+      /* if no components defined determine number and type of columns from first line */
+      if (bSCAN && !lpCols)
+      {
+        if (file_ascii_scancomps(_this,dDest,lpLine,lpDlm,bEmptyCells)!=O_K)
         {
-          sprintf(lpBuf,"d%03d",(int)(++nDCtr));
-          CData_AddComp(dDest,lpBuf,(nBuf.y==0)?T_DOUBLE:T_COMPLEX);
+          bStop = TRUE;
+          break;
         }
-        else
+        nComps = CData_GetNComps(dDest);
+      }
+
+      /* prepare column descriptors and allocate first records (records are
+         written as a whole, so the destination must be row-major) */
+      if (!lpCols)
+      {
+        if (CData_Rowmajor(dDest)!=O_K)
+        {
+          IERROR(_this,ERR_NOMEM,0,0,0);
+          bStop = TRUE;
+          break;
+        }
+        if (nComps>0) lpCols = (FILE_ASCII_COL*)dlp_calloc(nComps,sizeof(FILE_ASCII_COL));
+        if (!lpCols)
         {
-          sprintf(lpBuf,"n%03d",(int)(++nNCtr));
-          CData_AddComp(dDest,lpBuf,T_LONG);
+          bStop = TRUE;
+          break;
         }
+        for (j=0; j<nComps; j++)
+        {
+          lpCols[j].nOfs  = CData_GetCompOffset(dDest,j);
+          lpCols[j].nType = CData_GetCompType(dDest,j);
+          lpCols[j].bSym  = dlp_is_symbolic_type_code(lpCols[j].nType);
+          lpCols[j].bFlt  = dlp_is_float_type_code(lpCols[j].nType);
+        }
+        nReclen = CData_GetRecLen(dDest);
+        if (CData_GetNRecs(dDest)==0)
+        {
+          /* estimate number of records from line density in buffer */
+          for (tx=lpLine, nEst=0; tx<lpBuf+nFill; tx++)
+            if (!(tx=(char*)memchr(tx,'\n',lpBuf+nFill-tx))) break; else nEst++;
+          if (!bEOF && nEst>0 && nFileLen>0)
+            nEst = (INT64)((FLOAT64)nEst*(FLOAT64)nFileLen/(FLOAT64)(lpBuf+nFill-lpLine)*1.05);
+          nEst = MAX(nEst+1,FILE_ASCII_MINREC);
+          CData_Allocate(dDest,(INT32)MIN(nEst,T_INT_MAX));
+        }
+        nMaxRecs = CData_GetMaxRecs(dDest);
+        CData_SetNRecs(dDest,nMaxRecs);
       }
-      else if(sscanf(lpCol,"%s",lpBuf))
+
+      /* stop if all preallocated records are filled */
+      if (nLRead==nMaxRead)
       {
-        sprintf(lpBuf,"s%03d",(int)(++nSCtr));
-        CData_AddComp(dDest,lpBuf,255);
+        bStop = TRUE;
+        break;
       }
-      else
+
+      /* geometric growth of destination table */
+      if (nLRead>=nMaxRecs)
       {
-        fclose(lpFile);
-        return IERROR(_this,FIL_PROCESS,"reading",sFilename,0);
+        if (CData_Realloc(dDest,nMaxRecs>0?(INT32)MIN(2*(INT64)nMaxRecs,T_INT_MAX):FILE_ASCII_MINREC)!=O_K)
+        {
+          IERROR(_this,ERR_NOMEM,0,0,0);
+          bStop = TRUE;
+          break;
+        }
+        dlp_memset(CData_XAddr(dDest,nMaxRecs,0),0,
+          (size_t)(CData_GetMaxRecs(dDest)-nMaxRecs)*(size_t)nReclen);
+        nMaxRecs = CData_GetMaxRecs(dDest);
+        CData_SetNRecs(dDest,nMaxRecs);
       }
+      lpRec = CData_XAddr(dDest,nLRead,0);
 
-      lpCol = bEmptyCells ? file_strtok(NULL,sSep) : strtok(NULL,sSep);
-    }
-  }
-
-
-  /* ////////////////////////////////////////////////////////// */
-  /* if no records allocated determine number of needed records */
-  /* ////////////////////////////////////////////////////////// */
-
-  if(CData_GetNRecs(dDest) == 0)
-  {
-    CData_Allocate(dDest,nLines);
-  }
-
-  fseek(lpFile,0,SEEK_SET);
-
-  nComps = CData_GetNComps(dDest);
-  lpSLen = (UINT32*)dlp_calloc(nComps,sizeof(UINT32));  /* array for maximal string length in column */
-
-
-  /* ////////////////////////// */
-  /* read file                  */
-  /* ////////////////////////// */
-
-  for(nLRead=0; !feof(lpFile); )
-  {
-    /* get next line */
-    if(NULL == fgets(lpLine,nMaxL,lpFile)) break;
-
-    /* trim trailing line break */
-    if (dlp_strlen(lpLine))
-    {
-      tx = &lpLine[dlp_strlen(lpLine)-1];
-      while (tx>lpLine && (*tx=='\n'||*tx=='\r')) {*tx=0;tx--;}
-    }
-
-    /* skip comments */
-    if(dlp_strlen(_this->m_lpsComment) && (lpLine == strstr(lpLine,_this->m_lpsComment))) continue;
-
-    /* skip lines not starting with line filter string */
-    if(dlp_strlen(_this->m_lpsLineFlt) && (lpLine != strstr(lpLine,_this->m_lpsLineFlt))) continue;
-
-    /* skip empty lines */
-    if(!dlp_strlen(lpLine)) continue;
-    for (tx=lpLine; *tx && iswspace(*tx); tx++) ;
-    if (!*tx) continue;
-
-    /* parse line */
-    lpCol = bEmptyCells ? file_strtok(lpLine,sSep) : strtok(lpLine,sSep);
-    for(j=0; j<nComps; j++)
-    {
-      /* skip not existing columns in line */
-      /* if(bEOL) continue; */
-
-      if (!lpCol) break;
-
-      if (dlp_is_symbolic_type_code(CData_GetCompType(dDest,j)) == TRUE )
+      /* parse line */
+      for (j=0, lpsPos=lpLine; j<nComps; j++)
       {
-        nRetV = sscanf(lpCol,"%s",lpBuf);
-        if(nRetV != EOF)
+        if (!(lpCol=file_ascii_nexttok(&lpsPos,lpDlm,bEmptyCells))) break;
+
+        if (lpCols[j].bSym)
         {
-          /* Store empty string if sscanf did not succeed */
-          dlp_strcpy(lpBuf,lpCol);
-          if(dlp_strlen(lpBuf)>255)
+          if (!*lpCol) continue;
+          nSLen = dlp_strlen(lpCol);
+          if (nSLen>255)
           {
             IERROR(_this,FIL_FORMAT,sFilename,"ascii",
               "symbolic types can hold max 255 characters.");
-            lpBuf[255]=0;
+            nSLen = 255;
           }
-          CData_Sstore(dDest, lpBuf, nLRead, j);
+          if ((INT32)nSLen>lpCols[j].nSLen) lpCols[j].nSLen = (INT32)nSLen;
+          if ((INT32)nSLen>lpCols[j].nType-1) nSLen = lpCols[j].nType-1;
+          dlp_memmove(lpRec+lpCols[j].nOfs,lpCol,nSLen);
+          dlp_memset(lpRec+lpCols[j].nOfs+nSLen,0,lpCols[j].nType-nSLen);
         }
-
-        /* remember longest string in column */
-        if(dlp_strlen(lpBuf) > lpSLen[j]) lpSLen[j] = dlp_strlen(lpBuf);
-      }
-      else
-      {
-        if (dlp_is_float_type_code(CData_GetCompType(dDest,j)))
-          dlp_strreplace(lpCol,",",".");
-
-        if(strlen(lpCol) > 0)
+        else if (*lpCol)
         {
-          nRetV = dlp_sscanc(lpCol,&nBuf);
-          /* Store 0 if sscanf did not succeed */
-          if(nRetV != O_K) nBuf = CMPLX(0);
-          CData_Cstore (dDest, nBuf, nLRead, j);
+          if (file_ascii_scand(lpCol,lpCols[j].bFlt?',':0,&nVal)==O_K)
+          {
+            if (lpCols[j].nType==T_DOUBLE) *(FLOAT64*)(lpRec+lpCols[j].nOfs) = nVal;
+            else dlp_store(CMPLX(nVal),lpRec+lpCols[j].nOfs,lpCols[j].nType);
+          }
+          else
+          {
+            if (lpCols[j].bFlt) dlp_strreplace(lpCol,",",".");
+            /* Store 0 if scanning did not succeed */
+            if (dlp_sscanc(lpCol,&nBuf)!=O_K) nBuf = CMPLX(0);
+            dlp_store(nBuf,lpRec+lpCols[j].nOfs,lpCols[j].nType);
+          }
         }
       }
-      lpCol = bEmptyCells ? file_strtok(NULL,sSep) : strtok(NULL,sSep);
+      nLRead++;
     }
-    nLRead++;
+
+    /* move incomplete last line to beginning of buffer */
+    if (lpLine<lpBuf+nFill)
+    {
+      nFill -= lpLine-lpBuf;
+      dlp_memmove(lpBuf,lpLine,nFill);
+    }
+    else nFill = 0;
   }
   CData_SetNRecs(dDest,nLRead);
   CData_Realloc(dDest,nLRead);
@@ -290,67 +496,64 @@ INT16 CGEN_PROTECTED CDlpFile_ImportAsciiToData
 
   /* Close file */
   fclose(lpFile);
+  dlp_free(lpBuf);
 
-  if(bSCAN)
+  if(bSCAN && lpCols)
   {
     /* ////////////////////////// */
     /* shrink symbolic components */
     /* ////////////////////////// */
 
     ICREATEEX(CData,dVirt1,"~vitual1",NULL);
-    ICREATEEX(CData,dVirt2,"~vitual2",NULL);
 
+    /* create target structure (drop symbolic components without contents) */
     for(i=0;i<nComps;i++)
     {
-      if(dlp_is_symbolic_type_code(CData_GetCompType(dDest,i)))
+      if(lpCols[i].bSym)
       {
-        INT16 nSLen      = 0;
-        INT32  nReclnFrom = 0;
-        INT32  nReclnTo   = 0;
-        INT32  nComp      = 0;
-        BYTE* lpFrom     = NULL;
-        BYTE* lpTo       = NULL;
-
-        if(lpSLen[i] <= 0)  continue;
-        if(lpSLen[i] > 250) nSLen = 255; /* 250           */
-        else nSLen = (INT16)lpSLen[i]+5; /*     + 5 = 255 */
-
-        CData_AddComp(dVirt2,CData_GetCname(dDest,i),nSLen);
-
-        nComp = CData_GetNComps(dVirt2);
-        if(nComp==1) CData_Allocate(dVirt2,nLRead);
-
-        lpTo       = CData_XAddr(dVirt2,0,nComp-1);
-        lpFrom     = CData_XAddr(dDest,0,i);
-        nReclnTo   = CData_GetRecLen(dVirt2);
-        nReclnFrom = CData_GetRecLen(dDest);
-
-        DLPASSERT(lpTo);
-        DLPASSERT(lpFrom);
-
-        for(j=0; j<nLRead; j++)
-        {
-          dlp_memmove(lpTo,lpFrom,nSLen*sizeof(char));
-          lpFrom += nReclnFrom;
-          lpTo   += nReclnTo;
-        }
+        if(lpCols[i].nSLen <= 0)  continue;
+        if(lpCols[i].nSLen > 250) lpCols[i].nSLen = 255; /* 250           */
+        else lpCols[i].nSLen += 5;                       /*     + 5 = 255 */
+        CData_AddComp(dVirt1,CData_GetCname(dDest,i),(INT16)lpCols[i].nSLen);
       }
       else
       {
-        CData_SelectComps(dVirt1,dDest,i,1);
-        CData_Join(dVirt2,dVirt1);
+        lpCols[i].nSLen = CData_GetCompSize(dDest,i);
+        CData_AddComp(dVirt1,CData_GetCname(dDest,i),lpCols[i].nType);
+      }
+    }
+    CData_Allocate(dVirt1,nLRead);
+
+    /* copy column by column */
+    for(i=0,j=0;i<nComps;i++)
+    {
+      INT32 nReclnFrom = CData_GetCompStride(dDest,i);
+      INT32 nReclnTo   = CData_GetCompStride(dVirt1,j);
+      INT32 nR         = 0;
+      BYTE* lpFrom     = NULL;
+      BYTE* lpTo       = NULL;
+
+      if(lpCols[i].nSLen <= 0) continue;
+      lpTo   = CData_XAddr(dVirt1,0,j++);
+      lpFrom = CData_XAddr(dDest,0,i);
+      DLPASSERT(lpTo);
+      DLPASSERT(lpFrom);
+
+      for(nR=0; nR<nLRead; nR++)
+      {
+        dlp_memmove(lpTo,lpFrom,lpCols[i].nSLen*sizeof(char));
+        lpFrom += nReclnFrom;
+        lpTo   += nReclnTo;
       }
     }
 
     CData_Reset(BASEINST(dDest),TRUE);
-    CData_Copy(BASEINST(dDest),BASEINST(dVirt2));
+    CData_Copy(BASEINST(dDest),BASEINST(dVirt1));
 
     IDESTROY(dVirt1);
-    IDESTROY(dVirt2);
   }
 
-  dlp_free(lpSLen);
-  dlp_free(lpLine);
+  dlp_free(lpCols);
 
   DLP_CHECK_MEMINTEGRITY;
 
@@ -689,6 +892,241 @@ INT16 CGEN_PROTECTED CDlpFile_LibsndfileExport
 #endif /*__NOLIBSNDFILE */
 }
 
+/**
+ * <p>Opens a sound file for chunked reading. In contrast to
+ * {@link LibsndfileImport CDlpFile_LibsndfileImport} the file is not loaded
+ * completely. Samples of one channel are delivered by subsequent calls to
+ * {@link Snd_Read CDlpFile_Snd_Read}, converted to <code>FLOAT32</code> and
+ * normalized by the maximal value of the sample type in the file.</p>
+ *
+ * <p>Without libsndfile (<code>__NOLIBSNDFILE</code>) the file is imported
+ * completely by {@link ImportWaveToData CDlpFile_ImportWaveToData} and the
+ * samples are delivered from memory.</p>
+ *
+ * @param _this
+ *          Pointer to file instance (used for error reporting)
+ * @param sFilename
+ *          Name of sound file to open
+ * @param nChannel
+ *          Zero-based index of channel to read (ignored for single channel
+ *          files)
+ * @return A pointer to a sound stream data structure or <code>NULL</code> in
+ *         case of errors. The caller must free the stream by
+ *         {@link Snd_Done CDlpFile_Snd_Done}.
+ * @see Snd_Read CDlpFile_Snd_Read
+ * @see Snd_Done CDlpFile_Snd_Done
+ */
+CFILE_SNDSTREAM* CGEN_EXPORT CDlpFile_Snd_Init
+(
+  CDlpFile*   _this,
+  const char* sFilename,
+  INT32       nChannel
+)
+{
+#ifndef __NOLIBSNDFILE
+  CFILE_SNDSTREAM* lpSS    = NULL;
+  SNDFILE*         file    = NULL;
+  SF_INFO          sf_info = { 0, 0, 0, 0, 0, 0 };
+
+  /* Open sound file */
+  file = sf_open(sFilename, SFM_READ, &sf_info);
+  if (!file)
+  {
+    IERROR(_this,ERR_FILEOPEN,sFilename,"reading",0);
+    return NULL;
+  }
+  if (sf_info.channels==1) nChannel = 0;
+  if (nChannel<0 || nChannel>=sf_info.channels)
+  {
+    IERROR(_this,FIL_INVALARG,"channel index",0,0);
+    sf_close(file);
+    return NULL;
+  }
+
+  /* Initialize stream */
+  lpSS = (CFILE_SNDSTREAM*)dlp_calloc(1,sizeof(CFILE_SNDSTREAM));
+  if (!lpSS)
+  {
+    IERROR(_this,ERR_NOMEM,0,0,0);
+    sf_close(file);
+    return NULL;
+  }
+  lpSS->lpSndfile = file;
+  lpSS->nFrames   = (INT64)sf_info.frames;
+  lpSS->nChannels = sf_info.channels;
+  lpSS->nChannel  = nChannel;
+  lpSS->nSrate    = (FLOAT64)sf_info.samplerate;
+
+  /* Determine sample type and normalization (same as LibsndfileImport) */
+  switch(sf_info.format & SF_FORMAT_SUBMASK)
+  {
+    case SF_FORMAT_PCM_U8: lpSS->nType = T_UCHAR;  lpSS->nNorm = T_UCHAR_MAX; break;
+    case SF_FORMAT_PCM_S8: lpSS->nType = T_CHAR;   lpSS->nNorm = T_CHAR_MAX;  break;
+    case SF_FORMAT_PCM_16: lpSS->nType = T_SHORT;  lpSS->nNorm = T_SHORT_MAX; break;
+    case SF_FORMAT_PCM_24:
+    case SF_FORMAT_PCM_32: lpSS->nType = T_INT;    lpSS->nNorm = T_INT_MAX;   break;
+    case SF_FORMAT_FLOAT : lpSS->nType = T_FLOAT;  lpSS->nNorm = 1.f;         break;
+    case SF_FORMAT_DOUBLE: lpSS->nType = T_DOUBLE; lpSS->nNorm = 1.f;         break;
+    default:
+      IERROR(_this,FIL_FORMAT,sFilename,"wav",0);
+      CDlpFile_Snd_Done(lpSS);
+      return NULL;
+  }
+
+  return lpSS;
+#else /* __NOLIBSNDFILE */
+  CFILE_SNDSTREAM* lpSS  = NULL;
+  CData*           idSig = NULL;
+
+  /* Import sound file (single channel only, nChannel is ignored) */
+  ICREATEEX(CData,idSig,"~sndstream",NULL);
+  if (!idSig) { IERROR(_this,ERR_NOMEM,0,0,0); return NULL; }
+  if (CDlpFile_ImportWaveToData(_this,sFilename,BASEINST(idSig),"wav")!=O_K)
+  {
+    IDESTROY(idSig);
+    return NULL;
+  }
+
+  /* Initialize stream */
+  lpSS = (CFILE_SNDSTREAM*)dlp_calloc(1,sizeof(CFILE_SNDSTREAM));
+  if (!lpSS)
+  {
+    IERROR(_this,ERR_NOMEM,0,0,0);
+    IDESTROY(idSig);
+    return NULL;
+  }
+  lpSS->lpSndfile = idSig;
+  lpSS->nFrames   = CData_GetNRecs(idSig);
+  lpSS->nChannels = 1;
+  lpSS->nChannel  = 0;
+  lpSS->nSrate    = 1000./idSig->m_lpTable->m_fsr;
+  lpSS->nType     = CData_GetCompType(idSig,0);
+  lpSS->nNorm     = lpSS->nType==T_SHORT ? T_SHORT_MAX : 1.f;
+
+  return lpSS;
+#endif /* __NOLIBSNDFILE */
+}
+
+/**
+ * Reads the next samples of the selected channel from a sound stream. The
+ * samples are converted to <code>FLOAT32</code> and normalized.
+ *
+ * @param lpSS
+ *          Pointer to sound stream data structure (returned by
+ *          {@link Snd_Init CDlpFile_Snd_Init})
+ * @param lpBuf
+ *          Buffer to be filled with samples, must be capable of holding
+ *          <code>nSamples</code> values
+ * @param nSamples
+ *          Number of samples to read
+ * @return The number of samples read (less than <code>nSamples</code> at the
+ *         end of the file) or a negative value in case of errors
+ */
+INT32 CGEN_EXPORT CDlpFile_Snd_Read
+(
+  CFILE_SNDSTREAM* lpSS,
+  FLOAT32*         lpBuf,
+  INT32            nSamples
+)
+{
+#ifndef __NOLIBSNDFILE
+  SNDFILE* file     = NULL;
+  BYTE*    lpNewBuf = NULL;
+  INT64    nRead    = 0;
+  INT64    nI       = 0;
+  INT32    nC       = 0;
+
+  if (!lpSS || !lpBuf || nSamples<0) return NOT_EXEC;
+  file = (SNDFILE*)lpSS->lpSndfile;
+  if (nSamples>lpSS->nFrames-lpSS->nPos) nSamples = (INT32)(lpSS->nFrames-lpSS->nPos);
+  if (nSamples<=0) return 0;
+
+  /* (Re-)allocate raw read buffer */
+  if (nSamples>lpSS->nBufLen)
+  {
+    lpNewBuf = (BYTE*)__dlp_realloc(lpSS->lpBuf,(size_t)nSamples*lpSS->nChannels,
+      dlp_get_type_size(lpSS->nType),__FILE__,__LINE__,"CDlpFile_Snd_Read","");
+    if (!lpNewBuf) return NOT_EXEC;
+    lpSS->lpBuf   = lpNewBuf;
+    lpSS->nBufLen = nSamples;
+  }
+
+  /* Read interleaved frames */
+  switch (lpSS->nType)
+  {
+    case T_UCHAR :
+    case T_CHAR  : nRead = sf_read_raw    (file,(void*  )lpSS->lpBuf,(sf_count_t)nSamples*lpSS->nChannels)/lpSS->nChannels; break;
+    case T_SHORT : nRead = sf_readf_short (file,(short* )lpSS->lpBuf,nSamples); break;
+    case T_INT   : nRead = sf_readf_int   (file,(int*   )lpSS->lpBuf,nSamples); break;
+    case T_FLOAT : nRead = sf_readf_float (file,(float* )lpSS->lpBuf,nSamples); break;
+    case T_DOUBLE: nRead = sf_readf_double(file,(double*)lpSS->lpBuf,nSamples); break;
+    default      : return NOT_EXEC;
+  }
+  if (nRead<0) return NOT_EXEC;
+
+  /* Pick channel, convert and normalize */
+  nC = lpSS->nChannels;
+  for (nI=0; nI<nRead; nI++)
+  {
+    switch (lpSS->nType)
+    {
+      case T_UCHAR : lpBuf[nI] = (FLOAT32)((  UINT8*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+      case T_CHAR  : lpBuf[nI] = (FLOAT32)((   INT8*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+      case T_SHORT : lpBuf[nI] = (FLOAT32)((  INT16*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+      case T_INT   : lpBuf[nI] = (FLOAT32)((  INT32*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+      case T_FLOAT : lpBuf[nI] =          ((FLOAT32*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+      case T_DOUBLE: lpBuf[nI] = (FLOAT32)((FLOAT64*)lpSS->lpBuf)[nI*nC+lpSS->nChannel]; break;
+    }
+    if (lpSS->nNorm!=1.f) lpBuf[nI] /= lpSS->nNorm;
+  }
+
+  lpSS->nPos += nRead;
+  return (INT32)nRead;
+#else /* __NOLIBSNDFILE */
+  CData* idSig = NULL;
+  INT32  nI    = 0;
+
+  if (!lpSS || !lpBuf || nSamples<0) return NOT_EXEC;
+  idSig = (CData*)lpSS->lpSndfile;
+  if (nSamples>lpSS->nFrames-lpSS->nPos) nSamples = (INT32)(lpSS->nFrames-lpSS->nPos);
+  if (nSamples<=0) return 0;
+
+  /* Copy, convert and normalize */
+  for (nI=0; nI<nSamples; nI++)
+  {
+    lpBuf[nI] = (FLOAT32)CData_Dfetch(idSig,(INT32)lpSS->nPos+nI,0);
+    if (lpSS->nNorm!=1.f) lpBuf[nI] /= lpSS->nNorm;
+  }
+
+  lpSS->nPos += nSamples;
+  return nSamples;
+#endif /* __NOLIBSNDFILE */
+}
+
+/**
+ * Closes a sound stream and frees its data structure.
+ *
+ * @param lpSS
+ *          Pointer to sound stream data structure (returned by
+ *          {@link Snd_Init CDlpFile_Snd_Init}), may be <code>NULL</code>
+ * @see Snd_Init CDlpFile_Snd_Init
+ */
+void CGEN_EXPORT CDlpFile_Snd_Done(CFILE_SNDSTREAM* lpSS)
+{
+  if (!lpSS) return;
+#ifndef __NOLIBSNDFILE
+  if (lpSS->lpSndfile) sf_close((SNDFILE*)lpSS->lpSndfile);
+#else /* __NOLIBSNDFILE */
+  if (lpSS->lpSndfile)
+  {
+    CData* idSig = (CData*)lpSS->lpSndfile;
+    IDESTROY(idSig);
+  }
+#endif /* __NOLIBSNDFILE */
+  dlp_free(lpSS->lpBuf);
+  dlp_free(lpSS);
+}
+
 
 
 /**
@@ -1006,8 +1444,8 @@ INT16 CGEN_PROTECTED CDlpFile_ImportEspsLabToData
 
         lpTo       = CData_XAddr(dVirt2,0,nComp-1);
         lpFrom     = CData_XAddr(dDest,0,i);
-        nReclnTo   = CData_GetRecLen(dVirt2);
-        nReclnFrom = CData_GetRecLen(dDest);
+        nReclnTo   = CData_GetCompStride(dVirt2,nComp-1);
+        nReclnFrom = CData_GetCompStride(dDest,i);
 
         DLPASSERT(lpTo);
         DLPASSERT(lpFrom);
@@ -1210,7 +1648,7 @@ INT16 CGEN_PROTECTED CDlpFile_ImportPmToData
         einzel_PM.laenge = ( (einzel_PM.laenge << 8) & 0xff00 ) | ( (einzel_PM.laenge >> 8) & 0x00ff );
       if(CData_GetMaxRecs(dDest)<=i+1)
       {
-        CData_Realloc(dDest,CData_GetMaxRecs(dDest)+1000);
+        CData_Realloc(dDest,2*CData_GetMaxRecs(dDest));
         lpDest = (INT16*)CData_XAddr(dDest,i,0);
       }
       nExite = (INT16)einzel_PM.anregung;
@@ -1301,7 +1739,7 @@ INT16 CGEN_PROTECTED CDlpFile_ImportPmTxtToData
         laenge = ( (laenge << 8) & 0xff00 ) | ( (laenge >> 8) & 0x00ff );
       if(CData_GetMaxRecs(dDest)<=i+1)
       {
-        CData_Realloc(dDest,CData_GetMaxRecs(dDest)+1000);
+        CData_Realloc(dDest,2*CData_GetMaxRecs(dDest));
         lpDest = (INT16*)CData_XAddr(dDest,i,0);
       }
       *(lpDest++) = (INT16)laenge;
@@ -1799,6 +2237,7 @@ INT16 CGEN_PROTECTED CDlpFile_ImportRawToData
   dDest = AS(CData,iDest);
   DLPASSERT(dDest);
   if(CData_GetRecLen(dDest) <= 0)   return(NOT_EXEC);
+  if(CData_Rowmajor(dDest) != O_K)  return IERROR(_this,ERR_NOMEM,0,0,0);
 
   lpFile = fopen(sFilename,"rb");
   if (!lpFile) return IERROR(_this,ERR_FILEOPEN,sFilename,"reading",0);
@@ -2092,6 +2531,7 @@ INT16 CGEN_PROTECTED CDlpFile_ExportRawFromData
   DLPASSERT(dSrc);
   if(CData_GetRecLen(dSrc) <= 0)  return(NOT_EXEC);
   if(CData_GetNRecs(dSrc) <= 0)   return(NOT_EXEC);
+  if(CData_Rowmajor(dSrc) != O_K) return IERROR(_this,ERR_NOMEM,0,0,0);
 
   lpSrc = CData_XAddr(dSrc,0,0);
   if(lpSrc == NULL) return IERROR(_this,FIL_PROCESS,"writing",sFilename,0);
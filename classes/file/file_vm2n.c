@@ -224,6 +224,7 @@ INT16 CGEN_PROTECTED CDlpFile_ImportDataFromVm2Nist
     sprintf(sBuf,"ch%02ld",(long)n);
     CData_AddComp(idDest,sBuf,nSampleBytes==2?T_SHORT:T_CHAR);
   }
+  if (CData_Rowmajor(idDest)!=O_K     ) _F_ERROR(out of memory                  )
   CData_AllocateUninitialized(idDest,nSamples);
   CData_SetDescr(idDest,RINC,1000./(FLOAT64)nSampleRate);
 
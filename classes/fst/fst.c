@@ -185,6 +185,7 @@ INT16 CFst_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_OPTION("/fst","",LPMV(m_bFst),NULL,"Transducer",0)
 	REGISTER_OPTION("/fwd","",LPMV(m_bFwd),NULL,"Do forward algorithm instead of sdp",0)
 	REGISTER_OPTION("/greedy","/lmatch",LPMV(m_bGreedy),NULL,"Greedy match (use longest matching sequence).",0)
+	REGISTER_OPTION("/hopcroft","",LPMV(m_bHopcroft),NULL,"Minimization by partition refinement",0)
 	REGISTER_OPTION("/implicit","",LPMV(m_bImplicit),NULL,"Wire units implicitely",0)
 	REGISTER_OPTION("/index","",LPMV(m_bIndex),NULL,"Append or use index",0)
 	REGISTER_OPTION("/lazy","",LPMV(m_bLazy),NULL,"Lazy minimization",0)
@@ -205,6 +206,7 @@ INT16 CFst_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_OPTION("/usemap","",LPMV(m_bUsemap),NULL,"Use MAP approximation",0)
 
 	/* Register fields */
+	REGISTER_FIELD("adj","",LPMV(m_idAdj),NULL,"Internal use: Adjacency index (see FSTI_ADJ iterators)",FF_HIDDEN | FF_NOSET,6002,1,"data",NULL)
 	REGISTER_FIELD("climit","",LPMV(m_nClimit),NULL,"Limit of cycle passes when traversing graphs",0,2004,1,"int",(INT32)1)
 	REGISTER_FIELD("cps_hash","",LPMV(m_lpCpsHash),NULL,"Composition: Composed state hash map",FF_HIDDEN | FF_NOSET | FF_NOSAVE | FF_NONAUTOMATIC,6000,1,"void*",NULL)
 	REGISTER_FIELD("cps_hnpool","",LPMV(m_lpCpsHnpool),NULL,"Composition: Hash node pool table",FF_HIDDEN | FF_NOSET | FF_NOSAVE | FF_NONAUTOMATIC,6000,1,"void**",NULL)
@@ -320,14 +322,21 @@ INT16 CFst_Reset(CDlpObject* __this, BOOL bResetMembers)
   IFIELD_RESET(CData,"td");
   IFIELD_RESET(CData,"is");
   IFIELD_RESET(CData,"os");
+  IFIELD_RESET(CData,"adj");
 #else
   CDlpTable_Reset(AS(CData,_this->ud)->m_lpTable);
   CDlpTable_Reset(AS(CData,_this->td)->m_lpTable);
   CDlpTable_Reset(AS(CData,_this->sd)->m_lpTable);
   CDlpTable_Reset(AS(CData,_this->is)->m_lpTable);
   CDlpTable_Reset(AS(CData,_this->os)->m_lpTable);
+  CDlpTable_Reset(AS(CData,_this->m_idAdj)->m_lpTable);
 #endif
 
+  /* The automaton algorithms require row-major tables */
+  CData_Rowmajor(AS(CData,_this->ud));
+  CData_Rowmajor(AS(CData,_this->sd));
+  CData_Rowmajor(AS(CData,_this->td));
+
   CData_AddComp(AS(CData,_this->ud),"~NAM",32                 );
   CData_AddComp(AS(CData,_this->ud),"~XS" ,DLP_TYPE(FST_ITYPE));
   CData_AddComp(AS(CData,_this->ud),"~XT" ,DLP_TYPE(FST_ITYPE));
@@ -519,6 +528,7 @@ INT16 CFst_ResetAllOptions(CDlpObject* __this, BOOL bInit)
 	_this->m_bFst = FALSE;
 	_this->m_bFwd = FALSE;
 	_this->m_bGreedy = FALSE;
+	_this->m_bHopcroft = FALSE;
 	_this->m_bImplicit = FALSE;
 	_this->m_bIndex = FALSE;
 	_this->m_bLazy = FALSE;
@@ -2138,6 +2148,11 @@ INT16 CFst::Typerepair()
 	return CFst_Typerepair(this);
 }
 
+INT16 CFst::Units(CFst* itSrc, FST_UNITFUNC_TYPE* lpFunc, void* lpArg, BOOL bSerial)
+{
+	return CFst_Units(this, itSrc, lpFunc, lpArg, bSerial);
+}
+
 INT16 CFst::Compose(CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2)
 {
 	return CFst_Compose(this, itSrc1, itSrc2, nUnit1, nUnit2);
@@ -2153,6 +2168,26 @@ INT16 CFst::Product(CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2)
 	return CFst_Product(this, itSrc1, itSrc2, nUnit1, nUnit2);
 }
 
+BYTE* CFst::Cts_Col(FST_CTS_TYPE* lpCts, INT32 nIc, INT32* lpBs)
+{
+	return CFst_Cts_Col(lpCts, nIc, lpBs);
+}
+
+FST_CTS_TYPE* CFst::Cts_Pack(INT32 nUnit, INT16 nMode)
+{
+	return CFst_Cts_Pack(this, nUnit, nMode);
+}
+
+INT16 CFst::Cts_Unpack(FST_CTS_TYPE* lpCts)
+{
+	return CFst_Cts_Unpack(lpCts);
+}
+
+void CFst::Cts_Done(FST_CTS_TYPE* lpCts)
+{
+	CFst_Cts_Done(lpCts);
+}
+
 INT32 CFst::Addunit(const char* lpsName)
 {
 	return CFst_Addunit(this, lpsName);
@@ -2213,11 +2248,21 @@ INT16 CFst::Deltrans(INT32 nUnit, INT32 nTrans)
 	return CFst_Deltrans(this, nUnit, nTrans);
 }
 
+INT16 CFst::ReverseUnit(INT32 nU)
+{
+	return CFst_ReverseUnit(this, nU);
+}
+
 INT16 CFst::Reverse(INT32 nUnit)
 {
 	return CFst_Reverse(this, nUnit);
 }
 
+INT16 CFst::TrimUnit(INT32 nU, FLOAT64 nWlim)
+{
+	return CFst_TrimUnit(this, nU, nWlim);
+}
+
 INT16 CFst::Trim(INT32 nUnit, FLOAT64 nWlim)
 {
 	return CFst_Trim(this, nUnit, nWlim);
@@ -2253,9 +2298,9 @@ void CFst::Edist_Fwd(FST_TID_TYPE* lpTI, FST_ITYPE nS, FST_WTYPE nDist, FST_WTYP
 	CFst_Edist_Fwd(this, lpTI, nS, nDist, lpW, lpTos);
 }
 
-INT16 CFst::Epsdist(CFst* itSrc, INT32 nUnit)
+INT16 CFst::EpsdistUnit(CFst* itSrc, INT32 nUnit)
 {
-	return CFst_Epsdist(this, itSrc, nUnit);
+	return CFst_EpsdistUnit(this, itSrc, nUnit);
 }
 
 FST_ITYPE CFst::Erm_GetDestTerState(FST_TID_TYPE* lpTIsrc, FST_ITYPE nTerSrc)
@@ -2268,6 +2313,16 @@ BOOL CFst::Erm_EpsDistFromStart(FST_TID_TYPE* lpTIedt, FST_ITYPE nSsrc, FST_WTYP
 	return CFst_Erm_EpsDistFromStart(lpTIedt, nSsrc, lpEpsWFZ);
 }
 
+INT16 CFst::EpsremoveUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs)
+{
+	return CFst_EpsremoveUnit(this, itSrc, nUnit, lpWs);
+}
+
+INT16 CFst::Epsdist(CFst* itSrc, INT32 nUnit)
+{
+	return CFst_Epsdist(this, itSrc, nUnit);
+}
+
 INT16 CFst::Epsremove(CFst* itSrc, INT32 nUnit)
 {
 	return CFst_Epsremove(this, itSrc, nUnit);
@@ -2318,9 +2373,19 @@ BOOL CFst::Det_CmpResiduals(FST_ITYPE nS1, FST_ITYPE nS2, FST_ITYPE** lpMap, INT
 	return CFst_Det_CmpResiduals(this, nS1, nS2, lpMap, nMapSi);
 }
 
-INT16 CFst::DeterminizeUnit(CFst* itSrc, INT32 nUnit)
+UINT32 CFst::Det_SigResiduals(FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS)
+{
+	return CFst_Det_SigResiduals(this, lpRsh, nS);
+}
+
+FST_ITYPE CFst::Det_FindResiduals(FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS, FST_ITYPE** lpMap, INT32* nMapSi)
+{
+	return CFst_Det_FindResiduals(this, lpRsh, nS, lpMap, nMapSi);
+}
+
+INT16 CFst::DeterminizeUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs)
 {
-	return CFst_DeterminizeUnit(this, itSrc, nUnit);
+	return CFst_DeterminizeUnit(this, itSrc, nUnit, lpWs);
 }
 
 INT16 CFst::Determinize(CFst* itSrc, INT32 nUnit)
@@ -2328,9 +2393,39 @@ INT16 CFst::Determinize(CFst* itSrc, INT32 nUnit)
 	return CFst_Determinize(this, itSrc, nUnit);
 }
 
-INT16 CFst::MinimizeUnit(CFst* itSrc, INT32 nUnit)
+INT16 CFst::MinimizeUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs)
 {
-	return CFst_MinimizeUnit(this, itSrc, nUnit);
+	return CFst_MinimizeUnit(this, itSrc, nUnit, lpWs);
+}
+
+void CFst::Prt_Init(FST_PRT_TYPE* lpPrt, INT32 nElems, INT32* lpClass, INT32 nClasses)
+{
+	CFst_Prt_Init(this, lpPrt, nElems, lpClass, nClasses);
+}
+
+void CFst::Prt_Done(FST_PRT_TYPE* lpPrt)
+{
+	CFst_Prt_Done(this, lpPrt);
+}
+
+void CFst::Prt_Mark(FST_PRT_TYPE* lpPrt, INT32 nE)
+{
+	CFst_Prt_Mark(lpPrt, nE);
+}
+
+void CFst::Prt_Split(FST_PRT_TYPE* lpPrt)
+{
+	CFst_Prt_Split(lpPrt);
+}
+
+INT32 CFst::Prt_Classify(FST_PRK_TYPE* lpKey, BYTE* lpData, INT32 nRecs, INT32 nRecLen, INT32 nOffs, INT32* lpClass)
+{
+	return CFst_Prt_Classify(lpKey, lpData, nRecs, nRecLen, nOffs, lpClass);
+}
+
+INT16 CFst::HopcroftUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs)
+{
+	return CFst_HopcroftUnit(this, itSrc, nUnit, lpWs);
 }
 
 INT16 CFst::Lazymin()
@@ -2383,6 +2478,11 @@ void CFst::STI_Sort(FST_TID_TYPE* lpTI)
 	CFst_STI_Sort(lpTI);
 }
 
+void CFst::STI_AdjIndex(FST_TID_TYPE* lpTI)
+{
+	CFst_STI_AdjIndex(lpTI);
+}
+
 BYTE* CFst::STI_GetTransPtr(FST_TID_TYPE* lpTI, INT32 nTrans)
 {
 	return CFst_STI_GetTransPtr(lpTI, nTrans);
@@ -2433,6 +2533,11 @@ BYTE* CFst::STI_TtoS(FST_TID_TYPE* lpTI, INT32 nState, BYTE* lpTrans)
 	return CFst_STI_TtoS(lpTI, nState, lpTrans);
 }
 
+BYTE* CFst::STI_TfromSTis(FST_TID_TYPE* lpTI, FST_ITYPE nState, FST_STYPE nTis, BYTE* lpTrans)
+{
+	return CFst_STI_TfromSTis(lpTI, nState, nTis, lpTrans);
+}
+
 BOOL CFst::STI_Walk(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void* lpWalkFuncData, FST_ITYPE nState, BOOL bBwd)
 {
 	return CFst_STI_Walk(lpTI, lpWalkFunc, lpWalkFuncData, nState, bBwd);
@@ -2443,6 +2548,11 @@ BOOL CFst::STI_WalkInt(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void*
 	return CFst_STI_WalkInt(lpTI, lpWalkFunc, lpWalkFuncData, nState, bBwd, nDepth);
 }
 
+void CFst::Cat_CopyStructure(CFst* itSrc)
+{
+	CFst_Cat_CopyStructure(this, itSrc);
+}
+
 INT16 CFst::CatEx(CFst* itSrc, INT32 nFirstUnit, INT32 nCount)
 {
 	return CFst_CatEx(this, itSrc, nFirstUnit, nCount);
@@ -2553,6 +2663,11 @@ INT16 CFst::Fslist(INT32 nUnit, CData* idDst)
 	return CFst_Fslist(this, nUnit, idDst);
 }
 
+void CFst::FsunifyUnit(INT32 nU)
+{
+	CFst_FsunifyUnit(this, nU);
+}
+
 INT16 CFst::Fsunify(INT32 nUnit)
 {
 	return CFst_Fsunify(this, nUnit);
@@ -2583,6 +2698,21 @@ INT16 CFst::Excerpt(CFst* itSrc, INT32 nUnit, CData* idStates, INT32 nIcStates,
 	return CFst_Excerpt(this, itSrc, nUnit, idStates, nIcStates, idIs, nParam);
 }
 
+void CFst::Sdist_Up(FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE i)
+{
+	CFst_Sdist_Up(this, lpD, lpH, lpP, i);
+}
+
+void CFst::Sdist_Down(FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE nSize, FST_ITYPE i)
+{
+	CFst_Sdist_Down(this, lpD, lpH, lpP, nSize, i);
+}
+
+INT16 CFst::SdistUnit(INT32 nUnit, FST_WTYPE* lpD, INT32* lpCtr)
+{
+	return CFst_SdistUnit(this, nUnit, lpD, lpCtr);
+}
+
 INT16 CFst::Potential(INT32 nUnit)
 {
 	return CFst_Potential(this, nUnit);
@@ -2928,14 +3058,34 @@ FST_ITYPE CFst::Cps_FindState(FST_ITYPE nSX, FST_ITYPE nSY, BYTE nFlagXY)
 	return CFst_Cps_FindState(this, nSX, nSY, nFlagXY);
 }
 
-int CFst::Bsn_CompUp(const void* lpElem1, const void* lpElem2)
+BOOL CFst::Bsn_Better(FST_PQU_TYPE* lpE1, FST_PQU_TYPE* lpE2, INT16 nWsr)
+{
+	return CFst_Bsn_Better(lpE1, lpE2, nWsr);
+}
+
+void CFst::Bsn_Swap(FST_PQU_TYPE* lpPQ, INT32 i, INT32 j)
+{
+	CFst_Bsn_Swap(lpPQ, i, j);
+}
+
+void CFst::Bsn_PqDown(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, BOOL bMin, INT16 nWsr)
+{
+	CFst_Bsn_PqDown(lpPQ, nSize, i, bMin, nWsr);
+}
+
+void CFst::Bsn_PqPush(FST_PQU_TYPE* lpPQ, INT32 nSize, FST_PQU_TYPE* lpE, INT16 nWsr)
+{
+	CFst_Bsn_PqPush(lpPQ, nSize, lpE, nWsr);
+}
+
+INT32 CFst::Bsn_PqWorst(FST_PQU_TYPE* lpPQ, INT32 nSize, INT16 nWsr)
 {
-	return CFst_Bsn_CompUp(lpElem1, lpElem2);
+	return CFst_Bsn_PqWorst(lpPQ, nSize, nWsr);
 }
 
-int CFst::Bsn_CompDown(const void* lpElem1, const void* lpElem2)
+void CFst::Bsn_PqRemove(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, INT16 nWsr)
 {
-	return CFst_Bsn_CompDown(lpElem1, lpElem2);
+	CFst_Bsn_PqRemove(lpPQ, nSize, i, nWsr);
 }
 
 INT16 CFst::BestNUnit(CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength)
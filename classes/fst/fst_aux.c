@@ -32,10 +32,27 @@
  * instance. If errors are found, the method causes an assertion failure. The
  * method will, however, not make any corrections to the instance.
  *
+ * <p>In all modes the method converts the unit, state and transition tables
+ * to row-major layout, which the automaton algorithms require (see
+ * <code>CData_Rowmajor</code>).</p>
+ *
  * @param _this The automaton to be checked.
  */
 void CGEN_PUBLIC CFst_Check(CFst* _this)
 {
+  if
+  (
+    _this &&
+    (
+      CData_Rowmajor(AS(CData,_this->ud))!=O_K ||
+      CData_Rowmajor(AS(CData,_this->sd))!=O_K ||
+      CData_Rowmajor(AS(CData,_this->td))!=O_K
+    )
+  )
+  {
+    IERROR(_this,ERR_NOMEM,0,0,0);
+  }
+
 #ifdef _DEBUG
 #ifndef __MAX_TYPE_32BIT
 
@@ -580,4 +597,141 @@ INT16 CGEN_PUBLIC CFst_Typerepair(CFst* _this)
   }
   return O_K;
 }
+
+/**
+ * Shared state of unit-wise operations (see CFst_Units).
+ */
+typedef struct fst_units_pfor
+{
+  CFst*              itSrc;                                                     /* Source automaton                  */
+  FST_UNITFUNC_TYPE* lpFunc;                                                    /* Unit operation                    */
+  void*              lpArg;                                                     /* Argument of unit operation        */
+  FST_UWS_TYPE*      lpWs;                                                      /* Per chunk workspaces              */
+} FST_UNITS_PFOR;
+
+/**
+ * Loop body of CFst_Units, processes the units <code>nFirst</code> ...
+ * <code>nEnd-1</code> into the workspace of chunk <code>nChunk</code>. Each
+ * unit is copied to a private source automaton first because most unit
+ * operations sort or temporarily extend their source. The first failing unit
+ * stops the chunk. The loop body may run on a worker thread, it neither
+ * creates instances nor reports errors.
+ */
+static void CFst_UnitsTask(void* lpArg, INT32 nFirst, INT32 nEnd, INT32 nChunk)
+{
+  FST_UNITS_PFOR* lpP  = (FST_UNITS_PFOR*)lpArg;                                /* Shared loop state                 */
+  FST_UWS_TYPE*   lpWs = &lpP->lpWs[nChunk];                                    /* Workspace of chunk                */
+  INT16           nErr = O_K;                                                   /* Error code                        */
+
+  for (lpWs->nUnit=nFirst; lpWs->nUnit<nEnd && nErr==O_K; lpWs->nUnit++)        /* Loop over units of chunk          */
+  {                                                                             /* >>                                */
+    nErr = CFst_CopyUi(lpWs->itSrc,lpP->itSrc,NULL,lpWs->nUnit);                /*   Copy source unit                */
+    if (nErr==O_K)                                                              /*   Ok                              */
+      nErr = lpP->lpFunc(lpWs->itDst,lpWs->itSrc,lpWs,lpP->lpArg);              /*     Process unit                  */
+    if (nErr==O_K) nErr = CFst_Cat(lpWs->itRes,lpWs->itDst);                    /*   Append to chunk result          */
+  }                                                                             /* <<                                */
+  lpWs->nErr = nErr;                                                            /* Store error code                  */
+}
+
+/**
+ * Applies a unit operation to all units of a source automaton and stores the
+ * results in this instance. The units are distributed over the worker pool
+ * (see dlp_parallel_for) and the per-chunk results are concatenated in unit
+ * order, so the result does not depend on the number of threads. All
+ * instances the operation needs are created here, in the calling thread, and
+ * passed to the operation through its workspace. The operation must neither
+ * create instances nor report errors unless it runs serially, it returns
+ * error codes instead. On verbose levels greater than 0 the units are
+ * processed serially to keep the protocol readable.
+ *
+ * <p>The operation is invoked as <code>lpFunc(itDst,itSrc,lpWs,lpArg)</code>
+ * with a copy of the current source unit in <code>itSrc</code>. It stores
+ * the result in <code>itDst</code>; the index of the unit in the original
+ * source is <code>lpWs->nUnit</code>.</p>
+ *
+ * @param _this   Destination automaton instance (should be empty)
+ * @param itSrc   Source automaton instance (must not be <code>_this</code>)
+ * @param lpFunc  Unit operation
+ * @param lpArg   Argument passed to the unit operation
+ * @param bSerial Process units serially (required if the operation creates
+ *                instances or reports errors)
+ * @return O_K if successfull, the error code of the first failing unit
+ *         otherwise
+ */
+INT16 CGEN_PROTECTED CFst_Units
+(
+  CFst*              _this,
+  CFst*              itSrc,
+  FST_UNITFUNC_TYPE* lpFunc,
+  void*              lpArg,
+  BOOL               bSerial
+)
+{
+  FST_UNITS_PFOR rP;                                                            /* Shared loop state                 */
+  FST_UWS_TYPE*  lpWs    = NULL;                                                /* Current workspace                 */
+  INT32          nXU     = UD_XXU(itSrc);                                       /* Number of units                   */
+  INT32          nGrain  = 0;                                                   /* Units per chunk                   */
+  INT32          nChunks = 0;                                                   /* Number of chunks                  */
+  INT32          nC      = 0;                                                   /* Current chunk                     */
+  INT16          nCheck  = 0;                                                   /* Verbose level                     */
+  INT16          nErr    = O_K;                                                 /* Error code                        */
+
+  /* Initialize */                                                              /* --------------------------------- */
+  if (nXU<1) return O_K;                                                        /* Nothing to be done                */
+  nCheck = MAX(BASEINST(_this)->m_nCheck,BASEINST(itSrc)->m_nCheck);            /* Get maximum verbose level         */
+  if (bSerial || nCheck>0) nGrain = nXU;                                        /* Serial: one chunk                 */
+  nChunks   = dlp_pfor_nchunks(nXU,nGrain);                                     /* Get number of chunks              */
+  rP.itSrc  = itSrc;                                                            /* Store source                      */
+  rP.lpFunc = lpFunc;                                                           /* Store unit operation              */
+  rP.lpArg  = lpArg;                                                            /* Store argument                    */
+  rP.lpWs   = (FST_UWS_TYPE*)dlp_calloc(nChunks,sizeof(FST_UWS_TYPE));          /* Allocate per-chunk workspaces     */
+  if (!rP.lpWs) return ERR_NOMEM;                                               /* Out of memory                     */
+  for (nC=0; nC<nChunks; nC++)                                                  /* Create instances (in this thread) */
+  {                                                                             /* >>                                */
+    lpWs = &rP.lpWs[nC];                                                        /*   Get workspace                   */
+    ICREATEEX(CFst ,lpWs->itSrc   ,"CFst_Units~itSrc"   ,NULL);                 /*   Create instances                */
+    ICREATEEX(CFst ,lpWs->itDst   ,"CFst_Units~itDst"   ,NULL);                 /*   |                               */
+    ICREATEEX(CFst ,lpWs->itRes   ,"CFst_Units~itRes"   ,NULL);                 /*   |                               */
+    ICREATEEX(CFst ,lpWs->itAux   ,"CFst_Units~itAux"   ,NULL);                 /*   |                               */
+    ICREATEEX(CData,lpWs->idDetRt ,"CFst_Units~idDetRt" ,NULL);                 /*   |                               */
+    ICREATEEX(CData,lpWs->idDetAux,"CFst_Units~idDetAux",NULL);                 /*   |                               */
+    if                                                                          /*   Out of memory                   */
+    (                                                                           /*   |                               */
+      !lpWs->itSrc || !lpWs->itDst   || !lpWs->itRes ||                         /*   |                               */
+      !lpWs->itAux || !lpWs->idDetRt || !lpWs->idDetAux                         /*   |                               */
+    )                                                                           /*   |                               */
+    {                                                                           /*   >>                              */
+      nErr = ERR_NOMEM;                                                         /*     Remember error                */
+      goto L_EXIT;                                                              /*     Clean up                      */
+    }                                                                           /*   <<                              */
+    BASEINST(lpWs->itSrc)->m_nCheck = nCheck;                                   /*   Set verbose levels              */
+    BASEINST(lpWs->itDst)->m_nCheck = nCheck;                                   /*   |                               */
+    BASEINST(lpWs->itRes)->m_nCheck = nCheck;                                   /*   |                               */
+  }                                                                             /* <<                                */
+
+  /* Process units */                                                           /* --------------------------------- */
+  if (dlp_parallel_for(0,nXU,nGrain,CFst_UnitsTask,&rP)!=nChunks)               /* Run loop                          */
+    { nErr = NOT_EXEC; goto L_EXIT; }                                           /* Failed                            */
+  for (nC=0; nC<nChunks; nC++)                                                  /* Concatenate results in order      */
+  {                                                                             /* >>                                */
+    if ((nErr = rP.lpWs[nC].nErr)!=O_K) goto L_EXIT;                            /*   First error wins                */
+    if ((nErr = CFst_Cat(_this,rP.lpWs[nC].itRes))!=O_K) goto L_EXIT;           /*   Append chunk result             */
+  }                                                                             /* <<                                */
+
+  /* Clean up */                                                                /* --------------------------------- */
+L_EXIT:                                                                         /* Jump label                        */
+  for (nC=0; nC<nChunks; nC++)                                                  /* Destroy per-chunk instances       */
+  {                                                                             /* >>                                */
+    lpWs = &rP.lpWs[nC];                                                        /*   Get workspace                   */
+    if (lpWs->itSrc   ) IDESTROY(lpWs->itSrc   );                               /*   Destroy instances               */
+    if (lpWs->itDst   ) IDESTROY(lpWs->itDst   );                               /*   |                               */
+    if (lpWs->itRes   ) IDESTROY(lpWs->itRes   );                               /*   |                               */
+    if (lpWs->itAux   ) IDESTROY(lpWs->itAux   );                               /*   |                               */
+    if (lpWs->idDetRt ) IDESTROY(lpWs->idDetRt );                               /*   |                               */
+    if (lpWs->idDetAux) IDESTROY(lpWs->idDetAux);                               /*   |                               */
+  }                                                                             /* <<                                */
+  dlp_free(rP.lpWs);                                                            /* Free per-chunk workspaces         */
+  return nErr;                                                                  /* Return first error                */
+}
+
 /* EOF */
@@ -28,20 +28,6 @@
 #include "dlp_fst.h"
 #include "dlp_math.h"
 
-/* TODO: Move to fst.def, HEADERCODE: --> */
-typedef struct tag_FST_PQU_TYPE
-{
-  FST_ITYPE nXini;
-  FST_ITYPE nXter;
-  FST_ITYPE nYini;
-  FST_ITYPE nYter;
-  FST_ITYPE nTran;
-  FST_ITYPE nPlen;
-  FST_WTYPE nCacc;
-  FST_WTYPE nCtot;
-} FST_PQU_TYPE;
-/* <-- */
-
 void CGEN_PRIVATE CFst_Cps_HashPrint(CFst* _this)
 {
   hscan_t  hs;
@@ -408,27 +394,142 @@ FST_ITYPE CGEN_PRIVATE CFst_Cps_FindState
 }
 
 /**
- * Internally used by best-N-paths algorithm when sorting priority queue.
- * @see Bsn_CompDown CFst_Bsn_CompDown
+ * Internally used by best-N-paths algorithm. Compares two priority queue
+ * entries by their total cost with respect to the weight semiring. Entries of
+ * equal cost are ordered by their insertion sequence number (first in, first
+ * out), hence the order is total.
+ *
+ * @param lpE1 Pointer to first entry
+ * @param lpE2 Pointer to second entry
+ * @param nWsr Weight semiring type
+ * @return <code>TRUE</code> if <code>lpE1</code> is better than
+ *         <code>lpE2</code>, <code>FALSE</code> otherwise
  * @see BestNUnit CFst_BestNUnit
  */
-int CGEN_SPRIVATE CFst_Bsn_CompUp(const void* lpElem1, const void* lpElem2)
+BOOL CGEN_SPRIVATE CFst_Bsn_Better(FST_PQU_TYPE* lpE1, FST_PQU_TYPE* lpE2, INT16 nWsr)
 {
-  if (((FST_PQU_TYPE*)lpElem1)->nCtot < ((FST_PQU_TYPE*)lpElem2)->nCtot) return -1;
-  if (((FST_PQU_TYPE*)lpElem1)->nCtot > ((FST_PQU_TYPE*)lpElem2)->nCtot) return  1;
-  return 0;
+  if (lpE1->nCtot!=lpE2->nCtot)
+    return nWsr==FST_WSR_PROB ? lpE1->nCtot>lpE2->nCtot : lpE1->nCtot<lpE2->nCtot;
+  return lpE1->nSeq<lpE2->nSeq;
 }
 
 /**
- * Internally used by best-N-paths algorithm when sorting priority queue.
- * @see Bsn_CompUp CFst_Bsn_CompUp
- * @see BestNUnit CFst_BestNUnit
+ * Internally used by best-N-paths algorithm. Exchanges two priority queue
+ * entries.
+ */
+void CGEN_SPRIVATE CFst_Bsn_Swap(FST_PQU_TYPE* lpPQ, INT32 i, INT32 j)
+{
+  FST_PQU_TYPE e = lpPQ[i];
+  lpPQ[i] = lpPQ[j];
+  lpPQ[j] = e;
+}
+
+/**
+ * Internally used by best-N-paths algorithm. Restores the min-max heap property
+ * from entry <code>i</code> downwards. On even levels of the heap (<code>bMin
+ * </code>=<code>TRUE</code>) an entry is better than all its descendants, on
+ * odd levels it is worse than all its descendants.
+ *
+ * @param lpPQ  Priority queue (min-max heap)
+ * @param nSize Number of entries
+ * @param i     Index of entry to move down
+ * @param bMin  <code>TRUE</code> if <code>i</code> is on an even level
+ * @param nWsr  Weight semiring type
+ */
+void CGEN_SPRIVATE CFst_Bsn_PqDown(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, BOOL bMin, INT16 nWsr)
+{
+  INT32 m = 0;                                                                 /* Extreme child or grandchild       */
+  INT32 k = 0;                                                                 /* Current descendant                */
+
+  while (2*i+1<nSize)
+  {
+    /* Find best (bMin) or worst (!bMin) child or grandchild */
+    m = 2*i+1;
+    k = 2*i+2;
+    if (k<nSize && (bMin ? CFst_Bsn_Better(&lpPQ[k],&lpPQ[m],nWsr) : CFst_Bsn_Better(&lpPQ[m],&lpPQ[k],nWsr))) m=k;
+    for (k=4*i+3; k<nSize && k<=4*i+6; k++)
+      if (bMin ? CFst_Bsn_Better(&lpPQ[k],&lpPQ[m],nWsr) : CFst_Bsn_Better(&lpPQ[m],&lpPQ[k],nWsr)) m=k;
+    if (bMin ? !CFst_Bsn_Better(&lpPQ[m],&lpPQ[i],nWsr) : !CFst_Bsn_Better(&lpPQ[i],&lpPQ[m],nWsr)) break;
+    CFst_Bsn_Swap(lpPQ,i,m);
+    if (m<=2*i+2) break;                                                       /* Child -> done                     */
+    k = (m-1)/2;                                                               /* Grandchild -> check its parent    */
+    if (bMin ? CFst_Bsn_Better(&lpPQ[k],&lpPQ[m],nWsr) : CFst_Bsn_Better(&lpPQ[m],&lpPQ[k],nWsr))
+      CFst_Bsn_Swap(lpPQ,k,m);
+    i = m;
+  }
+}
+
+/**
+ * Internally used by best-N-paths algorithm. Inserts an entry into the
+ * priority queue (min-max heap) in O(log <i>N</i>) time.
+ *
+ * @param lpPQ  Priority queue (min-max heap, capacity at least <code>nSize
+ *              </code>+1)
+ * @param nSize Number of entries before insertion
+ * @param lpE   Entry to insert
+ * @param nWsr  Weight semiring type
  */
-int CGEN_SPRIVATE CFst_Bsn_CompDown(const void* lpElem1, const void* lpElem2)
+void CGEN_SPRIVATE CFst_Bsn_PqPush(FST_PQU_TYPE* lpPQ, INT32 nSize, FST_PQU_TYPE* lpE, INT16 nWsr)
 {
-  if (((FST_PQU_TYPE*)lpElem1)->nCtot > ((FST_PQU_TYPE*)lpElem2)->nCtot) return -1;
-  if (((FST_PQU_TYPE*)lpElem1)->nCtot < ((FST_PQU_TYPE*)lpElem2)->nCtot) return  1;
-  return 0;
+  INT32 i    = nSize;                                                          /* Current index                     */
+  INT32 p    = 0;                                                              /* Parent index                      */
+  INT32 g    = 0;                                                              /* Grandparent index                 */
+  INT32 nLev = 0;                                                              /* Level of entry                    */
+  BOOL  bMin = FALSE;                                                          /* Entry moves on even levels        */
+
+  lpPQ[i] = *lpE;
+  if (i==0) return;
+  for (p=i+1; p>1; p>>=1) nLev++;
+  bMin = (nLev%2==0);
+  p    = (i-1)/2;
+  if (bMin ? CFst_Bsn_Better(&lpPQ[p],&lpPQ[i],nWsr) : CFst_Bsn_Better(&lpPQ[i],&lpPQ[p],nWsr))
+  {
+    CFst_Bsn_Swap(lpPQ,i,p);
+    i    = p;
+    bMin = !bMin;
+  }
+  while (i>=3)
+  {
+    g = ((i-1)/2-1)/2;
+    if (bMin ? !CFst_Bsn_Better(&lpPQ[i],&lpPQ[g],nWsr) : !CFst_Bsn_Better(&lpPQ[g],&lpPQ[i],nWsr)) break;
+    CFst_Bsn_Swap(lpPQ,i,g);
+    i = g;
+  }
+}
+
+/**
+ * Internally used by best-N-paths algorithm. Returns the index of the worst
+ * entry of the priority queue (min-max heap).
+ *
+ * @param lpPQ  Priority queue (min-max heap)
+ * @param nSize Number of entries (must be positive)
+ * @param nWsr  Weight semiring type
+ */
+INT32 CGEN_SPRIVATE CFst_Bsn_PqWorst(FST_PQU_TYPE* lpPQ, INT32 nSize, INT16 nWsr)
+{
+  if (nSize<=1) return 0;
+  if (nSize==2) return 1;
+  return CFst_Bsn_Better(&lpPQ[1],&lpPQ[2],nWsr) ? 2 : 1;
+}
+
+/**
+ * Internally used by best-N-paths algorithm. Removes an entry from the
+ * priority queue (min-max heap) in O(log <i>N</i>) time. Only the best entry
+ * (index 0) and the worst entry (see {@link Bsn_PqWorst CFst_Bsn_PqWorst})
+ * may be removed.
+ *
+ * @param lpPQ  Priority queue (min-max heap)
+ * @param nSize Number of entries before removal
+ * @param i     Index of entry to remove
+ * @param nWsr  Weight semiring type
+ */
+void CGEN_SPRIVATE CFst_Bsn_PqRemove(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, INT16 nWsr)
+{
+  DLPASSERT(i<=2);
+  nSize--;
+  if (i==nSize) return;
+  lpPQ[i] = lpPQ[nSize];
+  CFst_Bsn_PqDown(lpPQ,nSize,i,i==0,nWsr);
 }
 
 /**
@@ -445,12 +546,13 @@ int CGEN_SPRIVATE CFst_Bsn_CompDown(const void* lpElem1, const void* lpElem2)
  */
 INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength)
 {
-  FST_PQU_TYPE* lpPQ      = NULL;                                              /* Priority queue data struct         */
+  FST_PQU_TYPE* lpPQ      = NULL;                                              /* Priority queue (min-max heap)      */
+  FST_PQU_TYPE  iPQE;                                                          /* Priority queue entry to push       */
+  INT32         nSeq      = 0;                                                 /* Priority queue insertion counter   */
   FST_TID_TYPE* lpTIX     = NULL;                                              /* Source graph iterator data struct  */
   BYTE*         lpTX      = NULL;                                              /* Ptr. to current source transition  */
   FST_ITYPE     nFS       = 0;                                                 /* First state of source unit         */
   INT32          nArrivals = 0;                                                 /* Paths having reached a final state */
-  FST_WTYPE     nNeAdd    = 0.;                                                /* Neutral element of addition        */
   FST_WTYPE     nNeMult   = 0.;                                                /* Neutral element of multiplication  */
   FST_ITYPE     nPQsize   = 0;                                                 /* Priority queue size                */
   FST_ITYPE     nT        = 0;                                                 /* Index of current source transition */
@@ -495,7 +597,6 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
 
   CFst_Cps_AddSdAux(_this);
   nNeMult = CFst_Wsr_NeMult(_this->m_nWsr);
-  nNeAdd  = CFst_Wsr_NeAdd (_this->m_nWsr);
 
   /* Add in itSrc the component Extracted that stores how many times this node has been visited */
   nIcP = CData_FindComp(AS(CData,itSrc->sd),NC_SD_POT);
@@ -504,7 +605,6 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
 
   /* Initialize - Create priority queue */
   lpPQ = (FST_PQU_TYPE*)dlp_calloc(nPaths+1,sizeof(FST_PQU_TYPE));
-  for (k=0; k<nPaths+1; k++) lpPQ[k].nCtot = nNeAdd;
 
   /* Initialize - Graph iterator */
   lpTIX = CFst_STI_Init(itSrc,nUnit,FSTI_SORTINI);
@@ -548,14 +648,16 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
         nNewY++;
 
         /* Push into priority queue */
-        lpPQ[nPQsize].nXini = nXter;
-        lpPQ[nPQsize].nYini = nYter;
-        lpPQ[nPQsize].nXter = *CFst_STI_TTer(lpTIX,lpTX);
-        lpPQ[nPQsize].nYter = nNewY;
-        lpPQ[nPQsize].nTran = nT;
-        lpPQ[nPQsize].nPlen = nPlen+1;
-        lpPQ[nPQsize].nCacc = CFst_Wsr_Op(_this,nCacc,nWX,OP_MULT); /* nWX + nCacc; */
-        lpPQ[nPQsize].nCtot = nCtot;
+        iPQE.nXini = nXter;
+        iPQE.nYini = nYter;
+        iPQE.nXter = *CFst_STI_TTer(lpTIX,lpTX);
+        iPQE.nYter = nNewY;
+        iPQE.nTran = nT;
+        iPQE.nPlen = nPlen+1;
+        iPQE.nCacc = CFst_Wsr_Op(_this,nCacc,nWX,OP_MULT); /* nWX + nCacc; */
+        iPQE.nCtot = nCtot;
+        iPQE.nSeq  = nSeq++;
+        CFst_Bsn_PqPush(lpPQ,nPQsize,&iPQE,_this->m_nWsr);
         nPQsize++;
 
         IFCHECKEX(1)
@@ -563,19 +665,13 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
             (int)nPQsize,(int)nXter,(int)nYter,(float)nCacc,(int)nT,(int)nPlen,
             (float)nCtot,(int)*CFst_STI_TTer(lpTIX,lpTX),(int)nNewY);
 
-        /* Sort priority queue */
-        if (_this->m_nWsr == FST_WSR_PROB)
-          qsort(lpPQ,nPaths+1,sizeof(FST_PQU_TYPE),CFst_Bsn_CompDown);
-        else
-          qsort(lpPQ,nPaths+1,sizeof(FST_PQU_TYPE),CFst_Bsn_CompUp);
-
-        /* Delete last element from queue (if neccesary) to keep its size smaller than nPaths+1 */
+        /* Delete worst element from queue (if neccesary) to keep its size smaller than nPaths+1 */
         if (nPQsize == nPaths+1-nArrivals)
         {
-          lpPQ[nPQsize-1].nCtot = nNeAdd;
+          CFst_Bsn_PqRemove(lpPQ,nPQsize,CFst_Bsn_PqWorst(lpPQ,nPQsize,_this->m_nWsr),_this->m_nWsr);
           nPQsize--;
         }
-        nCmax = lpPQ[nPQsize-1].nCtot;
+        nCmax = lpPQ[CFst_Bsn_PqWorst(lpPQ,nPQsize,_this->m_nWsr)].nCtot;
 
         IFCHECKEX(2)
           for (k=0; k<nPQsize; k++)
@@ -600,8 +696,7 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
       nCacc = lpPQ[0].nCacc;
       nCtot = lpPQ[0].nCtot;
 
-      dlp_memmove(lpPQ,&lpPQ[1],nPaths*sizeof(FST_PQU_TYPE));
-      lpPQ[nPQsize-1].nCtot = nNeAdd;
+      CFst_Bsn_PqRemove(lpPQ,nPQsize,0,_this->m_nWsr);
       nPQsize--;
       IFCHECKEX(1) printf(" Pop priority queue\n");
       IFCHECKEX(2)
@@ -641,17 +736,46 @@ INT16 CGEN_PROTECTED CFst_BestNUnit(CFst* _this, CFst* itSrc, INT32 nUnit, INT32
   return O_K;
 }
 
+/**
+ * Arguments of the unit operation of {@link BestN CFst_BestN}.
+ */
+typedef struct fst_bsn_args
+{
+  INT32 nPaths;                                                                 /* Number of paths                   */
+  INT32 nPathlength;                                                            /* Maximal path length               */
+  BOOL  bPush;                                                                  /* Copy of m_bPush option            */
+  BOOL  bLocal;                                                                 /* Copy of m_bLocal option           */
+} FST_BSN_ARGS;
+
+/**
+ * Unit operation of {@link BestN CFst_BestN} (see CFst_Units). With the
+ * option <code>/local</code> the operation creates instances and must run
+ * serially.
+ */
+static INT16 CFst_Bsn_UnitFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  FST_BSN_ARGS* lpA = (FST_BSN_ARGS*)lpArg;                                     /* Arguments                         */
+
+  _this->m_bPush = lpA->bPush;
+  if (lpA->bLocal) return CFst_BestNUnitLocal(_this,itSrc,0,lpA->nPaths);
+  return CFst_BestNUnit(_this,itSrc,0,lpA->nPaths,lpA->nPathlength);
+}
+
 /*
  * Manual page at fst_man.def
  */
 INT16 CGEN_PUBLIC CFst_BestN(CFst* _this, CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength)
 {
-  CFst* itUnit = NULL;                                                         /* Current unit                      */
-  INT32  nU     = 0;                                                            /* Current unit index                */
+  FST_BSN_ARGS rA;                                                              /* Arguments of unit operation       */
   INT32  nIcW   = -1;                                                           /* Comp. index of src.trans. weights */
   INT32  nIcP   = -1;                                                           /* Comp. index of src.state potential*/
-  BOOL  bPush  = FALSE;                                                        /* Copy of m_bPush option            */
-  BOOL  bLocal = FALSE;                                                        /* Copy of m_bLocal option           */
+  INT16  nErr   = O_K;                                                          /* Error code                        */
 
   /* Validation */
   CHECK_THIS_RV(NOT_EXEC);
@@ -666,40 +790,37 @@ INT16 CGEN_PUBLIC CFst_BestN(CFst* _this, CFst* itSrc, INT32 nUnit, INT32 nPaths
   CFst_Potential(itSrc,nUnit);
   DLPASSERT(CData_FindComp(AS(CData,itSrc->sd),NC_SD_POT)>=0);                 /* CFst_Potential failed?             */
 
-  bPush  = _this->m_bPush;
-  bLocal = _this->m_bLocal;
+  rA.nPaths      = nPaths;
+  rA.nPathlength = nPathlength;
+  rA.bPush       = _this->m_bPush;
+  rA.bLocal      = _this->m_bLocal;
 
   /* NO RETURNS BEYOND THIS POINT! */
   CREATEVIRTUAL(CFst,itSrc,_this);
   CFst_Reset(BASEINST(_this),TRUE);
-  if (nUnit<0) { ICREATEEX(CFst,itUnit,"CFst_BestN~itUnit",NULL); }
-  else         itUnit = _this;
-
-  if (BASEINST(_this)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(_this)->m_nCheck;
-  if (BASEINST(itSrc)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(itSrc)->m_nCheck;
 
   /* BestN of units */
-  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(itSrc); nU++)
+  if (nUnit>=0)
   {
-    itUnit->m_bPush = bPush;
-    if (bLocal) CFst_BestNUnitLocal(itUnit,itSrc,nU,nPaths);
-    else        CFst_BestNUnit     (itUnit,itSrc,nU,nPaths,nPathlength);
-    if (nUnit>=0) break;
-    CFst_Cat(_this,itUnit);
+    if (BASEINST(itSrc)->m_nCheck>BASEINST(_this)->m_nCheck) BASEINST(_this)->m_nCheck=BASEINST(itSrc)->m_nCheck;
+    _this->m_bPush = rA.bPush;
+    if (rA.bLocal) CFst_BestNUnitLocal(_this,itSrc,nUnit,nPaths);
+    else           CFst_BestNUnit     (_this,itSrc,nUnit,nPaths,nPathlength);
   }
+  else if ((nErr=CFst_Units(_this,itSrc,CFst_Bsn_UnitFunc,&rA,rA.bLocal))!=O_K)
+    IERROR(_this,nErr==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
 
   /* Copy input and output symbol table */                                      /* --------------------------------- */
   CData_Copy(_this->is,itSrc->is);                                              /* Copy input symbol table           */
   CData_Copy(_this->os,itSrc->os);                                              /* Copy output symbol table          */
 
   /* Clean up */
-  if (nUnit<0) IDESTROY(itUnit);
   DESTROYVIRTUAL(itSrc,_this);
   if (nIcP<0) CData_DeleteComps(AS(CData,itSrc->sd),nIcP,1);
   CData_DeleteComps(AS(CData,_this->sd),CData_FindComp(AS(CData,_this->sd),NC_SD_POT),1);
   if(nPathlength>0) CFst_Trim(_this,-1,0);                                  /* remove short paths without endstate */
   CFst_Check(_this);                                                           /* TODO: Remove after debugging      */
-  return O_K;
+  return nErr;
 }
 
 /* EOF */
@@ -23,8 +23,6 @@
  * You should have received a copy of the GNU Lesser General Public License
  * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
  */
-#define _CPS_MAPHASH_
-
 /* These error macro produces a string containing file name and line number */
 #define STRINGIFY2(X) #X
 #define STRINGIFY1(X) STRINGIFY2(X)
@@ -54,7 +52,6 @@ struct fstc_t {
 /* Internal state structure */
 struct fstc_s {
   struct fstc_s *snxt,*sprv; /* Connected list of all states */
-  struct fstc_s *hnxt,*hprv; /* Connected list in the hash chain of that state */
   struct fstc_s *qnxt;       /* Next state in queue */
   struct fstc_t *tn,*tb,*tl; /* First outgoing, self-loop and ingoing transition */
   struct fstc_t *tfl0;       /* Removable transition in universal epsilon filter */
@@ -73,6 +70,13 @@ struct fstc_d {
   INT16 typ;          /* Dlabpro data type */
 };
 
+/* Internal label index entry (outgoing transitions of one state sorted by input symbol) */
+struct fstc_x {
+  INT32 i;                   /* Input symbol */
+  UINT32 k;                  /* Position in the state's transition list */
+  struct fstc_t *t;          /* Transition */
+};
+
 /* Internal fst structure */
 struct fstc_f {
   UINT32 ns,nt;         /* Number of states and transitions */
@@ -81,51 +85,21 @@ struct fstc_f {
   struct fstc_mem smem; /* State memory for destination */
   struct fstc_mem tmem; /* Transition memory */
   struct fstc_d *d;     /* Extra transition components for operands */
+  struct fstc_x *x;     /* Label index of right operand (NULL if not built) */
+  UINT32 *xo;           /* Offsets of the states in the label index (ns+1 entries) */
 };
 
-#ifndef _CPS_MAPHASH_
-/* Internal done map structure */
-struct fstc_m {
-  unsigned char *buf; /* Bitmap data */
-  uint64_t ne,nb;     /* Number of states in epsilon filter and right operand */
-};
-#endif
-
 /* Internal algorithm structure */
 struct fstc_c {
   char dbg;          /* Debug level */
-  struct fstc_s **h; /* State hash */
   struct fstc_s  *q; /* State queue */
-  struct fstc_m   m; /* Done map */
+  struct fstc_m   m; /* Composed state map */
+  const char   *err; /* Error in fstc_news */
 };
 
 /* This is set to qnxt if a state is not in the queue */
 #define QNONE	((struct fstc_s*)(-1))
 
-/* Hash chain dimension */
-#define HBIT            23
-#define HMASK	          ((1<<HBIT)-1)
-/* Calculating the chain index */
-#define HCH1(ia,ie,ib)  (((ia)+1)*((ie)+1)*((ib)+1))
-#define HCH(ia,ie,ib)   (((HCH1(ia,ie,ib)>>HBIT)^HCH1(ia,ie,ib))&HMASK)
-
-#ifndef _CPS_MAPHASH_
-/* Get map index from state indizies */
-#define MAPID(m,a,e,b)  (((uint64_t)(a)*(m).ne+(uint64_t)(e))*(m).nb+(uint64_t)(b))
-/* Done map set and get by map index */
-#define MAPGETI(m,i)		((m).buf[(i)>>3]&(0x1<<((i)&0x7)))
-#define MAPSETI(m,i)		((m).buf[(i)>>3]|=0x1<<((i)&0x7))
-/* Done map set and get by state indizies */
-#define MAPGET(m,a,e,b) MAPGETI(m,MAPID(m,a,e,b))
-#define MAPSET(m,a,e,b) MAPSETI(m,MAPID(m,a,e,b))
-/* Done map initialize */
-#define MAPINIT(m,ans,ens,bns) { \
-  if(!((m).buf=(unsigned char *)calloc((((uint64_t)(ans)*(ens)*(bns))>>3)+1,sizeof(unsigned char)))) return "Out of memory"; \
-  (m).ne=(ens); (m).nb=(bns); \
-}
-#define MAPFREE(m)     free((m).buf)
-#endif
-
 /* Add a new transition to one of the operands
  *
  * @param f   Operand transducer
@@ -165,6 +139,7 @@ const char *fstc_fload(struct fstc_f *f,CFst *c,INT32 ui,char epsout){
   struct fstc_d **dp;
   f->ns=UD_XS(c,ui);
   f->nt=UD_XT(c,ui)+f->ns;
+  f->x=NULL; f->xo=NULL;
   psr=CFst_Wsr_GetType(c,NULL)==FST_WSR_PROB;
   if((err=fstc_meminit(&f->tmem,sizeof(struct fstc_t),f->nt))) return err;
   if((err=fstc_meminit(&f->smem,sizeof(struct fstc_s)*f->ns,1))) return err;
@@ -213,6 +188,7 @@ const char *fstc_fload(struct fstc_f *f,CFst *c,INT32 ui,char epsout){
  */
 const char *fstc_feps(struct fstc_f *f,char noeps){
   const char *err;
+  f->x=NULL; f->xo=NULL;
   if((err=fstc_meminit(&f->tmem,sizeof(struct fstc_t),16))) return err;
   if(noeps){
     if((err=fstc_meminit(&f->smem,sizeof(struct fstc_s)*(f->ns=1),1))) return err;
@@ -251,6 +227,63 @@ const char *fstc_feps(struct fstc_f *f,char noeps){
   return NULL;
 }
 
+/* Compare two label index entries by input symbol and list position
+ *
+ * @param a  First entry
+ * @param b  Second entry
+ * @return   Comparison result for qsort
+ */
+int fstc_xcmp(const void *a,const void *b){
+  const struct fstc_x *xa=(const struct fstc_x *)a;
+  const struct fstc_x *xb=(const struct fstc_x *)b;
+  if(xa->i!=xb->i) return xa->i<xb->i?-1:1;
+  return xa->k<xb->k?-1:xa->k>xb->k?1:0;
+}
+
+/* Build the label index of an operand
+ *
+ * The outgoing transitions of each state are sorted by input symbol. Equal
+ * symbols keep the order of the transition list, so matching through the
+ * index yields the transitions in the same order as walking the list.
+ *
+ * @param f  Operand transducer
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fstc_findex(struct fstc_f *f){
+  UINT32 si,n;
+  struct fstc_t *t;
+  if(!(f->xo=(UINT32*)malloc((f->ns+1)*sizeof(UINT32)))) return FSTCERR("Out of memory");
+  for(n=0,si=0;si<f->ns;si++){
+    f->xo[si]=n;
+    for(t=f->s[si].tn;t;t=t->nnxt) n++;
+  }
+  f->xo[f->ns]=n;
+  if(!(f->x=(struct fstc_x*)malloc((n?n:1)*sizeof(struct fstc_x)))) return FSTCERR("Out of memory");
+  for(si=0;si<f->ns;si++){
+    struct fstc_x *x=f->x+f->xo[si];
+    for(n=0,t=f->s[si].tn;t;t=t->nnxt,n++){ x[n].i=t->i; x[n].k=n; x[n].t=t; }
+    if(n>1) qsort(x,n,sizeof(struct fstc_x),fstc_xcmp);
+  }
+  return NULL;
+}
+
+/* Find the first transition with a given input symbol in the label index
+ *
+ * @param f   Operand transducer (with label index)
+ * @param si  State index
+ * @param i   Input symbol
+ * @return    Index of the first matching entry in <code>f->x</code> or
+ *            <code>f->xo[si+1]</code> if there is none
+ */
+UINT32 fstc_xfind(struct fstc_f *f,UINT32 si,INT32 i){
+  UINT32 l=f->xo[si],r=f->xo[si+1];
+  while(l<r){
+    UINT32 m=l+(r-l)/2;
+    if(f->x[m].i<i) l=m+1; else r=m;
+  }
+  return l;
+}
+
 /* Find a used state or create a new one
  *
  * @param c   Algorithm structure
@@ -261,12 +294,11 @@ const char *fstc_feps(struct fstc_f *f,char noeps){
  * @return    State pointer in destination transducer or NULL if expanded before
  */
 struct fstc_s *fstc_news(struct fstc_c *c,struct fstc_f *fr,UINT32 ia,UINT32 ie,UINT32 ib){
-  UINT32 ch=HCH(ia,ie,ib);
-  struct fstc_s *s=c->h[ch];
-  if(MAPGET(c->m,ia,ie,ib)) return NULL;
-  while(s && (s->ia!=ia || s->ie!=ie || s->ib!=ib)) s=s->hnxt;
-  if(s) return s;
-  s=(struct fstc_s *)fstc_memget(&fr->smem);
+  struct fstc_s **ps=mapget(&c->m,ia,ie,ib);
+  struct fstc_s *s;
+  if(ps) return *ps==MAPDONE?NULL:*ps;
+  if(!(s=(struct fstc_s *)fstc_memget(&fr->smem))){ c->err=FSTCERR("Out of memory"); return NULL; }
+  if((c->err=mapins(&c->m,ia,ie,ib,s))){ fstc_memput(&fr->smem,s); return NULL; }
   s->ia=ia; s->ie=ie; s->ib=ib;
   s->tn=s->tb=s->tl=NULL;
   s->fin=s->l0=0;
@@ -274,9 +306,6 @@ struct fstc_s *fstc_news(struct fstc_c *c,struct fstc_f *fr,UINT32 ia,UINT32 ie,
   if(fr->s) fr->s->sprv=s;
   s->snxt=fr->s; fr->s=s;
   s->sprv=NULL;
-  if(c->h[ch]) c->h[ch]->hprv=s;
-  s->hnxt=c->h[ch]; c->h[ch]=s;
-  s->hprv=NULL;
   s->qnxt=c->q; c->q=s;
   return s;
 }
@@ -303,13 +332,7 @@ const char *fstc_sfree(struct fstc_c *c,struct fstc_f *fr,struct fstc_s *s){
     t2=t->bnxt;
     fstc_memput(&fr->tmem,t);
   }
-  MAPSET(c->m,s->ia,s->ie,s->ib);
-  if(s->hnxt) s->hnxt->hprv=s->hprv;
-  if(s->hprv) s->hprv->hnxt=s->hnxt;
-  else{
-    UINT32 ch=HCH(s->ia,s->ie,s->ib);
-    c->h[ch]=s->hnxt;
-  }
+  *mapget(&c->m,s->ia,s->ie,s->ib)=MAPDONE;
   fstc_memput(&fr->smem,s);
   return NULL;
 }
@@ -325,26 +348,35 @@ const char *fstc_sfree(struct fstc_c *c,struct fstc_f *fr,struct fstc_s *s){
  */
 const char *fstc_cps(struct fstc_f *fa,struct fstc_f *fe,struct fstc_f *fb,struct fstc_f *fr,char dbg){
   struct fstc_c c;
+  struct fstc_t *tsym=NULL;
+  uint64_t nest=((uint64_t)fa->ns+fb->ns)*fe->ns; /* Estimated number of states */
   const char *err;
   memset(fr,0,sizeof(struct fstc_f));
-  fstc_meminit(&fr->smem,sizeof(struct fstc_s),4096);
-  fstc_meminit(&fr->tmem,sizeof(struct fstc_t),4096);
-  if(!(c.h=(struct fstc_s **)calloc(HMASK+1,sizeof(struct fstc_s *)))) return "Out of memory";
-  MAPINIT(c.m,fa->ns,fe->ns,fb->ns);
+  if(!fb->x && (err=fstc_findex(fb))) return err;
+  /* In the fixed filter every non-epsilon symbol matches the EPSSYM loop only */
+  if(fe->ns==1) for(tsym=fe->s[0].tn;tsym && tsym->i!=EPSSYM;) tsym=tsym->nnxt;
+  if((err=fstc_meminit(&fr->smem,sizeof(struct fstc_s),(UINT32)MIN(MAX(nest,64),4096)))) return err;
+  if((err=fstc_meminit(&fr->tmem,sizeof(struct fstc_t),(UINT32)MIN(MAX(nest,64),4096)))) return err;
+  if((err=mapinit(&c.m,nest))) return err;
   c.q=NULL;
   c.dbg=dbg;
+  c.err=NULL;
   fr->s0=fstc_news(&c,fr,0,0,0);
-  while(c.q){
+  while(c.q && !c.err){
     struct fstc_s *sb=c.q;
     struct fstc_t *ta,*te,*tb;
     struct fstc_s *sn;
+    UINT32 xb,xe;
+    INT32 mb;
     c.q=sb->qnxt; sb->qnxt=QNONE;
     if(fa->s[sb->ia].fin && fb->s[sb->ib].fin) sb->fin=1;
     if(c.dbg) printf("sexp  %i,%i,%i%s\n",sb->ia,sb->ie,sb->ib,sb->fin?" (fin)":"");
+    xe=fb->xo[sb->ib+1];
     for(ta=fa->s[sb->ia].tn;ta;ta=ta->nnxt)
-      for(te=fe->s[sb->ie].tn;te;te=te->nnxt) if(ta->o==te->i || (te->i==EPSSYM && ta->o>0))
-        for(tb=fb->s[sb->ib].tn;tb;tb=tb->nnxt) if((te->o!=EPSSYM && te->o==tb->i) || (te->o==EPSSYM && tb->i==ta->o))
-          if((sn=fstc_news(&c,fr,ta->n,te->n,tb->n))){
+      for(te=(tsym && ta->o>=0)?tsym:fe->s[sb->ie].tn;te;te=(tsym && ta->o>=0)?NULL:te->nnxt) if(ta->o==te->i || (te->i==EPSSYM && ta->o>0))
+        /* Symbol to match in right operand: filter output or (for EPSSYM) the intermediate symbol */
+        for(mb=te->o==EPSSYM?ta->o:te->o,xb=fstc_xfind(fb,sb->ib,mb);xb<xe && fb->x[xb].i==mb;xb++)
+          if((sn=fstc_news(&c,fr,ta->n,te->n,(tb=fb->x[xb].t)->n))){
             struct fstc_t *tr=(struct fstc_t *)fstc_memget(&fr->tmem);
             if(c.dbg) printf("tadd  %i,%i,%i => %i/%i,%i/%i => %i,%i,%i\n",sb->ia,sb->ie,sb->ib,ta->o,te->i,te->o,tb->i,sn->ia,sn->ie,sn->ib);
             tr->si=sb; tr->st=sn;
@@ -401,9 +433,8 @@ const char *fstc_cps(struct fstc_f *fa,struct fstc_f *fe,struct fstc_f *fb,struc
       if((err=fstc_sfree(&c,fr,sb))) return err;
     }else if(!sb->fin && !sb->tn){ if((err=fstc_sfree(&c,fr,sb))) return err; }
   }
-  free(c.h);
-  MAPFREE(c.m);
-  return NULL;
+  mapfree(&c.m);
+  return c.err;
 }
 
 /* Save one transition of internal destination transducer into dlabpro one
@@ -486,6 +517,9 @@ const char *fstc_fsave(struct fstc_f *f,CFst *c,char noint,struct fstc_d *da,str
 void fstc_ffree(struct fstc_f *fr){
   fstc_memfree(&fr->smem);
   fstc_memfree(&fr->tmem);
+  if(fr->x)  free(fr->x);
+  if(fr->xo) free(fr->xo);
+  fr->x=NULL; fr->xo=NULL;
 }
 
 /* Perform composition algorithm
@@ -1,5 +1,5 @@
 /* dLabPro class CFst (fst)
- * - Composition - Fast internal memory structure
+ * - Composition - Composed state map
  *
  * AUTHOR : Frank Duckhorn
  * PACKAGE: dLabPro/classes
@@ -24,85 +24,134 @@
  * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifdef _CPS_MAPHASH_
-/* Fast internal done map structure */
+/* Composed state map
+ *
+ * Open-addressing hash table (Robin Hood probing) from the state index
+ * triple (a,e,b) of the operands and the epsilon filter to the state of the
+ * destination transducer. States freed during composition keep their entry
+ * with the value MAPDONE, so they are never created again. Therefore entries
+ * are never removed and the table needs no tombstones. The table starts at a
+ * size estimated from the operands and doubles when it is 3/4 full.
+ */
 
-#define HASHBITS  20
-#define HASHXCH   (1<<8)
+/* Value of states which have been expanded and freed */
+#define MAPDONE   ((struct fstc_s*)(-2))
+/* Minimal number of map entries */
+#define MAPMINBIT 8
 
-struct fstc_mch {
-  struct fstc_mch *prv;
-  uint64_t used;
-  uint64_t i[HASHXCH];
+/* Map entry */
+struct fstc_me {
+  UINT32 a,e,b;              /* State index in left operand, epsilon filter and right operand */
+  UINT32 d;                  /* Probe distance + 1 (0 for empty entries) */
+  struct fstc_s *s;          /* Destination state or MAPDONE */
 };
 
+/* Map structure */
 struct fstc_m {
-  uint64_t na,ne,nb;
-  struct fstc_mch **chs;
+  struct fstc_me *e;         /* Entries */
+  UINT32 bits;               /* Number of entries is 1<<bits */
+  UINT32 used;               /* Number of used entries */
 };
 
-const char *mapinit(struct fstc_m *m,uint64_t na,uint64_t ne,uint64_t nb){
-  uint64_t ch;
-  m->na=na;
-  m->ne=ne;
-  m->nb=nb;
-  if(!(m->chs=(struct fstc_mch**)malloc(sizeof(struct fstc_mch*)*(1<<HASHBITS)))) return "Out of memory";
-  for(ch=0;ch<(1<<HASHBITS);ch++) m->chs[ch]=NULL;
+/* Hash function
+ *
+ * @param a  State index in left operand
+ * @param e  State index in epsilon filter
+ * @param b  State index in right operand
+ * @return   The hash value
+ */
+static UINT32 maph(UINT32 a,UINT32 e,UINT32 b){
+  UINT32 h=a*0x9E3779B1U;
+  h^=(b+0x7F4A7C15U+(h<<6)+(h>>2))*0x85EBCA77U;
+  h^=(e+0x165667B1U+(h<<6)+(h>>2))*0xC2B2AE3DU;
+  h^=h>>15;
+  h*=0x2C1B3C6DU;
+  h^=h>>12;
+  return h;
+}
+
+/* Initialize map
+ *
+ * @param m     Map structure
+ * @param nest  Estimated number of states
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *mapinit(struct fstc_m *m,uint64_t nest){
+  for(m->bits=MAPMINBIT;m->bits<31 && ((uint64_t)1<<m->bits)<nest*2;) m->bits++;
+  m->used=0;
+  if(!(m->e=(struct fstc_me*)calloc((size_t)1<<m->bits,sizeof(struct fstc_me)))) return FSTCERR("Out of memory");
   return NULL;
 }
+
+/* Free map
+ *
+ * @param m  Map structure
+ */
 void mapfree(struct fstc_m *m){
-  uint64_t ch;
-  for(ch=0;ch<(1<<HASHBITS);ch++){
-    while(m->chs[ch]){
-      struct fstc_mch *c=m->chs[ch];
-      m->chs[ch]=c->prv;
-      free(c);
-    }
-  }
-  free(m->chs);
-  m->chs=NULL;
+  if(m->e) free(m->e);
+  m->e=NULL;
+  m->used=0;
 }
 
-#define MAPID(m,a,e,b)  (((a)*(m)->ne+(e))*(m)->nb+(b))
-static uint64_t mapch(uint64_t i){
-  uint64_t x=1<<HASHBITS;
-  uint64_t ch=0;
-  while(i){ ch^=i&(x-1); i>>=HASHBITS; }
-  return ch;
+/* Find a map entry
+ *
+ * @param m  Map structure
+ * @param a  State index in left operand
+ * @param e  State index in epsilon filter
+ * @param b  State index in right operand
+ * @return   Pointer to the entry's value or <code>NULL</code> if not found
+ *           (valid until the next insertion)
+ */
+struct fstc_s **mapget(struct fstc_m *m,UINT32 a,UINT32 e,UINT32 b){
+  UINT32 mask=((UINT32)1<<m->bits)-1;
+  UINT32 i=maph(a,e,b)&mask;
+  UINT32 d;
+  for(d=1;m->e[i].d>=d;d++,i=(i+1)&mask)
+    if(m->e[i].a==a && m->e[i].b==b && m->e[i].e==e) return &m->e[i].s;
+  return NULL;
 }
-char mapget(struct fstc_m *m,uint64_t a,uint64_t e,uint64_t b){
-  uint64_t i=MAPID(m,a,e,b);
-  uint64_t ch=mapch(i);
-  struct fstc_mch *c=m->chs[ch];
-  for(;c;c=c->prv){
-    uint64_t cu=c->used, *ci=c->i;
-    for(;cu;cu--,ci++) if(*ci==i) return 1;
-  }
-  return 0;
+
+/* Insert an entry without size check (the key must not be in the map)
+ *
+ * @param m  Map structure
+ * @param n  Entry to insert (d is ignored)
+ */
+static void mapput(struct fstc_m *m,struct fstc_me n){
+  UINT32 mask=((UINT32)1<<m->bits)-1;
+  UINT32 i=maph(n.a,n.e,n.b)&mask;
+  for(n.d=1;m->e[i].d;n.d++,i=(i+1)&mask)
+    if(m->e[i].d<n.d){ struct fstc_me x=m->e[i]; m->e[i]=n; n=x; }
+  m->e[i]=n;
+  m->used++;
 }
 
-const char *mapset(struct fstc_m *m,uint64_t a,uint64_t e,uint64_t b){
-  uint64_t i=MAPID(m,a,e,b);
-  uint64_t ch=mapch(i);
-  struct fstc_mch *c;
-  for(c=m->chs[ch];c;c=c->prv){
-    uint64_t cu=c->used, *ci=c->i;
-    for(;cu;cu--,ci++) if(*ci==i) return NULL;
-  }
-  c=m->chs[ch];
-  if(!c || c->used==HASHXCH){
-    if(!(c=(struct fstc_mch*)malloc(sizeof(struct fstc_mch)))) return "Out of memory";
-    c->used=0;
-    c->prv=m->chs[ch];
-    m->chs[ch]=c;
+/* Insert a new entry (the key must not be in the map)
+ *
+ * @param m  Map structure
+ * @param a  State index in left operand
+ * @param e  State index in epsilon filter
+ * @param b  State index in right operand
+ * @param s  Destination state
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *mapins(struct fstc_m *m,UINT32 a,UINT32 e,UINT32 b,struct fstc_s *s){
+  struct fstc_me n;
+  if((uint64_t)(m->used+1)*4>((uint64_t)3<<m->bits)){
+    struct fstc_me *eo=m->e;
+    UINT32 i,no=(UINT32)1<<m->bits;
+    if(m->bits>=31) return FSTCERR("State map overflow");
+    if(!(m->e=(struct fstc_me*)calloc((size_t)2<<m->bits,sizeof(struct fstc_me)))){ m->e=eo; return FSTCERR("Out of memory"); }
+    m->bits++;
+    m->used=0;
+    for(i=0;i<no;i++){
+      if(eo[i].d) mapput(m,eo[i]);
+    }
+    free(eo);
   }
-  c->i[c->used++]=i;
+  n.a=a;
+  n.e=e;
+  n.b=b;
+  n.s=s;
+  mapput(m,n);
   return NULL;
 }
-
-#define MAPINIT(m,na,ne,nb) if((err=mapinit(&(m),na,ne,nb))) return err;
-#define MAPFREE(m)          mapfree(&(m));
-#define MAPGET(m,a,e,b)     mapget(&(m),a,e,b)
-#define MAPSET(m,a,e,b)     if((err=mapset(&(m),a,e,b))) return err;
-
-#endif
@@ -0,0 +1,236 @@
+/* dLabPro class CFst (fst)
+ * - Compact transition store
+ *
+ * AUTHOR : Matthias Wolff
+ * PACKAGE: dLabPro/classes
+ *
+ * Copyright 2013 dLabPro contributors and others (see COPYRIGHT file)
+ * - Chair of System Theory and Speech Technology, TU Dresden
+ * - Chair of Communications Engineering, BTU Cottbus
+ *
+ * This file is part of dLabPro.
+ *
+ * dLabPro is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * dLabPro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dlp_cscope.h" /* Indicate C scope */
+#include "dlp_fst.h"
+
+/*
+ * A compact transition store holds the transitions of one unit as separate,
+ * densely packed arrays of initial states, terminal states, input and output
+ * symbols and weights (structure of arrays). Other components of the
+ * transition table are not copied. The transitions may be ordered by initial
+ * or by terminal states. In this case the store contains the offsets of the
+ * states' transition lists (compressed sparse rows). The store remembers the
+ * transition table record of each transition. Hence it converts back into
+ * the transition table without loss, regardless of the order and the layout
+ * (see CDlpTable_SetColmajor) of the table.
+ */
+
+/**
+ * Internal use. Returns the number of bytes between two successive cells of
+ * a component of the transition table and the address of the cell of the
+ * first transition of the unit packed into a compact transition store.
+ *
+ * @param lpCts Pointer to compact transition store
+ * @param nIc   Component index
+ * @param lpBs  Pointer to a buffer to be filled with the stride
+ * @return The address of the cell or <code>NULL</code> if <code>nIc</code>
+ *         is negative
+ */
+BYTE* CGEN_SPRIVATE CFst_Cts_Col(FST_CTS_TYPE* lpCts, INT32 nIc, INT32* lpBs)
+{
+  CData* idTd = AS(CData,lpCts->iFst->td);
+  if (nIc<0) return NULL;
+  *lpBs = CDlpTable_GetCompStride(idTd->m_lpTable,nIc);
+  return CData_XAddr(idTd,UD_FT(lpCts->iFst,lpCts->nUnit),nIc);
+}
+
+/**
+ * Packs the transitions of one unit into a compact transition store.
+ *
+ * <h3>Remarks</h3>
+ * <ul>
+ *   <li>The input and output symbol arrays (<code>lpTis</code>,
+ *     <code>lpTos</code>) are <code>NULL</code> if the transition table has
+ *     no {@link NC_TD_TIS} or {@link NC_TD_TOS} component. The weight array
+ *     (<code>lpW</code>) is <code>NULL</code> if the automaton is not
+ *     weighted.</li>
+ *   <li>Sorting is stable, i.e. transitions with the same initial (or
+ *     terminal) state keep the order of the transition table.</li>
+ *   <li>The transition table is not modified. Changes of the store are
+ *     written back by {@link Cts_Unpack CFst_Cts_Unpack}.</li>
+ * </ul>
+ *
+ * <h3>Example</h3>
+ * <pre class="code">
+ * FST_CTS_TYPE* lpCts = CFst_Cts_Pack(_this,nUnit,FSTI_SORTINI);
+ * FST_ITYPE     nT    = 0;
+ *
+ * for (nT=lpCts->lpOfs[nS]; nT&lt;lpCts->lpOfs[nS+1]; nT++)
+ * {
+ *   // Process transition from state nS to state lpCts->lpTer[nT]
+ * }
+ * CFst_Cts_Done(lpCts);
+ * </pre>
+ *
+ * @param _this Pointer to automaton instance
+ * @param nUnit Index of unit to pack
+ * @param nMode Order of transitions: {@link FSTI_SORTINI} (by initial
+ *              states), {@link FSTI_SORTTER} (by terminal states) or 0
+ *              (order of transition table, no state offsets)
+ * @return A pointer to the compact transition store or <code>NULL</code> if
+ *         <code>nUnit</code> is invalid. The caller must release the store
+ *         by {@link Cts_Done CFst_Cts_Done}.
+ */
+FST_CTS_TYPE* CGEN_EXPORT CFst_Cts_Pack(CFst* _this, INT32 nUnit, INT16 nMode)
+{
+  FST_CTS_TYPE* lpCts = NULL;                                                   /* Compact transition store           */
+  FST_ITYPE     nXS   = 0;                                                      /* Number of states of unit           */
+  FST_ITYPE     nXT   = 0;                                                      /* Number of transitions of unit      */
+  FST_ITYPE     nT    = 0;                                                      /* Current transition                 */
+  FST_ITYPE     nK    = 0;                                                      /* Sort key (state)                   */
+  INT32         nIcW  = -1;                                                     /* Component index of weight          */
+  INT32         nBs   = 0;                                                      /* Stride of current component        */
+  BYTE*         lpC   = NULL;                                                   /* First cell of current component    */
+  FST_ITYPE*    lpP   = NULL;                                                   /* Insert positions                   */
+
+  /* Validate */                                                                /* --------------------------------- */
+  if (!_this || nUnit<0 || nUnit>=UD_XXU(_this)) return NULL;                   /* No automaton or bad unit          */
+
+  /* Initialize */                                                              /* --------------------------------- */
+  nXS = UD_XS(_this,nUnit);                                                     /* Number of states of unit          */
+  nXT = UD_XT(_this,nUnit);                                                     /* Number of transitions of unit     */
+  CFst_Wsr_GetType(_this,&nIcW);                                                /* Get weight component              */
+  lpCts        = (FST_CTS_TYPE*)dlp_calloc(1,sizeof(FST_CTS_TYPE));             /* Allocate store                    */
+  lpCts->iFst  = _this;                                                         /* Remember automaton                */
+  lpCts->nUnit = nUnit;                                                         /* Remember unit                     */
+  lpCts->nMode = nMode&(FSTI_SORTINI|FSTI_SORTTER);                             /* Remember order                    */
+  lpCts->nXS   = nXS;                                                           /* Number of states                  */
+  lpCts->nXT   = nXT;                                                           /* Number of transitions             */
+  lpCts->nIcTis= CData_FindComp(AS(CData,_this->td),NC_TD_TIS);                 /* Input symbol component            */
+  lpCts->nIcTos= CData_FindComp(AS(CData,_this->td),NC_TD_TOS);                 /* Output symbol component           */
+  lpCts->nIcW  = nIcW;                                                          /* Weight component                  */
+  lpCts->lpTid = (FST_ITYPE*)dlp_calloc(nXT+1,sizeof(FST_ITYPE));               /* Allocate record indices           */
+  lpCts->lpIni = (FST_ITYPE*)dlp_calloc(nXT+1,sizeof(FST_ITYPE));               /* Allocate initial states           */
+  lpCts->lpTer = (FST_ITYPE*)dlp_calloc(nXT+1,sizeof(FST_ITYPE));               /* Allocate terminal states          */
+  if (lpCts->nIcTis>=0)                                                         /* Has input symbols                 */
+    lpCts->lpTis = (FST_STYPE*)dlp_calloc(nXT+1,sizeof(FST_STYPE));             /*   Allocate input symbols          */
+  if (lpCts->nIcTos>=0)                                                         /* Has output symbols                */
+    lpCts->lpTos = (FST_STYPE*)dlp_calloc(nXT+1,sizeof(FST_STYPE));             /*   Allocate output symbols         */
+  if (nIcW>=0)                                                                  /* Is weighted                       */
+    lpCts->lpW   = (FST_WTYPE*)dlp_calloc(nXT+1,sizeof(FST_WTYPE));             /*   Allocate weights                */
+
+  /* Order transitions (stable counting sort) */                                /* --------------------------------- */
+  if (lpCts->nMode)                                                             /* Sorted store                      */
+  {                                                                             /* >>                                */
+    lpCts->lpOfs = (FST_ITYPE*)dlp_calloc(nXS+1,sizeof(FST_ITYPE));             /*   Allocate state offsets          */
+    lpC = CFst_Cts_Col(lpCts,lpCts->nMode&FSTI_SORTINI?IC_TD_INI:IC_TD_TER,&nBs);/*  Sort key component              */
+    for (nT=0; nT<nXT; nT++)                                                    /*   Count transitions per state     */
+    {                                                                           /*   >>                              */
+      nK = *(FST_ITYPE*)(lpC+(size_t)nT*nBs);                                   /*     Key                           */
+      DLPASSERT(nK>=0 && nK<nXS);                                               /*     Invalid state index           */
+      lpCts->lpOfs[nK+1]++;                                                     /*     Count                         */
+    }                                                                           /*   <<                              */
+    for (nK=0; nK<nXS; nK++) lpCts->lpOfs[nK+1]+=lpCts->lpOfs[nK];              /*   Prefix sums                     */
+    lpP = (FST_ITYPE*)dlp_calloc(nXS+1,sizeof(FST_ITYPE));                      /*   Allocate insert positions       */
+    dlp_memmove(lpP,lpCts->lpOfs,nXS*sizeof(FST_ITYPE));                        /*   Start at state offsets          */
+    for (nT=0; nT<nXT; nT++)                                                    /*   Place transitions               */
+      lpCts->lpTid[lpP[*(FST_ITYPE*)(lpC+(size_t)nT*nBs)]++] = nT;              /*   |                               */
+    dlp_free(lpP);                                                              /*   Free insert positions           */
+  }                                                                             /* <<                                */
+  else for (nT=0; nT<nXT; nT++) lpCts->lpTid[nT]=nT;                            /* Transition table order            */
+
+  /* Gather components (one pass per component) */                              /* --------------------------------- */
+  lpC = CFst_Cts_Col(lpCts,IC_TD_INI,&nBs);                                     /* Initial states                    */
+  for (nT=0; nT<nXT; nT++)                                                      /* |                                 */
+    lpCts->lpIni[nT] = *(FST_ITYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs);         /* |                                 */
+  lpC = CFst_Cts_Col(lpCts,IC_TD_TER,&nBs);                                     /* Terminal states                   */
+  for (nT=0; nT<nXT; nT++)                                                      /* |                                 */
+    lpCts->lpTer[nT] = *(FST_ITYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs);         /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcTis,&nBs))!=NULL)                     /* Input symbols                     */
+    for (nT=0; nT<nXT; nT++)                                                    /* |                                 */
+      lpCts->lpTis[nT] = *(FST_STYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs);       /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcTos,&nBs))!=NULL)                     /* Output symbols                    */
+    for (nT=0; nT<nXT; nT++)                                                    /* |                                 */
+      lpCts->lpTos[nT] = *(FST_STYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs);       /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcW,&nBs))!=NULL)                       /* Weights                           */
+    for (nT=0; nT<nXT; nT++)                                                    /* |                                 */
+      lpCts->lpW[nT] = *(FST_WTYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs);         /* |                                 */
+
+  return lpCts;                                                                 /* Return store                      */
+}
+
+/**
+ * Writes a compact transition store back into the transition table of the
+ * automaton it was packed from. Each transition is stored into the record it
+ * was read from. Transition table components not held by the store are not
+ * changed.
+ *
+ * @param lpCts Pointer to compact transition store
+ * @return <code>O_K</code> if successful, <code>NOT_EXEC</code> if the
+ *         number of transitions of the unit has changed since packing
+ */
+INT16 CGEN_EXPORT CFst_Cts_Unpack(FST_CTS_TYPE* lpCts)
+{
+  FST_ITYPE nT  = 0;                                                            /* Current transition                 */
+  INT32     nBs = 0;                                                            /* Stride of current component        */
+  BYTE*     lpC = NULL;                                                         /* First cell of current component    */
+
+  /* Validate */                                                                /* --------------------------------- */
+  if (!lpCts || !lpCts->iFst) return NOT_EXEC;                                  /* No store                          */
+  if (lpCts->nUnit>=UD_XXU(lpCts->iFst)) return NOT_EXEC;                       /* Unit gone                         */
+  if (UD_XT(lpCts->iFst,lpCts->nUnit)!=lpCts->nXT) return NOT_EXEC;             /* Transitions added or removed      */
+
+  /* Scatter components (one pass per component) */                            /* --------------------------------- */
+  lpC = CFst_Cts_Col(lpCts,IC_TD_INI,&nBs);                                     /* Initial states                    */
+  for (nT=0; nT<lpCts->nXT; nT++)                                               /* |                                 */
+    *(FST_ITYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs) = lpCts->lpIni[nT];         /* |                                 */
+  lpC = CFst_Cts_Col(lpCts,IC_TD_TER,&nBs);                                     /* Terminal states                   */
+  for (nT=0; nT<lpCts->nXT; nT++)                                               /* |                                 */
+    *(FST_ITYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs) = lpCts->lpTer[nT];         /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcTis,&nBs))!=NULL)                     /* Input symbols                     */
+    for (nT=0; nT<lpCts->nXT; nT++)                                             /* |                                 */
+      *(FST_STYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs) = lpCts->lpTis[nT];       /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcTos,&nBs))!=NULL)                     /* Output symbols                    */
+    for (nT=0; nT<lpCts->nXT; nT++)                                             /* |                                 */
+      *(FST_STYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs) = lpCts->lpTos[nT];       /* |                                 */
+  if ((lpC = CFst_Cts_Col(lpCts,lpCts->nIcW,&nBs))!=NULL)                       /* Weights                           */
+    for (nT=0; nT<lpCts->nXT; nT++)                                             /* |                                 */
+      *(FST_WTYPE*)(lpC+(size_t)lpCts->lpTid[nT]*nBs) = lpCts->lpW[nT];         /* |                                 */
+
+  return O_K;                                                                   /* Ok                                */
+}
+
+/**
+ * Releases a compact transition store created by {@link Cts_Pack
+ * CFst_Cts_Pack}.
+ *
+ * @param lpCts Pointer to compact transition store (may be <code>NULL</code>)
+ */
+void CGEN_EXPORT CFst_Cts_Done(FST_CTS_TYPE* lpCts)
+{
+  if (!lpCts) return;
+  dlp_free(lpCts->lpTid);
+  dlp_free(lpCts->lpIni);
+  dlp_free(lpCts->lpTer);
+  dlp_free(lpCts->lpTis);
+  dlp_free(lpCts->lpTos);
+  dlp_free(lpCts->lpW);
+  dlp_free(lpCts->lpOfs);
+  dlp_free(lpCts);
+}
+
+/* EOF */
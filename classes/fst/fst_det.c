@@ -538,16 +538,18 @@ BOOL CGEN_PRIVATE CFst_Det_CmpResiduals(CFst* _this, FST_ITYPE nS1, FST_ITYPE nS
     printf("\n       State %ld:",(long)nS2); for (nR2=nFR2; nR2<nFR2+nXR2; nR2++) CFst_Det_PrtResidual(_this,nR2);
   }
 
-  /* MWX 2004-10-27 TODO: Veeeery naive implementation;
-                          compare sorted hash lists instead!  --> */
-  /* MWX 2004-12-02 Problem: how to compare floats with hash lists?? */
-  if(nXR1>*nMapSi) *lpMap=(FST_ITYPE*)dlp_realloc(*lpMap,*nMapSi=nXR1,sizeof(FST_ITYPE));
-  for (i=0; i<nXR1; i++) lpMap[0][i]=-1;
+  /* Candidates are preselected by CFst_Det_FindResiduals, so the quadratic
+     comparison runs on (almost) equal residual sets only. Each residual of
+     nS2 must be matched once (lpMap[0][nXR1..2*nXR1-1] flags the used ones),
+     which makes this a comparison of residual multisets. --> */
+  if(2*nXR1>*nMapSi) *lpMap=(FST_ITYPE*)dlp_realloc(*lpMap,*nMapSi=2*nXR1,sizeof(FST_ITYPE));
+  for (i=0; i<2*nXR1; i++) lpMap[0][i]=-1;
 
   for (nR1=nFR1; nR1<nFR1+nXR1; nR1++)
   {
     for (nR2=nFR2; nR2<nFR2+nXR2; nR2++)
     {
+      if (lpMap[0][nXR1+nR2-nFR2]>=0) continue;
       if (((FST_ITYPE*)(lpDR+nR1*nDRRecLen))[0]!=((FST_ITYPE*)(lpDR+nR2*nDRRecLen))[0]) continue;
       if (((FST_ITYPE*)(lpDR+nR1*nDRRecLen))[1]!=((FST_ITYPE*)(lpDR+nR2*nDRRecLen))[1]) continue;
       if
@@ -565,11 +567,9 @@ BOOL CGEN_PRIVATE CFst_Det_CmpResiduals(CFst* _this, FST_ITYPE nS1, FST_ITYPE nS
       }
 
       /* Lines equal -> write map */
-      if (lpMap[0][nR1-nFR1]==-1)
-      {
-        lpMap[0][nR1-nFR1]=nR2;
-        break;
-      }
+      lpMap[0][nR1-nFR1]=nR2;
+      lpMap[0][nXR1+nR2-nFR2]=nR1;
+      break;
     }
   }
 
@@ -584,6 +584,133 @@ BOOL CGEN_PRIVATE CFst_Det_CmpResiduals(CFst* _this, FST_ITYPE nS1, FST_ITYPE nS
   return (i==nXR1);
 }
 
+int cf_comp_uint32_up(const void* a, const void* b)
+{
+  if (*(const UINT32*)a > *(const UINT32*)b) return  1;
+  if (*(const UINT32*)a < *(const UINT32*)b) return -1;
+  return 0;
+}
+
+/**
+ * Computes the signature of the residual set of a state. The signature is
+ * built from the sorted keys of all residuals of the state, where a key mixes
+ * the source state and the residual string. Residual weights are not part of
+ * the signature because {@link Det_CmpResiduals CFst_Det_CmpResiduals}
+ * compares them with the tolerance of <code>OP_EQUAL</code>. Equal residual
+ * (multi)sets always yield equal signatures, hence the signature can be used
+ * to look up candidates for {@link Det_CmpResiduals CFst_Det_CmpResiduals}.
+ *
+ * @param _this Pointer to automaton instance containing residual table
+ * @param lpRsh Pointer to residual set hash map (provides key buffer)
+ * @param nS    State index
+ * @return The signature
+ */
+UINT32 CGEN_PRIVATE CFst_Det_SigResiduals(CFst* _this, FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS)
+{
+  FST_ITYPE nFR  = 0;                                                          /* First residual of state           */
+  FST_ITYPE nXR  = 0;                                                          /* Number of residuals of state      */
+  FST_ITYPE nR   = 0;                                                          /* Current residual                  */
+  UINT32    nK   = 0;                                                          /* Residual key                      */
+  UINT32    nSig = 0;                                                          /* Signature                         */
+  INT32     i    = 0;                                                          /* Loop counter                      */
+  BYTE*     lpDR;                                                              /* Residual table data pointer       */
+  INT32     nDRRecLen;                                                         /* Residual table record length      */
+
+  lpDR      = AS(CData,_this->m_idDetRt)->m_lpTable->m_theDataPointer;
+  nDRRecLen = AS(CData,_this->m_idDetRt)->m_lpTable->m_reclen;
+  nFR       = *(FST_ITYPE*)(CData_XAddr(AS(CData,_this->sd),nS,_this->m_nIcSdAux  ));
+  nXR       = *(FST_ITYPE*)(CData_XAddr(AS(CData,_this->sd),nS,_this->m_nIcSdAux+1));
+
+  if (nXR>lpRsh->nKSi)
+    lpRsh->lpKey = (UINT32*)dlp_realloc(lpRsh->lpKey,lpRsh->nKSi=nXR,sizeof(UINT32));
+
+  /* Compute residual keys */
+  for (nR=nFR; nR<nFR+nXR; nR++)
+  {
+    nK  = (UINT32)((FST_ITYPE*)(lpDR+nR*nDRRecLen))[0]*0x9E3779B1;
+    nK ^= (UINT32)((FST_ITYPE*)(lpDR+nR*nDRRecLen))[1]*0x85EBCA77 + (nK<<6) + (nK>>2);
+    nK ^= nK>>15; nK *= 0x2C1B3C6D; nK ^= nK>>12;
+    lpRsh->lpKey[nR-nFR] = nK;
+  }
+
+  /* Combine sorted keys (residual order does not matter) */
+  qsort(lpRsh->lpKey,nXR,sizeof(UINT32),cf_comp_uint32_up);
+  for (i=0, nSig=(UINT32)nXR; i<nXR; i++)
+    nSig = (nSig^lpRsh->lpKey[i])*0x01000193;
+
+  return nSig;
+}
+
+/**
+ * Looks up a state whose residual set equals the one of state <code>nS</code>.
+ * Candidates are found by the residual signature and verified by
+ * {@link Det_CmpResiduals CFst_Det_CmpResiduals}. If there is no such state,
+ * <code>nS</code> is stored in the hash map.
+ *
+ * @param _this  Pointer to automaton instance containing residual table
+ * @param lpRsh  Pointer to residual set hash map
+ * @param nS     State index
+ * @param lpMap  Static map for CFst_Det_CmpResiduals (will be reallocated)
+ * @param nMapSi Current size of map (initial: 0)
+ * @return The index of the (lowest) equal state or -1 if there is none
+ */
+FST_ITYPE CGEN_PRIVATE CFst_Det_FindResiduals
+(
+  CFst*             _this,
+  FST_DET_RSH_TYPE* lpRsh,
+  FST_ITYPE         nS,
+  FST_ITYPE**       lpMap,
+  INT32*            nMapSi
+)
+{
+  UINT32    nSig = 0;                                                          /* Signature of state nS             */
+  FST_ITYPE nC   = 0;                                                          /* Candidate state                   */
+  FST_ITYPE nL   = -1;                                                         /* Last state in bucket              */
+  INT32     i    = 0;                                                          /* Loop counter                      */
+
+  nSig = CFst_Det_SigResiduals(_this,lpRsh,nS);
+
+  /* Check candidates (bucket lists are sorted by state index) */
+  for (nC=lpRsh->lpHead[nSig&lpRsh->nMask]; nC>=0; nL=nC, nC=lpRsh->lpNext[nC])
+    if (lpRsh->lpSig[nC]==nSig && CFst_Det_CmpResiduals(_this,nC,nS,lpMap,nMapSi))
+      return nC;
+
+  /* Not found -> store state */
+  if (nS>=lpRsh->nSSi)
+  {
+    lpRsh->nSSi  = 2*nS+64;
+    lpRsh->lpNext = (FST_ITYPE*)dlp_realloc(lpRsh->lpNext,lpRsh->nSSi,sizeof(FST_ITYPE));
+    lpRsh->lpSig  = (UINT32*   )dlp_realloc(lpRsh->lpSig ,lpRsh->nSSi,sizeof(UINT32   ));
+  }
+  lpRsh->lpSig[nS]  = nSig;
+  lpRsh->lpNext[nS] = -1;
+  if (nL>=0) lpRsh->lpNext[nL] = nS;
+  else       lpRsh->lpHead[nSig&lpRsh->nMask] = nS;
+  lpRsh->nCount++;
+
+  /* Grow bucket array (re-insert states in ascending order) */
+  if (lpRsh->nCount>lpRsh->nMask)
+  {
+    FST_ITYPE* lpTail = NULL;
+    lpRsh->nMask  = 2*lpRsh->nMask+1;
+    lpRsh->lpHead = (FST_ITYPE*)dlp_realloc(lpRsh->lpHead,lpRsh->nMask+1,sizeof(FST_ITYPE));
+    lpTail        = (FST_ITYPE*)dlp_calloc(lpRsh->nMask+1,sizeof(FST_ITYPE));
+    for (i=0; i<=lpRsh->nMask; i++) lpRsh->lpHead[i] = lpTail[i] = -1;
+    for (nC=0; nC<=nS; nC++)
+    {
+      if (*(FST_ITYPE*)(CData_XAddr(AS(CData,_this->sd),nC,_this->m_nIcSdAux+1))==0) continue;
+      i = lpRsh->lpSig[nC]&lpRsh->nMask;
+      lpRsh->lpNext[nC] = -1;
+      if (lpTail[i]>=0) lpRsh->lpNext[lpTail[i]] = nC;
+      else              lpRsh->lpHead[i] = nC;
+      lpTail[i] = nC;
+    }
+    dlp_free(lpTail);
+  }
+
+  return -1;
+}
+
 int cf_comp1_itype_up(const void* a, const void* b)
 {
   const FST_ITYPE *ai=(FST_ITYPE*)a;
@@ -595,15 +722,24 @@ int cf_comp1_itype_up(const void* a, const void* b)
 }
 
 /**
- * Determinizes one unit. There are no checks performed.
+ * Determinizes one unit. There are no checks performed. If <code>lpWs</code>
+ * is not <code>NULL</code>, the function uses the tables of the workspace
+ * and may run on a worker thread (see CFst_Units).
  *
  * @param _this Pointer to this (destination) automaton instance
  * @param itSrc Pointer to source automaton instance
  * @param nUnit Index of unit to determinize
+ * @param lpWs  Workspace, may be <code>NULL</code>
  * @return O_K if successfull, a (negative) error code otherwise
  * @see Determinize CFst_Determinize
  */
-INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
+INT16 CGEN_PROTECTED CFst_DeterminizeUnit
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  INT32         nUnit,
+  FST_UWS_TYPE* lpWs
+)
 {
   CData*     idAux   = NULL;           /* Auxilary table for determinization                    */
   FST_ITYPE  nIniDst = 0;              /* Currently processed initial destination state         */
@@ -622,6 +758,8 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
   FST_TID_TYPE* lpTI = NULL;
   FST_ITYPE* lpMap   = NULL;
   INT32      nMapSi  = 0;
+  FST_DET_RSH_TYPE rsh;                /* Residual set hash map                                 */
+  INT32      i       = 0;              /* Loop counter                                          */
 
   IFCHECK
   {
@@ -649,10 +787,18 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
   BASEINST(_this)->m_nCheck = BASEINST(_this)->m_nCheck>BASEINST(itSrc)->m_nCheck?BASEINST(_this)->m_nCheck:BASEINST(itSrc)->m_nCheck;
 
   /* NO RETURNS BEYOND THIS POINT! */
-  ICREATEEX(CData,idAux,"id_det_rt",
-    CDlpObject_FindWord(BASEINST(_this),"det_rt",WL_TYPE_FIELD));
-  _this->m_idDetRt = BASEINST(idAux);
-  ICREATEEX(CData,idAux,"CFst_DeterminizeUnit~idAux",NULL );
+  if (lpWs)
+  {
+    _this->m_idDetRt = BASEINST(lpWs->idDetRt);
+    idAux = lpWs->idDetAux;
+  }
+  else
+  {
+    ICREATEEX(CData,idAux,"id_det_rt",
+      CDlpObject_FindWord(BASEINST(_this),"det_rt",WL_TYPE_FIELD));
+    _this->m_idDetRt = BASEINST(idAux);
+    ICREATEEX(CData,idAux,"CFst_DeterminizeUnit~idAux",NULL );
+  }
   _this->m_lpDetSt = CFst_Ssr_Init(_this->m_nGrany);
   lpTI = CFst_STI_Init(itSrc,nUnit,FSTI_SORTINI);                              /* Sorted transition iterator        */
   DLPASSERT(lpTI->nOfTTis>0);
@@ -664,6 +810,13 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
   /* Create start residual(s) */
   CFst_Det_AddResidual(_this,0,0,-1,CFst_Wsr_NeMult(_this->m_nWsr));           /* Residual of start state           */
 
+  /* Initialize residual set hash map */
+  dlp_memset(&rsh,0,sizeof(FST_DET_RSH_TYPE));
+  rsh.nMask  = 255;
+  rsh.lpHead = (FST_ITYPE*)dlp_malloc((rsh.nMask+1)*sizeof(FST_ITYPE));
+  for (i=0; i<=rsh.nMask; i++) rsh.lpHead[i]=-1;
+  CFst_Det_FindResiduals(_this,&rsh,0,&lpMap,&nMapSi);
+
   /* Build destination transducer */
   for (nIniDst=0; nIniDst<UD_XS(_this,0); nIniDst++)
   {
@@ -752,20 +905,18 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
           /* Check last new destination state
              (try to find previously generated identical state) */
           IFCHECK printf("\n       Comparing state residual tables (states *<-->%ld)",(long)UD_XS(_this,0)-1);
-          for (nS=0; nS<UD_XS(_this,0)-1; nS++)
-            if (CFst_Det_CmpResiduals(_this,nS,UD_XS(_this,0)-1,&lpMap,&nMapSi))
-            {
-              IFCHECK printf("\n       State %ld identified as state %ld --> removing copy",(long)UD_XS(_this,0)-1,(long)nS);
+          if ((nS=CFst_Det_FindResiduals(_this,&rsh,UD_XS(_this,0)-1,&lpMap,&nMapSi))>=0)
+          {
+            IFCHECK printf("\n       State %ld identified as state %ld --> removing copy",(long)UD_XS(_this,0)-1,(long)nS);
 
-              /* Modify last new transition */
-              TD_TER(_this,nTDst)=nS;
+            /* Modify last new transition */
+            TD_TER(_this,nTDst)=nS;
 
-              /* Delete last new state and its residual table */
-              UD_XS(_this,0)--;
-              CData_IncNRecs(AS(CData,_this->sd),-1);
-              CData_IncNRecs(AS(CData,_this->m_idDetRt),nR-nFR+1);
-              break;
-            }
+            /* Delete last new state and its residual table */
+            UD_XS(_this,0)--;
+            CData_IncNRecs(AS(CData,_this->sd),-1);
+            CData_IncNRecs(AS(CData,_this->m_idDetRt),nR-nFR+1);
+          }
 
           /* Reset string and weight sums */
           nSumStr = CFst_Ssr_NeAdd();
@@ -795,10 +946,17 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
 
   /* Clean up */
   dlp_free(lpMap);
+  dlp_free(rsh.lpHead);
+  dlp_free(rsh.lpNext);
+  dlp_free(rsh.lpSig);
+  dlp_free(rsh.lpKey);
   CFst_STI_Done(lpTI);
-  IDESTROY(idAux);
-  idAux=AS(CData,_this->m_idDetRt);
-  IDESTROY(idAux);
+  if (!lpWs)
+  {
+    IDESTROY(idAux);
+    idAux=AS(CData,_this->m_idDetRt);
+    IDESTROY(idAux);
+  }
   CFst_Ssr_Done(_this->m_lpDetSt);
   _this->m_lpDetSt = NULL;
   _this->m_idDetRt = NULL;
@@ -806,13 +964,26 @@ INT16 CGEN_PROTECTED CFst_DeterminizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
   return O_K;
 }
 
+/**
+ * Unit operation of {@link Determinize CFst_Determinize} (see CFst_Units).
+ */
+static INT16 CFst_Det_UnitFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  return CFst_DeterminizeUnit(_this,itSrc,0,lpWs);
+}
+
 /*
  * Manual page at fst_man.def
  */
 INT16 CGEN_PUBLIC CFst_Determinize(CFst* _this, CFst* itSrc, INT32 nUnit)
 {
-  CFst* itUnit = NULL;                                                         /* Current unit                      */
-  INT32  nU     = 0;                                                            /* Current unit index                */
+  INT16 nErr = O_K;                                                            /* Error code                        */
 
   /* Validation */
   CHECK_THIS_RV(NOT_EXEC);
@@ -823,59 +994,418 @@ INT16 CGEN_PUBLIC CFst_Determinize(CFst* _this, CFst* itSrc, INT32 nUnit)
   /* NO RETURNS BEYOND THIS POINT! */
   CREATEVIRTUAL(CFst,itSrc,_this);
   CFst_Reset(BASEINST(_this),TRUE);
-  if (nUnit<0) { ICREATEEX(CFst,itUnit,"CFst_Determinize~itUnit",NULL); }
-  else         itUnit = _this;
-
-  if (BASEINST(_this)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(_this)->m_nCheck;
-  if (BASEINST(itSrc)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(itSrc)->m_nCheck;
 
   /* Determinize units */
-  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(itSrc); nU++)
+  if (nUnit>=0)
   {
-    CFst_DeterminizeUnit(itUnit,itSrc,nU);
-    if (nUnit>=0) break;
-    CFst_Cat(_this,itUnit);
+    if (BASEINST(itSrc)->m_nCheck>BASEINST(_this)->m_nCheck) BASEINST(_this)->m_nCheck=BASEINST(itSrc)->m_nCheck;
+    CFst_DeterminizeUnit(_this,itSrc,nUnit,NULL);
   }
+  else if ((nErr=CFst_Units(_this,itSrc,CFst_Det_UnitFunc,NULL,FALSE))!=O_K)
+    IERROR(_this,nErr==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
 
   /* Copy input and output symbol tables */
   CData_Copy(_this->is,itSrc->is);
   CData_Copy(_this->os,itSrc->os);
 
   /* Clean up */
-  DLPASSERT(itUnit->m_lpDetSt==NULL);                                          /* String table not destroyed        */
-  DLPASSERT(itUnit->m_idDetRt==NULL);                                          /* Residual table not destroyed      */
-  if (nUnit<0) IDESTROY(itUnit);
+  DLPASSERT(_this->m_lpDetSt==NULL);                                           /* String table not destroyed        */
+  DLPASSERT(_this->m_idDetRt==NULL);                                           /* Residual table not destroyed      */
   DESTROYVIRTUAL(itSrc,_this);
   CFst_Check(_this);                                                           /* TODO: Remove after debugging      */
-  return O_K;
+  return nErr;
 }
 
 /**
- * Minimizes one unit. There are no checks performed.
+ * Minimizes one unit. There are no checks performed and an empty unit is not
+ * reported. If <code>lpWs</code> is not <code>NULL</code>, the function uses
+ * the auxiliary automaton and the tables of the workspace and may run on a
+ * worker thread (see CFst_Units).
  *
  * @param _this Pointer to this (destination) automaton instance
  * @param itSrc Pointer to source automaton instance
  * @param nUnit Index of unit to minimize
- * @return O_K if successfull, a (negative) error code otherwise
+ * @param lpWs  Workspace, may be <code>NULL</code>
+ * @return O_K if successfull, FST_UNITEMPTY if the unit has no transitions
+ *         left after trimming, a (negative) error code otherwise
  * @see Minimize CFst_Minimize
  */
-INT16 CGEN_PROTECTED CFst_MinimizeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
+INT16 CGEN_PROTECTED CFst_MinimizeUnit
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  INT32         nUnit,
+  FST_UWS_TYPE* lpWs
+)
 {
   CFst* itAux  = NULL;
   INT16 nErr   = O_K;
+  INT16 nRet   = O_K;
 
-  ICREATEEX(CFst,itAux,"CFst_MinimizeUnit~itAux",NULL);
+  if (lpWs) itAux = lpWs->itAux;
+  else ICREATEEX(CFst,itAux,"CFst_MinimizeUnit~itAux",NULL);
 
   if(_this!=itSrc) CFst_CopyUi(_this,itSrc,NULL,nUnit);
-  CFst_Reverse(_this,0);
-  IF_OK((nErr = CFst_DeterminizeUnit(itAux,_this,0)))
+  nRet = CFst_ReverseUnit(_this,0);
+  IF_OK((nErr = CFst_DeterminizeUnit(itAux,_this,0,lpWs)))
   {
-    CFst_Reverse(itAux,0);
-    nErr = CFst_DeterminizeUnit(_this,itAux,0);
+    CFst_ReverseUnit(itAux,0);
+    nErr = CFst_DeterminizeUnit(_this,itAux,0,lpWs);
   }
 
-  IDESTROY(itAux);
-  return nErr;
+  if (!lpWs) IDESTROY(itAux);
+  return nErr!=O_K ? nErr : nRet;
+}
+
+/**
+ * Initializes a refinable set partition of the elements 0..<code>nElems</code>-1.
+ *
+ * @param _this    Pointer to automaton instance
+ * @param lpPrt    Pointer to partition struct
+ * @param nElems   Number of elements
+ * @param lpClass  Initial set of each element (0..<code>nClasses</code>-1)
+ * @param nClasses Number of initial sets
+ * @see Prt_Done CFst_Prt_Done
+ */
+void CGEN_PRIVATE CFst_Prt_Init
+(
+  CFst*         _this,
+  FST_PRT_TYPE* lpPrt,
+  INT32         nElems,
+  INT32*        lpClass,
+  INT32         nClasses
+)
+{
+  INT32 nE = 0;                                                                /* Current element                   */
+  INT32 nC = 0;                                                                /* Current set                       */
+  INT32 nN = nElems>0 ? nElems : 1;                                            /* Allocation size                   */
+
+  lpPrt->nSets = nClasses;
+  lpPrt->nW    = 0;
+  lpPrt->lpE   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpL   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpS   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpF   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpP   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpM   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+  lpPrt->lpW   = (INT32*)dlp_calloc(nN,sizeof(INT32));
+
+  /* Counting sort of elements by initial set */
+  for (nE=0; nE<nElems; nE++) lpPrt->lpP[lpClass[nE]]++;
+  for (nC=0, nE=0; nC<nClasses; nC++)
+  {
+    lpPrt->lpF[nC]  = nE;
+    nE             += lpPrt->lpP[nC];
+    lpPrt->lpP[nC]  = lpPrt->lpF[nC];
+  }
+  for (nE=0; nE<nElems; nE++)
+  {
+    nC = lpClass[nE];
+    lpPrt->lpS[nE] = nC;
+    lpPrt->lpL[nE] = lpPrt->lpP[nC];
+    lpPrt->lpE[lpPrt->lpP[nC]++] = nE;
+  }
+}
+
+/**
+ * Frees the memory of a refinable set partition.
+ *
+ * @param _this Pointer to automaton instance
+ * @param lpPrt Pointer to partition struct
+ * @see Prt_Init CFst_Prt_Init
+ */
+void CGEN_PRIVATE CFst_Prt_Done(CFst* _this, FST_PRT_TYPE* lpPrt)
+{
+  dlp_free(lpPrt->lpE);
+  dlp_free(lpPrt->lpL);
+  dlp_free(lpPrt->lpS);
+  dlp_free(lpPrt->lpF);
+  dlp_free(lpPrt->lpP);
+  dlp_free(lpPrt->lpM);
+  dlp_free(lpPrt->lpW);
+}
+
+/**
+ * Marks an element of a refinable set partition. Marked elements are moved to
+ * the front of their set.
+ *
+ * @param lpPrt Pointer to partition struct
+ * @param nE    Element to mark
+ * @see Prt_Split CFst_Prt_Split
+ */
+void CGEN_SPRIVATE CFst_Prt_Mark(FST_PRT_TYPE* lpPrt, INT32 nE)
+{
+  INT32 nS = lpPrt->lpS[nE];                                                   /* Set of element                    */
+  INT32 i  = lpPrt->lpL[nE];                                                   /* Location of element               */
+  INT32 j  = lpPrt->lpF[nS]+lpPrt->lpM[nS];                                    /* First unmarked location in set    */
+
+  if (i<j) return;                                                             /* Already marked                    */
+  lpPrt->lpE[i] = lpPrt->lpE[j]; lpPrt->lpL[lpPrt->lpE[i]] = i;
+  lpPrt->lpE[j] = nE;            lpPrt->lpL[nE]            = j;
+  if (!lpPrt->lpM[nS]++) lpPrt->lpW[lpPrt->nW++] = nS;
+}
+
+/**
+ * Splits all sets containing marked elements into the marked and the unmarked
+ * part. The smaller part becomes a new set which is appended to the partition.
+ * All marks are cleared.
+ *
+ * @param lpPrt Pointer to partition struct
+ * @see Prt_Mark CFst_Prt_Mark
+ */
+void CGEN_SPRIVATE CFst_Prt_Split(FST_PRT_TYPE* lpPrt)
+{
+  INT32 nS = 0;                                                                /* Set to split                      */
+  INT32 nZ = 0;                                                                /* New set                           */
+  INT32 i  = 0;                                                                /* Location in lpE                   */
+  INT32 j  = 0;                                                                /* First unmarked location in set    */
+
+  while (lpPrt->nW)
+  {
+    nS = lpPrt->lpW[--lpPrt->nW];
+    j  = lpPrt->lpF[nS]+lpPrt->lpM[nS];
+    if (j==lpPrt->lpP[nS]) { lpPrt->lpM[nS]=0; continue; }                     /* All elements marked -> no split   */
+    nZ = lpPrt->nSets++;
+    if (lpPrt->lpM[nS]<=lpPrt->lpP[nS]-j)
+    {
+      lpPrt->lpF[nZ] = lpPrt->lpF[nS];                                         /* Marked part is new set            */
+      lpPrt->lpP[nZ] = lpPrt->lpF[nS] = j;
+    }
+    else
+    {
+      lpPrt->lpP[nZ] = lpPrt->lpP[nS];                                         /* Unmarked part is new set          */
+      lpPrt->lpF[nZ] = lpPrt->lpP[nS] = j;
+    }
+    for (i=lpPrt->lpF[nZ]; i<lpPrt->lpP[nZ]; i++) lpPrt->lpS[lpPrt->lpE[i]] = nZ;
+    lpPrt->lpM[nS] = lpPrt->lpM[nZ] = 0;
+  }
+}
+
+int cf_comp_prk_up(const void* a, const void* b)
+{
+  const FST_PRK_TYPE* ak = (const FST_PRK_TYPE*)a;
+  const FST_PRK_TYPE* bk = (const FST_PRK_TYPE*)b;
+  int nCmp = memcmp(ak->lpK,bk->lpK,ak->nLen);
+  if (nCmp) return nCmp;
+  return ak->nId - bk->nId;
+}
+
+/**
+ * Classifies table records by their contents. Records with equal bytes at
+ * <code>nOffs</code>..<code>nRecLen</code>-1 are put into the same class.
+ *
+ * @param lpKey   Sort key buffer (at least <code>nRecs</code> entries)
+ * @param lpData  Pointer to first record
+ * @param nRecs   Number of records
+ * @param nRecLen Record length in bytes
+ * @param nOffs   Offset of first key byte in record
+ * @param lpClass Filled with the class of each record
+ * @return The number of classes
+ */
+INT32 CGEN_SPRIVATE CFst_Prt_Classify
+(
+  FST_PRK_TYPE* lpKey,
+  BYTE*         lpData,
+  INT32         nRecs,
+  INT32         nRecLen,
+  INT32         nOffs,
+  INT32*        lpClass
+)
+{
+  INT32 i  = 0;                                                                /* Current record                    */
+  INT32 nC = 0;                                                                /* Number of classes                 */
+
+  for (i=0; i<nRecs; i++)
+  {
+    lpKey[i].lpK  = lpData+i*nRecLen+nOffs;
+    lpKey[i].nLen = nRecLen-nOffs;
+    lpKey[i].nId  = i;
+  }
+  qsort(lpKey,nRecs,sizeof(FST_PRK_TYPE),cf_comp_prk_up);
+  for (i=0; i<nRecs; i++)
+  {
+    if (i>0 && memcmp(lpKey[i].lpK,lpKey[i-1].lpK,lpKey[i].nLen)) nC++;
+    lpClass[lpKey[i].nId] = nC;
+  }
+  return nRecs>0 ? nC+1 : 0;
+}
+
+/**
+ * Minimizes one deterministic unit by partition refinement (Hopcroft's
+ * algorithm for partial transition functions after Valmari and Lehtinen).
+ * Transitions are labeled by the contents of all their data components (input
+ * and output symbols, weights, etc.), the initial partition of the states is
+ * given by the contents of their state table records. Unconnected states are
+ * removed beforehand. If the unit is not deterministic with respect to these
+ * labels, the method falls back to {@link MinimizeUnit CFst_MinimizeUnit}.
+ * There are no checks performed. If <code>lpWs</code> is not
+ * <code>NULL</code>, the fallback uses the workspace and the function may run
+ * on a worker thread (see CFst_Units).
+ *
+ * @param _this Pointer to this (destination) automaton instance
+ * @param itSrc Pointer to source automaton instance
+ * @param nUnit Index of unit to minimize
+ * @param lpWs  Workspace, may be <code>NULL</code>
+ * @return O_K if successfull, a (negative) error code otherwise (see
+ *         {@link MinimizeUnit CFst_MinimizeUnit})
+ * @see Minimize CFst_Minimize
+ */
+INT16 CGEN_PROTECTED CFst_HopcroftUnit
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  INT32         nUnit,
+  FST_UWS_TYPE* lpWs
+)
+{
+  FST_PRT_TYPE  B;                     /* Partition of states (blocks)                          */
+  FST_PRT_TYPE  C;                     /* Partition of transitions (cords)                      */
+  FST_PRK_TYPE* lpKey   = NULL;        /* Sort key buffer                                       */
+  INT32*        lpSC    = NULL;        /* Initial class of states / new state index of blocks   */
+  INT32*        lpTC    = NULL;        /* Initial class of transitions                          */
+  INT32*        lpAF    = NULL;        /* First adjacent transition of states                   */
+  INT32*        lpA     = NULL;        /* Adjacent transitions                                  */
+  INT32*        lpRep   = NULL;        /* Representative state of blocks / last state of class  */
+  INT32         nXS     = 0;           /* Number of states                                      */
+  INT32         nXT     = 0;           /* Number of transitions                                 */
+  INT32         nSC     = 0;           /* Number of initial state classes                       */
+  INT32         nTC     = 0;           /* Number of transition labels                           */
+  INT32         nS      = 0;           /* Current state                                         */
+  INT32         nT      = 0;           /* Current transition                                    */
+  INT32         nB      = 0;           /* Current block                                         */
+  INT32         nC      = 0;           /* Current cord                                          */
+  INT32         nXB     = 0;           /* Number of blocks in result                            */
+  INT32         nXR     = 0;           /* Number of transitions in result                       */
+  INT32         i       = 0;           /* Loop counter                                          */
+  INT32         j       = 0;           /* Loop counter                                          */
+  BOOL          bDet    = TRUE;        /* Unit is deterministic                                 */
+  BYTE*         lpSD    = NULL;        /* State table data                                      */
+  BYTE*         lpTD    = NULL;        /* Transition table data                                 */
+  INT32         nRls    = 0;           /* State table record length                             */
+  INT32         nRlt    = 0;           /* Transition table record length                        */
+  INT32         nOfI    = 0;           /* Offset of initial state in transition record          */
+  INT32         nOfT    = 0;           /* Offset of terminal state in transition record         */
+  INT32         nOfK    = 0;           /* Offset of transition label in transition record       */
+
+  if (_this!=itSrc) CFst_CopyUi(_this,itSrc,NULL,nUnit);
+  CFst_TrimStates(_this,0);                                                    /* Remove unconnected states         */
+  nXS = UD_XS(_this,0);
+  nXT = UD_XT(_this,0);
+  if (nXS==0) return O_K;
+
+  IFCHECK printf("\n   Unit %ld: %ld states, %ld transitions",(long)nUnit,(long)nXS,(long)nXT);
+
+  lpSD = CData_XAddr(AS(CData,_this->sd),0,0);
+  lpTD = CData_XAddr(AS(CData,_this->td),0,0);
+  nRls = CData_GetRecLen(AS(CData,_this->sd));
+  nRlt = CData_GetRecLen(AS(CData,_this->td));
+  nOfI = CData_GetCompOffset(AS(CData,_this->td),IC_TD_INI);
+  nOfT = CData_GetCompOffset(AS(CData,_this->td),IC_TD_TER);
+  nOfK = CData_GetNComps(AS(CData,_this->td))>IC_TD_DATA
+       ? CData_GetCompOffset(AS(CData,_this->td),IC_TD_DATA) : nRlt;
+
+  /* Initial partitions: states by state table record, transitions by label */
+  lpKey = (FST_PRK_TYPE*)dlp_calloc(MAX(nXS,nXT)+1,sizeof(FST_PRK_TYPE));
+  lpSC  = (INT32*)dlp_calloc(nXS+1,sizeof(INT32));
+  lpTC  = (INT32*)dlp_calloc(nXT+1,sizeof(INT32));
+  lpAF  = (INT32*)dlp_calloc(nXS+1,sizeof(INT32));
+  lpA   = (INT32*)dlp_calloc(nXT+1,sizeof(INT32));
+  lpRep = (INT32*)dlp_calloc(MAX(nXS,nXT)+1,sizeof(INT32));
+  nSC   = CFst_Prt_Classify(lpKey,lpSD,nXS,nRls,0,lpSC);
+  nTC   = CFst_Prt_Classify(lpKey,lpTD,nXT,nRlt,nOfK,lpTC);
+  dlp_free(lpKey);
+
+  /* Check determinism (no two transitions with equal label leaving a state) */
+  for (nT=0; nT<nXT; nT++) lpAF[*(FST_ITYPE*)(lpTD+nT*nRlt+nOfI)+1]++;
+  for (nS=0; nS<nXS; nS++) lpAF[nS+1]+=lpAF[nS];
+  for (nT=0; nT<nXT; nT++) lpA[lpAF[*(FST_ITYPE*)(lpTD+nT*nRlt+nOfI)]++]=nT;
+  for (nS=nXS; nS>0; nS--) lpAF[nS]=lpAF[nS-1];
+  lpAF[0]=0;
+  for (nC=0; nC<nTC; nC++) lpRep[nC]=-1;
+  for (nS=0; nS<nXS && bDet; nS++)
+    for (i=lpAF[nS]; i<lpAF[nS+1]; i++)
+    {
+      if (lpRep[lpTC[lpA[i]]]==nS) { bDet=FALSE; break; }
+      lpRep[lpTC[lpA[i]]]=nS;
+    }
+  if (!bDet)
+  {
+    IFCHECK printf("\n   Unit %ld is not deterministic -> using CFst_MinimizeUnit",(long)nUnit);
+    dlp_free(lpSC);
+    dlp_free(lpTC);
+    dlp_free(lpAF);
+    dlp_free(lpA);
+    dlp_free(lpRep);
+    return CFst_MinimizeUnit(_this,_this,0,lpWs);
+  }
+
+  /* Index incoming transitions of states */
+  dlp_memset(lpAF,0,(nXS+1)*sizeof(INT32));
+  for (nT=0; nT<nXT; nT++) lpAF[*(FST_ITYPE*)(lpTD+nT*nRlt+nOfT)+1]++;
+  for (nS=0; nS<nXS; nS++) lpAF[nS+1]+=lpAF[nS];
+  for (nT=0; nT<nXT; nT++) lpA[lpAF[*(FST_ITYPE*)(lpTD+nT*nRlt+nOfT)]++]=nT;
+  for (nS=nXS; nS>0; nS--) lpAF[nS]=lpAF[nS-1];
+  lpAF[0]=0;
+
+  /* Refine partitions */
+  CFst_Prt_Init(_this,&B,nXS,lpSC,nSC);
+  CFst_Prt_Init(_this,&C,nXT,lpTC,nTC);
+  for (nB=1, nC=0; nC<C.nSets; nC++)
+  {
+    /* Split blocks by source states of cord */
+    for (i=C.lpF[nC]; i<C.lpP[nC]; i++)
+      CFst_Prt_Mark(&B,*(FST_ITYPE*)(lpTD+C.lpE[i]*nRlt+nOfI));
+    CFst_Prt_Split(&B);
+
+    /* Split cords by new blocks */
+    for ( ; nB<B.nSets; nB++)
+    {
+      for (i=B.lpF[nB]; i<B.lpP[nB]; i++)
+        for (j=lpAF[B.lpE[i]]; j<lpAF[B.lpE[i]+1]; j++)
+          CFst_Prt_Mark(&C,lpA[j]);
+      CFst_Prt_Split(&C);
+    }
+  }
+  CFst_Prt_Done(_this,&C);
+
+  IFCHECK printf("\n   Unit %ld: %ld states after minimization",(long)nUnit,(long)B.nSets);
+
+  /* Number blocks by their first state (start state remains 0) and compact state table */
+  for (nB=0; nB<B.nSets; nB++) lpSC[nB]=-1;
+  for (nS=0, nXB=0; nS<nXS; nS++)
+  {
+    nB = B.lpS[nS];
+    if (lpSC[nB]>=0) continue;
+    lpSC[nB]  = nXB;
+    lpRep[nB] = nS;
+    if (nXB<nS) dlp_memmove(lpSD+nXB*nRls,lpSD+nS*nRls,nRls);
+    nXB++;
+  }
+
+  /* Keep transitions leaving representative states and compact transition table */
+  for (nT=0, nXR=0; nT<nXT; nT++)
+  {
+    nS = *(FST_ITYPE*)(lpTD+nT*nRlt+nOfI);
+    nB = B.lpS[nS];
+    if (lpRep[nB]!=nS) continue;
+    if (nXR<nT) dlp_memmove(lpTD+nXR*nRlt,lpTD+nT*nRlt,nRlt);
+    *(FST_ITYPE*)(lpTD+nXR*nRlt+nOfI) = lpSC[nB];
+    *(FST_ITYPE*)(lpTD+nXR*nRlt+nOfT) = lpSC[B.lpS[*(FST_ITYPE*)(lpTD+nXR*nRlt+nOfT)]];
+    nXR++;
+  }
+  CData_SetNRecs(AS(CData,_this->sd),nXB);
+  CData_SetNRecs(AS(CData,_this->td),nXR);
+  UD_XS(_this,0) = nXB;
+  UD_XT(_this,0) = nXR;
+
+  /* Clean up */
+  CFst_Prt_Done(_this,&B);
+  dlp_free(lpSC);
+  dlp_free(lpTC);
+  dlp_free(lpAF);
+  dlp_free(lpA);
+  dlp_free(lpRep);
+  return O_K;
 }
 
 /*
@@ -1038,10 +1568,45 @@ INT16 CGEN_PROTECTED CFst_Lazymin(CFst* _this)
   dlp_free(rT);
   dlp_free(rS);
 
-  /* Delete unused states and transitions */
+  /* Delete unused states and transitions (empty unit is reported by caller) */
   _this->m_bLocal=TRUE;
-  CFst_Trim(_this,0,0);
+  return CFst_TrimUnit(_this,0,0.);
+}
+
+/**
+ * Arguments of the unit operation of {@link Minimize CFst_Minimize}.
+ */
+typedef struct fst_min_args
+{
+  BOOL   bLazy;                                                                /* Lazy minimization                 */
+  BOOL   bHopcroft;                                                            /* Hopcroft's algorithm              */
+  INT16* lpErr;                                                                /* Per unit: deferred warning        */
+} FST_MIN_ARGS;
+
+/**
+ * Unit operation of {@link Minimize CFst_Minimize} (see CFst_Units). Empty
+ * units are stored in the deferred warnings and reported by the caller.
+ */
+static INT16 CFst_Min_UnitFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  FST_MIN_ARGS* lpA  = (FST_MIN_ARGS*)lpArg;                                   /* Arguments                         */
+  INT16         nErr = O_K;                                                    /* Error code                        */
 
+  if (lpA->bLazy)
+  {
+    CFst_CopyUi(_this,itSrc,NULL,0);
+    nErr = CFst_Lazymin(_this);
+  }
+  else if (lpA->bHopcroft) nErr = CFst_HopcroftUnit(_this,itSrc,0,lpWs);
+  else nErr = CFst_MinimizeUnit(_this,itSrc,0,lpWs);
+  if (nErr!=FST_UNITEMPTY) return nErr;
+  lpA->lpErr[lpWs->nUnit] = nErr;
   return O_K;
 }
 
@@ -1050,48 +1615,54 @@ INT16 CGEN_PROTECTED CFst_Lazymin(CFst* _this)
  */
 INT16 CGEN_PUBLIC CFst_Minimize(CFst* _this, CFst* itSrc, INT32 nUnit)
 {
-  CFst* itUnit = NULL;                                                         /* Current unit                      */
-  INT32  nU     = 0;                                                            /* Current unit index                */
-  BOOL  bLazy;
+  FST_MIN_ARGS rA;                                                             /* Arguments of unit operation       */
+  INT32        nU   = 0;                                                       /* Current unit index                */
+  INT16        nErr = O_K;                                                     /* Error code                        */
 
   /* Validation */
   CHECK_THIS_RV(NOT_EXEC);
   CFst_Check(_this);
   CFst_Check(itSrc);
   if (nUnit>=UD_XXU(itSrc)) return IERROR(_this,FST_BADID,"unit",nUnit,0);
-  bLazy = _this->m_bLazy;
+  rA.bLazy     = _this->m_bLazy;
+  rA.bHopcroft = _this->m_bHopcroft;
+  rA.lpErr     = NULL;
 
   /* NO RETURNS BEYOND THIS POINT! */
   CREATEVIRTUAL(CFst,itSrc,_this);
   CFst_Reset(BASEINST(_this),TRUE);
-  if (nUnit<0) { ICREATEEX(CFst,itUnit,"CFst_Minimize~itUnit",NULL); }
-  else         itUnit = _this;
-
-  if (BASEINST(_this)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(_this)->m_nCheck;
-  if (BASEINST(itSrc)->m_nCheck>BASEINST(itUnit)->m_nCheck) BASEINST(itUnit)->m_nCheck=BASEINST(itSrc)->m_nCheck;
 
   /* Minimize units */
-  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(itSrc); nU++)
+  if (nUnit>=0)
   {
-    if(bLazy)
+    if (BASEINST(itSrc)->m_nCheck>BASEINST(_this)->m_nCheck) BASEINST(_this)->m_nCheck=BASEINST(itSrc)->m_nCheck;
+    if (rA.bLazy)
     {
-      CFst_CopyUi(itUnit,itSrc,NULL,nU);
-      CFst_Lazymin(itUnit);
+      CFst_CopyUi(_this,itSrc,NULL,nUnit);
+      nErr = CFst_Lazymin(_this);
     }
-    else CFst_MinimizeUnit(itUnit,itSrc,nU);
-    if (nUnit>=0) break;
-    CFst_Cat(_this,itUnit);
+    else if (rA.bHopcroft) nErr = CFst_HopcroftUnit(_this,itSrc,nUnit,NULL);
+    else nErr = CFst_MinimizeUnit(_this,itSrc,nUnit,NULL);
+    if (nErr==FST_UNITEMPTY) { IERROR(_this,FST_UNITEMPTY,nUnit,0,0); nErr = O_K; }
   }
+  else if (!(rA.lpErr = (INT16*)dlp_calloc(UD_XXU(itSrc),sizeof(INT16))))
+    nErr = IERROR(_this,ERR_NOMEM,0,0,0);
+  else if ((nErr=CFst_Units(_this,itSrc,CFst_Min_UnitFunc,&rA,FALSE))!=O_K)
+    IERROR(_this,nErr==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
+  else
+    for (nU=0; nU<UD_XXU(itSrc); nU++)
+      if (rA.lpErr[nU]==FST_UNITEMPTY)
+        IERROR(_this,FST_UNITEMPTY,nU,0,0);
 
   /* Copy input and output symbol tables */
   CData_Copy(_this->is,itSrc->is);
   CData_Copy(_this->os,itSrc->os);
 
   /* Clean up */
-  if (nUnit<0) IDESTROY(itUnit);
+  dlp_free(rA.lpErr);
   DESTROYVIRTUAL(itSrc,_this);
   CFst_Check(_this);                                                           /* TODO: Remove after debugging      */
-  return O_K;
+  return nErr;
 }
 
 /* EOF */
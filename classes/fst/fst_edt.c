@@ -538,12 +538,20 @@ INT16 CGEN_PUBLIC CFst_Deltrans(CFst* _this, INT32 nUnit, INT32 nTrans)
   return O_K;
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Reverses one unit. Called by {@link Reverse CFst_Reverse} and
+ * {@link MinimizeUnit CFst_MinimizeUnit}. The function does not report an
+ * empty unit but returns an error code instead. Without the option
+ * <code>/psr</code> it creates no instances and may run on a worker thread
+ * (see CFst_Units).
+ *
+ * @param _this Pointer to automaton instance
+ * @param nU    Index of unit to reverse
+ * @return O_K if successfull, FST_UNITEMPTY if no transitions are left after
+ *         unifying the final states
  */
-INT16 CGEN_PUBLIC CFst_Reverse(CFst* _this, INT32 nUnit)
+INT16 CGEN_PROTECTED CFst_ReverseUnit(CFst* _this, INT32 nU)
 {
-  INT32      nU             = 0;                                                /* Current unit                       */
   FST_ITYPE nS             = 0;                                                /* Current state                      */
   FST_ITYPE nFS            = 0;                                                /* First state of current unit        */
   FST_ITYPE nXS            = 0;                                                /* Number of states of current unit   */
@@ -553,61 +561,77 @@ INT16 CGEN_PUBLIC CFst_Reverse(CFst* _this, INT32 nUnit)
   FST_ITYPE nIni           = 0;                                                /* Initial state of curr. transition  */
   FST_ITYPE nTer           = 0;                                                /* Terminal state of curr. transition */
   FST_ITYPE nAbsFinalState = 0;                                                /* The unified final state            */
-  INT32      nIcRcs         = -1;                                               /* Index of ref. ctr. component in sd */
-  INT32      nIcRct         = -1;                                               /* Index of ref. ctr. component in td */
+  INT16     nErr           = O_K;                                              /* Error code                         */
 
-  /* Validation*/
-  CHECK_THIS_RV(NOT_EXEC);
-  CFst_Check(_this);
+  /* Make sure there is a single final state */
+  if(!_this->m_bPsr) _this->m_bLocal=TRUE;                                     /* set local option to prevent trim from changing probabilities */
+  CFst_FsunifyUnit(_this,nU);
+  nErr = CFst_TrimUnit(_this,nU,0.);
+  if (!_this->m_bLocal && CFst_Wsr_GetType(_this,NULL)==FST_WSR_PROB) CFst_Probs(_this,-1);
 
-  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
-  {
-    /* Make sure there is a single final state */
-    if(!_this->m_bPsr) _this->m_bLocal=TRUE;                                   /* set local option to prevent trim from changing probabilities */
-    CFst_Fsunify(_this,nU);
-
-    /* Initialize */
-    nFS    = UD_FS(_this,nU);
-    nXS    = UD_XS(_this,nU);
-    nFT    = UD_FT(_this,nU);
-    nXT    = UD_XT(_this,nU);
-    nIcRcs = CData_FindComp(AS(CData,_this->sd),NC_SD_RC);
-    nIcRct = CData_FindComp(AS(CData,_this->td),NC_TD_RC);
+  /* Initialize */
+  nFS    = UD_FS(_this,nU);
+  nXS    = UD_XS(_this,nU);
+  nFT    = UD_FT(_this,nU);
+  nXT    = UD_XT(_this,nU);
 
-    /* Identify the final state */
-    for (nS=nFS; nS<nFS+nXS; nS++)
+  /* Identify the final state */
+  for (nS=nFS; nS<nFS+nXS; nS++)
+  {
+    if ((SD_FLG(_this,nS)&0x01)==0x01)
     {
-      if ((SD_FLG(_this,nS)&0x01)==0x01)
-      {
-        nAbsFinalState = nS-nFS;
-        IFCHECKEX(1) printf("\n Found final state: %ld (absolute: %ld)",(long)(nS-UD_FS(_this,nU)),(long)nS);
-        break;
-      }
+      nAbsFinalState = nS-nFS;
+      IFCHECKEX(1) printf("\n Found final state: %ld (absolute: %ld)",(long)(nS-UD_FS(_this,nU)),(long)nS);
+      break;
     }
+  }
 
-    /* Probability semiring: Calculate (fictive) transition reference counters */
-    if (CFst_Wsr_GetType(_this,NULL)==FST_WSR_PROB && _this->m_bPsr) CFst_Rcs(_this,nU,0.);
+  /* Probability semiring: Calculate (fictive) transition reference counters */
+  if (CFst_Wsr_GetType(_this,NULL)==FST_WSR_PROB && _this->m_bPsr) CFst_Rcs(_this,nU,0.);
 
-    /* swap from -> to */
-    for (nT=nFT; nT<nFT+nXT; nT++)
-    {
-      nIni = TD_INI(_this,nT);
-      nTer = TD_TER(_this,nT);
+  /* swap from -> to */
+  for (nT=nFT; nT<nFT+nXT; nT++)
+  {
+    nIni = TD_INI(_this,nT);
+    nTer = TD_TER(_this,nT);
 
-      /* Update start state and final state */
-      if      (nIni == 0             ) nIni = nAbsFinalState;
-      else if (nIni == nAbsFinalState) nIni = 0;
+    /* Update start state and final state */
+    if      (nIni == 0             ) nIni = nAbsFinalState;
+    else if (nIni == nAbsFinalState) nIni = 0;
 
-      if      (nTer == 0             ) nTer = nAbsFinalState;
-      else if (nTer == nAbsFinalState) nTer = 0;
+    if      (nTer == 0             ) nTer = nAbsFinalState;
+    else if (nTer == nAbsFinalState) nTer = 0;
 
-      /* Swap initial and terminal states */
-      TD_INI(_this,nT) = nTer;
-      TD_TER(_this,nT) = nIni;
-    }
+    /* Swap initial and terminal states */
+    TD_INI(_this,nT) = nTer;
+    TD_TER(_this,nT) = nIni;
+  }
 
-    /* Probability semiring: Recalculate transition probabilities */
-    if (CFst_Wsr_GetType(_this,NULL)==FST_WSR_PROB && _this->m_bPsr) CFst_Probs(_this,nU);
+  /* Probability semiring: Recalculate transition probabilities */
+  if (CFst_Wsr_GetType(_this,NULL)==FST_WSR_PROB && _this->m_bPsr) CFst_Probs(_this,nU);
+
+  return nErr;
+}
+
+/*
+ * Manual page at fst_man.def
+ */
+INT16 CGEN_PUBLIC CFst_Reverse(CFst* _this, INT32 nUnit)
+{
+  INT32      nU             = 0;                                                /* Current unit                       */
+  INT32      nIcRcs         = -1;                                               /* Index of ref. ctr. component in sd */
+  INT32      nIcRct         = -1;                                               /* Index of ref. ctr. component in td */
+
+  /* Validation*/
+  CHECK_THIS_RV(NOT_EXEC);
+  CFst_Check(_this);
+
+  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
+  {
+    /* Reverse unit */
+    nIcRcs = CData_FindComp(AS(CData,_this->sd),NC_SD_RC);
+    nIcRct = CData_FindComp(AS(CData,_this->td),NC_TD_RC);
+    if (CFst_ReverseUnit(_this,nU)==FST_UNITEMPTY) IERROR(_this,FST_UNITEMPTY,nU,0,0);
 
     /* Stop in single unit mode */
     if (nUnit>=0) break;
@@ -626,18 +650,67 @@ INT16 CGEN_PUBLIC CFst_Reverse(CFst* _this, INT32 nUnit)
   return O_K;
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Trims one unit. Called by {@link Trim CFst_Trim} and
+ * {@link ReverseUnit CFst_ReverseUnit}. The function does not report an empty
+ * unit but returns an error code instead, it creates no instances and may
+ * run on a worker thread (see CFst_Units).
+ *
+ * @param _this Pointer to automaton instance
+ * @param nU    Index of unit to trim
+ * @param nWlim Weight threshold (0 for none)
+ * @return O_K if successfull, FST_UNITEMPTY if no transitions are left
  */
-INT16 CGEN_PUBLIC CFst_Trim(CFst* _this, INT32 nUnit, FLOAT64 nWlim)
+INT16 CGEN_PROTECTED CFst_TrimUnit(CFst* _this, INT32 nU, FLOAT64 nWlim)
 {
-  INT32      nU   = 0;
   FST_ITYPE nT   = 0;
   FST_ITYPE nFT  = 0;
   FST_ITYPE nXS  = 0;
   FST_WTYPE nW   = 0.;
   INT32      nIcW = 0;
 
+  /* Initialize */
+  CFst_Wsr_GetType(_this,&nIcW);
+  nFT = UD_FT(_this,nU);
+  nXS = UD_XS(_this,nU);
+
+  /* Check for invalid node ID's and transition weights */
+  for (nT=nFT; nT<nFT+UD_XT(_this,nU); )
+  {
+    nW = nIcW>=0 ? CData_Dfetch(AS(CData,_this->td),nT,nIcW) : 0.;
+    if
+    (
+      TD_INI(_this,nT)<0 || TD_INI(_this,nT)>nXS ||
+      TD_TER(_this,nT)<0 || TD_TER(_this,nT)>nXS
+    )
+    {
+      IFCHECK printf("\n Delete invalid transition %ld (%ld->%ld) from unit %ld",
+          (long)nT,(long)TD_INI(_this,nT),(long)TD_TER(_this,nT),(long)nU);
+      CFst_Deltrans(_this,nU,nT);
+    }
+    else if (nIcW>=0 && nWlim!=0. && CFst_Wsr_Op(_this,nW,nWlim,OP_LESS))
+    {
+      IFCHECK printf("\n Delete heavy transition %ld (%ld->%ld) from unit %ld",
+                     (long)nT,(long)TD_INI(_this,nT),(long)TD_TER(_this,nT),(long)nU);
+      CFst_Deltrans(_this,nU,nT);
+    }
+    else nT++;
+  }
+
+  /* Remove unconnected states */
+  CFst_TrimStates(_this,nU);
+
+  /* Check unit */
+  return UD_XT(_this,nU)==0 ? FST_UNITEMPTY : O_K;
+}
+
+/*
+ * Manual page at fst_man.def
+ */
+INT16 CGEN_PUBLIC CFst_Trim(CFst* _this, INT32 nUnit, FLOAT64 nWlim)
+{
+  INT32 nU = 0;
+
   /* Protocol */
   IFCHECK
   {
@@ -650,43 +723,11 @@ INT16 CGEN_PUBLIC CFst_Trim(CFst* _this, INT32 nUnit, FLOAT64 nWlim)
   CHECK_THIS_RV(NOT_EXEC);
   CFst_Check(_this);
 
-  /* Initialize */
-  CFst_Wsr_GetType(_this,&nIcW);
-
   /* Loop over units */
   for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
   {
-    nFT = UD_FT(_this,nU);
-    nXS = UD_XS(_this,nU);
-
-    /* Check for invalid node ID's and transition weights */
-    for (nT=nFT; nT<nFT+UD_XT(_this,nU); )
-    {
-      nW = nIcW>=0 ? CData_Dfetch(AS(CData,_this->td),nT,nIcW) : 0.;
-      if
-      (
-        TD_INI(_this,nT)<0 || TD_INI(_this,nT)>nXS ||
-        TD_TER(_this,nT)<0 || TD_TER(_this,nT)>nXS
-      )
-      {
-        IFCHECK printf("\n Delete invalid transition %ld (%ld->%ld) from unit %ld",
-            (long)nT,(long)TD_INI(_this,nT),(long)TD_TER(_this,nT),(long)nU);
-        CFst_Deltrans(_this,nU,nT);
-      }
-      else if (nIcW>=0 && nWlim!=0. && CFst_Wsr_Op(_this,nW,nWlim,OP_LESS))
-      {
-        IFCHECK printf("\n Delete heavy transition %ld (%ld->%ld) from unit %ld",
-                       (long)nT,(long)TD_INI(_this,nT),(long)TD_TER(_this,nT),(long)nU);
-        CFst_Deltrans(_this,nU,nT);
-      }
-      else nT++;
-    }
-
-    /* Remove unconnected states */
-    CFst_TrimStates(_this,nU);
-
-    /* Check unit */
-    if (UD_XT(_this,nU)==0) IERROR(_this,FST_UNITEMPTY,nU,0,0);
+    /* Trim unit */
+    if (CFst_TrimUnit(_this,nU,nWlim)==FST_UNITEMPTY) IERROR(_this,FST_UNITEMPTY,nU,0,0);
 
     /* Stop in single unit mode */
     if (nUnit>=0) break;
@@ -74,10 +74,19 @@ void CGEN_PRIVATE CFst_Edist_Fwd
   }
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Computes the epsilon distances of one unit. Called by {@link Epsdist
+ * CFst_Epsdist} and {@link Epsremove CFst_Epsremove}. There are no checks
+ * performed (the source must have an input symbol component and
+ * <code>nUnit</code> must be valid), so the function may run on a worker
+ * thread.
+ *
+ * @param _this Destination automaton instance
+ * @param itSrc Source automaton instance
+ * @param nUnit Index of unit to process
+ * @return O_K if successfull, a (negative) error code otherwise
  */
-INT16 CGEN_PUBLIC CFst_Epsdist(CFst* _this, CFst* itSrc, INT32 nUnit)
+INT16 CGEN_PROTECTED CFst_EpsdistUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
 {
   FST_TID_TYPE* lpTI    = NULL;                                                /* Automaton iterator data struct     */
   BYTE*         lpT     = NULL;                                                /* Current transition                 */
@@ -89,17 +98,10 @@ INT16 CGEN_PUBLIC CFst_Epsdist(CFst* _this, CFst* itSrc, INT32 nUnit)
 
   /* Validate */
   CHECK_THIS_RV(NOT_EXEC);
-  CFst_Check(_this);
-  if (nUnit<0 || nUnit>=UD_XXU(itSrc))                                         /* TODO: add multi-unit support!      */
-    return IERROR(_this,FST_BADID,"unit",nUnit,0);
-  if (CData_FindComp(AS(CData,itSrc->td),NC_TD_TIS)<0)
-    return
-      IERROR(_this,FST_MISS,"input symbol component",NC_TD_TIS,
-        "transition table");
 
   /* Initialize - NO RETURNS BEYOND THIS POINT */                              /* ---------------------------------- */
   CREATEVIRTUAL(CFst,itSrc,_this);                                             /* Overlapping arguments support      */
-  lpTI            = CFst_STI_Init(itSrc,nUnit,FSTI_SORTINI);                   /* Create automaton iterator          */
+  lpTI            = CFst_STI_Init(itSrc,nUnit,FSTI_ADJ);                       /* Create indexed automaton iterator  */
   itSrc->m_nWsr   = CFst_Wsr_GetType(itSrc,&itSrc->m_nIcW);                    /* Determine weight semiring          */
   itSrc->m_nIcTos = CData_FindComp(AS(CData,itSrc->td),NC_TD_TOS);             /* Find output symbol component       */
   lpW             = (FST_WTYPE*)dlp_calloc(lpTI->nXS,sizeof(FST_WTYPE));       /* Allocate weight distance array     */
@@ -185,7 +187,6 @@ INT16 CGEN_PUBLIC CFst_Epsdist(CFst* _this, CFst* itSrc, INT32 nUnit)
   dlp_free(lpTos);                                                             /* Destroy output symbol dist. array  */
   CFst_STI_Done(lpTI);                                                         /* Destroy automaton iterator         */
   DESTROYVIRTUAL(itSrc,_this);                                                 /* Overlapping arguments support      */
-  CFst_Check(_this);                                                           /* TODO: remove after debugging       */
   return O_K;                                                                  /* That was gooood ...                */
 }
 
@@ -258,10 +259,27 @@ BOOL CGEN_PRIVATE CFst_Erm_EpsDistFromStart
   return FALSE;                                                                 /* Did not find an epsilon path      */
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Removes the epsilon transitions from one unit. Called by {@link Epsremove
+ * CFst_Epsremove}. There are no checks performed (the source must have an
+ * input symbol component and <code>nUnit</code> must be valid). If
+ * <code>lpWs</code> is not <code>NULL</code>, the function uses the
+ * auxiliary automaton of the workspace and may run on a worker thread (see
+ * CFst_Units).
+ *
+ * @param _this Destination automaton instance
+ * @param itSrc Source automaton instance
+ * @param nUnit Index of unit to process
+ * @param lpWs  Workspace, may be <code>NULL</code>
+ * @return O_K if successfull, a (negative) error code otherwise
  */
-INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
+INT16 CGEN_PROTECTED CFst_EpsremoveUnit
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  INT32         nUnit,
+  FST_UWS_TYPE* lpWs
+)
 {
   CFst*         itEdt   = NULL;                                                 /* Epsilon distance transducer       */
   FST_TID_TYPE* lpTIsrc = NULL;                                                 /* Ptr.to src. iterator data struct  */
@@ -283,13 +301,6 @@ INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
 
   /* Validate */
   CHECK_THIS_RV(NOT_EXEC);
-  CFst_Check(_this);
-  if (nUnit<0 || nUnit>=UD_XXU(itSrc))                                          /* TODO: add multi-unit support!     */
-    return IERROR(_this,FST_BADID,"unit",nUnit,0);
-  if (CData_FindComp(AS(CData,itSrc->td),NC_TD_TIS)<0)
-    return
-      IERROR(_this,FST_MISS,"input symbol component",NC_TD_TIS,
-        "transition table");
 
   /* Protocol */                                                                /* --------------------------------- */
   nCheck = BASEINST(itSrc)->m_nCheck;                                           /* Get maximum verbose level ...     */
@@ -313,7 +324,8 @@ INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
   if (nT==UD_FT(itSrc,nUnit)+UD_XT(itSrc,nUnit))                                /* Did not find any eps. transitions */
   {                                                                             /* >>                                */
     IFCHECKEX(1) printf("\n No epsilon transitions found in source");           /*   Protocol                        */
-    goto L_OK;                                                                  /*   Nothing to be done              */
+    CFst_CopyUi(_this,itSrc,NULL,nUnit);                                        /*   Just copy the unit              */
+    goto L_OK;                                                                  /*   Nothing else to be done         */
   }                                                                              /* <<                                */
 
   /* Initialize - NO RETURNS BEYOND THIS POINT */                               /* --------------------------------- */
@@ -337,8 +349,9 @@ INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
   CData_Copy(_this->os,itSrc->os);                                             /* Copy output symbol table           */
 
   /* Calculate epsilon distances */                                             /* --------------------------------- */
-  ICREATEEX(CFst,itEdt,"CFst_Epsremove.itEdt",NULL);                            /* Create auxilary CFst instance     */
-  CFst_Epsdist(itEdt,itSrc,nUnit);                                              /* Calculate epsilon distances       */
+  if (lpWs) itEdt = lpWs->itAux;                                                /* Use auxilary CFst of workspace    */
+  else ICREATEEX(CFst,itEdt,"CFst_Epsremove.itEdt",NULL);                       /* or create one                     */
+  CFst_EpsdistUnit(itEdt,itSrc,nUnit);                                          /* Calculate epsilon distances       */
   lpTIedt = CFst_STI_Init(itEdt,0,FSTI_SORTINI);                                /* Init. eps. distance FST interator */
 
   /* Final checks */                                                            /* --------------------------------- */
@@ -427,9 +440,8 @@ INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
   CFst_STI_Done(lpTIsrc);                                                       /* Destroy source iterator           */
   CData_DeleteComps(AS(CData,_this->sd),_this->m_nIcSdAux,1);                   /* Remove aux. state component       */
   CData_DeleteComps(AS(CData,itSrc->sd),itSrc->m_nIcSdAux,1);                   /* Remove aux. state component       */
-  IDESTROY(itEdt);                                                              /* Destroy eps. distance transducer  */
+  if (!lpWs) IDESTROY(itEdt);                                                   /* Destroy eps. distance transducer  */
   DESTROYVIRTUAL(itSrc,_this);                                                  /* Overlapping arguments support     */
-  CFst_Check(_this);                                                            /* TODO: remove after debugging      */
 
   /* Protocol */                                                                /* --------------------------------- */
 L_OK:                                                                           /* Jump label                        */
@@ -443,4 +455,114 @@ L_OK:
   return O_K;                                                                   /* jo!                               */
 }
 
+/**
+ * Unit operation of {@link Epsdist CFst_Epsdist} (see CFst_Units).
+ */
+static INT16 CFst_Erm_EpsdistFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  return CFst_EpsdistUnit(_this,itSrc,0);
+}
+
+/**
+ * Unit operation of {@link Epsremove CFst_Epsremove} (see CFst_Units).
+ */
+static INT16 CFst_Erm_EpsremoveFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  return CFst_EpsremoveUnit(_this,itSrc,0,lpWs);
+}
+
+/*
+ * Manual page at fst_man.def
+ */
+INT16 CGEN_PUBLIC CFst_Epsdist(CFst* _this, CFst* itSrc, INT32 nUnit)
+{
+  INT16 nErr = O_K;                                                             /* Error code                        */
+
+  /* Validation */
+  CHECK_THIS_RV(NOT_EXEC);
+  CFst_Check(_this);
+  CFst_Check(itSrc);
+  if (nUnit>=UD_XXU(itSrc)) return IERROR(_this,FST_BADID,"unit",nUnit,0);
+  if (CData_FindComp(AS(CData,itSrc->td),NC_TD_TIS)<0)
+    return
+      IERROR(_this,FST_MISS,"input symbol component",NC_TD_TIS,
+        "transition table");
+  if (nUnit>=0)
+  {
+    nErr = CFst_EpsdistUnit(_this,itSrc,nUnit);
+    CFst_Check(_this);                                                          /* TODO: Remove after debugging      */
+    return nErr;
+  }
+
+  /* NO RETURNS BEYOND THIS POINT! */
+  CREATEVIRTUAL(CFst,itSrc,_this);
+  CFst_Reset(BASEINST(_this),TRUE);
+
+  /* Compute epsilon distances of units */
+  nErr = CFst_Units(_this,itSrc,CFst_Erm_EpsdistFunc,NULL,FALSE);
+  if (nErr!=O_K) IERROR(_this,nErr==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
+
+  /* Copy input and output symbol tables */
+  CData_Copy(_this->is,itSrc->is);
+  CData_Copy(_this->os,itSrc->os);
+
+  /* Clean up */
+  DESTROYVIRTUAL(itSrc,_this);
+  CFst_Check(_this);                                                            /* TODO: Remove after debugging      */
+  return nErr;
+}
+
+/*
+ * Manual page at fst_man.def
+ */
+INT16 CGEN_PUBLIC CFst_Epsremove(CFst* _this, CFst* itSrc, INT32 nUnit)
+{
+  INT16 nErr = O_K;                                                             /* Error code                        */
+
+  /* Validation */
+  CHECK_THIS_RV(NOT_EXEC);
+  CFst_Check(_this);
+  CFst_Check(itSrc);
+  if (nUnit>=UD_XXU(itSrc)) return IERROR(_this,FST_BADID,"unit",nUnit,0);
+  if (CData_FindComp(AS(CData,itSrc->td),NC_TD_TIS)<0)
+    return
+      IERROR(_this,FST_MISS,"input symbol component",NC_TD_TIS,
+        "transition table");
+  if (nUnit>=0)
+  {
+    nErr = CFst_EpsremoveUnit(_this,itSrc,nUnit,NULL);
+    CFst_Check(_this);                                                          /* TODO: Remove after debugging      */
+    return nErr;
+  }
+
+  /* NO RETURNS BEYOND THIS POINT! */
+  CREATEVIRTUAL(CFst,itSrc,_this);
+  CFst_Reset(BASEINST(_this),TRUE);
+
+  /* Remove epsilon transitions from units */
+  nErr = CFst_Units(_this,itSrc,CFst_Erm_EpsremoveFunc,NULL,FALSE);
+  if (nErr!=O_K) IERROR(_this,nErr==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
+
+  /* Copy input and output symbol tables */
+  CData_Copy(_this->is,itSrc->is);
+  CData_Copy(_this->os,itSrc->os);
+
+  /* Clean up */
+  DESTROYVIRTUAL(itSrc,_this);
+  CFst_Check(_this);                                                            /* TODO: Remove after debugging      */
+  return nErr;
+}
+
 /* EOF */
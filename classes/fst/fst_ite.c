@@ -50,6 +50,12 @@
  *                    <td>Experimental: Forward and backward pointers for each state are stored.
  *                        Transition sorting is avoided. Forward and backward iteration is very fast.
  *                        Every change enforces a recreation of the pointer lists.</td></tr>
+ *                <tr><td><code>FSTI_ADJ</code></td><td><code>0x0010</code></td>
+ *                    <td>Use the adjacency index stored in field {@link adj} (cannot be used together with
+ *                        any other mode). The transition table is not modified. Forward and backward
+ *                        iteration and the search for input symbols
+ *                        ({@link STI_TfromSTis CFst_STI_TfromSTis}) are fast. See
+ *                        {@link STI_AdjIndex CFst_STI_AdjIndex} for details.</td></tr>
  *              </table>
  * @return      A pointer to a graph iteration data structure
  *              or <code>NULL</code> in case of errors.
@@ -81,7 +87,7 @@ FST_TID_TYPE* CGEN_EXPORT CFst_STI_Init(CFst* iFst, INT32 nUnit, INT32 nMode)
   lpTI->nRls     = CData_GetRecLen(AS(CData,iFst->sd));
   lpTI->nRlt     = CData_GetRecLen(AS(CData,iFst->td));
 
-  if ((nMode&FSTI_SLOPPY)==0)
+  if ((nMode&(FSTI_SLOPPY|FSTI_ADJ))==0)
   {
     dlp_free(iFst->m_lpFts);
     iFst->m_lpFts=NULL;
@@ -152,7 +158,7 @@ void CGEN_EXPORT CFst_STI_UnitChanged(FST_TID_TYPE* lpTI, INT16 nMode)
     else                                                                        /*   Strict sorting or any change    */
       CFst_STI_Sort(lpTI);                                                      /*     Resort iterator               */
   }                                                                             /* <<                                */
-  else                                                                          /* For unsorted iterators...         */
+  else if ((lpTI->nMode&FSTI_ADJ)==0)                                           /* For unsorted iterators...         */
   {                                                                             /* >>                                */
     dlp_free(lpTI->iFst->m_lpFts);                                              /*   Clear trans. sorting index      */
     lpTI->iFst->m_lpFts = NULL;                                                 /*   ...                             */
@@ -164,6 +170,8 @@ void CGEN_EXPORT CFst_STI_UnitChanged(FST_TID_TYPE* lpTI, INT16 nMode)
   if(lpTI->lpPTBwd) dlp_free(lpTI->lpPTBwd);
   if(lpTI->lpPTMem) dlp_free(lpTI->lpPTMem);
 
+  if(lpTI->nMode&FSTI_ADJ) CFst_STI_AdjIndex(lpTI);                             /* Validate or rebuild adj. index    */
+
   if(lpTI->nMode==FSTI_PTR){
     CFst *_this=lpTI->iFst;
     INT32 nT;
@@ -192,7 +200,7 @@ void CGEN_EXPORT CFst_STI_UnitChanged(FST_TID_TYPE* lpTI, INT16 nMode)
  */
 void CGEN_EXPORT CFst_STI_Done(FST_TID_TYPE* lpTI)
 {
-  if ((lpTI->nMode&FSTI_SLOPPY)==0)
+  if ((lpTI->nMode&(FSTI_SLOPPY|FSTI_ADJ))==0)
   {
     dlp_free(lpTI->iFst->m_lpFts);
     lpTI->iFst->m_lpFts = NULL;
@@ -201,6 +209,7 @@ void CGEN_EXPORT CFst_STI_Done(FST_TID_TYPE* lpTI)
   if(lpTI->lpPTFwd) dlp_free(lpTI->lpPTFwd);
   if(lpTI->lpPTBwd) dlp_free(lpTI->lpPTBwd);
   if(lpTI->lpPTMem) dlp_free(lpTI->lpPTMem);
+  dlp_free(lpTI->lpAdjF);
   dlp_free(lpTI);
 }
 
@@ -366,6 +375,155 @@ void CGEN_EXPORT CFst_STI_Sort(FST_TID_TYPE* lpTI)
   DLPASSERT(CFst_STI_IsSorted(lpTI,lpTI->nMode,NULL,NULL));                     /* TODO: Remove after debugging!     */
 }
 
+/**
+ * Internal use. Compares two entries (key and transition) of an adjacency
+ * list. Called by {@link STI_AdjIndex CFst_STI_AdjIndex}.
+ */
+int CFst_STI_Adj_Cmp(const void* lpE1, const void* lpE2)
+{
+  if (((FST_ITYPE*)lpE1)[0] > ((FST_ITYPE*)lpE2)[0]) return  1;
+  if (((FST_ITYPE*)lpE1)[0] < ((FST_ITYPE*)lpE2)[0]) return -1;
+  if (((FST_ITYPE*)lpE1)[1] > ((FST_ITYPE*)lpE2)[1]) return  1;
+  if (((FST_ITYPE*)lpE1)[1] < ((FST_ITYPE*)lpE2)[1]) return -1;
+  return 0;
+}
+
+/**
+ * <p>Validates or (re)builds the adjacency index of the unit processed by an
+ * iterator and initializes the adjacency lists of the iterator. Called by
+ * {@link STI_UnitChanged CFst_STI_UnitChanged} for iterators in
+ * <code>FSTI_ADJ</code> mode.</p>
+ * <p>The adjacency index is stored in field {@link adj} of the automaton
+ * instance. Record <code>t</code> of this table belongs to record
+ * <code>t</code> of the transition table. Within the records of a unit,
+ * component 0 lists the unit relative transition indices ordered by initial
+ * state and input symbol, component 1 lists them ordered by terminal state.
+ * The index is saved and copied along with the automaton. It is validated in
+ * linear time whenever an iterator is created or updated and only units
+ * whose index does not match the transition table are indexed again. Hence
+ * changes of the automaton need not to be reported to the index.</p>
+ *
+ * @param lpTI Iterator data structure (returned by {@link STI_Init CFst_STI_Init})
+ */
+void CGEN_SPRIVATE CFst_STI_AdjIndex(FST_TID_TYPE* lpTI)
+{
+  CFst*      _this   = lpTI->iFst;                                              /* Automaton instance                */
+  CData*     idAdj   = AS(CData,lpTI->iFst->m_idAdj);                           /* Adjacency index table             */
+  FST_ITYPE  nXS     = lpTI->nXS;                                               /* Number of states of unit          */
+  FST_ITYPE  nXT     = lpTI->nXT;                                               /* Number of transitions of unit     */
+  FST_ITYPE  nS      = 0;                                                       /* Current state                     */
+  FST_ITYPE  nT      = 0;                                                       /* Current transition                */
+  FST_ITYPE  nP      = 0;                                                       /* Current position in adj. list     */
+  FST_ITYPE  nAdj    = 0;                                                       /* Current adjacent state            */
+  FST_ITYPE  nAdjSav = 0;                                                       /* Previous adjacent state           */
+  FST_ITYPE  nTis    = 0;                                                       /* Current input symbol              */
+  FST_ITYPE  nTisSav = 0;                                                       /* Previous input symbol             */
+  FST_ITYPE* lpBuf   = NULL;                                                    /* Sort buffer and insert positions  */
+  BYTE*      lpT     = NULL;                                                    /* Current transition pointer        */
+  BOOL       bValid  = TRUE;                                                    /* Stored index matches td           */
+
+  /* Allocate adjacency lists of iterator */                                    /* --------------------------------- */
+  dlp_free(lpTI->lpAdjF);                                                       /* Free previous lists               */
+  lpTI->lpAdjF  = (FST_ITYPE*)__dlp_calloc(4*nXT+2*(nXS+1)+1,sizeof(FST_ITYPE), /* Allocate all lists at once        */
+    __FILE__,__LINE__,"CFst",BASEINST(_this)->m_lpInstanceName);                /* |                                 */
+  lpTI->lpAdjB  = lpTI->lpAdjF +nXT;                                            /* Backward list                     */
+  lpTI->lpAdjPf = lpTI->lpAdjB +nXT;                                            /* Positions in forward list         */
+  lpTI->lpAdjPb = lpTI->lpAdjPf+nXT;                                            /* Positions in backward list        */
+  lpTI->lpAdjOf = lpTI->lpAdjPb+nXT;                                            /* State offsets in forward list     */
+  lpTI->lpAdjOb = lpTI->lpAdjOf+nXS+1;                                          /* State offsets in backward list    */
+
+  /* Conform index table to transition table */                                 /* --------------------------------- */
+  if                                                                            /* Index table malformed?            */
+  (                                                                             /* |                                 */
+    CData_GetNComps(idAdj)!=2 ||                                                /* |                                 */
+    CData_GetCompType(idAdj,0)!=DLP_TYPE(FST_ITYPE) ||                          /* |                                 */
+    CData_GetCompType(idAdj,1)!=DLP_TYPE(FST_ITYPE)                             /* |                                 */
+  )                                                                             /* |                                 */
+  {                                                                             /* >>                                */
+    CData_Reset(BASEINST(idAdj),TRUE);                                          /* Reset it                          */
+    CData_AddComp(idAdj,"~FWD",DLP_TYPE(FST_ITYPE));                            /* Forward component                 */
+    CData_AddComp(idAdj,"~BWD",DLP_TYPE(FST_ITYPE));                            /* Backward component                */
+  }                                                                             /* <<                                */
+  if (CData_GetNRecs(idAdj)!=UD_XXT(_this))                                     /* Number of transitions changed     */
+  {                                                                             /* >>                                */
+    if (CData_GetMaxRecs(idAdj)<UD_XXT(_this))                                  /* Grow by at least one eighth       */
+      CData_Realloc(idAdj,UD_XXT(_this)+MAX(_this->m_nGrany,UD_XXT(_this)/8));  /* |                                 */
+    CData_SetNRecs(idAdj,UD_XXT(_this));                                        /* Set number of records             */
+  }                                                                             /* <<                                */
+
+  /* Validate forward index of unit */                                          /* --------------------------------- */
+  for (nT=0; nT<nXT; nT++) lpTI->lpAdjPf[nT] = lpTI->lpAdjPb[nT] = -1;          /* No transition listed yet          */
+  for (nP=0, nAdjSav=-1, nTisSav=0; nP<nXT && bValid; nP++)                     /* Loop over forward list            */
+  {                                                                             /* >>                                */
+    nT = *(FST_ITYPE*)CDATA_XADDR(idAdj,lpTI->nFT+nP,0);                        /* Get listed transition             */
+    if (nT<0 || nT>=nXT || lpTI->lpAdjPf[nT]>=0) { bValid=FALSE; break; }       /* Invalid or listed twice           */
+    lpT  = lpTI->lpFT+(size_t)nT*lpTI->nRlt;                                    /* Get transition pointer            */
+    nAdj = *CFst_STI_TIni(lpTI,lpT);                                            /* Get initial state                 */
+    nTis = lpTI->nOfTTis>0 ? *CFst_STI_TTis(lpTI,lpT) : 0;                      /* Get input symbol                  */
+    if (nAdj<nAdjSav || nAdj>=nXS || (nAdj==nAdjSav && nTis<nTisSav))           /* Not ordered                       */
+      { bValid=FALSE; break; }                                                  /* |                                 */
+    lpTI->lpAdjF[nP]=nT; lpTI->lpAdjPf[nT]=nP; lpTI->lpAdjOf[nAdj+1]++;         /* Store in adjacency lists          */
+    nAdjSav=nAdj; nTisSav=nTis;                                                 /* Remember state and symbol         */
+  }                                                                             /* <<                                */
+
+  /* Validate backward index of unit */                                         /* --------------------------------- */
+  for (nP=0, nAdjSav=-1; nP<nXT && bValid; nP++)                                /* Loop over backward list           */
+  {                                                                             /* >>                                */
+    nT = *(FST_ITYPE*)CDATA_XADDR(idAdj,lpTI->nFT+nP,1);                        /* Get listed transition             */
+    if (nT<0 || nT>=nXT || lpTI->lpAdjPb[nT]>=0) { bValid=FALSE; break; }       /* Invalid or listed twice           */
+    nAdj = *CFst_STI_TTer(lpTI,lpTI->lpFT+(size_t)nT*lpTI->nRlt);               /* Get terminal state                */
+    if (nAdj<nAdjSav || nAdj>=nXS) { bValid=FALSE; break; }                     /* Not ordered                       */
+    lpTI->lpAdjB[nP]=nT; lpTI->lpAdjPb[nT]=nP; lpTI->lpAdjOb[nAdj+1]++;         /* Store in adjacency lists          */
+    nAdjSav=nAdj;                                                               /* Remember state                    */
+  }                                                                             /* <<                                */
+
+  /* (Re)build index of unit */                                                 /* --------------------------------- */
+  if (!bValid)                                                                  /* Stored index does not match       */
+  {                                                                             /* >>                                */
+    IFCHECKEX(2) printf("\n    Indexing unit %ld",(long)lpTI->nUnit);           /* Protocol (verbose level 2)        */
+    lpBuf = (FST_ITYPE*)__dlp_calloc(2*nXT+2*nXS+1,sizeof(FST_ITYPE),           /* Allocate sort buffer              */
+      __FILE__,__LINE__,"CFst",BASEINST(_this)->m_lpInstanceName);              /* |                                 */
+    for (nS=0; nS<=nXS; nS++) lpTI->lpAdjOf[nS] = lpTI->lpAdjOb[nS] = 0;        /* Clear state offsets               */
+    for (nT=0, lpT=lpTI->lpFT; nT<nXT; nT++, lpT+=lpTI->nRlt)                   /* Count adjacent transitions        */
+    {                                                                           /* >>                                */
+      lpTI->lpAdjOf[*CFst_STI_TIni(lpTI,lpT)+1]++;                              /* ... leaving state                 */
+      lpTI->lpAdjOb[*CFst_STI_TTer(lpTI,lpT)+1]++;                              /* ... entering state                */
+    }                                                                           /* <<                                */
+    for (nS=0; nS<nXS; nS++)                                                    /* Accumulate state offsets          */
+    {                                                                           /* >>                                */
+      lpTI->lpAdjOf[nS+1] += lpTI->lpAdjOf[nS];                                 /* ...                               */
+      lpTI->lpAdjOb[nS+1] += lpTI->lpAdjOb[nS];                                 /* ...                               */
+      lpBuf[2*nXT    +nS] = lpTI->lpAdjOf[nS];                                  /* Insert position (forward)         */
+      lpBuf[2*nXT+nXS+nS] = lpTI->lpAdjOb[nS];                                  /* Insert position (backward)        */
+    }                                                                           /* <<                                */
+    for (nT=0, lpT=lpTI->lpFT; nT<nXT; nT++, lpT+=lpTI->nRlt)                   /* Distribute transitions            */
+    {                                                                           /* >>                                */
+      nP = lpBuf[2*nXT+*CFst_STI_TIni(lpTI,lpT)]++;                             /* Forward list (stable)             */
+      lpBuf[2*nP  ] = lpTI->nOfTTis>0 ? *CFst_STI_TTis(lpTI,lpT) : 0;           /* |                                 */
+      lpBuf[2*nP+1] = nT;                                                       /* |                                 */
+      lpTI->lpAdjB[lpBuf[2*nXT+nXS+*CFst_STI_TTer(lpTI,lpT)]++] = nT;           /* Backward list (stable)            */
+    }                                                                           /* <<                                */
+    for (nS=0; nS<nXS; nS++)                                                    /* Order forward lists by symbols    */
+      if (lpTI->lpAdjOf[nS+1]-lpTI->lpAdjOf[nS]>1)                              /* |                                 */
+        qsort(lpBuf+2*lpTI->lpAdjOf[nS],lpTI->lpAdjOf[nS+1]-lpTI->lpAdjOf[nS],  /* |                                 */
+          2*sizeof(FST_ITYPE),CFst_STI_Adj_Cmp);                                /* |                                 */
+    for (nP=0; nP<nXT; nP++)                                                    /* Store adjacency lists             */
+    {                                                                           /* >>                                */
+      lpTI->lpAdjF[nP] = lpBuf[2*nP+1];                                         /* Iterator lists                    */
+      lpTI->lpAdjPf[lpTI->lpAdjF[nP]] = nP;                                     /* |                                 */
+      lpTI->lpAdjPb[lpTI->lpAdjB[nP]] = nP;                                     /* |                                 */
+      *(FST_ITYPE*)CDATA_XADDR(idAdj,lpTI->nFT+nP,0) = lpTI->lpAdjF[nP];        /* Index table                       */
+      *(FST_ITYPE*)CDATA_XADDR(idAdj,lpTI->nFT+nP,1) = lpTI->lpAdjB[nP];        /* |                                 */
+    }                                                                           /* <<                                */
+    dlp_free(lpBuf);                                                            /* Free sort buffer                  */
+  }                                                                             /* <<                                */
+  else for (nS=0; nS<nXS; nS++)                                                 /* Accumulate state offsets          */
+  {                                                                             /* >>                                */
+    lpTI->lpAdjOf[nS+1] += lpTI->lpAdjOf[nS];                                   /* ...                               */
+    lpTI->lpAdjOb[nS+1] += lpTI->lpAdjOb[nS];                                   /* ...                               */
+  }                                                                             /* <<                                */
+}
+
 /**
  * Returns the pointer for a given global transiton index.
  *
@@ -531,6 +689,15 @@ BYTE* CGEN_EXPORT CFst_STI_TfromS(FST_TID_TYPE* lpTI, FST_ITYPE nState, BYTE* lp
   /* Validation */
   if (nState>lpTI->nXS) return NULL;
 
+  /* Adjacency index mode */
+  if ((lpTI->nMode&FSTI_ADJ) && nState>=0)
+  {
+    FST_ITYPE nP;
+    if (nState>=lpTI->nXS) return NULL;
+    nP = lpTrans ? lpTI->lpAdjPf[(lpTrans-lpTI->lpFT)/lpTI->nRlt]+1 : lpTI->lpAdjOf[nState];
+    return nP<lpTI->lpAdjOf[nState+1] ? lpTI->lpFT+(size_t)lpTI->nRlt*lpTI->lpAdjF[nP] : NULL;
+  }
+
   /* PT mode */
   if(lpTI->nMode==FSTI_PTR && nState>=0){
     if(!lpTrans) return lpTI->lpPTFwd[nState]?lpTI->lpPTFwd[nState]->lpT:NULL;
@@ -600,7 +767,8 @@ BYTE* CGEN_EXPORT CFst_STI_TfromS(FST_TID_TYPE* lpTI, FST_ITYPE nState, BYTE* lp
  *
  * <h3>Runtime Considerations</h3>
  * <ul>
- *   <li>This iteration function is <i><b>not</b></i> faster for sorted graphs.</li>
+ *   <li>This iteration function is <i><b>not</b></i> faster for sorted graphs.
+ *   It is fast for iterators in <code>FSTI_ADJ</code> mode.</li>
  *   <li>You should rather use a forward iteration using
  *   <code>CStr_SSI_TfromN</code> than a backward iteration using
  *   {@link STI_TtoS CFst_STI_TtoS}.
@@ -618,6 +786,15 @@ BYTE* CGEN_EXPORT CFst_STI_TtoS(FST_TID_TYPE* lpTI, INT32 nState, BYTE* lpTrans)
   /* Validation */
   if (nState>lpTI->nXS) return NULL;
 
+  /* Adjacency index mode */
+  if ((lpTI->nMode&FSTI_ADJ) && nState>=0)
+  {
+    FST_ITYPE nP;
+    if (nState>=lpTI->nXS) return NULL;
+    nP = lpTrans ? lpTI->lpAdjPb[(lpTrans-lpTI->lpFT)/lpTI->nRlt]+1 : lpTI->lpAdjOb[nState];
+    return nP<lpTI->lpAdjOb[nState+1] ? lpTI->lpFT+(size_t)lpTI->nRlt*lpTI->lpAdjB[nP] : NULL;
+  }
+
   /* PT mode */
   if(lpTI->nMode==FSTI_PTR && nState>=0){
     if(!lpTrans) return lpTI->lpPTBwd[nState]?lpTI->lpPTBwd[nState]->lpT:NULL;
@@ -659,6 +836,81 @@ BYTE* CGEN_EXPORT CFst_STI_TtoS(FST_TID_TYPE* lpTI, INT32 nState, BYTE* lpTrans)
   return NULL;
 }
 
+/**
+ * <p>Returns a pointer to the next transition with the initial state
+ * <code>nState</code> and the input symbol <code>nTis</code>. If
+ * <code>lpTrans</code> is <code>NULL</code> the first such transition is
+ * returned. This function may be used to enumerate all transitions leaving a
+ * given state with a given input symbol:</p>
+ * <pre class="code">
+ *
+ *   FST_TID_TYPE* iMySearch = {@link STI_Init CFst_STI_Init}(iMyFst,nMyUnit,FSTI_ADJ);
+ *   BYTE*         lpTrans   = NULL;
+ *
+ *   <span class="c-key">while</span> ((lpTrans=<span class="c-key">CFst_STI_TfromSTis</span>(iMySearch,nMyIniState,nMyTis,lpTrans))!=NULL)
+ *   {
+ *     ...
+ *   }
+ *   {@link STI_Done CFst_STI_Done}(iMySearch);
+ *
+ * </pre>
+ *
+ * <h3>Runtime Considerations</h3>
+ * <ul>
+ *   <li>For iterators in <code>FSTI_ADJ</code> mode the first transition is
+ *   found by a binary search in the transitions leaving <code>nState</code>.
+ *   For other iterators the transitions are searched linearly.</li>
+ * </ul>
+ *
+ * @param lpTI    Iterator data structure (returned by {@link STI_Init CFst_STI_Init})
+ * @param nState  Unit relative initial state index of transitions to search
+ * @param nTis    Input symbol of transitions to search
+ * @param lpTrans Previous transition (may be <code>NULL</code>)
+ * @return        A pointer to the next transition or <code>NULL</code> if no
+ *                such transition was found
+ */
+BYTE* CGEN_EXPORT CFst_STI_TfromSTis
+(
+  FST_TID_TYPE* lpTI,
+  FST_ITYPE     nState,
+  FST_STYPE     nTis,
+  BYTE*         lpTrans
+)
+{
+  FST_ITYPE nL = 0;
+  FST_ITYPE nR = 0;
+  FST_ITYPE nM = 0;
+
+  /* Validation */
+  if (nState<0 || nState>=lpTI->nXS || lpTI->nOfTTis<=0) return NULL;
+
+  /* No adjacency index: linear search */
+  if ((lpTI->nMode&FSTI_ADJ)==0)
+  {
+    while ((lpTrans=CFst_STI_TfromS(lpTI,nState,lpTrans))!=NULL)
+      if (*CFst_STI_TTis(lpTI,lpTrans)==nTis) return lpTrans;
+    return NULL;
+  }
+
+  /* Adjacency index: binary search for first transition */
+  if (lpTrans)
+    nL = lpTI->lpAdjPf[(lpTrans-lpTI->lpFT)/lpTI->nRlt]+1;
+  else
+  {
+    nL = lpTI->lpAdjOf[nState];
+    nR = lpTI->lpAdjOf[nState+1];
+    while (nL<nR)
+    {
+      nM = nL+(nR-nL)/2;
+      if (*CFst_STI_TTis(lpTI,lpTI->lpFT+(size_t)lpTI->nRlt*lpTI->lpAdjF[nM])<nTis) nL=nM+1;
+      else nR=nM;
+    }
+  }
+  if (nL>=lpTI->lpAdjOf[nState+1]) return NULL;
+  lpTrans = lpTI->lpFT+(size_t)lpTI->nRlt*lpTI->lpAdjF[nL];
+  return *CFst_STI_TTis(lpTI,lpTrans)==nTis ? lpTrans : NULL;
+}
+
 /**
  * <p>Walks through an automaton graph and calls a user defined callback
  * function for every transition traversed during the walk. The walk continues
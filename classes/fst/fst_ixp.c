@@ -27,6 +27,36 @@
 #include "dlp_cscope.h" /* Indicate C scope */
 #include "dlp_fst.h"
 
+/**
+ * Copies the fields and the structure of the descriptor tables (but no
+ * records) of a source automaton to this instance. The symbol tables are
+ * cleared. Called by {@link CatEx CFst_CatEx} on empty destinations. Copying
+ * the whole source would make unit-wise processing quadratic in the number of
+ * units.
+ *
+ * @param _this Pointer to destination automaton instance
+ * @param itSrc Pointer to source automaton instance
+ */
+void CGEN_PRIVATE CFst_Cat_CopyStructure(CFst* _this, CFst* itSrc)
+{
+  CData* idDst[3]; /* Destination descriptor tables */
+  CData* idSrc[3]; /* Source descriptor tables */
+  INT32  i = 0;    /* Loop counter */
+
+  CDlpObject_CopySelective(BASEINST(_this),BASEINST(itSrc),WL_TYPE_FIELD);
+  idDst[0]=AS(CData,_this->ud); idSrc[0]=AS(CData,itSrc->ud);
+  idDst[1]=AS(CData,_this->sd); idSrc[1]=AS(CData,itSrc->sd);
+  idDst[2]=AS(CData,_this->td); idSrc[2]=AS(CData,itSrc->td);
+  for (i=0; i<3; i++)
+  {
+    CDlpObject_CopySelective(BASEINST(idDst[i]),BASEINST(idSrc[i]),WL_TYPE_FIELD);
+    if (CDlpTable_Copy(idDst[i]->m_lpTable,idSrc[i]->m_lpTable,0,0)!=O_K)
+      CData_Reset(BASEINST(idDst[i]),TRUE);
+  }
+  CData_Reset(_this->is,0);
+  CData_Reset(_this->os,0);
+}
+
 /**
  * Appends units from a source automaton instance to this instance.
  *
@@ -46,6 +76,9 @@ INT16 CGEN_PUBLIC CFst_CatEx(CFst* _this, CFst* itSrc, INT32 nFirstUnit, INT32 n
   INT32 nXTs  = 0;  /* Number of source transitions to append */
   INT32 nXXSd = 0;  /* Total number of states in destination */
   INT32 nXXTd = 0;  /* Total number of transitions in destination */
+  INT32 nRec[3];    /* Numbers of records to append (temporary) */
+  INT32 i     = 0;  /* Loop counter */
+  CData* idTab[3];  /* Destination descriptor tables (temporary) */
 
   /* Validate */
   CHECK_THIS_RV(NOT_EXEC);
@@ -60,15 +93,7 @@ INT16 CGEN_PUBLIC CFst_CatEx(CFst* _this, CFst* itSrc, INT32 nFirstUnit, INT32 n
   CREATEVIRTUAL(CFst,itSrc,_this);
 
   /* If destination empty copy all properties from source */
-  if (UD_XXU(_this)==0)
-  {
-    CFst_Copy(BASEINST(_this),BASEINST(itSrc));
-    CData_SetNRecs(AS(CData,_this->ud),0);
-    CData_SetNRecs(AS(CData,_this->sd),0);
-    CData_SetNRecs(AS(CData,_this->td),0);
-    CData_Reset(_this->is,0);
-    CData_Reset(_this->os,0);
-  }
+  if (UD_XXU(_this)==0) CFst_Cat_CopyStructure(_this,itSrc);
 
   /* Get some metrics */
   nXUd  = UD_XXU(_this);
@@ -82,6 +107,14 @@ INT16 CGEN_PUBLIC CFst_CatEx(CFst* _this, CFst* itSrc, INT32 nFirstUnit, INT32 n
     nXTs+=UD_XT(itSrc,nU);
   }
 
+  /* Grow destination tables by at least one eighth (keeps unit-wise concatenation linear) */
+  idTab[0]=AS(CData,_this->ud); nRec[0]=nCount;
+  idTab[1]=AS(CData,_this->sd); nRec[1]=nXSs;
+  idTab[2]=AS(CData,_this->td); nRec[2]=nXTs;
+  for (i=0; i<3; i++)
+    if (CData_GetMaxRecs(idTab[i])>0 && CData_GetNRecs(idTab[i])+nRec[i]>CData_GetMaxRecs(idTab[i]))
+      CData_Realloc(idTab[i],CData_GetNRecs(idTab[i])+MAX(nRec[i]+_this->m_nGrany,CData_GetNRecs(idTab[i])/8));
+
   /* Cat descriptor tables */
   CDlpTable_CatEx(AS(CData,_this->ud)->m_lpTable,AS(CData,itSrc->ud)->m_lpTable,nFirstUnit,nCount);
   CDlpTable_CatEx(AS(CData,_this->sd)->m_lpTable,AS(CData,itSrc->sd)->m_lpTable,nFSs      ,nXSs  );
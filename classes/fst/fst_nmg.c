@@ -1253,14 +1253,14 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
   INT32      nIte        = 0;
   INT32      nIni        = 0;
   INT32      nTer        = 0;
+  INT32      nXSnew      = 0;
   FST_ITYPE nS          = 0;
   FST_ITYPE nT          = 0;
+  FST_ITYPE nFS         = 0;
   FST_ITYPE nFT         = 0;
   FST_ITYPE nXT         = 0;
-  CData *lpSMapNewToOld = NULL;
-  CData *lpSMapOldToNew = NULL;
-  CData *lpAux          = NULL;
-  BYTE *lpRec           = NULL;
+  FST_ITYPE* lpSMapNewToOld = NULL;
+  FST_ITYPE* lpSMapOldToNew = NULL;
 
   /* Protocol */
   IFCHECK
@@ -1273,17 +1273,16 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
   /* Verify */
   DLPASSERT((nU>=0)&&(nU<=UD_XXU(_this)));
 
-  /* Initialize */
-  ICREATEEX(CData,lpAux,"~lpAux",NULL);
-  ICREATEEX(CData,lpSMapNewToOld,"~lpSMapNewToOld",NULL);
-  ICREATEEX(CData,lpSMapOldToNew,"~lpSMapOldToNew",NULL);
-  CData_Reset(BASEINST(lpSMapNewToOld),FALSE);
-  CData_Reset(BASEINST(lpSMapOldToNew),FALSE);
-  CData_AddComp(lpSMapNewToOld,"idx",T_LONG);
-  CData_AddComp(lpSMapOldToNew,"idx",T_LONG);
-  CData_AllocUninitialized(lpSMapNewToOld,UD_XS(_this,nU));
-  CData_AllocateUninitialized(lpSMapOldToNew,UD_XS(_this,nU));
-  CData_Fill(lpSMapOldToNew,CMPLX(-1.0),CMPLX(0.0));
+  /* Initialize (no instances, the function may run on a worker thread) */
+  lpSMapNewToOld = (FST_ITYPE*)dlp_malloc((UD_XS(_this,nU)+1)*sizeof(FST_ITYPE));
+  lpSMapOldToNew = (FST_ITYPE*)dlp_malloc((UD_XS(_this,nU)+1)*sizeof(FST_ITYPE));
+  if (!lpSMapNewToOld || !lpSMapOldToNew)
+  {
+    dlp_free(lpSMapNewToOld);
+    dlp_free(lpSMapOldToNew);
+    return ERR_NOMEM;
+  }
+  for (nS=0; nS<UD_XS(_this,nU); nS++) lpSMapOldToNew[nS]=-1;
 
   /* Mark connected states */
   CFst_MarkConnected(_this, nU);
@@ -1295,15 +1294,15 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
        SD_FLG(_this,nS+UD_FS(_this,nU))&SD_FLG_USER4) ||
        nS==0)
     {
-      CData_IncNRecs(lpSMapNewToOld,1);
-      CData_Dstore(lpSMapNewToOld,nS,i,0);
-      CData_Dstore(lpSMapOldToNew,i,nS,0);
+      lpSMapNewToOld[i]=nS;
+      lpSMapOldToNew[nS]=i;
       i++;
     }
   }
+  nXSnew = i;
 
   /* Count open states to be removed */
-  nRm = UD_XS(_this,nU)-CData_GetNRecs(lpSMapNewToOld);
+  nRm = UD_XS(_this,nU)-nXSnew;
 
   if(nRm>0)
   {
@@ -1319,8 +1318,8 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
       for (nT=nFT; nT<nFT+nXT; nT++)
       {
         /* Map initial and final state */
-        nIni = (INT32)CData_Dfetch(lpSMapOldToNew,TD_INI(_this,nT),0);
-        nTer = (INT32)CData_Dfetch(lpSMapOldToNew,TD_TER(_this,nT),0);
+        nIni = (INT32)lpSMapOldToNew[TD_INI(_this,nT)];
+        nTer = (INT32)lpSMapOldToNew[TD_TER(_this,nT)];
         /* Copy transition to keeping ones if it is valid */
         if(nIni>=0&&nTer>=0){
           if(nT!=nTdst)
@@ -1342,8 +1341,8 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
       for (nT=nFT; nT<nFT+nXT; )
       {
         /* Map initial and final state */
-        nIni = (INT32)CData_Dfetch(lpSMapOldToNew,TD_INI(_this,nT),0);
-        nTer = (INT32)CData_Dfetch(lpSMapOldToNew,TD_TER(_this,nT),0);
+        nIni = (INT32)lpSMapOldToNew[TD_INI(_this,nT)];
+        nTer = (INT32)lpSMapOldToNew[TD_TER(_this,nT)];
 
         /* Remove transitions having invalid initial or final state */
         if(nIni<0||nTer<0)
@@ -1366,34 +1365,24 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
 
     /* Remove open states */
     IFCHECK printf("\n Unit %ld: Removing %ld open states",(long)nU,(long)nRm);
-    CData_Scopy(lpAux,AS(CData,_this->sd));
-    CData_AllocateUninitialized(lpAux,CData_GetNRecs(lpSMapNewToOld));
-    lpRec  = CData_XAddr(lpAux,0,0);
+    nFS    = UD_FS(_this,nU);
     nRecln = CData_GetRecLen(AS(CData,_this->sd));
 
-    for(i=0; i<CData_GetNRecs(lpSMapNewToOld); i++)
-    {
-      nS = (INT32)CData_Dfetch(lpSMapNewToOld,i,0);
-
-      /* State survived -> copy state description */
-      dlp_memmove(lpRec,CData_XAddr(AS(CData,_this->sd),nS+UD_FS(_this,nU),0),nRecln);
-      lpRec+=nRecln;
-    }
-
+    /* Move surviving state descriptions to the front of the unit (in place) */
+    for(i=0; i<nXSnew; i++)
+      if (lpSMapNewToOld[i]!=i)
+        dlp_memmove(CData_XAddr(AS(CData,_this->sd),nFS+i,0),
+          CData_XAddr(AS(CData,_this->sd),nFS+lpSMapNewToOld[i],0),nRecln);
 
     /* Update state table */
-    CData_SelectRecs(lpSMapNewToOld,AS(CData,_this->sd),0,UD_FS(_this,nU));
-    CData_Cat(lpSMapNewToOld,lpAux);
-    CData_SelectRecs(lpAux,AS(CData,_this->sd),UD_FS(_this,nU)+UD_XS(_this,nU),UD_XXS(_this)-(UD_FS(_this,nU)+UD_XS(_this,nU)));
-    CData_Cat(lpSMapNewToOld,lpAux);
-    CData_Copy(_this->sd,BASEINST(lpSMapNewToOld));
+    CData_DeleteRecs(AS(CData,_this->sd),nFS+nXSnew,nRm);
 
     /* Adjust transition table */
     for(nT=nFT; nT<nFT+nXT; nT++)
     {
       /* Map initial and final state */
-      TD_INI(_this,nT)=(INT32)CData_Dfetch(lpSMapOldToNew,TD_INI(_this,nT),0);
-      TD_TER(_this,nT)=(INT32)CData_Dfetch(lpSMapOldToNew,TD_TER(_this,nT),0);
+      TD_INI(_this,nT)=(INT32)lpSMapOldToNew[TD_INI(_this,nT)];
+      TD_TER(_this,nT)=(INT32)lpSMapOldToNew[TD_TER(_this,nT)];
     }
 
     /* Adjust unit descriptions */
@@ -1407,9 +1396,8 @@ INT16 CGEN_PROTECTED CFst_TrimStates(CFst* _this, INT32 nU)
     SD_FLG(_this,nS)&=~(SD_FLG_USER3|SD_FLG_USER4);
 
   /* Cleanup */
-  if(lpAux         !=NULL) IDESTROY(lpAux);
-  if(lpSMapNewToOld!=NULL) IDESTROY(lpSMapNewToOld);
-  if(lpSMapOldToNew!=NULL) IDESTROY(lpSMapOldToNew);
+  dlp_free(lpSMapNewToOld);
+  dlp_free(lpSMapOldToNew);
 
   CFst_Check(_this); /* TODO: Remove after debugging */
 
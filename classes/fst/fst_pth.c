@@ -67,65 +67,79 @@ INT16 CGEN_PUBLIC CFst_Fslist(CFst* _this, INT32 nUnit, CData* idDst)
   return O_K;
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Unifies the final states of one unit without trimming it. Called by
+ * {@link Fsunify CFst_Fsunify} and {@link ReverseUnit CFst_ReverseUnit}.
+ *
+ * @param _this Pointer to automaton instance
+ * @param nU    Index of unit to process
  */
-INT16 CGEN_PUBLIC CFst_Fsunify(CFst* _this, INT32 nUnit)
+void CGEN_PROTECTED CFst_FsunifyUnit(CFst* _this, INT32 nU)
 {
-  INT32         nU         = 0;
   FST_ITYPE     nS         = 0;
   BYTE*         lpT        = NULL;
   FST_TID_TYPE* lpIterator = NULL;
 
-  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
-  {
-    /* Add a new final state */
-    CFst_Addstates(_this,nU,1,TRUE);
-    IFCHECKEX(1) printf("\n Created new final state: %ld (absolute: %ld)",(long)UD_XS(_this,nU)-1,(long)(UD_XS(_this,nU)-1+UD_FS(_this,nU)));
+  /* Add a new final state */
+  CFst_Addstates(_this,nU,1,TRUE);
+  IFCHECKEX(1) printf("\n Created new final state: %ld (absolute: %ld)",(long)UD_XS(_this,nU)-1,(long)(UD_XS(_this,nU)-1+UD_FS(_this,nU)));
 
-    /* Initialize graph iterator */
-    lpIterator = CFst_STI_Init(_this,nU,FSTI_PTR);
+  /* Initialize graph iterator */
+  lpIterator = CFst_STI_Init(_this,nU,FSTI_PTR);
 
-    /* Find all final states (but ignore the new final state: UD_XS(_this,nU)-1 ) */
-    for (nS=UD_FS(_this,nU); nS<UD_FS(_this,nU)+UD_XS(_this,nU)-1; nS++)
+  /* Find all final states (but ignore the new final state: UD_XS(_this,nU)-1 ) */
+  for (nS=UD_FS(_this,nU); nS<UD_FS(_this,nU)+UD_XS(_this,nU)-1; nS++)
+  {
+    if ((SD_FLG(_this,nS)&SD_FLG_FINAL)==SD_FLG_FINAL)
     {
-      if ((SD_FLG(_this,nS)&SD_FLG_FINAL)==SD_FLG_FINAL)
-      {
-        IFCHECKEX(1) printf("\n Found final state: %ld (absolute: %ld)",(long)(nS-UD_FS(_this,nU)),(long)nS);
+      IFCHECKEX(1) printf("\n Found final state: %ld (absolute: %ld)",(long)(nS-UD_FS(_this,nU)),(long)nS);
 
-        /* Find out if there are transitions originating in current final state */
-        if (CFst_STI_TfromS(lpIterator,nS-UD_FS(_this,nU),NULL)!=NULL)
-        {
-          IFCHECKEX(1) printf("\n Create transition: %ld --> %ld",(long)(nS-UD_FS(_this,nU)),(long)UD_XS(_this,nU)-1);
+      /* Find out if there are transitions originating in current final state */
+      if (CFst_STI_TfromS(lpIterator,nS-UD_FS(_this,nU),NULL)!=NULL)
+      {
+        IFCHECKEX(1) printf("\n Create transition: %ld --> %ld",(long)(nS-UD_FS(_this,nU)),(long)UD_XS(_this,nU)-1);
 
-          /* Insert epsilon transition leading to the new final state */
-          CFst_Addtrans(_this,nU,nS-UD_FS(_this,nU),UD_XS(_this,nU)-1);
-          CFst_STI_UnitChanged(lpIterator,FSTI_CADD);
+        /* Insert epsilon transition leading to the new final state */
+        CFst_Addtrans(_this,nU,nS-UD_FS(_this,nU),UD_XS(_this,nU)-1);
+        CFst_STI_UnitChanged(lpIterator,FSTI_CADD);
 
-          /* Make current state a non-final state */
-          SD_FLG(_this,nS)&=~0x01;   /* x = x & 0xFE */
-        }
-        else
+        /* Make current state a non-final state */
+        SD_FLG(_this,nS)&=~0x01;   /* x = x & 0xFE */
+      }
+      else
+      {
+        /* Find out if there are transitions leading to current final state,
+           if yes, detour them */
+        IFCHECKEX(1) printf("\n Outer final state: %ld",(long)(nS-UD_FS(_this,nU)));
+        lpT=NULL;
+        while ((lpT=CFst_STI_TtoS(lpIterator,nS-UD_FS(_this,nU),lpT))!=NULL)
         {
-          /* Find out if there are transitions leading to current final state,
-             if yes, detour them */
-          IFCHECKEX(1) printf("\n Outer final state: %ld",(long)(nS-UD_FS(_this,nU)));
-          lpT=NULL;
-          while ((lpT=CFst_STI_TtoS(lpIterator,nS-UD_FS(_this,nU),lpT))!=NULL)
-          {
-            IFCHECKEX(1)
-              printf("\n Detour transition: %ld --> (%ld ~> %ld)",(long)*CFst_STI_TIni(lpIterator,lpT),
-                  (long)*CFst_STI_TTer(lpIterator,lpT),(long)UD_XS(_this,nU)-1);
-
-            /* Set terminal state of transition lpT to the new final state */
-            *CFst_STI_TTer(lpIterator,lpT) = UD_XS(_this,nU)-1;
-          }
+          IFCHECKEX(1)
+            printf("\n Detour transition: %ld --> (%ld ~> %ld)",(long)*CFst_STI_TIni(lpIterator,lpT),
+                (long)*CFst_STI_TTer(lpIterator,lpT),(long)UD_XS(_this,nU)-1);
+
+          /* Set terminal state of transition lpT to the new final state */
+          *CFst_STI_TTer(lpIterator,lpT) = UD_XS(_this,nU)-1;
         }
       }
     }
+  }
 
-    /* Destroy graph iterator */
-    CFst_STI_Done(lpIterator);
+  /* Destroy graph iterator */
+  CFst_STI_Done(lpIterator);
+}
+
+/*
+ * Manual page at fst_man.def
+ */
+INT16 CGEN_PUBLIC CFst_Fsunify(CFst* _this, INT32 nUnit)
+{
+  INT32 nU = 0;
+
+  for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
+  {
+    /* Unify final states of unit */
+    CFst_FsunifyUnit(_this,nU);
 
     /* Stop in single unit mode */
     if (nUnit>=0) break;
@@ -215,17 +229,20 @@ INT16 CGEN_PRIVATE CFst_TreeUnit_Walk
 }
 
 /**
- * Expands one unit into a tree. There are no checks performed.
+ * Expands one unit into a tree. There are no checks performed and errors are
+ * not reported, so the function may run on a worker thread (see CFst_Units).
  *
  * @param _this Pointer to this (destination) automaton instance
  * @param itSrc Pointer to source automaton instance
  * @param nUnit Index of unit to process
- * @return O_K if successfull, a (negative) error code otherwise
+ * @return O_K if successfull, FST_PATHTOOLONG if paths were cut at the
+ *         maximal length, FST_INTERNAL on internal errors
  * @see Tree CFst_Tree
  */
 INT16 CGEN_PROTECTED CFst_TreeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
 {
   FST_TID_TYPE* lpTI = NULL;                                                   /* Automaton iterator data structure */
+  INT16         nErr = O_K;                                                    /* Error code                        */
 
   /* Verify parameters */
   DLPASSERT(_this!=itSrc);
@@ -246,12 +263,59 @@ INT16 CGEN_PROTECTED CFst_TreeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
   lpTI = CFst_STI_Init(itSrc,nUnit,FSTI_SORTINI);
   switch (CFst_TreeUnit_Walk(_this,lpTI,0,0,0))
   {
-  case -1: IERROR(_this,FST_PATHTOOLONG,"expanding",nUnit,0); break;
-  case -2: IERROR(_this,FST_INTERNAL,__FILE__,__LINE__,0   ); break;
+  case -1: nErr = FST_PATHTOOLONG; break;
+  case -2: nErr = FST_INTERNAL;    break;
   }
   CFst_STI_Done(lpTI);
 
-  return O_K;
+  return nErr;
+}
+
+/**
+ * Arguments of the unit operation of {@link Tree CFst_Tree}.
+ */
+typedef struct fst_tree_args
+{
+  CFst*  itOpt;                                                                /* Instance holding the options      */
+  INT32  nUnit;                                                                /* Unit to expand (-1 for all)       */
+  INT16* lpErr;                                                                /* Per unit: deferred error          */
+} FST_TREE_ARGS;
+
+/**
+ * Unit operation of {@link Tree CFst_Tree} (see CFst_Units). Expands the
+ * selected units and copies the others. Expansion errors are stored in the
+ * deferred errors and reported by the caller.
+ */
+static INT16 CFst_Tree_UnitFunc
+(
+  CFst*         _this,
+  CFst*         itSrc,
+  FST_UWS_TYPE* lpWs,
+  void*         lpArg
+)
+{
+  FST_TREE_ARGS* lpA   = (FST_TREE_ARGS*)lpArg;                                /* Arguments                         */
+  CFst*          itOpt = lpA->itOpt;                                           /* Instance holding the options      */
+
+  CFst_Reset(BASEINST(_this),TRUE);
+  BASEINST(_this)->m_nCheck    = BASEINST(itOpt)->m_nCheck;
+  _this->m_nMaxLen   = itOpt->m_nMaxLen;
+  _this->m_nClimit   = itOpt->m_nClimit;
+  _this->m_bNoloops  = itOpt->m_bNoloops;
+  _this->m_bClimit   = itOpt->m_bClimit;
+  _this->m_bIndex    = itOpt->m_bIndex;
+  if (_this->m_bClimit)
+    itSrc->m_nIcSdAux = CData_FindComp(AS(CData,itSrc->sd),"CLMT");
+
+  if (lpA->nUnit<0 || lpA->nUnit==lpWs->nUnit)
+  {
+    IFCHECK printf("\n Expanding unit %ld\n -------------------",(long)lpWs->nUnit);
+    lpA->lpErr[lpWs->nUnit] = CFst_TreeUnit(_this,itSrc,0);
+    IFCHECK printf("\n -------------------");
+    return O_K;
+  }
+  IFCHECK printf("\n Copying unit %ld",(long)lpWs->nUnit);
+  return CFst_CopyUi(_this,itSrc,NULL,0);
 }
 
 /*
@@ -259,11 +323,10 @@ INT16 CGEN_PROTECTED CFst_TreeUnit(CFst* _this, CFst* itSrc, INT32 nUnit)
  */
 INT16 CGEN_PUBLIC CFst_Tree(CFst* _this, CFst* itSrc, INT32 nUnit)
 {
-  CFst*     itUnit = NULL;                                                     /* Current unit                      */
-  INT32      nU     = 0;                                                        /* Current unit index                */
-  FST_ITYPE nS     = 0;                                                        /* Current state                     */
-  INT16     nErr   = O_K;                                                      /* Current error status              */
-  INT16     nRet   = O_K;                                                      /* Return value                      */
+  FST_TREE_ARGS rA;                                                            /* Arguments of unit operation       */
+  INT32         nU     = 0;                                                    /* Current unit index                */
+  FST_ITYPE     nS     = 0;                                                    /* Current state                     */
+  INT16         nRet   = O_K;                                                  /* Return value                      */
 
   CHECK_THIS_RV(NOT_EXEC);
   CFst_Check(_this);
@@ -303,7 +366,6 @@ INT16 CGEN_PUBLIC CFst_Tree(CFst* _this, CFst* itSrc, INT32 nUnit)
   CData_Scopy(AS(CData,_this->ud),AS(CData,itSrc->ud));
   CData_Scopy(AS(CData,_this->sd),AS(CData,itSrc->sd));
   CData_Scopy(AS(CData,_this->td),AS(CData,itSrc->td));
-  ICREATEEX(CFst,itUnit,"CFst_Tree~itUnit",NULL);
 
   /* Add and initialize cycle limits component to source */
   if (_this->m_bClimit)
@@ -320,33 +382,21 @@ INT16 CGEN_PUBLIC CFst_Tree(CFst* _this, CFst* itSrc, INT32 nUnit)
       );
   }
 
-  /* Loop over units */
-  for (nU=0; nU<UD_XXU(itSrc); nU++)
-  {
-    CFst_Reset(BASEINST(itUnit),TRUE);
-    BASEINST(itUnit)->m_nCheck    = BASEINST(_this)->m_nCheck;
-    itUnit->m_nMaxLen   = _this->m_nMaxLen;
-    itUnit->m_nClimit   = _this->m_nClimit;
-    itUnit->m_bNoloops  = _this->m_bNoloops;
-    itUnit->m_bClimit   = _this->m_bClimit;
-    itUnit->m_bIndex    = _this->m_bIndex;
-
-    if (nUnit<0 || nUnit==nU)
-    {
-      IFCHECK printf("\n Expanding unit %ld\n -------------------",(long)nU);
-      nErr=CFst_TreeUnit(itUnit,itSrc,nU);
-      IFCHECK printf("\n -------------------");
-    }
-    else
-    {
-      IFCHECK printf("\n Copying unit %ld",(long)nU);
-      nErr=CFst_CopyUi(itUnit,itSrc,NULL,nU);
-    }
-    IF_NOK(nErr) nRet=nErr;
-
-    nErr=CFst_Cat(_this,itUnit);
-    IF_NOK(nErr) nRet=nErr;
-  }
+  /* Expand units */
+  rA.itOpt = _this;
+  rA.nUnit = nUnit;
+  rA.lpErr = (INT16*)dlp_calloc(MAX(UD_XXU(itSrc),1),sizeof(INT16));
+  if (!rA.lpErr)
+    nRet = IERROR(_this,ERR_NOMEM,0,0,0);
+  else if ((nRet=CFst_Units(_this,itSrc,CFst_Tree_UnitFunc,&rA,FALSE))!=O_K)
+    IERROR(_this,nRet==ERR_NOMEM?ERR_NOMEM:NOT_EXEC,0,0,0);
+  else
+    for (nU=0; nU<UD_XXU(itSrc); nU++)
+      switch (rA.lpErr[nU])
+      {
+      case FST_PATHTOOLONG: IERROR(_this,FST_PATHTOOLONG,"expanding",nU,0); break;
+      case FST_INTERNAL   : IERROR(_this,FST_INTERNAL,__FILE__,__LINE__,0); break;
+      }
 
   /* Copy input and output symbol table */                                      /* --------------------------------- */
   CData_Copy(_this->is,itSrc->is);                                              /* Copy input symbol table           */
@@ -360,7 +410,7 @@ INT16 CGEN_PUBLIC CFst_Tree(CFst* _this, CFst* itSrc, INT32 nUnit)
   }
 
   /* Clean up */
-  IDESTROY(itUnit);
+  dlp_free(rA.lpErr);
   DESTROYVIRTUAL(itSrc,_this);
   CFst_Check(_this);                                                           /* TODO: Remove after debugging      */
 
@@ -625,7 +675,7 @@ INT16 CGEN_PUBLIC CFst_Excerpt
       IFCHECK printf("\n - forward...",nS);
       CFst_ResetStateFlag(itSrc,nUnit,SD_FLG_USER1);
       lpED->bBwd = FALSE;
-      lpTI = CFst_STI_Init(itSrc,nUnit,0/*HACK: Sorting not compatible with marking (and SLOWER)!*/);
+      lpTI = CFst_STI_Init(itSrc,nUnit,FSTI_ADJ);
       CFst_ExcerptWalk(lpTI,lpED,nS,0,0);
       CFst_STI_Done(lpTI);
       IFCHECKEX(2) printf("\n   "); IFCHECK printf("done.");
@@ -635,7 +685,7 @@ INT16 CGEN_PUBLIC CFst_Excerpt
       IFCHECK printf("\n - backward...",nS);
       CFst_ResetStateFlag(itSrc,nUnit,SD_FLG_USER1);
       lpED->bBwd = TRUE;
-      lpTI = CFst_STI_Init(itSrc,nUnit,0/*HACK: Sorting not compatible with marking (and SLOWER)!*/);
+      lpTI = CFst_STI_Init(itSrc,nUnit,FSTI_ADJ);
       CFst_ExcerptWalk(lpTI,lpED,nS,lpED->nXIs-1,0);
       CFst_STI_Done(lpTI);
       IFCHECKEX(2) printf("\n   "); IFCHECK printf("done.");
@@ -706,31 +756,247 @@ INT16 CGEN_PUBLIC CFst_Excerpt
   return O_K;
 }
 
+/**
+ * Restores the heap property of the Dijkstra queue of {@link SdistUnit
+ * CFst_SdistUnit} upwards from heap position <code>i</code>.
+ *
+ * @param _this Automaton instance (semiring type must be set)
+ * @param lpD   Distance array
+ * @param lpH   Heap (state indices)
+ * @param lpP   Heap positions of states
+ * @param i     Heap position to start at
+ */
+void CGEN_PRIVATE CFst_Sdist_Up
+(
+  CFst*      _this,
+  FST_WTYPE* lpD,
+  FST_ITYPE* lpH,
+  FST_ITYPE* lpP,
+  FST_ITYPE  i
+)
+{
+  FST_ITYPE nS  = lpH[i];                                                       /* State to sift up                   */
+  FST_ITYPE nPa = 0;                                                            /* Parent heap position               */
+
+  while (i>0)                                                                   /* Sift up                            */
+  {                                                                             /* >>                                 */
+    nPa = (i-1)/2;                                                              /*   Parent position                  */
+    if (!CFst_Wsr_Op(_this,lpD[nS],lpD[lpH[nPa]],OP_GREATER)) break;            /*   Not better than parent -> stop   */
+    lpH[i] = lpH[nPa]; lpP[lpH[i]] = i; i = nPa;                                /*   Move parent down                 */
+  }                                                                             /* <<                                 */
+  lpH[i] = nS; lpP[nS] = i;                                                     /* Place state                        */
+}
+
+/**
+ * Restores the heap property of the Dijkstra queue of {@link SdistUnit
+ * CFst_SdistUnit} downwards from heap position <code>i</code>.
+ *
+ * @param _this Automaton instance (semiring type must be set)
+ * @param lpD   Distance array
+ * @param lpH   Heap (state indices)
+ * @param lpP   Heap positions of states
+ * @param nSize Number of heap entries
+ * @param i     Heap position to start at
+ */
+void CGEN_PRIVATE CFst_Sdist_Down
+(
+  CFst*      _this,
+  FST_WTYPE* lpD,
+  FST_ITYPE* lpH,
+  FST_ITYPE* lpP,
+  FST_ITYPE  nSize,
+  FST_ITYPE  i
+)
+{
+  FST_ITYPE nS = lpH[i];                                                        /* State to sift down                 */
+  FST_ITYPE nC = 0;                                                             /* Child heap position                */
+
+  while ((nC=2*i+1)<nSize)                                                      /* Sift down                          */
+  {                                                                             /* >>                                 */
+    if (nC+1<nSize && CFst_Wsr_Op(_this,lpD[lpH[nC+1]],lpD[lpH[nC]],OP_GREATER))/*   Pick better child                */
+      nC++;                                                                     /*   |                                */
+    if (!CFst_Wsr_Op(_this,lpD[lpH[nC]],lpD[nS],OP_GREATER)) break;             /*   Child not better -> stop         */
+    lpH[i] = lpH[nC]; lpP[lpH[i]] = i; i = nC;                                  /*   Move child up                    */
+  }                                                                             /* <<                                 */
+  lpH[i] = nS; lpP[nS] = i;                                                     /* Place state                        */
+}
+
+/**
+ * Single-source shortest-distance engine. Computes the best (Viterbi) path
+ * weight from every state of unit <code>nUnit</code> to the set of final
+ * states. The distances are the state potentials as defined by {@link
+ * -potential}. The function picks the cheapest applicable algorithm:
+ * <ol>
+ *   <li>If the unit is acyclic, the states are processed once in reverse
+ *     topological order (Kahn's algorithm on the reversed graph).</li>
+ *   <li>If the unit is cyclic and no transition weight is better than the
+ *     neutral element of multiplication (i.e. non-negative log./trop. weights
+ *     or probabilities not exceeding 1), Dijkstra's algorithm is used.</li>
+ *   <li>Otherwise a FIFO queue based generic relaxation (Mohri) is used. The
+ *     relaxation fails if a state is dequeued more often than the maximal path
+ *     length which indicates a cycle of "negative" weight.</li>
+ * </ol>
+ * <p>The function reads the transitions from a {@link Cts_Pack compact
+ * transition store} ordered by terminal states. The transition table is not
+ * modified.</p>
+ *
+ * @param _this Automaton instance (semiring type must be set)
+ * @param nUnit Index of unit to process
+ * @param lpD   Pointer to a buffer of <code>UD_XS(_this,nUnit)</code> weights
+ *              to be filled with the distances
+ * @param lpCtr Pointer to an array of 5 event counters (units processed by
+ *              algorithms 1. to 3., state enumerations, transition
+ *              enumerations) to be incremented
+ * @return <code>O_K</code> if successful, <code>NOT_EXEC</code> if the
+ *         relaxation did not converge
+ */
+INT16 CGEN_PROTECTED CFst_SdistUnit
+(
+  CFst*      _this,
+  INT32      nUnit,
+  FST_WTYPE* lpD,
+  INT32*     lpCtr
+)
+{
+  FST_CTS_TYPE* lpCts   = NULL;                                                 /* Compact transition store           */
+  FST_ITYPE     nT      = 0;                                                    /* Current transition                 */
+  FST_ITYPE     nFS     = 0;                                                    /* First state of unit                */
+  FST_ITYPE     nXS     = 0;                                                    /* Number of states of unit           */
+  FST_ITYPE     nS      = 0;                                                    /* Current state                      */
+  FST_ITYPE     nIni    = 0;                                                    /* Initial state of curr. transition  */
+  INT32         nXL     = 0;                                                    /* Maximal path length                */
+  FST_WTYPE     nNeAdd  = 0.;                                                   /* Neutral element of addition        */
+  FST_WTYPE     nNeMult = 0.;                                                   /* Neutral element of multiplication  */
+  FST_WTYPE     nW      = 0.;                                                   /* Current accumulated weight         */
+  FST_ITYPE*    lpQ     = NULL;                                                 /* Topo. order, heap or FIFO queue    */
+  FST_ITYPE*    lpAux   = NULL;                                                 /* Out-degrees, heap pos. or counters */
+  BYTE*         lpInQ   = NULL;                                                 /* State in FIFO queue flags          */
+  FST_ITYPE     nQh     = 0;                                                    /* Queue head                         */
+  FST_ITYPE     nQn     = 0;                                                    /* Number of queue entries            */
+  BOOL          bNonneg = TRUE;                                                 /* No weight better than NeMult       */
+  INT16         nRet    = O_K;                                                  /* Return value                       */
+
+  /* Initialize */                                                              /* --------------------------------- */
+  nFS     = UD_FS(_this,nUnit);                                                 /* First state of unit               */
+  nXS     = UD_XS(_this,nUnit);                                                 /* Number of states of unit          */
+  nXL     = nXS>_this->m_nMaxLen ? nXS : _this->m_nMaxLen;                      /* Maximal path length               */
+  nNeAdd  = CFst_Wsr_NeAdd (_this->m_nWsr);                                     /* Neutral element of addition       */
+  nNeMult = CFst_Wsr_NeMult(_this->m_nWsr);                                     /* Neutral element of multiplication */
+  for (nS=0; nS<nXS; nS++)                                                      /* Initial distances                 */
+    lpD[nS] = (SD_FLG(_this,nS+nFS)&SD_FLG_FINAL) ? nNeMult : nNeAdd;           /* |                                 */
+  if (nXS<=0) return O_K;                                                       /* Nothing to be done                */
+  lpCts = CFst_Cts_Pack(_this,nUnit,FSTI_SORTTER);                              /* Pack ordered by terminal states   */
+  if (!lpCts->lpW) { CFst_Cts_Done(lpCts); return O_K; }                        /* Not weighted -> all done          */
+  lpQ   = (FST_ITYPE*)dlp_calloc(nXS,sizeof(FST_ITYPE));                        /* Allocate queue                    */
+  lpAux = (FST_ITYPE*)dlp_calloc(nXS,sizeof(FST_ITYPE));                        /* Allocate auxiliary state array    */
+
+  /* Count out-degrees and check weights */                                     /* --------------------------------- */
+  for (nT=0; nT<lpCts->nXT; nT++)                                               /* Loop over transitions             */
+  {                                                                             /* >>                                */
+    lpAux[lpCts->lpIni[nT]]++;                                                  /*   Count out-degree                */
+    if (CFst_Wsr_Op(_this,lpCts->lpW[nT],nNeMult,OP_GREATER))                   /*   Weight better than NeMult?      */
+      bNonneg = FALSE;                                                          /*     Dijkstra not applicable       */
+  }                                                                             /* <<                                */
+
+  /* 1. Reverse topological order */                                            /* --------------------------------- */
+  for (nS=0,nQn=0; nS<nXS; nS++)                                                /* Seed with states w/o successors   */
+    if (lpAux[nS]==0) lpQ[nQn++] = nS;                                          /* |                                 */
+  for (nQh=0; nQh<nQn; nQh++)                                                   /* Loop over states in order         */
+  {                                                                             /* >>                                */
+    nS = lpQ[nQh];                                                              /*   Next state (all succ. done)     */
+    lpCtr[3]++;                                                                 /*   Count state enumerations        */
+    for (nT=lpCts->lpOfs[nS]; nT<lpCts->lpOfs[nS+1]; nT++)                      /*   Loop over incoming transitions  */
+    {                                                                           /*   >>                              */
+      nIni = lpCts->lpIni[nT];                                                  /*     Initial state                 */
+      lpCtr[4]++;                                                               /*     Count transition enumerations */
+      if (lpD[nS]!=nNeAdd)                                                      /*     Terminal state reaches final  */
+      {                                                                         /*     >>                            */
+        nW = CFst_Wsr_Op(_this,lpCts->lpW[nT],lpD[nS],OP_MULT);                 /*       Weight via transition       */
+        if (CFst_Wsr_Op(_this,lpD[nIni],nW,OP_LESS)) lpD[nIni] = nW;            /*       Relax                       */
+      }                                                                         /*     <<                            */
+      if (--lpAux[nIni]==0) lpQ[nQn++] = nIni;                                  /*     All successors done -> enqueue*/
+    }                                                                           /*   <<                              */
+  }                                                                             /* <<                                */
+  if (nQn==nXS) { lpCtr[0]++; goto L_EXIT; }                                    /* Acyclic -> done                   */
+
+  /* Cyclic unit: start over */                                                 /* --------------------------------- */
+  for (nS=0; nS<nXS; nS++)                                                      /* Initial distances                 */
+    lpD[nS] = (SD_FLG(_this,nS+nFS)&SD_FLG_FINAL) ? nNeMult : nNeAdd;           /* |                                 */
+
+  if (bNonneg)                                                                  /* 2. Dijkstra                       */
+  {                                                                             /* >>                                */
+    lpCtr[1]++;                                                                 /*   Count algorithm                 */
+    for (nS=0,nQn=0; nS<nXS; nS++)                                              /*   Seed heap with final states     */
+      if (SD_FLG(_this,nS+nFS)&SD_FLG_FINAL) { lpQ[nQn]=nS; lpAux[nS]=nQn++; }  /*   | (all equal, no sifting)       */
+      else lpAux[nS] = -1;                                                      /*   | (-1: not in heap)             */
+    while (nQn>0)                                                               /*   Pop best state                  */
+    {                                                                           /*   >>                              */
+      nS = lpQ[0]; lpAux[nS] = -2;                                              /*     Settle (-2: settled)          */
+      if (--nQn>0)                                                              /*     Restore heap                  */
+      {                                                                         /*     >>                            */
+        lpQ[0] = lpQ[nQn]; lpAux[lpQ[0]] = 0;                                   /*       Last entry to top           */
+        CFst_Sdist_Down(_this,lpD,lpQ,lpAux,nQn,0);                             /*       Sift down                   */
+      }                                                                         /*     <<                            */
+      lpCtr[3]++;                                                               /*     Count state enumerations      */
+      for (nT=lpCts->lpOfs[nS]; nT<lpCts->lpOfs[nS+1]; nT++)                    /*     Loop over incoming transitions*/
+      {                                                                         /*     >>                            */
+        nIni = lpCts->lpIni[nT];                                                /*       Initial state               */
+        lpCtr[4]++;                                                             /*       Count trans. enumerations   */
+        if (lpAux[nIni]==-2) continue;                                          /*       Already settled             */
+        nW = CFst_Wsr_Op(_this,lpCts->lpW[nT],lpD[nS],OP_MULT);                 /*       Weight via transition       */
+        if (!CFst_Wsr_Op(_this,lpD[nIni],nW,OP_LESS)) continue;                 /*       No improvement              */
+        lpD[nIni] = nW;                                                         /*       Relax                       */
+        if (lpAux[nIni]<0) { lpQ[nQn]=nIni; lpAux[nIni]=nQn++; }                /*       Insert into heap            */
+        CFst_Sdist_Up(_this,lpD,lpQ,lpAux,lpAux[nIni]);                         /*       Sift up                     */
+      }                                                                         /*     <<                            */
+    }                                                                           /*   <<                              */
+  }                                                                             /* <<                                */
+  else                                                                          /* 3. Generic FIFO relaxation        */
+  {                                                                             /* >>                                */
+    lpCtr[2]++;                                                                 /*   Count algorithm                 */
+    lpInQ = (BYTE*)dlp_calloc(nXS,sizeof(BYTE));                                /*   Allocate queue flags            */
+    for (nS=0,nQh=0,nQn=0; nS<nXS; nS++)                                        /*   Seed queue with final states    */
+    {                                                                           /*   >>                              */
+      lpAux[nS] = 0;                                                            /*     Reset dequeue counter         */
+      if (SD_FLG(_this,nS+nFS)&SD_FLG_FINAL) { lpQ[nQn++]=nS; lpInQ[nS]=1; }    /*     Enqueue final state           */
+    }                                                                           /*   <<                              */
+    while (nQn>0)                                                               /*   Dequeue state                   */
+    {                                                                           /*   >>                              */
+      nS = lpQ[nQh]; nQh = (nQh+1)%nXS; nQn--; lpInQ[nS] = 0;                   /*     Pop head                      */
+      if (++lpAux[nS]>nXL) { nRet=NOT_EXEC; break; }                            /*     Does not converge             */
+      lpCtr[3]++;                                                               /*     Count state enumerations      */
+      for (nT=lpCts->lpOfs[nS]; nT<lpCts->lpOfs[nS+1]; nT++)                    /*     Loop over incoming transitions*/
+      {                                                                         /*     >>                            */
+        nIni = lpCts->lpIni[nT];                                                /*       Initial state               */
+        lpCtr[4]++;                                                             /*       Count trans. enumerations   */
+        nW = CFst_Wsr_Op(_this,lpCts->lpW[nT],lpD[nS],OP_MULT);                 /*       Weight via transition       */
+        if (!CFst_Wsr_Op(_this,lpD[nIni],nW,OP_LESS)) continue;                 /*       No improvement              */
+        lpD[nIni] = nW;                                                         /*       Relax                       */
+        if (!lpInQ[nIni]) { lpQ[(nQh+nQn++)%nXS]=nIni; lpInQ[nIni]=1; }         /*       Enqueue                     */
+      }                                                                         /*     <<                            */
+    }                                                                           /*   <<                              */
+  }                                                                             /* <<                                */
+
+L_EXIT:
+  /* Clean up */                                                                /* --------------------------------- */
+  dlp_free(lpInQ);                                                              /* Free queue flags                  */
+  dlp_free(lpAux);                                                              /* Free auxiliary state array        */
+  dlp_free(lpQ);                                                                /* Free queue                        */
+  CFst_Cts_Done(lpCts);                                                         /* Release transition store          */
+  return nRet;                                                                  /* Return                            */
+}
+
 /*
  * Manual at fst_man.def
  */
 INT16 CGEN_PUBLIC CFst_Potential(CFst* _this, INT32 nUnit)
 {
-  FST_TID_TYPE* lpTI    = NULL;                                                /* Graph iterator data struct         */
-  BYTE*         lpT     = NULL;                                                /* Current transition                 */
-  INT32          nIcP    = -1;                                                  /* Component index of potential       */
-  FST_WTYPE     nNeAdd  = 0.;                                                  /* Neutral element of addition        */
-  FST_WTYPE     nNeMult = 0.;                                                  /* Neutral element of multiplication  */
-  INT32          nU      = 0;                                                   /* Current unit                       */
-  FST_ITYPE     nS      = 0;                                                   /* Current state                      */
-  FST_ITYPE     nFS     = 0;                                                   /* First state of current unit        */
-  FST_ITYPE     nXS     = 0;                                                   /* Number of states in current unit   */
-  FST_ITYPE     nIni    = 0;                                                   /* Initial state of current transition*/
-  INT32          nL      = 0;                                                   /* Current Viterbi search layer       */
-  INT32          nXL     = 0;                                                   /* Maximal number of search layers    */
-  INT32          nB      = 0;                                                   /* Current beam width                 */
-  FST_WTYPE     nW      = 0.;                                                  /* Current accumulated weight         */
-  FST_WTYPE*    lpPIni  = NULL;                                                /* Ptr.to potential of curr.ini.state */
-  FST_WTYPE*    lpPTer  = NULL;                                                /* Ptr.to potential of curr.ter.state */
-  BYTE*         lpLBrd  = NULL;                                                /* Write state presence layer buffer  */
-  BYTE*         lpLBwr  = NULL;                                                /* Read state presence layer buffer   */
-  BYTE*         lpSwap  = NULL;                                                /* Buffer swapping pointer            */
-  INT32          nCtr[]  = {0,0,0};                                             /* Event counters                     */
+  INT32      nIcP   = -1;                                                       /* Component index of potential       */
+  INT32      nU     = 0;                                                        /* Current unit                       */
+  FST_ITYPE  nS     = 0;                                                        /* Current state                      */
+  FST_ITYPE  nFS    = 0;                                                        /* First state of current unit        */
+  FST_WTYPE* lpD    = NULL;                                                     /* Distances of states of curr. unit  */
+  INT32      nCtr[] = {0,0,0,0,0};                                              /* Event counters                     */
 
   /* Validate */
   CHECK_THIS_RV(0);
@@ -748,8 +1014,6 @@ INT16 CGEN_PUBLIC CFst_Potential(CFst* _this, INT32 nUnit)
 
   /* Initialize */
   _this->m_nWsr = CFst_Wsr_GetType(_this,&_this->m_nIcW);
-  nNeAdd        = CFst_Wsr_NeAdd (_this->m_nWsr);
-  nNeMult       = CFst_Wsr_NeMult(_this->m_nWsr);
 
   /* Create potential component in state table */
   nIcP = CData_FindComp(AS(CData,_this->sd),NC_SD_POT);
@@ -762,85 +1026,17 @@ INT16 CGEN_PUBLIC CFst_Potential(CFst* _this, INT32 nUnit)
   /* Loop over units */
   for (nU=nUnit<0?0:nUnit; nU<UD_XXU(_this); nU++)
   {
-    /* Initialize search */
-    nFS    = UD_FS(_this,nU);
-    nXS    = UD_XS(_this,nU);
-    nXL    = nXS>_this->m_nMaxLen ? nXS : _this->m_nMaxLen;
-    lpTI   = CFst_STI_Init(_this,nU,FSTI_SORTTER);
-    lpLBrd = (BYTE*)dlp_calloc(UD_XS(_this,nU),sizeof(BYTE));
-    lpLBwr = (BYTE*)dlp_calloc(UD_XS(_this,nU),sizeof(BYTE));
-
-    for (nS=0,nB=0; nS<nXS; nS++)
-    {
-      *(FST_WTYPE*)CData_XAddr(AS(CData,_this->sd),nS+nFS,nIcP) = nNeAdd;
-      lpLBrd[nS] = 0;
-      if (SD_FLG(_this,nS+nFS)&0x01)
-      {
-        *(FST_WTYPE*)CData_XAddr(AS(CData,_this->sd),nS+nFS,nIcP) = nNeMult;
-        lpLBrd[nS] = 1;
-        nB++;
-      }
-      lpLBwr[nS] = 0;
-    }
-
-    /* Viterbi traversal */
-    for (nL=0; nB>0 && nL<=nXL; nL++)
-    {
-      IFCHECKEX(1) { printf("\n   nL=%ld:",(long)nL); nCtr[0]++; }
-
-      /* Walk one step */
-      for (nS=0,nB=0; nS<nXS; nS++)
-        if (lpLBrd[nS])
-        {
-          IFCHECKEX(1   ) nCtr[1]++;
-          IFDOPRINT(2,nL) printf("\n     nS=%ld",(long)nS);
-
-          /* For all transitions arriving at state nS... */
-          lpT = NULL;
-          while ((lpT=CFst_STI_TtoS(lpTI,nS,lpT))!=NULL)
-          {
-            nIni   = *CFst_STI_TIni(lpTI,lpT);
-            lpPIni = (FST_WTYPE*)CData_XAddr(AS(CData,_this->sd),nIni+nFS,nIcP);
-            lpPTer = (FST_WTYPE*)CData_XAddr(AS(CData,_this->sd),nS  +nFS,nIcP);
-            nW     = CFst_Wsr_Op(_this,*CFst_STI_TW(lpTI,lpT),*lpPTer,OP_MULT);
-
-            IFCHECKEX(1) nCtr[2]++;
-            IFDOPRINT(2,nL)
-              printf("\n         %ld (w=%5g) --(w=%5g)--> %ld (w=%5g); newweight=%5g",
-              (long)nIni,(double)*lpPIni,(double)*CFst_STI_TW(lpTI,lpT),(long)nS,(double)*lpPTer,(double)nW);
-
-            if (CFst_Wsr_Op(_this,*lpPIni,nW,OP_LESS))
-            {
-              if (lpLBwr[nIni]==0) nB++;
-              lpLBwr[nIni] = 1;
-              *lpPIni      = nW;
-            }
-          }
-        }
-
-      /* Finish layer */
-      lpSwap = lpLBrd; lpLBrd = lpLBwr; lpLBwr = lpSwap;
-      for (nS=0; nS<nXS; nS++) lpLBwr[nS]=0;
-
-      /* Protocol */
-      IFDOPRINT(2,nL) printf("\n    ");
-      IFCHECKEX(1   ) printf(" beamwidth=%ld",(long)nB);
-      IFDOPRINT(2,nL)
-      {
-        printf("\n    continue <cr>, no print -1, nonstop -2: ");
-        dlp_getx(T_SHORT,&_this->m_nPrintstop);
-      }
-    }
-
-    /* Clean up */
-    dlp_free(lpLBrd);
-    dlp_free(lpLBwr);
-    CFst_STI_Done(lpTI);
-
-    /* Verification */
-    if (nL==_this->m_nMaxLen && nB>0)
+    /* Compute shortest distances to final states */
+    nFS = UD_FS(_this,nU);
+    lpD = (FST_WTYPE*)dlp_calloc(UD_XS(_this,nU)+1,sizeof(FST_WTYPE));
+    if (CFst_SdistUnit(_this,nU,lpD,nCtr)!=O_K)
       IERROR(_this,FST_PATHTOOLONG,"calculating potential of",nU,0);
 
+    /* Store potentials */
+    for (nS=0; nS<UD_XS(_this,nU); nS++)
+      *(FST_WTYPE*)CData_XAddr(AS(CData,_this->sd),nS+nFS,nIcP) = lpD[nS];
+    dlp_free(lpD);
+
     /* Stop in single unit mode */
     if (nUnit>=0) break;
   }
@@ -849,10 +1045,12 @@ INT16 CGEN_PUBLIC CFst_Potential(CFst* _this, INT32 nUnit)
   IFCHECKEX(1)
   {
     printf("\n\n   FST instance      : %s" ,BASEINST(_this)->m_lpInstanceName);
-    printf("\n   Search layers     : %ld",(long)nCtr[0]);
-    printf("\n   Node enumerations : %ld",(long)nCtr[1]);
-    printf("\n   Trans enumerations: %ld",(long)nCtr[2]);
-    printf("\n\n CFst_Paths done.\n");
+    printf("\n   Acyclic units     : %ld",(long)nCtr[0]);
+    printf("\n   Dijkstra units    : %ld",(long)nCtr[1]);
+    printf("\n   Relaxation units  : %ld",(long)nCtr[2]);
+    printf("\n   Node enumerations : %ld",(long)nCtr[3]);
+    printf("\n   Trans enumerations: %ld",(long)nCtr[4]);
+    printf("\n\n CFst_Potential done.\n");
     dlp_fprint_x_line(stdout,'-',dlp_maxprintcols());
     printf("\n");
   }
@@ -1051,8 +1249,9 @@ INT16 CGEN_PUBLIC CFst_PushWeights(CFst* _this, CFst* itSrc, INT32 nUnit)
   CFst* itUnit = NULL;                                                         /* Current unit                      */
   INT32  nU     = 0;                                                            /* Current unit index                */
   INT32  nIcP;
-  FST_TID_TYPE* lpTI;
-  BYTE *lpT;
+  FST_CTS_TYPE* lpCts;
+  FST_WTYPE* lpP;
+  FST_ITYPE nT;
 
   /* Validation */
   CHECK_THIS_RV(NOT_EXEC);
@@ -1079,16 +1278,22 @@ INT16 CGEN_PUBLIC CFst_PushWeights(CFst* _this, CFst* itSrc, INT32 nUnit)
     CFst_CopyUi(itUnit,itSrc,NULL,nU);
     CFst_Potential(itUnit,0);
     nIcP=CData_FindComp(AS(CData,itUnit->sd),NC_SD_POT);
-    lpTI=CFst_STI_Init(itUnit,0,0);
-    for(lpT=NULL;(lpT=CFst_STI_TfromS(lpTI,-1,lpT));)
+    lpCts=CFst_Cts_Pack(itUnit,0,0);
+    if(lpCts->lpW)
     {
-      FST_WTYPE *nW=CFst_STI_TW(lpTI,lpT);
-      if(*CFst_STI_TTer(lpTI,lpT)!=0)
-        *nW=CFst_Wsr_Op(itUnit,*nW,CData_Dfetch(AS(CData,itUnit->sd),*CFst_STI_TTer(lpTI,lpT),nIcP),OP_MULT);
-      if(*CFst_STI_TIni(lpTI,lpT)!=0)
-        *nW=CFst_Wsr_Op(itUnit,*nW,CData_Dfetch(AS(CData,itUnit->sd),*CFst_STI_TIni(lpTI,lpT),nIcP),OP_DIV);
+      lpP=(FST_WTYPE*)dlp_calloc(lpCts->nXS+1,sizeof(FST_WTYPE));
+      CData_DcompFetch(AS(CData,itUnit->sd),lpP,nIcP,lpCts->nXS);
+      for(nT=0;nT<lpCts->nXT;nT++)
+      {
+        if(lpCts->lpTer[nT]!=0)
+          lpCts->lpW[nT]=CFst_Wsr_Op(itUnit,lpCts->lpW[nT],lpP[lpCts->lpTer[nT]],OP_MULT);
+        if(lpCts->lpIni[nT]!=0)
+          lpCts->lpW[nT]=CFst_Wsr_Op(itUnit,lpCts->lpW[nT],lpP[lpCts->lpIni[nT]],OP_DIV);
+      }
+      dlp_free(lpP);
+      CFst_Cts_Unpack(lpCts);
     }
-    CFst_STI_Done(lpTI);
+    CFst_Cts_Done(lpCts);
     CFst_Cat(_this,itUnit);
   }
 
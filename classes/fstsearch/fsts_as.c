@@ -72,9 +72,10 @@ const char *fsts_as_init(struct fsts_glob *glob){
   if(glob->cfg.as.aheu==AS_AH_POT && (err=fsts_fstpw(&glob->src))) return err;
   if(!(algo=(struct fsts_as_algo *)calloc(1,sizeof(struct fsts_as_algo)))) return FSTSERR("out of memory");
   glob->algo=algo;
-  if((err=fsts_btm_init(&algo->btm,&glob->cfg))) return err;
+  if((err=fsts_btm_init(&algo->btm,&glob->cfg,NULL))) return err;
+  if((err=fsts_stkinit(&algo->stkh,0))) return err;
   if((err=fsts_as_lsinit(&algo->ls,&algo->btm,&glob->cfg))) return err;
-  if((err=fsts_as_sgen(&s,NULL,NULL,NULL,&algo->btm))) return err;
+  if((err=fsts_as_sgen(&s,NULL,NULL,NULL,&algo->btm,&algo->stkh))) return err;
   s.w=glob->src.units[0].pot0;
   if(!(algo->res=(struct fsts_as_s**)calloc(glob->cfg.numpaths,sizeof(struct fsts_as_s*)))) return FSTSERR("out of memory");
   return fsts_as_lsadd(&algo->ls,&s,0);
@@ -91,6 +92,7 @@ void fsts_as_free(struct fsts_glob *glob){
   if(!glob->algo) return;
   fsts_as_lsfree(&algo->ls);
   fsts_btm_free(&algo->btm);
+  fsts_stkfree(&algo->stkh);
   free(algo->res);
   free(glob->algo);
   glob->algo=NULL;
@@ -100,19 +102,43 @@ void fsts_as_free(struct fsts_glob *glob){
  *
  * This function reduces the timevariant weights
  * by the frame mininal weight. The offset is
- * stored in w->wo.
+ * stored in w->w0. If the weights are stored in
+ * the source data instance they are copied first.
  *
  * @param w  Timevariant weights
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */
-void fsts_as_sheumin(struct fsts_w *w){
-  INT32 f;
+const char *fsts_as_sheumin(struct fsts_w *w){
+  INT32 f,s;
+  if(fsts_wref(w)){
+    void *wc;
+    if(!(wc=malloc(w->ns*w->nf*fsts_wsize(w)))) return FSTSERR("out of memory");
+    w->w=memcpy(wc,w->w,w->ns*w->nf*fsts_wsize(w));
+  }
   for(f=0;f<w->nf;f++){
-    INT32 s;
-    FLOAT64 w0=w->w[w->ns*f];
-    for(s=1;s<w->ns;s++) if(w->w[w->ns*f+s]<w0) w0=w->w[w->ns*f+s];
-    for(s=0;s<w->ns;s++) w->w[w->ns*f+s]-=w0;
-    w->w0+=w0;
+    struct fsts_w wf;
+    fsts_wf(w,f,&wf);
+    if(w->t==T_DOUBLE){
+      FLOAT64 *wd=(FLOAT64*)wf.w, w0=wd[0];
+      for(s=1;s<w->ns;s++) if(wd[s]<w0) w0=wd[s];
+      for(s=0;s<w->ns;s++) wd[s]-=w0;
+      w->w0+=w0;
+    }else if(w->t==T_FLOAT){
+      FLOAT32 *wd=(FLOAT32*)wf.w, w0=wd[0];
+      for(s=1;s<w->ns;s++) if(wd[s]<w0) w0=wd[s];
+      for(s=0;s<w->ns;s++) wd[s]-=w0;
+      w->w0+=w0;
+    }else{
+      UINT16 *wd=(UINT16*)wf.w, q0=wd[0];
+      for(s=1;s<w->ns;s++) if(wd[s]<q0) q0=wd[s];
+      if(q0==FSTS_WQINF) continue;
+      for(s=0;s<w->ns;s++) if(wd[s]!=FSTS_WQINF) wd[s]-=q0;
+      w->w0+=w->wo+q0*w->wq;
+    }
   }
+  /* The quantization offset is part of w->w0 now */
+  w->wo=0.;
+  return NULL;
 }
 
 /* A* decoder search function
@@ -132,10 +158,9 @@ const char *fsts_as_isearch(struct fsts_glob *glob,struct fsts_w *w){
   FLOAT64 *wmin;
   INT32 f;
   UINT16 nres=0;
-  if(glob->src.maxstk && !glob->cfg.stkprn) fprintf(stderr,"WARN: algo=as decoder will be slow with stkprn=FALSE\n");
   algo->ls.h.schg[0]=(void**)&s1;
-  fsts_as_mapinit(algo->ls.map,(w->nf+1)*glob->src.units[0].ns); /* TODO: increase map by stk bits */
-  if(glob->cfg.as.sheu==AS_SH_MIN) fsts_as_sheumin(w);
+  fsts_as_mapinit(algo->ls.map,w->nf+1,glob->src.units[0].ns,glob->src.maxstk && !glob->cfg.stkprn);
+  if(glob->cfg.as.sheu==AS_SH_MIN && w->w && (err=fsts_as_sheumin(w))) return err;
   wmin=(FLOAT64*)malloc((w->nf+1)*sizeof(FLOAT64));
   for(f=0;f<=w->nf;f++) wmin[f]=T_DOUBLE_MAX;
   algo->f=0;
@@ -164,14 +189,18 @@ const char *fsts_as_isearch(struct fsts_glob *glob,struct fsts_w *w){
         if(t->is>=0 && !wf.w && s1->f) continue;
         s2.f=s1->f;
         if(t->is>=0 && wf.w) s2.f++;
-        if(t->stk<0 && (!s1->nstk || s1->stk[s1->nstk-1]!=-t->stk)) continue;
+        if(t->stk<0 && fsts_stktop(s1->stk)!=-t->stk) continue;
         s2.s=t->ter;
         s2.id=s2.f*u->ns+s2.s;
-        /* TODO: update s2.id by new stk */
-        if((!glob->src.maxstk || glob->cfg.stkprn) && fsts_as_mapget(algo->ls.map,s2.id)) continue;
-        if((err=fsts_as_sgen(&s2,s1,t,&wf,&algo->btm))) return err;
+        if(!algo->ls.map.stk && fsts_as_mapget(algo->ls.map,s2.f,s2.s,0)) continue;
+        if((err=fsts_as_sgen(&s2,s1,t,&wf,&algo->btm,&algo->stkh))) return err;
+        if(!glob->cfg.stkprn) s2.id^=fsts_stkkey(s2.stk);
+        if(algo->ls.map.stk && fsts_as_mapget(algo->ls.map,s2.f,s2.s,fsts_stkid(s2.stk))){
+          if((err=fsts_as_sfree(&s2,NULL,&algo->btm))) return err;
+          continue;
+        }
         if(glob->cfg.as.prnw && s2.w-glob->cfg.as.prnw>=wmin[s2.f]){
-          fsts_as_sfree(&s2,NULL,&algo->btm);
+          if((err=fsts_as_sfree(&s2,NULL,&algo->btm))) return err;
           continue;
         }
         #ifdef _DEBUG
@@ -183,9 +212,9 @@ const char *fsts_as_isearch(struct fsts_glob *glob,struct fsts_w *w){
         if(glob->debug>=4) printf("\n");
         #endif
       }
-      if(u->sfin[s1->s] && !wf.w && !s1->nstk){
+      if(u->sfin[s1->s] && !wf.w && !s1->stk){
         struct fsts_as_s *s2=(struct fsts_as_s *)fsts_memget(&algo->ls.h.mem);
-        if((err=fsts_as_sgen(s2,s1,NULL,NULL,&algo->btm))) return err;
+        if((err=fsts_as_sgen(s2,s1,NULL,NULL,&algo->btm,&algo->stkh))) return err;
         #ifdef _DEBUG
         if(glob->debug>=4) printf("  >fin: f %4i s %8i w %8.1f os: 0x%08x\n",s2->f,s2->s,s2->w,glob->cfg.numpaths>1?BTHASH(s2->bt.os):0);
         #endif
@@ -193,7 +222,7 @@ const char *fsts_as_isearch(struct fsts_glob *glob,struct fsts_w *w){
         algo->res[nres++]=s2;
       }
     }
-    fsts_as_lsfins(&algo->ls,s1,prn);
+    if((err=fsts_as_lsfins(&algo->ls,s1,prn))) return err;
   }
   if(glob->debug>=1){
     if(glob->debug>=2) printf("Info:\n");
@@ -202,12 +231,14 @@ const char *fsts_as_isearch(struct fsts_glob *glob,struct fsts_w *w){
     printf("  %s\n",fsts_hdbg(&algo->ls.h,1));
     printf("  %s\n",fsts_btmdbg(&algo->btm,1));
     printf("  map %4iMB\n",FSTSMB(algo->ls.map.n));
+    if(algo->stkh.num) printf("  stk %8u\n",algo->stkh.num);
   }
   glob->mem = 
     sizeof(struct fsts_as_algo) +
     fsts_as_qmem(&algo->ls.q) +
     fsts_hmem(&algo->ls.h) +
     fsts_as_mapmem(algo->ls.map) +
+    fsts_stkmem(&algo->stkh) +
     fsts_btmmem1(&algo->btm);
   fsts_as_mapfree(algo->ls.map);
   free(wmin);
@@ -230,9 +261,9 @@ const char *fsts_as_backtrack(struct fsts_glob *glob,CFst *itDst){
   UINT32 i;
   if((err=fsts_btstart(&bti,glob,&algo->btm,itDst))) return err;
   for(i=0;i<glob->cfg.numpaths && (s=algo->res[i]);i++){
-    fsts_btpath(&bti,s->w,&s->bt);
+    if((err=fsts_btpath(&bti,s->w,&s->bt))) return err;
     if(glob->state==FS_SEARCHING) break;
-    fsts_as_sfree(s,NULL,&algo->btm);
+    if((err=fsts_as_sfree(s,NULL,&algo->btm))) return err;
   }
   if(glob->debug>=1 && algo->btm.lat.head) printf("  lat %4iMB\n",FSTSMB(fsts_latsize(&algo->btm.lat)));
   glob->mem += fsts_btmmem2(&algo->btm);
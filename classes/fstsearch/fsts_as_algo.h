@@ -42,6 +42,7 @@ struct fsts_as_algo {
   UINT64             nstates; /* Number of expanded states   */
   struct fsts_as_ls  ls;      /* State storage               */
   struct fsts_btm    btm;     /* Backtrack memory            */
+  struct fsts_stkh   stkh;    /* Pushdown stack memory       */
   struct fsts_as_s **res;     /* Path end states             */
 };
 
@@ -41,7 +41,7 @@ const char *fsts_as_lsinit(struct fsts_as_ls *ls,struct fsts_btm *btm,struct fst
   ls->numpaths=cfg->numpaths;
   ls->btm=btm;
   if((err=fsts_hinit(&ls->h,sizeof(struct fsts_as_s),cfg->numpaths,cfg->stkprn?NULL:fsts_as_scmpstk))) return err;
-  if((err=fsts_as_qinit(&ls->q,cfg->as.qsize))) return err;
+  if((err=fsts_as_qinit(&ls->q,cfg->as.qsize,&ls->h,btm))) return err;
   return NULL;
 }
 
@@ -74,13 +74,13 @@ const char *fsts_as_lsadd(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 dbg){
     #ifdef _DEBUG
     if(dbg>=4) printf(" => %s0 (w: %8.1f os: 0x%08x)",sh->w<=s->w?"del":"rpl",sh->w,sh->bt.os?BTHASH(sh->bt.os):0);
     #endif
-    if(sh->w<=s->w) fsts_as_sfree(s,sh,ls->btm); else{
+    if(sh->w<=s->w){ if((err=fsts_as_sfree(s,sh,ls->btm))) return err; }else{
       #ifdef OPT_AVL
       struct fsts_as_qs *qp=sh->qs;
       #else
       UINT32 qp=sh->qp;
       #endif
-      fsts_as_sfree(sh,s,ls->btm);
+      if((err=fsts_as_sfree(sh,s,ls->btm))) return err;
       *sh=*s;
       if((err=fsts_as_qrpl(&ls->q,sh,qp))) return err;
     }
@@ -94,13 +94,13 @@ const char *fsts_as_lsadd(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 dbg){
       #ifdef _DEBUG
       if(dbg>=4) printf(" => %s%i (w: %8.1f os: 0x%08x)",sh->w<=s->w?"del":"rpl",i,sh->w,BTHASH(sh->bt.os));
       #endif
-      if(sh->w<=s->w) fsts_as_sfree(s,sh,ls->btm); else{
+      if(sh->w<=s->w){ if((err=fsts_as_sfree(s,sh,ls->btm))) return err; }else{
         #ifdef OPT_AVL
         struct fsts_as_qs *qp=sh->qs;
         #else
         UINT32 qp=sh->qp;
         #endif
-        fsts_as_sfree(sh,s,ls->btm);
+        if((err=fsts_as_sfree(sh,s,ls->btm))) return err;
         *sh=*s;                                         /* insert the state */
         if((err=fsts_as_qrpl(&ls->q,sh,qp))) return err;
       }
@@ -124,13 +124,13 @@ const char *fsts_as_lsadd(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 dbg){
         #ifdef _DEBUG
         if(dbg>=4) printf(" => %sX (w: %8.1f os: 0x%08x)",shmax->w<=s->w?"del":"rpl",shmax->w,BTHASH(shmax->bt.os));
         #endif
-        if(shmax->w<=s->w) fsts_as_sfree(s,shmax,ls->btm); else {
+        if(shmax->w<=s->w){ if((err=fsts_as_sfree(s,shmax,ls->btm))) return err; }else {
           #ifdef OPT_AVL
           struct fsts_as_qs *qp=shmax->qs;
           #else
           UINT32 qp=shmax->qp;
           #endif
-          fsts_as_sfree(shmax,s,ls->btm);
+          if((err=fsts_as_sfree(shmax,s,ls->btm))) return err;
           *shmax=*s;                                         /* insert the state */
           if((err=fsts_as_qrpl(&ls->q,shmax,qp))) return err;
         }
@@ -147,8 +147,77 @@ const char *fsts_as_lsadd(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 dbg){
   return NULL;
 }
 
-void fsts_as_lsfins(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 prn){
+/* Hash function of the done map keys */
+#define fsts_as_mapkhash(f,s,stk) ((((UINT32)(f)*0x9E3779B1)^((UINT32)(s)*0x85EBCA77)^((UINT32)(stk)*0xC2B2AE3D))>>7)
+
+/* A* state done map lookup function (stack mode)
+ *
+ * @param map The state done map
+ * @param f   Frame
+ * @param s   State
+ * @param stk Pushdown stack id
+ * @return 1 if the state is done, 0 otherwise
+ */
+UINT8 fsts_as_mapkget(struct fsts_as_map *map,UINT32 f,UINT32 s,UINT32 stk){
+  UINT32 i;
+  if(!map->k) return 0;
+  for(i=fsts_as_mapkhash(f,s,stk)&map->kmask;map->k[i].f!=FSTS_AS_MAPKNONE;i=(i+1)&map->kmask)
+    if(map->k[i].f==f && map->k[i].s==s && map->k[i].stk==stk) return 1;
+  return 0;
+}
+
+/* A* state done map insert function (stack mode)
+ *
+ * This function records a state in the hash set.
+ * The set is doubled when it is half full.
+ *
+ * @param map The state done map
+ * @param f   Frame
+ * @param s   State
+ * @param stk Pushdown stack id
+ * @return 0 if out of memory, 1 otherwise
+ */
+UINT8 fsts_as_mapkon(struct fsts_as_map *map,UINT32 f,UINT32 s,UINT32 stk){
+  UINT32 i;
+  if(2*(map->kn+1)>map->kmask){
+    struct fsts_as_mapk *k=map->k;
+    UINT32 j,kmask=map->kmask;
+    map->kmask=kmask ? 2*kmask+1 : 0xfff;
+    if(!(map->k=(struct fsts_as_mapk*)malloc((map->kmask+1)*sizeof(struct fsts_as_mapk)))){ map->k=k; map->kmask=kmask; return 0; }
+    memset(map->k,0xff,(map->kmask+1)*sizeof(struct fsts_as_mapk));
+    if(k) for(j=0;j<=kmask;j++) if(k[j].f!=FSTS_AS_MAPKNONE){
+      for(i=fsts_as_mapkhash(k[j].f,k[j].s,k[j].stk)&map->kmask;map->k[i].f!=FSTS_AS_MAPKNONE;i=(i+1)&map->kmask) {}
+      map->k[i]=k[j];
+    }
+    map->n+=(map->kmask+1-(k?kmask+1:0))*sizeof(struct fsts_as_mapk);
+    free(k);
+  }
+  for(i=fsts_as_mapkhash(f,s,stk)&map->kmask;map->k[i].f!=FSTS_AS_MAPKNONE;i=(i+1)&map->kmask)
+    if(map->k[i].f==f && map->k[i].s==s && map->k[i].stk==stk) return 1;
+  map->k[i].f=f;
+  map->k[i].s=s;
+  map->k[i].stk=stk;
+  map->kn++;
+  return 1;
+}
+
+/* A* active state finish function
+ *
+ * This function marks an active state as expanded.
+ * If all states of it's hash element are done the
+ * element is released and the state is recorded
+ * in the state done map (together with its stack
+ * if stack pruning is off).
+ *
+ * @param ls  The memory
+ * @param s   The active state
+ * @param prn 0: state was pruned, 1: state was expanded
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_as_lsfins(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 prn){
   struct fsts_hs *hs;
+  const char *err;
+  UINT32 f=s->f, sn=s->s, stk=fsts_stkid(s->stk);
   if((hs=fsts_hfins(&ls->h,s,prn))){
     UINT16 i;
     for(i=0,s=(struct fsts_as_s*)fsts_hs2s(hs);i<hs->use;i++,s++){
@@ -157,8 +226,9 @@ void fsts_as_lsfins(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 prn){
       #else
       if(s->qp) fsts_as_qpop(&ls->q,s->qp);
       #endif
-      fsts_as_sfree(s,NULL,ls->btm);
+      if((err=fsts_as_sfree(s,NULL,ls->btm))) return err;
     }
-    fsts_as_mapon(ls->map,hs->id);
+    fsts_as_mapon(ls->map,f,sn,stk);
   }
+  return NULL;
 }
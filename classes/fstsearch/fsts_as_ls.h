@@ -38,6 +38,6 @@ struct fsts_as_ls {
 const char *fsts_as_lsinit(struct fsts_as_ls *ls,struct fsts_btm *btm,struct fsts_cfg *cfg);
 void fsts_as_lsfree(struct fsts_as_ls *ls);
 const char *fsts_as_lsadd(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 dbg);
-void fsts_as_lsfins(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 prn);
+const char *fsts_as_lsfins(struct fsts_as_ls *ls,struct fsts_as_s *s,UINT8 prn);
 
 #endif
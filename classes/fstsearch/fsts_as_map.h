@@ -26,10 +26,35 @@
 #ifndef _FSTS_AS_MAP_H
 #define _FSTS_AS_MAP_H
 
-/* A* state done map */
+/* A* state done map key (stack mode) */
+struct fsts_as_mapk {
+  UINT32 f;   /* Frame (FSTS_AS_MAPKNONE=unused)  */
+  UINT32 s;   /* State                            */
+  UINT32 stk; /* Pushdown stack id (0=empty)      */
+};
+
+#define FSTS_AS_MAPKNONE 0xffffffff
+
+/* A* state done map
+ *
+ * The map holds one row of state flags per frame.
+ * Rows are allocated on the first finished state
+ * of their frame, so the memory grows with the
+ * frames actually reached by the search instead
+ * of the whole utterance.
+ * Without stack pruning states with different
+ * pushdown stacks are different search states.
+ * In this case the map is a hash set of
+ * (frame, state, stack id) keys instead. */
 struct fsts_as_map {
-  UINT32 n;  /* Size of m in bytes */
-  UINT8 *m;  /* Map pointer */
+  UINT32  nf; /* Number of frames (rows)          */
+  UINT32  nr; /* Size of one row in bytes         */
+  UINT32  n;  /* Size of allocated memory (bytes) */
+  UINT8 **m;  /* Row pointers (NULL=not reached)  */
+  UINT8   stk;   /* Stack mode (use k instead of m)  */
+  UINT32  kmask; /* Hash set size - 1                */
+  UINT32  kn;    /* Number of keys in hash set       */
+  struct fsts_as_mapk *k; /* Hash set (stack mode)   */
 };
 
 /* OPT_BYTE uses one byte per state,
@@ -37,30 +62,56 @@ struct fsts_as_map {
 /* #define OPT_BYTE */
 #ifdef OPT_BYTE
 
-#define fsts_as_mapinit(map,num) { \
-  (map).n=(num); \
-  if(!((map).m=(UINT8*)calloc((map).n,sizeof(UINT8)))) return FSTSERR("out of memory"); \
-}
-
-#define fsts_as_mapget(map,id) ((map).m[(id)])
-#define fsts_as_mapon(map,id)  ((map).m[(id)]=1)
+#define fsts_as_maprow(ns)       (ns)
+#define fsts_as_mapbit(r,s)      ((r)[(s)])
+#define fsts_as_mapset(r,s)      ((r)[(s)]=1)
 
 #else
 
-#define fsts_as_mapinit(map,num) { \
-  (map).n=((num)>>3)+1; \
-  if(!((map).m=(UINT8*)calloc((map).n,sizeof(UINT8)))) return FSTSERR("out of memory"); \
+#define fsts_as_maprow(ns)       (((ns)>>3)+1)
+#define fsts_as_mapbit(r,s)      ((r)[(s)>>3]&(0x1<<((s)&0x7)))
+#define fsts_as_mapset(r,s)      ((r)[(s)>>3]|=0x1<<((s)&0x7))
+
+#endif
+
+#define fsts_as_mapinit(map,nframes,ns,bstk) { \
+  (map).nf=(nframes); \
+  (map).nr=fsts_as_maprow(ns); \
+  (map).n=(map).nf*sizeof(UINT8*); \
+  (map).stk=(bstk); \
+  (map).kmask=(map).kn=0; \
+  (map).k=NULL; \
+  if(!((map).m=(UINT8**)calloc((map).nf,sizeof(UINT8*)))) return FSTSERR("out of memory"); \
 }
 
-#define fsts_as_mapget(map,id) ((map).m[(id)>>3]&(0x1<<((id)&0x7)))
-#define fsts_as_mapon(map,id)  ((map).m[(id)>>3]|=0x1<<((id)&0x7))
+#define fsts_as_mapget(map,f,s,stkid) ((map).stk ? fsts_as_mapkget(&(map),(f),(s),(stkid)) : \
+  ((map).m[(f)] && fsts_as_mapbit((map).m[(f)],(s))))
 
-#endif
+#define fsts_as_mapon(map,f,s,stkid) { \
+  if((map).stk){ \
+    if(!fsts_as_mapkon(&(map),(f),(s),(stkid))) return FSTSERR("out of memory"); \
+  }else{ \
+    if(!(map).m[(f)]){ \
+      if(!((map).m[(f)]=(UINT8*)calloc((map).nr,sizeof(UINT8)))) return FSTSERR("out of memory"); \
+      (map).n+=(map).nr; \
+    } \
+    fsts_as_mapset((map).m[(f)],(s)); \
+  } \
+}
+
+#define fsts_as_mapfree(map) { \
+  UINT32 mf; \
+  for(mf=0;mf<(map).nf;mf++) free((map).m[mf]); \
+  free((map).m); \
+  free((map).k); \
+}
 
-#define fsts_as_mapfree(map)  free((map).m)
 #define fsts_as_mapsize(map)  ((map).n)
 
 /* Return maximal amount of memory used */
 #define fsts_as_mapmem(map)   ((map).n)
 
+UINT8 fsts_as_mapkget(struct fsts_as_map *map,UINT32 f,UINT32 s,UINT32 stk);
+UINT8 fsts_as_mapkon(struct fsts_as_map *map,UINT32 f,UINT32 s,UINT32 stk);
+
 #endif
@@ -27,7 +27,7 @@
 #include "fsts_glob.h"
 #include "fsts_as_algo.h"
 
-/* Default size of the queue */
+/* Default initial size of the queue */
 #define QDEFSIZE  32767
 
 /* Weight threshold for queue pruning */
@@ -35,22 +35,26 @@
 /* Maximal fraction of nodes to prune */
 #define QPRNN  0.05
 
-UINT32 nextbase2(UINT32 v){
-  UINT32 i=1;
-  while(v>i) i<<=1;
-  return i;
-}
-
 /* A* active state queue init function
  *
  * This function initializes the active state queue.
  *
+ * A non-zero size is an exact limit on the number
+ * of queued states. When it is reached the queue is
+ * pruned and the pruned states are removed from the
+ * visited states hash h and their backtrack data
+ * is released to btm.
+ *
  * @param q    The active state queue
  * @param len  Size of the queue (0=auto + init with QDEFSIZE)
+ * @param h    Visited states hash
+ * @param btm  Backtrack memory
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_as_qinit(struct fsts_as_q *q,UINT32 len){
+const char *fsts_as_qinit(struct fsts_as_q *q,UINT32 len,struct fsts_h *h,struct fsts_btm *btm){
   q->prn=len!=0;
+  q->h=h;
+  q->btm=btm;
   q->used=0;
   q->usedmax=0;
   q->wmax=0.;
@@ -64,7 +68,7 @@ const char *fsts_as_qinit(struct fsts_as_q *q,UINT32 len){
   q->head->h=0;
   q->first=q->last=NULL;
   #else
-  q->len = len ? nextbase2(len)-1 : QDEFSIZE;
+  q->len = len ? len : QDEFSIZE;
   if(!(q->s=(struct fsts_as_s **)malloc((q->len+1)*sizeof(struct fsts_as_s *)))) return FSTSERR("out of memory");
   #endif
   return NULL;
@@ -195,22 +199,25 @@ end:
  * q->wmax and the best node.
  *
  * @param q  The active state queue
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */
-void fsts_as_qprn(struct fsts_as_q *q){
+const char *fsts_as_qprn(struct fsts_as_q *q){
   FLOAT64 wmin=q->wmax-(q->wmax-q->s[1]->w)*QPRNW;
   UINT32  uend=q->used-q->len*QPRNN;
-  UINT32  pend=(q->len+1)/2;
+  UINT32  pend=q->used/2+1;
   UINT32  p;
+  const char *err;
   for(p=q->used;uend<q->used && p>=pend;p--) if(q->s[p]->w>=wmin){
     struct fsts_as_s *sfix;
-    fsts_as_sfree(q->s[p],NULL,*(((struct fsts_btm**)q)-1)); /* TODO: remove dirty btm pointer calc */
-    sfix=(struct fsts_as_s*)fsts_hdels((struct fsts_h*)(q+1),q->s[p]); /* TODO: remove dirty hash address calc */
+    if((err=fsts_as_sfree(q->s[p],NULL,q->btm))) return err;
+    sfix=(struct fsts_as_s*)fsts_hdels(q->h,q->s[p]);
     if(sfix && sfix->qp) q->s[sfix->qp]=sfix;
     /* TODO: if(hs->done==hs->use && prnf && q->s[p]->f<algo->f-prnf) fsts_hdel(hs) */
     fsts_as_qheapify(q,q->s[q->used--],p);
   }
   q->wmax=wmin;
 /*  printf("qprn: prn %i of %i\n",q->len-q->used,q->len-uend);*/
+  return NULL;
 }
 
 /* A* active state queue replace function
@@ -230,8 +237,8 @@ const char *fsts_as_qrpl(struct fsts_as_q *q,struct fsts_as_s *s,UINT32 p){
     if(q->used==q->len){
       if(q->prn){
         s->qp=0;
-        ((struct fsts_h*)(q+1))->schg[1]=(void**)&s; /* TODO: remove dirty hash address calc */
-        while(q->used==q->len) fsts_as_qprn(q);
+        q->h->schg[1]=(void**)&s;
+        while(q->used==q->len) if((err=fsts_as_qprn(q))) return err;
       }else{ if((err=fsts_as_qresize(q))) return err; }
     }
     p=++q->used;
@@ -360,12 +367,13 @@ void fsts_as_qdel(struct fsts_as_q *q,struct fsts_as_qs *qs){
 const char *fsts_as_qrpl(struct fsts_as_q *q,struct fsts_as_s *s,struct fsts_as_qs *qs){
   if(!qs && q->len && q->used==q->len){
     if(s->w>=q->last->s->w){
-      ((struct fsts_h*)(q+1))->schg[1]=NULL; /* TODO: remove dirty hash address calc */
-      fsts_hdels((struct fsts_h*)(q+1),s); /* TODO: remove dirty hash address calc */
+      q->h->schg[1]=NULL;
+      fsts_hdels(q->h,s);
       return NULL;
     }else{
-      ((struct fsts_h*)(q+1))->schg[1]=(void**)&s; /* TODO: remove dirty hash address calc */
-      struct fsts_as_s *sfix=(struct fsts_as_s*)fsts_hdels((struct fsts_h*)(q+1),q->last->s); /* TODO: remove dirty hash address calc */
+      struct fsts_as_s *sfix;
+      q->h->schg[1]=(void**)&s;
+      sfix=(struct fsts_as_s*)fsts_hdels(q->h,q->last->s);
       if(sfix && sfix->qs) sfix->qs->s=sfix;
       qs=q->last;
     }
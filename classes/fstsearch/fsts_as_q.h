@@ -33,6 +33,8 @@ struct fsts_as_q {
   UINT32  usedmax;      /* Maximal used elements           */
   UINT8   prn;          /* 0: Queue resize, 1: Queue prune */
   FLOAT64 wmax;         /* Current maximal weight          */
+  struct fsts_h   *h;   /* Visited states hash (pruning)   */
+  struct fsts_btm *btm; /* Backtrack memory (pruning)      */
   #ifdef OPT_AVL
   struct fsts_mem    qsmem;
   struct fsts_as_qs *head;
@@ -60,7 +62,7 @@ struct fsts_as_qs {
   #define fsts_as_qmem(q) fsts_memmem(&(q)->qsmem)
 #endif
 
-const char *fsts_as_qinit(struct fsts_as_q *q,UINT32 len);
+const char *fsts_as_qinit(struct fsts_as_q *q,UINT32 len,struct fsts_h *h,struct fsts_btm *btm);
 void fsts_as_qfree(struct fsts_as_q *q);
 const char *fsts_as_qdbg(struct fsts_as_q *q,UINT8 t);
 #ifdef OPT_AVL
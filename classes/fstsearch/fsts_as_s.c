@@ -34,9 +34,10 @@
  * @param s     Active state which will be free'd
  * @param sref  State with which s was recombinded (for lattice generation)
  * @param btm   Bactrack memory
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */
-void fsts_as_sfree(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_btm *btm){
-  fsts_btsfree(&s->bt,sref?&sref->bt:NULL,sref?s->w-sref->w:0.,btm);
+const char *fsts_as_sfree(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_btm *btm){
+  return fsts_btsfree(&s->bt,sref?&sref->bt:NULL,sref?s->w-sref->w:0.,0,btm);
 }
 
 /* A* active state generation function
@@ -48,47 +49,41 @@ void fsts_as_sfree(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_btm *b
  * @param t     The transition used
  * @param w     The timevariant weight array
  * @param btm   Bactrack memory
+ * @param stkh  Pushdown stack memory
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_as_sgen(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_t *t,struct fsts_w *w,struct fsts_btm *btm){
-  INT32 d;
+const char *fsts_as_sgen(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_t *t,struct fsts_w *w,struct fsts_btm *btm,struct fsts_stkh *stkh){
   const char *err;
   if(!sref){
     s->id=0;
     s->s=s->f=0;
-    s->nstk=0;
+    s->stk=NULL;
     s->w=0.;
     return fsts_btsgen(&s->bt,NULL,NULL,0,0.,btm);
   }
-  if((err=fsts_btsgen(&s->bt,&sref->bt,t,1,s->w,btm))) return err;
-  s->nstk=sref->nstk;
-  for(d=0;d<s->nstk;d++) s->stk[d]=sref->stk[d];
+  s->stk=sref->stk;
   if(!t) s->w=sref->w; else{
     if(t->stk>0){
-      if(s->nstk+1==MAXSTK) return FSTSERR("stk: out of memory");
-      s->stk[s->nstk++]=t->stk;
-    }else if(t->stk<0) s->nstk--;
+      if((err=fsts_stkpush(stkh,&s->stk,t->stk))) return err;
+    }else if(t->stk<0) s->stk=fsts_stkpop(s->stk);
     s->w=sref->w+t->w;
-    if(t->is>=0 && w->w) s->w+=w->w[t->is];
+    if(t->is>=0 && w->w) s->w+=fsts_wget(w,t->is);
   }
-  return NULL;
+  /* The backtrack node stores the path weight after the transition */
+  return fsts_btsgen(&s->bt,&sref->bt,t,1,s->w,btm);
 }
 
 /* A* state stack compare function
  *
- * This function compares the pushdown memory
- * of two states.
+ * This function compares the pushdown stacks
+ * of two states. Stack nodes are shared, so
+ * equal stacks have equal node pointers.
  *
  * @param a  The first state
- * @param a  The second state
+ * @param b  The second state
  * @return   0: not equal, 1: equal
  */
 UINT8 fsts_as_scmpstk(void *a,void *b){
-  struct fsts_as_s *as=(struct fsts_as_s *)a;
-  struct fsts_as_s *bs=(struct fsts_as_s *)b;
-  INT32 i;
-  if(bs->nstk!=as->nstk) return 0;
-  for(i=0;i<as->nstk;i++) if(as->stk[i]!=bs->stk[i]) return 0;
-  return 1;
+  return ((struct fsts_as_s *)a)->stk==((struct fsts_as_s *)b)->stk;
 }
 
@@ -28,7 +28,7 @@
 
 /* A* internal active state */
 struct fsts_as_s {
-  uint64_t        id;          /* State id = f * numstates + s   */
+  uint64_t        id;          /* State id = f*numstates+s ^ stk */
   struct fsts_bts bt;          /* State backtrack node           */
   FLOAT64         w;           /* Current path weight            */
   UINT32          f,s;         /* Current frame and state number */
@@ -37,12 +37,11 @@ struct fsts_as_s {
   #else
   UINT32          qp;          /* Position in active state queue */
   #endif
-  INT8            nstk;        /* Usage of pushdown stack memory */
-  UINT16          stk[MAXSTK]; /* Pushdown stack memory          */
+  struct fsts_stk *stk;        /* Pushdown stack (shared)        */
 };
 
-void fsts_as_sfree(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_btm *btm);
-const char *fsts_as_sgen(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_t *t,struct fsts_w *w,struct fsts_btm *btm);
+const char *fsts_as_sfree(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_btm *btm);
+const char *fsts_as_sgen(struct fsts_as_s *s,struct fsts_as_s *sref,struct fsts_t *t,struct fsts_w *w,struct fsts_btm *btm,struct fsts_stkh *stkh);
 UINT8 fsts_as_scmp(void *a,void *b);
 UINT8 fsts_as_scmpstk(void *a,void *b);
 
@@ -29,78 +29,90 @@
 /* Number of initial elements in the backtrack memories */
 #define BTMEMSIZE   32768
 
+/* Path weight before stable prefix element p (0 after a link) */
+#define BTPREW(btm,p) ((p) ? ((btm)->pre[(p)-1].tid>=0 ? (btm)->pre[(p)-1].w : 0.) : (btm)->prew)
+
+/* Deferred reference counter change function
+ *
+ * This function appends a backtrack node to a list of
+ * pending reference counter changes.
+ *
+ * @param bt   Backtrack node
+ * @param lst  Pointer to the list
+ * @param n    Pointer to the number of list entries
+ * @param m    Pointer to the number of allocated list entries
+ * @return     0 on failure and 1 on success
+ */
+UINT8 fsts_btdefer(struct fsts_bt *bt,struct fsts_bt ***lst,UINT32 *n,UINT32 *m){
+  if(*n==*m){
+    UINT32 m2=*m?*m*2:BTMEMSIZE;
+    struct fsts_bt **lst2=(struct fsts_bt**)realloc(*lst,m2*sizeof(struct fsts_bt*));
+    if(!lst2) return 0;
+    *lst=lst2;
+    *m=m2;
+  }
+  (*lst)[(*n)++]=bt;
+  return 1;
+}
+
 /* Backtrack node insertion function
  *
  * This function generates the backtrack node for
  * a new state by inserting into the backtrack memory.
+ * If def is not <code>NULL</code> the reference counter
+ * of btref is not changed but the change is stored in def.
  *
  * @param btref  Backtrack info of the previous state
  * @param tid    Transition id or output symbol
  * @param w      New path weight
  * @param btmem  Backtrack memory to use
+ * @param def    Pending reference counter changes (multiple threads) or <code>NULL</code>
  * @return       The new backtrack node of <code>NULL</code> on error
  */
-struct fsts_bt *fsts_btgen(struct fsts_bt *btref,INT32 tid,FLOAT64 w,struct fsts_mem *btmem){
+struct fsts_bt *fsts_btgen(struct fsts_bt *btref,INT32 tid,FLOAT64 w,struct fsts_mem *btmem,struct fsts_btdef *def){
   struct fsts_bt *bt=NULL;
   #ifdef _DEBUG
   if(btref && !btref->ref) abort();
   #endif
-  if(!btref){
+  if(!btref || tid>=0){
     if(!(bt=(struct fsts_bt*)fsts_memget(btmem))) return NULL;
-    bt->tid=-1;
-    bt->ref=1;
-    bt->w=w;
-    bt->pa=NULL;
-    if(btmem->size>sizeof(struct fsts_bt)+(btmem->lock?sizeof(MUTEXHANDLE):0)) BTHASH(bt)=0;
-    #ifdef OPT_BTFREE
-    if(btmem->lock && dlp_create_mutex(BTMUTEX(bt,btmem))!=O_K) return NULL;
-    #endif
-  }else if(tid>=0){
-    if(!(bt=(struct fsts_bt*)fsts_memget(btmem))) return NULL;
-    bt->tid=tid;
+    bt->tid=btref?tid:-1;
     bt->ref=1;
     bt->w=w;
     bt->pa=btref;
-    #ifdef OPT_BTFREE
-    if(btmem->lock && dlp_lock_mutex(BTMUTEX(btref,btmem))!=O_K) return NULL;
-    btref->ref++;
-    if(btmem->lock) dlp_unlock_mutex(BTMUTEX(btref,btmem));
-    if(btmem->lock && dlp_create_mutex(BTMUTEX(bt,btmem))!=O_K) return NULL;
-    #endif
-    if(btmem->size>sizeof(struct fsts_bt)+(btmem->lock?sizeof(MUTEXHANDLE):0))
-      BTHASH(bt)=((BTHASH(btref)<<11)|(BTHASH(btref)>>21))^tid;
-  }else{
-    bt=btref;
-    #ifdef OPT_BTFREE
-    if(btmem->lock && dlp_lock_mutex(BTMUTEX(btref,btmem))!=O_K) return NULL;
-    btref->ref++;
-    if(btmem->lock) dlp_unlock_mutex(BTMUTEX(btref,btmem));
-    #endif
-  }
+    if(def) BTMEM(bt,btmem)=btmem;
+    if(btmem->size>sizeof(struct fsts_bt)+(def?sizeof(struct fsts_mem*):0))
+      BTHASH(bt)=btref?((BTHASH(btref)<<11)|(BTHASH(btref)>>21))^tid:0;
+    if(!btref) return bt;
+  }else bt=btref;
+  #ifdef OPT_BTFREE
+  if(def){ if(!fsts_btdefer(btref,&def->inc,&def->ninc,&def->minc)) return NULL; }
+  else btref->ref++;
+  #endif
   return bt;
 }
 
 /* Backtrack node unreference function
  *
  * This function unrefernces the backtrack node and
- * free's the element if possible.
+ * free's the element if possible. If def is not
+ * <code>NULL</code> the change is only stored in def.
  *
  * @param bt    Backtrack node
  * @param btmem Backtrack memory
+ * @param def   Pending reference counter changes (multiple threads) or <code>NULL</code>
+ * @return      0 on failure and 1 on success
  */
-void fsts_btunref(struct fsts_bt *bt,struct fsts_mem *btmem){
+UINT8 fsts_btunref(struct fsts_bt *bt,struct fsts_mem *btmem,struct fsts_btdef *def){
   #ifdef OPT_BTFREE
-  if(!bt) return;
-  if(btmem->lock && dlp_lock_mutex(BTMUTEX(bt,btmem))!=O_K) return;
-  if(!bt->ref || --bt->ref){
-    if(btmem->lock) dlp_unlock_mutex(BTMUTEX(bt,btmem));
-  }else{
-    if(btmem->lock) dlp_unlock_mutex(BTMUTEX(bt,btmem));
-    if(btmem->lock) dlp_destroy_mutex(BTMUTEX(bt,btmem));
-    fsts_btunref(bt->pa,btmem);
+  if(def) return fsts_btdefer(bt,&def->dec,&def->ndec,&def->mdec);
+  while(bt && bt->ref && !--bt->ref){
+    struct fsts_bt *pa=bt->pa;
     fsts_memput(btmem,bt);
+    bt=pa;
   }
   #endif
+  return 1;
 }
 
 /* Backtrack node equal
@@ -117,9 +129,101 @@ UINT8 fsts_bteql(struct fsts_bt *a,struct fsts_bt *b){
   if(!a || !b) return 0;
   if(BTHASH(a)!=BTHASH(b)) return 0;
   if(a->tid!=b->tid) return 0;
+  if(a->tid<0) return 1;
   return fsts_bteql(a->pa,b->pa);
 }
 
+/* Backtrack node longest common prefix
+ *
+ * This function returns the last node shared by
+ * the histories of two backtrack nodes.
+ *
+ * @param a  First backtrack node
+ * @param b  Second backtrack node
+ * @return   The common node or <code>NULL</code> if there is none
+ */
+struct fsts_bt *fsts_btlcp(struct fsts_bt *a,struct fsts_bt *b){
+  struct fsts_bt *bt;
+  UINT32 na,nb;
+  for(na=0,bt=a;bt;bt=bt->pa) na++;
+  for(nb=0,bt=b;bt;bt=bt->pa) nb++;
+  for(;na>nb;na--) a=a->pa;
+  for(;nb>na;nb--) b=b->pa;
+  while(a!=b){ a=a->pa; b=b->pa; }
+  return a;
+}
+
+/* Backtrack node release function
+ *
+ * This function unreferences a backtrack node and free's
+ * unused nodes immediately. It must only be called while
+ * no decoding thread is running.
+ *
+ * @param btm   Backtrack memory
+ * @param bt    Backtrack node
+ * @param btmem Backtrack memory owning the node
+ */
+void fsts_btrelease(struct fsts_btm *btm,struct fsts_bt *bt,struct fsts_mem *btmem){
+  #ifdef OPT_BTFREE
+  while(bt && bt->ref && !--bt->ref){
+    struct fsts_bt *pa=bt->pa;
+    fsts_memput(btm->defer?BTMEM(bt,btmem):btmem,bt);
+    bt=pa;
+  }
+  #endif
+}
+
+/* Backtrack node cut function
+ *
+ * This function cuts the history of a backtrack node.
+ * The node becomes a new root node and all previous
+ * nodes are unreferenced. If keep is set the cut off
+ * nodes are appended to the stable path prefix of the
+ * backtrack memory which is prepended in fsts_btpath.
+ * Links between histories (see fsts_btslink) are stored
+ * as prefix elements with transition -1.
+ *
+ * @param btm   Backtrack memory
+ * @param bt    Backtrack node
+ * @param btmem Backtrack memory owning the node
+ * @param keep  Switch for storing the cut off nodes
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_btcut(struct fsts_btm *btm,struct fsts_bt *bt,struct fsts_mem *btmem,UINT8 keep){
+  struct fsts_bt *pa;
+  UINT32 n,i;
+  if(!bt->pa) return NULL;
+  if(keep){
+    for(n=0,pa=bt;pa->pa;pa=pa->pa) n++;
+    if(btm->npre+n>btm->mpre){
+      UINT32 m2=btm->mpre?btm->mpre*2:BTMEMSIZE;
+      struct fsts_btp *pre2;
+      if(m2<btm->npre+n) m2=btm->npre+n;
+      if(!(pre2=(struct fsts_btp*)realloc(btm->pre,m2*sizeof(struct fsts_btp)))) return FSTSERR("out of memory");
+      btm->pre=pre2;
+      btm->mpre=m2;
+    }
+    for(i=btm->npre+n,pa=bt;pa->pa;pa=pa->pa){
+      btm->pre[--i].tid=pa->tid;
+      btm->pre[i].w=pa->w;
+      if(pa->tid<0 && i>=btm->pre0) btm->pre0=i+1;
+    }
+    btm->npre+=n;
+  }
+  pa=bt->pa;
+  bt->tid=-1;
+  bt->pa=NULL;
+  fsts_btrelease(btm,pa,btmem);
+  if(keep){
+    #ifdef OPT_BTFREE
+    bt->ref++;
+    if(btm->cut) fsts_btrelease(btm,btm->cut,btmem);
+    #endif
+    btm->cut=bt;
+  }
+  return NULL;
+}
+
 /* Backtrack state node free function
  *
  * This function free's the backtrack node of a state.
@@ -127,12 +231,20 @@ UINT8 fsts_bteql(struct fsts_bt *a,struct fsts_bt *b){
  * @param bt     State node which will be free'd
  * @param btref  Node with which bt was recombinded (for lattice generation)
  * @param wd     Weight difference between bt and btref
+ * @param late   Switch indicating that btref was already propagated
  * @param btm    Bactrack memory
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */ 
-void fsts_btsfree(struct fsts_bts *bt,struct fsts_bts *btref,FLOAT64 wd,struct fsts_btm *btm){
-  if(bt->ti){ fsts_btunref(bt->ti,&btm->ti); bt->ti=NULL; }
-  if(bt->os){ fsts_btunref(bt->os,&btm->os); if(!btm->os.delay) bt->os=NULL; }
-  if(btref && btm->lat.head){ btref->lat=fsts_latjoin(bt->lat,btref->lat,wd,&btm->lat); bt->lat=NULL; }
+const char *fsts_btsfree(struct fsts_bts *bt,struct fsts_bts *btref,FLOAT64 wd,UINT8 late,struct fsts_btm *btm){
+  const char *err;
+  if(bt->ti){ if(!fsts_btunref(bt->ti,&btm->ti,btm->defer?&btm->tidef:NULL)) return FSTSERR("out of memory"); bt->ti=NULL; }
+  if(bt->os){ if(!fsts_btunref(bt->os,&btm->os,btm->defer?&btm->osdef:NULL)) return FSTSERR("out of memory"); if(!btm->os.delay && !btm->defer) bt->os=NULL; }
+  if(btref && btm->lat.head){
+    if(!late){ if(!(btref->lat=fsts_latjoin(bt->lat,btref->lat,wd,&btm->lat))) return FSTSERR("out of memory"); }
+    else if(btref->lat && (err=fsts_latjoinin(bt->lat,btref->lat,wd,&btm->lat))) return err;
+    bt->lat=NULL;
+  }
+  return NULL;
 }
 
 /* Backtrack state node generation function
@@ -149,41 +261,91 @@ void fsts_btsfree(struct fsts_bts *bt,struct fsts_bts *btref,FLOAT64 wd,struct f
  */
 const char *fsts_btsgen(struct fsts_bts *bt,struct fsts_bts *btref,struct fsts_t *t,UINT8 ui0,FLOAT64 w,struct fsts_btm *btm){
   if(!btm->ti.size) bt->ti=NULL;
-  else if(!(bt->ti=fsts_btgen(btref?btref->ti:NULL,t?t->id:-1,w,&btm->ti))) return FSTSERR("out of memory");
+  else if(!(bt->ti=fsts_btgen(btref?btref->ti:NULL,t?t->id:-1,w,&btm->ti,btm->defer?&btm->tidef:NULL))) return FSTSERR("out of memory");
   if(!btm->os.size) bt->os=NULL;
-  else if(!(bt->os=fsts_btgen(btref?btref->os:NULL,(ui0&&t)?t->os:-1,w,&btm->os))) return FSTSERR("out of memory");
+  else if(!(bt->os=fsts_btgen(btref?btref->os:NULL,(ui0&&t)?t->os:-1,w,&btm->os,btm->defer?&btm->osdef:NULL))) return FSTSERR("out of memory");
   if(!btm->lat.head) bt->lat=NULL;
   else if(!(bt->lat=fsts_latgen(btref?btref->lat:NULL,(ui0&&t)?t->os:-1,&btm->lat))) return FSTSERR("out of memory");
   return NULL;
 }
 
+/* Backtrack state node link function
+ *
+ * This function links the root nodes of a new start state
+ * to the history of btref. The link ends the path returned
+ * by fsts_btpath but not the common prefix (see fsts_btlcp).
+ * It must only be called while no decoding thread is running.
+ *
+ * @param bt     The backtrack state node of the start state
+ * @param btref  The history to continue
+ */
+void fsts_btslink(struct fsts_bts *bt,struct fsts_bts *btref){
+  if(bt->ti && btref->ti){
+    bt->ti->pa=btref->ti;
+    #ifdef OPT_BTFREE
+    btref->ti->ref++;
+    #endif
+  }
+  if(bt->os && btref->os){
+    bt->os->pa=btref->os;
+    #ifdef OPT_BTFREE
+    btref->os->ref++;
+    #endif
+  }
+}
+
+/* Backtrack state node hold function
+ *
+ * This function replaces the history held in bt by the
+ * one of btref. It must only be called while no decoding
+ * thread is running.
+ *
+ * @param bt     The held backtrack state node
+ * @param btref  The new history
+ * @param btm    Bactrack memory
+ */
+void fsts_btshold(struct fsts_bts *bt,struct fsts_bts *btref,struct fsts_btm *btm){
+  #ifdef OPT_BTFREE
+  if(btref->ti) btref->ti->ref++;
+  if(btref->os) btref->os->ref++;
+  if(bt->ti) fsts_btrelease(btm,bt->ti,&btm->ti);
+  if(bt->os) fsts_btrelease(btm,bt->os,&btm->os);
+  #endif
+  bt->ti=btref->ti;
+  bt->os=btref->os;
+}
+
 /* Backtrack memory init function
  *
  * This function initializes the backtrack memory.
  *
- * @param btm  The backtrack memory
- * @param cfg  Configuration
+ * @param btm     The backtrack memory
+ * @param cfg     Configuration
+ * @param lathead Initial lattice state to share or <code>NULL</code> to create one
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_btm_init(struct fsts_btm *btm,struct fsts_cfg *cfg){
+const char *fsts_btm_init(struct fsts_btm *btm,struct fsts_cfg *cfg,struct fsts_latas *lathead){
   UINT8 jobs=cfg->algo==FA_TP && cfg->tp.jobs>1;
   const char *err;
+  #ifdef OPT_BTFREE
+  btm->defer=jobs;
+  #endif
+  btm->pre=NULL;
+  btm->npre=btm->mpre=btm->pre0=0;
+  btm->prew=0.;
+  btm->cut=NULL;
   if(cfg->bt==BT_T){
     UINT32 btsize=sizeof(struct fsts_bt);
-    #ifdef OPT_BTFREE
-    if(jobs) btsize+=sizeof(MUTEXHANDLE);
-    #endif
-    if((err=fsts_meminit(&btm->ti,btsize,BTMEMSIZE,0,jobs))) return err;
+    if(btm->defer) btsize+=sizeof(struct fsts_mem*);
+    if((err=fsts_meminit(&btm->ti,btsize,BTMEMSIZE,0,0))) return err;
   }
   if(cfg->bt==BT_OS || cfg->numpaths>1){
     UINT32 ossize=sizeof(struct fsts_bt);
     if(cfg->numpaths>1) ossize+=sizeof(UINT32);
-    #ifdef OPT_BTFREE
-    if(jobs)  ossize+=sizeof(MUTEXHANDLE);
-    #endif
-    if((err=fsts_meminit(&btm->os,ossize,BTMEMSIZE,cfg->algo==FA_TP && cfg->numpaths>1,jobs))) return err;
+    if(btm->defer) ossize=(ossize+sizeof(void*)-1)/sizeof(void*)*sizeof(void*)+sizeof(struct fsts_mem*);
+    if((err=fsts_meminit(&btm->os,ossize,BTMEMSIZE,cfg->algo==FA_TP && cfg->numpaths>1 && !btm->defer,0))) return err;
   }
-  if(cfg->bt==BT_LAT && (err=fsts_latinit(&btm->lat,cfg->latprn))) return err;
+  if(cfg->bt==BT_LAT && (err=fsts_latinit(&btm->lat,cfg->latprn,lathead))) return err;
   return NULL;
 }
 
@@ -197,6 +359,49 @@ void fsts_btm_free(struct fsts_btm *btm){
   if(btm->lat.head) fsts_latfree(&btm->lat);
   fsts_memfree(&btm->ti);
   fsts_memfree(&btm->os);
+  if(btm->tidef.inc) free(btm->tidef.inc);
+  if(btm->tidef.dec) free(btm->tidef.dec);
+  if(btm->osdef.inc) free(btm->osdef.inc);
+  if(btm->osdef.dec) free(btm->osdef.dec);
+  if(btm->pre) free(btm->pre);
+}
+
+/* Backtrack memory deferred reference function
+ *
+ * This function applies all pending reference counter increments
+ * of a backtrack memory. It must only be called while no decoding
+ * thread is running and before fsts_btmunref of all backtrack
+ * memories of the decoder.
+ *
+ * @param btm  The backtrack memory
+ */
+void fsts_btmref(struct fsts_btm *btm){
+  UINT32 i;
+  for(i=0;i<btm->tidef.ninc;i++) btm->tidef.inc[i]->ref++;
+  for(i=0;i<btm->osdef.ninc;i++) btm->osdef.inc[i]->ref++;
+  btm->tidef.ninc=btm->osdef.ninc=0;
+}
+
+/* Backtrack memory deferred unreference function
+ *
+ * This function applies all pending reference counter decrements
+ * of a backtrack memory. Unused nodes are put back to the memory
+ * of the thread which generated them.
+ *
+ * @param btm  The backtrack memory
+ */
+void fsts_btmunref(struct fsts_btm *btm){
+  struct fsts_bt *bt,*pa;
+  UINT32 i;
+  for(i=0;i<btm->tidef.ndec;i++) for(bt=btm->tidef.dec[i];bt && bt->ref && !--bt->ref;bt=pa){
+    pa=bt->pa;
+    fsts_memput(BTMEM(bt,&btm->ti),bt);
+  }
+  for(i=0;i<btm->osdef.ndec;i++) for(bt=btm->osdef.dec[i];bt && bt->ref && !--bt->ref;bt=pa){
+    pa=bt->pa;
+    fsts_memput(BTMEM(bt,&btm->os),bt);
+  }
+  btm->tidef.ndec=btm->osdef.ndec=0;
 }
 
 /* Backtrack memory debug function
@@ -260,21 +465,17 @@ const char *fsts_btstart(struct fsts_btinfo *bti,struct fsts_glob *glob,struct f
   return NULL;
 }
 
-/* Backtrack path function
+/* Backtrack unit function
  *
- * This function performs backtracking for one path.
+ * This function adds a new unit for one path
+ * to the destination transducer.
  *
- * @param bti  Backtrack working info object
- * @param bts  Backtrack state node of final state 
- * @return <code>NULL</code> if successfull, the error string otherwise
+ * @param bti    Backtrack working info object
+ * @param uname  Unit name
+ * @param w      Path weight
  */
-const char *fsts_btpath(struct fsts_btinfo *bti,FLOAT64 w,struct fsts_bts *bts){
-  char uname[32];
-  struct fsts_bt *bt,*btf=bti->cfg->bt==BT_T?bts->ti:bts->os;
-  INT32 nt,si;
+void fsts_btunit(struct fsts_btinfo *bti,const char *uname,FLOAT64 w){
   CFst *itDst=bti->itDst;
-  CFst *itSrc=bti->src->itSrc;
-  snprintf(uname,32,"path%i",bti->ui);
   if(bti->cfg->bt!=BT_T){
     itDst->m_bFst=TRUE;
     itDst->m_bLsr=TRUE;
@@ -287,12 +488,76 @@ const char *fsts_btpath(struct fsts_btinfo *bti,FLOAT64 w,struct fsts_bts *bts){
     CFst_Wsr_GetType(itDst,&bti->clsr);
   }
   CData_Dstore(AS(CData,itDst->ud),w,bti->ui,bti->gwi);
-  if(bti->cfg->bt==BT_LAT) return fsts_latbt(bts->lat,&bti->btm->lat,itDst,bti->ui++,w);
+}
+
+/* Backtrack transition function
+ *
+ * This function writes the transition bti->ti of a path.
+ *
+ * @param bti  Backtrack working info object
+ * @param tid  Transition id or output symbol
+ * @param si   Terminal state index
+ * @param w    Transition weight
+ */
+void fsts_bttrans(struct fsts_btinfo *bti,INT32 tid,INT32 si,FLOAT64 w){
+  CFst *itDst=bti->itDst;
+  CFst *itSrc=bti->src->itSrc;
+  if(bti->cfg->bt==BT_T){
+    INT32 uis;
+    dlp_memmove(CData_XAddr(AS(CData,itDst->td),bti->ti,0),CData_XAddr(AS(CData,itSrc->td),tid,0),bti->rlt);
+    if(bti->src->nunits==UD_XXU(itSrc)){
+      if(bti->ctos>=0 && tid>=UD_XT(itSrc,0)) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctos)=-1;
+      if(bti->ctis>=0) for(uis=0;uis<bti->src->nunits;uis++)
+        if(bti->src->units[uis].sub && tid>=UD_FT(itSrc,uis) && tid<UD_FT(itSrc,uis)+UD_XT(itSrc,uis)){
+          *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctis)=-1;
+          break;
+        }
+    }
+  }else{
+    if(bti->ctis>=0) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctis)=-1;
+    if(bti->ctos>=0) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctos)=tid;
+  }
+  TD_INI(itDst,bti->ti)=si-1;
+  TD_TER(itDst,bti->ti)=si;
+  if(bti->clsr>=0) *(FST_WTYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->clsr)=w;
+}
+
+/* Backtrack path function
+ *
+ * This function performs backtracking for one path.
+ * If the path starts at the root of the stable path prefix
+ * (see fsts_btcut) the kept prefix since the last link is
+ * prepended. Each node stores the path weight after its
+ * transition, the last transition receives the remaining
+ * path weight. The weight of prefix elements which were
+ * released by fsts_btpartial is not included.
+ *
+ * @param bti  Backtrack working info object
+ * @param w    Path weight
+ * @param bts  Backtrack state node of final state 
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_btpath(struct fsts_btinfo *bti,FLOAT64 w,struct fsts_bts *bts){
+  char uname[32];
+  struct fsts_bt *bt,*btf=bti->cfg->bt==BT_T?bts->ti:bts->os;
+  struct fsts_btm *btm=bti->btm;
+  INT32 nt,si,p,p0;
+  FLOAT64 w0=0.;
+  CFst *itDst=bti->itDst;
+  snprintf(uname,32,"path%i",bti->ui);
+  if(bti->cfg->bt==BT_LAT){
+    fsts_btunit(bti,uname,w);
+    return fsts_latbt(bts->lat,&bti->btm->lat,itDst,bti->ui++,w);
+  }
   for(nt=0,bt=btf;bt->tid>=0;bt=bt->pa) nt++;
+  p0=bt==btm->cut ? btm->pre0 : btm->npre;
+  if(bt==btm->cut && !p0) w0=btm->prew;
+  nt+=btm->npre-p0;
+  fsts_btunit(bti,uname,w-w0);
   CFst_Addstates(itDst,bti->ui,nt?nt:1,FALSE);
   CFst_Addstates(itDst,bti->ui,1,TRUE);
   if(!nt){
-    CFst_AddtransEx(itDst,bti->ui,0,1,-1,-1,w);
+    CFst_AddtransEx(itDst,bti->ui,0,1,-1,-1,w-w0);
     bti->ti++;
     return NULL;
   }
@@ -301,30 +566,62 @@ const char *fsts_btpath(struct fsts_btinfo *bti,FLOAT64 w,struct fsts_bts *bts){
   si=nt;
   bti->ti+=nt-1;
   for(bt=btf;bt->tid>=0;bt=bt->pa,bti->ti--,si--){
-    if(bti->cfg->bt==BT_T){
-      INT32 uis;
-      dlp_memmove(CData_XAddr(AS(CData,itDst->td),bti->ti,0),CData_XAddr(AS(CData,itSrc->td),bt->tid,0),bti->rlt);
-      if(bti->src->nunits==UD_XXU(itSrc)){
-        if(bti->ctos>=0 && bt->tid>=UD_XT(itSrc,0)) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctos)=-1;
-        if(bti->ctis>=0) for(uis=0;uis<bti->src->nunits;uis++)
-          if(bti->src->units[uis].sub && bt->tid>=UD_FT(itSrc,uis) && bt->tid<UD_FT(itSrc,uis)+UD_XT(itSrc,uis)){
-            *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctis)=-1;
-            break;
-          }
-      }
-    }else{
-      if(bti->ctis>=0) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctis)=-1;
-      if(bti->ctos>=0) *(FST_STYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->ctos)=bt->tid;
-    }
-    TD_INI(itDst,bti->ti)=si-1;
-    TD_TER(itDst,bti->ti)=si;
-    if(bti->clsr>=0){
-      *(FST_WTYPE*)CData_XAddr(AS(CData,itDst->td),bti->ti,bti->clsr)=w-(si==1?0.:bt->w);
-      w=bt->w;
-    }
+    fsts_bttrans(bti,bt->tid,si,w-(si==1?w0:bt->pa->w));
+    w=bt->pa->w;
+  }
+  for(p=btm->npre-1;p>=p0;p--,bti->ti--,si--){
+    fsts_bttrans(bti,btm->pre[p].tid,si,w-(si==1?w0:btm->pre[p-1].w));
+    if(p) w=btm->pre[p-1].w;
   }
   bti->ti+=nt+1;
   bti->ui++;
   return NULL;
 }
 
+/* Backtrack partial path function
+ *
+ * This function returns the stable path prefix
+ * starting at element p0 as one unit (see fsts_btcut).
+ * The transition weights are identical to the ones of
+ * the same prefix in fsts_btpath. Links are skipped and
+ * nothing is added if there is no new element. Afterwards
+ * only the last tp_partkeep prefix elements since the last
+ * link are kept for fsts_btpath (all if tp_partkeep<0), so
+ * the prefix needs constant memory by default.
+ *
+ * @param bti  Backtrack working info object
+ * @param p0   Index of the first new prefix element
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_btpartial(struct fsts_btinfo *bti,UINT32 p0){
+  struct fsts_btm *btm=bti->btm;
+  CFst *itDst=bti->itDst;
+  FLOAT64 w=0.;
+  UINT32 p,pk;
+  INT32 nt,si;
+  for(nt=0,p=p0;p<btm->npre;p++) if(btm->pre[p].tid>=0){
+    nt++;
+    w+=btm->pre[p].w-BTPREW(btm,p);
+  }
+  if(nt){
+    fsts_btunit(bti,"partial",w);
+    CFst_Addstates(itDst,bti->ui,nt,FALSE);
+    CFst_Addstates(itDst,bti->ui,1,TRUE);
+    CData_Reallocate(AS(CData,itDst->td),bti->ti+nt);
+    UD_XT(itDst,bti->ui)=nt;
+    for(si=1,p=p0;p<btm->npre;p++) if(btm->pre[p].tid>=0){
+      fsts_bttrans(bti,btm->pre[p].tid,si++,btm->pre[p].w-BTPREW(btm,p));
+      bti->ti++;
+    }
+    bti->ui++;
+  }
+  pk=btm->pre0;
+  if(bti->cfg->tp.partkeep>=0 && btm->npre-pk>(UINT32)bti->cfg->tp.partkeep) pk=btm->npre-bti->cfg->tp.partkeep;
+  if(pk){
+    btm->prew=BTPREW(btm,pk);
+    memmove(btm->pre,btm->pre+pk,(btm->npre-pk)*sizeof(struct fsts_btp));
+    btm->npre-=pk;
+    btm->pre0=0;
+  }
+  return NULL;
+}
@@ -29,11 +29,33 @@
 /* Enable free of unused backtrack elements */
 #define OPT_BTFREE
 
+/* Pending reference counter changes (deferred reference counting) */
+struct fsts_btdef {
+  struct fsts_bt **inc; /* Nodes to reference      */
+  struct fsts_bt **dec; /* Nodes to unreference    */
+  UINT32 ninc, ndec;    /* Number of pending nodes */
+  UINT32 minc, mdec;    /* Allocated entries       */
+};
+
+/* Stable path prefix element (see fsts_btcut) */
+struct fsts_btp {
+  INT32 tid;  /* Transition id or output symbol (-1: link) */
+  FLOAT64 w;  /* Path weight after transition              */
+};
+
 /* Backtrack memory */
 struct fsts_btm {
-  struct fsts_mem ti;  /* Transition index memory    */
-  struct fsts_mem os;  /* Output symbols memory      */
-  struct fsts_lat lat; /* Lattice storage structure  */
+  struct fsts_mem ti;      /* Transition index memory              */
+  struct fsts_mem os;      /* Output symbols memory                */
+  struct fsts_lat lat;     /* Lattice storage structure            */
+  UINT8 defer;             /* Defer reference counting (jobs>1)    */
+  struct fsts_btdef tidef; /* Pending changes in transition memory */
+  struct fsts_btdef osdef; /* Pending changes in output memory     */
+  struct fsts_btp *pre;    /* Stable path prefix (cut off nodes)   */
+  UINT32 npre, mpre;       /* Used and allocated prefix elements   */
+  UINT32 pre0;             /* First prefix element after last link */
+  FLOAT64 prew;            /* Path weight before first prefix elem. */
+  struct fsts_bt *cut;     /* Root node of the stable path prefix  */
 };
 
 /* Backtrack state node */
@@ -50,8 +72,8 @@ struct fsts_bt {
   FLOAT64 w;          /* Current path weight                    */
   struct fsts_bt *pa; /* Pointer to the previous backtrack info */
   /* optional: INT32 hash;        (only for osmem and numpaths>1)  */ /* Hash value of the history for fast comparision    */
-  /* optional: MUTEXHANDLE mutex; (only for jobs>1 and mem->lock)  */ /* Mutex for thread critical actions                 */
-  /* optional: void* delaynxt;    (only for osmem and numpaths>1)  */ /* For delayed free: pointer to next pending element */
+  /* optional: fsts_mem *mem;     (only for jobs>1)                */ /* Memory owning the node (for deferred free)        */
+  /* optional: void* delaynxt;    (osmem, numpaths>1 and jobs<=1)  */ /* For delayed free: pointer to next pending element */
 };
 
 /* Backtrack working information object */
@@ -67,24 +89,32 @@ struct fsts_btinfo {
 
 /* Marko reading the hash value of the history */
 #define BTHASH(bt)      (*(UINT32*)((bt)+1))
-/* Marko reading the mutex */
-#define BTMUTEX(bt,mem) ((MUTEXHANDLE*)(((BYTE*)(bt))+(mem)->size-((mem)->delay?sizeof(void*):0)-sizeof(MUTEXHANDLE)))
+/* Marko reading the memory owning the node */
+#define BTMEM(bt,mem)   (*(struct fsts_mem**)(((BYTE*)(bt))+(mem)->size-sizeof(struct fsts_mem*)))
 
 UINT8 fsts_bteql(struct fsts_bt *a,struct fsts_bt *b);
+struct fsts_bt *fsts_btlcp(struct fsts_bt *a,struct fsts_bt *b);
+const char *fsts_btcut(struct fsts_btm *btm,struct fsts_bt *bt,struct fsts_mem *btmem,UINT8 keep);
+void fsts_btrelease(struct fsts_btm *btm,struct fsts_bt *bt,struct fsts_mem *btmem);
 
-void fsts_btsfree(struct fsts_bts *bt,struct fsts_bts *btref,FLOAT64 wd,struct fsts_btm *btm);
+const char *fsts_btsfree(struct fsts_bts *bt,struct fsts_bts *btref,FLOAT64 wd,UINT8 late,struct fsts_btm *btm);
 const char *fsts_btsgen(struct fsts_bts *bt,struct fsts_bts *btref,struct fsts_t *t,UINT8 ui0,FLOAT64 w,struct fsts_btm *btm);
+void fsts_btslink(struct fsts_bts *bt,struct fsts_bts *btref);
+void fsts_btshold(struct fsts_bts *bt,struct fsts_bts *btref,struct fsts_btm *btm);
 
 /* Return maximal amount of memory used for decoding */
 #define fsts_btmmem1(btm)   fsts_memmem(&(btm)->ti) + fsts_memmem(&(btm)->os) + fsts_latmem1(&(btm)->lat)
 /* Return maximal amount of memory used for backtracking */
 #define fsts_btmmem2(btm)   fsts_latmem2(&(btm)->lat)
 
-const char *fsts_btm_init(struct fsts_btm *btm,struct fsts_cfg *cfg);
+const char *fsts_btm_init(struct fsts_btm *btm,struct fsts_cfg *cfg,struct fsts_latas *lathead);
 void fsts_btm_free(struct fsts_btm *btm);
+void fsts_btmref(struct fsts_btm *btm);
+void fsts_btmunref(struct fsts_btm *btm);
 const char *fsts_btmdbg(struct fsts_btm *btm,UINT8 t);
 
 const char *fsts_btstart(struct fsts_btinfo *bti,struct fsts_glob *glob,struct fsts_btm *btm,CFst *itDst);
 const char *fsts_btpath(struct fsts_btinfo *bti,FLOAT64 w,struct fsts_bts *bts);
+const char *fsts_btpartial(struct fsts_btinfo *bti,UINT32 p0);
 
 #endif
@@ -34,6 +34,10 @@ const char *fsts_algostr[]={FA, NULL};
 const char *fsts_ebtstr[]={BT, NULL};
 #undef E
 
+#define E(X)  #X
+const char *fsts_ewtstr[]={WT, NULL};
+#undef E
+
 /* Config function
  *
  * This function configures the selected decoding algorithm.
@@ -48,6 +52,7 @@ const char *fsts_cfg(struct fsts_cfg *cfg,CFstsearch *_this){
   const char *err=NULL;
   cfg->algo=(enum fsts_algo)fsts_cfg_enum(_this->m_lpsAlgo,fsts_algostr);
   cfg->bt  =(enum fsts_ebt )fsts_cfg_enum(_this->m_lpsBt  ,fsts_ebtstr );
+  cfg->wt  =(enum fsts_ewt )fsts_cfg_enum(_this->m_lpsWtype,fsts_ewtstr );
   cfg->numpaths=_this->m_nNumpaths;
   cfg->stkprn=_this->m_bStkprn;
   cfg->latprn=_this->m_nLatprn;
@@ -57,6 +62,7 @@ const char *fsts_cfg(struct fsts_cfg *cfg,CFstsearch *_this){
   if(_this->m_nNumpaths>65535) return FSTSERR("numpaths greater than 65535");
   if(cfg->algo<0)   return FSTSERR("algo unkown");
   if(cfg->bt  <0)   return FSTSERR("backtrack type (bt) unkown");
+  if(cfg->wt  <0)   return FSTSERR("weight type (wtype) unkown");
   if(cfg->latprn<0) return FSTSERR("negative value for latprn");
   switch(cfg->algo){
   case FA_TP:  err=fsts_tp_cfg(cfg,_this);   break;
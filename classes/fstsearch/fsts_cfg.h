@@ -38,10 +38,17 @@ enum fsts_ebt {BT};
 #undef E
 extern const char *fsts_ebtstr[];
 
+#define WT    E(AUTO), E(FLOAT), E(SHORT)
+#define E(X)  WT_##X
+enum fsts_ewt {WT};
+#undef E
+extern const char *fsts_ewtstr[];
+
 /* Global config structure */
 struct fsts_cfg {
   enum fsts_algo algo;     /* Algorithm selector        */
   enum fsts_ebt bt;        /* Backtrack type            */
+  enum fsts_ewt wt;        /* Weight storage type       */
   UINT16 numpaths;         /* Number of paths to decode */
   UINT8 stkprn;            /* Stack pruning             */
   FLOAT64 latprn;          /* Lattice pruning threshold */
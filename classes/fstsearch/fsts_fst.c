@@ -142,6 +142,7 @@ const char *fsts_unload(struct fsts_fst *src){
       free(u->tfroms);
       free(u->ttos);
       free(u->sfin);
+      if(u->pot) free(u->pot);
     }
     free(src->units);
   }
@@ -205,3 +206,81 @@ const char *fsts_fstpw(struct fsts_fst *src){
   return NULL;
 }
 
+/* Transducer unit look-ahead potential function
+ *
+ * This function calculates the look-ahead potential of all states of
+ * one unit after the potentials of all its sub units (see fsts_fstla).
+ * The relaxation dequeues each state at most ns times; if that limit is
+ * reached, the unit contains a negative cycle and the function fails.
+ *
+ * @param src  The transducer
+ * @param ui   Unit index
+ * @param l    Layer of the unit (for recursion depth check)
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_fstlau(struct fsts_fst *src,INT32 ui,INT32 l){
+  struct fsts_unit *u=src->units+ui;
+  struct fsts_t *t;
+  UINT32 si, *q=NULL, *nq=NULL, qs=0, qn=0;
+  UINT8 *inq=NULL;
+  const char *err=NULL;
+  if(u->pot) return NULL;
+  if(l==MAXLAYER) return FSTSERR("transducer has more than MAXLAYER layers");
+  if(u->sub) for(si=0;si<u->ns;si++) for(t=u->tfroms[si];t;t=t->nxt)
+    if(t->is>=0 && (err=fsts_fstlau(src,t->is,l+1))) return err;
+  if(!(u->pot=(FLOAT64*)malloc((u->ns+1)*sizeof(FLOAT64))) ||
+     !(q=(UINT32*)malloc((u->ns+1)*sizeof(UINT32))) ||
+     !(nq=(UINT32*)calloc(u->ns+1,sizeof(UINT32))) ||
+     !(inq=(UINT8*)calloc(u->ns+1,sizeof(UINT8)))){ err=FSTSERR("out of memory"); goto end; }
+  for(si=0;si<u->ns;si++) if(u->sfin[si]){
+    u->pot[si]=0.;
+    q[qn++]=si;
+    inq[si]=1;
+  }else u->pot[si]=T_DOUBLE_MAX;
+  /* Relax ingoing transitions of queued states (ring buffer, each state at most once in queue) */
+  while(qn){
+    UINT32 sq=q[qs];
+    qs=(qs+1)%u->ns; qn--;
+    inq[sq]=0;
+    if(++nq[sq]>u->ns){ err=FSTSERR("look-ahead does not converge (negative weight cycle)"); goto end; }
+    for(t=u->ttos[sq];t;t=t->prv){
+      FLOAT64 w=u->pot[sq]+t->w;
+      if(u->sub && t->is>=0) w+=src->units[t->is].pot[0];
+      if(w>=u->pot[t->ini]) continue;
+      u->pot[t->ini]=w;
+      if(!inq[t->ini]){
+        q[(qs+qn++)%u->ns]=t->ini;
+        inq[t->ini]=1;
+      }
+    }
+  }
+  /* States without a path to a final state get no look-ahead */
+  for(si=0;si<u->ns;si++) if(u->pot[si]==T_DOUBLE_MAX) u->pot[si]=0.;
+end:
+  if(err && u->pot){ free(u->pot); u->pot=NULL; }
+  if(q) free(q);
+  if(nq) free(nq);
+  if(inq) free(inq);
+  return err;
+}
+
+/* Transducer look-ahead potential function
+ *
+ * This function calculates for each state of each unit the best
+ * timeinvariant weight of a path to a final state of that unit.
+ * Transitions into sub units (on-the-fly composition) are weighted
+ * with the potential of the sub unit's initial state. The sum of these
+ * potentials over all layers of a hypothesis is the best weight it can
+ * still reach (language model look-ahead). Unlike fsts_fstpw the
+ * transition weights are not modified. The potentials are kept until
+ * the transducer is unloaded.
+ *
+ * @param src  The transducer
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_fstla(struct fsts_fst *src){
+  INT32 ui;
+  const char *err;
+  for(ui=0;ui<src->nunits;ui++) if((err=fsts_fstlau(src,ui,0))) return err;
+  return NULL;
+}
@@ -47,6 +47,7 @@ struct fsts_unit {
   struct fsts_t **tfroms; /* Transition array by initial state  (see fsts_t.nxt) */
   struct fsts_t **ttos;   /* Transition array by terminal state (see fsts_t.prv) */
   UINT8 *sfin;            /* Array indicating the final states  */
+  FLOAT64 *pot;           /* Look-ahead potential by state (see fsts_fstla) or NULL */
 };
 
 /* Internal transducer structure */
@@ -60,5 +61,6 @@ struct fsts_fst {
 const char *fsts_load(struct fsts_fst *src,CFst *itSrc,INT32 uid,UINT8 fast);
 const char *fsts_unload(struct fsts_fst *src);
 const char *fsts_fstpw(struct fsts_fst *src);
+const char *fsts_fstla(struct fsts_fst *src);
 
 #endif
@@ -156,8 +156,10 @@ INT16 CGEN_PUBLIC CFstsearch_Isearch(CFstsearch *_this,CData *idWeights){
   break;
   case FS_END:   return IERROR(_this,FSTS_STR,FSTSERR("restart search first"),0,0);
   }
-  if((err=fsts_wgen(&w,idWeights))) return IERROR(_this,FSTS_STR,err,0,0);
-  if(!w.w){
+  /* CFst_Sdp streams the weights from idWeights itself */
+  if(glob->cfg.algo==FA_SDP) fsts_winit(&w,idWeights);
+  else if((err=fsts_wgen(&w,idWeights,&glob->cfg))) return IERROR(_this,FSTS_STR,err,0,0);
+  if(!w.nf){
     if(glob->cfg.algo!=FA_TP && glob->cfg.algo!=FA_AS) return IERROR(_this,FSTS_STR,FSTSERR("timeinvariant decoding not implemented for this algo"),0,0);
     if(!_this->m_bFinal) return IERROR(_this,FSTS_STR,FSTSERR("timeinvariant iterative decoding not possible"),0,0);
   }else if(!_this->m_bFinal && glob->cfg.algo!=FA_TP){ err=FSTSERR("iterative decoding not implemented for that algo"); goto end; }
@@ -207,6 +209,27 @@ INT16 CGEN_PUBLIC CFstsearch_Backtrack(CFstsearch *_this,CFst *itDst){
   return CFstsearch_Restart(_this);
 }
 
+/* see fstsearch.def */
+INT16 CGEN_PUBLIC CFstsearch_Partial(CFstsearch *_this,CFst *itDst){
+  struct fsts_glob *glob;
+  const char *err=NULL;
+  fsts_getglob();
+  glob->debug=BASEINST(_this)->m_nCheck;
+  CFst_Reset(BASEINST(itDst),TRUE);
+  if(glob->state!=FS_SEARCHING && glob->state!=FS_END)
+    return IERROR(_this,FSTS_STR,FSTSERR("no search before backtracking"),0,0);
+  if(glob->cfg.algo!=FA_TP) return IERROR(_this,FSTS_STR,FSTSERR("partial backtracking not possible for this algo"),0,0);
+  fsts_gettime();
+  err=fsts_tp_partial(glob,itDst);
+  _this->m_nTime+=fsts_gettime();
+  if(err) return IERROR(_this,FSTS_STR,err,0,0);
+  if(glob->src.itSrc){
+    CData_Copy(itDst->is,glob->src.itSrc->is);
+    CData_Copy(itDst->os,glob->src.itSrc->os);
+  }
+  return O_K;
+}
+
 /* Unload source transducer
  *
  * This function unloads the source transducer and
@@ -31,6 +31,7 @@ struct fsts_glob;
 struct fsts_cfg;
 
 #include "fsts_mem.h"
+#include "fsts_stk.h"
 #include "fsts_w.h"
 #include "fsts_as.h"
 #include "fsts_tp.h"
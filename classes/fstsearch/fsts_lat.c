@@ -24,25 +24,34 @@
  * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
+
 #include "fsts_glob.h"
 
+/* Residual hash chain of a residual */
+#define RSHCH(ds,as) (((((UINT64)(ds))>>5)^(((UINT64)(as))>>5)*31)&RSHMASK)
+
 /* Lattice init function
  *
  * This function initializes the lattice structure and all sub structures
  *
- * @param lat  Pointer to lattice storage structure
- * @param prn  Pruning threshold
+ * @param lat   Pointer to lattice storage structure
+ * @param prn   Pruning threshold
+ * @param head  Initial lattice state to share or <code>NULL</code> to create one
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_latinit(struct fsts_lat *lat,FLOAT64 prn){
+const char *fsts_latinit(struct fsts_lat *lat,FLOAT64 prn,struct fsts_latas *head){
   const char *err;
   if((err=fsts_meminit(&lat->asmem,sizeof(struct fsts_latas),32768,0,0))) return err;
   if((err=fsts_meminit(&lat->dsmem,sizeof(struct fsts_latds),32768,0,0))) return err;
   if((err=fsts_meminit(&lat->resmem,sizeof(struct fsts_latres),32768,0,0))) return err;
+  if((err=fsts_meminit(&lat->ashmem,sizeof(struct fsts_latash),32768,0,0))) return err;
+  if((err=fsts_meminit(&lat->rshmem,sizeof(struct fsts_latrsh),32768,0,0))) return err;
+  lat->prn=prn;
+  if((lat->head=head)) return NULL;
   if(!(lat->head=(struct fsts_latas *)fsts_memget(&lat->asmem))) return FSTSERR("out of memory");
   memset(lat->head,0,sizeof(struct fsts_latas));
   lat->head->os=-1;
-  lat->prn=prn;
   return NULL;
 }
 
@@ -56,6 +65,8 @@ void fsts_latfree(struct fsts_lat *lat){
   fsts_memfree(&lat->asmem);
   fsts_memfree(&lat->dsmem);
   fsts_memfree(&lat->resmem);
+  fsts_memfree(&lat->ashmem);
+  fsts_memfree(&lat->rshmem);
 }
 
 /* Lattice size function
@@ -67,7 +78,7 @@ void fsts_latfree(struct fsts_lat *lat){
  * @return     Memory used in MB
  */
 UINT32 fsts_latsize(struct fsts_lat *lat){
-  return fsts_memsize(&lat->asmem)+fsts_memsize(&lat->dsmem)+fsts_memsize(&lat->resmem);
+  return fsts_memsize(&lat->asmem)+fsts_memsize(&lat->dsmem)+fsts_memsize(&lat->resmem)+fsts_memsize(&lat->ashmem)+fsts_memsize(&lat->rshmem);
 }
 
 /* Lattice generation function
@@ -119,6 +130,56 @@ struct fsts_latas *fsts_latjoin(struct fsts_latas *as,struct fsts_latas *asref,F
   return asnew;
 }
 
+/* Lattice anchor function
+ *
+ * This function is called before the decoder propagates
+ * an active state. It generates a new active state which is
+ * only referenced by the propagated state and it's successors.
+ * Hypothesis's recombined with the propagated state later on
+ * are joined into this active state by fsts_latjoinin.
+ *
+ * @param asref  Active state of the propagated state
+ * @param lat    Lattice storage structure
+ * @return       The new active state or <code>NULL</code> on error
+ */
+struct fsts_latas *fsts_latanchor(struct fsts_latas *asref,struct fsts_lat *lat){
+  struct fsts_latas *as=(struct fsts_latas*)fsts_memget(&lat->asmem);
+  if(!as) return NULL;
+  as->pa=asref;
+  as->paw=NULL;
+  as->os=-1;
+  as->w=0.;
+  as->s=-1;
+  return as;
+}
+
+/* Lattice join in place function
+ *
+ * This function is called whenever the decoder recombines
+ * a hypothesis with a state which was already propagated.
+ * The anchor of the propagated state (see fsts_latanchor)
+ * is modified in place such that all successors of the
+ * propagated state refer to both hypothesis's.
+ *
+ * @param as     The recombined previous active state
+ * @param asref  The anchor of the surviving (propagated) state
+ * @param wd     Weight difference of previous active states
+ * @param lat    Lattice storage structure
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_latjoinin(struct fsts_latas *as,struct fsts_latas *asref,FLOAT64 wd,struct fsts_lat *lat){
+  if(as==asref || (lat->prn && wd>lat->prn)) return NULL;
+  if(asref->paw){
+    struct fsts_latas *ascp=(struct fsts_latas*)fsts_memget(&lat->asmem);
+    if(!ascp) return FSTSERR("out of memory");
+    *ascp=*asref;
+    asref->pa=ascp;
+  }
+  asref->paw=as;
+  asref->w=wd;
+  return NULL;
+}
+
 /* Lattice determined state creation function
  *
  * This function creates a new determined state.
@@ -153,39 +214,94 @@ void fsts_latdsfree(struct fsts_latds *ds,struct fsts_lat *lat){
 /* Lattice add resdiual function
  *
  * This function adds a new residual to a determined state.
+ * The residuals are searched in the residual hash (if given)
+ * and inserted unsorted. Use fsts_latressort before comparing
+ * determined states.
  *
  * @param ds      Determined state
  * @param as      Active state of residual
  * @param w       Residual weight
  * @param wa      Total path weight
  * @param resmem  Memory for residuals
+ * @param rsh     Residual hash or <code>NULL</code> for linear search
+ * @param rshmem  Memory for residual hash
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_latdsaddres(struct fsts_latds *ds,struct fsts_latas *as,FLOAT64 w,FLOAT64 wa,struct fsts_mem *resmem){
-  struct fsts_latres **resin=&ds->res;
-  /* TODO: avl tree */
-  while(*resin && resin[0]->as<as) resin=&resin[0]->nxt;
-  if(!*resin || resin[0]->as!=as){
-    struct fsts_latres *res=(struct fsts_latres*)fsts_memget(resmem);
-    if(!res) return FSTSERR("out of memory");
+const char *fsts_latdsaddres(struct fsts_latds *ds,struct fsts_latas *as,FLOAT64 w,FLOAT64 wa,struct fsts_mem *resmem,struct fsts_latrsh **rsh,struct fsts_mem *rshmem){
+  struct fsts_latres *res=NULL;
+  struct fsts_latrsh *rsh1=NULL;
+  INT32 rshch=0;
+  if(rsh){
+    rshch=RSHCH(ds,as);
+    for(rsh1=rsh[rshch];rsh1 && (rsh1->ds!=ds || rsh1->res->as!=as);) rsh1=rsh1->nxt;
+    if(rsh1) res=rsh1->res;
+  }else for(res=ds->res;res && res->as!=as;) res=res->nxt;
+  if(!res){
+    if(!(res=(struct fsts_latres*)fsts_memget(resmem))) return FSTSERR("out of memory");
     res->as=as;
     res->w=w;
     res->wa=wa;
     ds->nres++;
-    res->nxt=*resin;
-    *resin=res;
-  }else if(w<resin[0]->w){
-    resin[0]->w=w;
-    resin[0]->wa=wa;
+    res->nxt=ds->res;
+    ds->res=res;
+    if(rsh){
+      if(!(rsh1=(struct fsts_latrsh*)fsts_memget(rshmem))) return FSTSERR("out of memory");
+      rsh1->ds=ds;
+      rsh1->res=res;
+      rsh1->nxt=rsh[rshch];
+      rsh[rshch]=rsh1;
+    }
+  }else if(w<res->w){
+    res->w=w;
+    res->wa=wa;
   }
   ds->w=MIN(ds->w,w);
   return NULL;
 }
 
+/* Lattice residuals sort function
+ *
+ * This function sorts a residual list by active state
+ * (merge sort on the linked list).
+ *
+ * @param res   Pointer to residuals
+ * @param n     Number of residuals
+ * @return      Sorted residuals
+ */
+struct fsts_latres *fsts_latressort(struct fsts_latres *res,INT32 n){
+  struct fsts_latres *a, *b, *r=NULL, **re=&r;
+  INT32 i;
+  if(n<2) return res;
+  for(a=res,i=1;i<n/2;i++) a=a->nxt;
+  b=a->nxt; a->nxt=NULL;
+  a=fsts_latressort(res,n/2);
+  b=fsts_latressort(b,n-n/2);
+  while(a && b){
+    if(a->as<b->as){ *re=a; a=a->nxt; }else{ *re=b; b=b->nxt; }
+    re=&re[0]->nxt;
+  }
+  *re=a?a:b;
+  return r;
+}
+
+/* Lattice hash mixing function
+ *
+ * @param x  Hash key
+ * @return   Mixed hash key
+ */
+UINT64 fsts_latmix(UINT64 x){
+  x^=x>>33; x*=0xff51afd7ed558ccdULL;
+  x^=x>>33; x*=0xc4ceb9fe1a85ec53ULL;
+  x^=x>>33;
+  return x;
+}
+
 /* Lattice residuals hash function
  *
  * This function computes a hash key for
- * the residuals of a determined state.
+ * the (sorted) residuals of a determined state.
+ * The weights are quantized by LATWQ, so residuals
+ * which differ only by rounding errors get equal.
  *
  * @param res   Pointer to residuals
  * @param woff  Weight offset to substract from residuals
@@ -195,7 +311,9 @@ UINT64 fsts_lathash(struct fsts_latres *res,FLOAT64 woff){
   UINT64 hash=0;
   for(;res;res=res->nxt){
     res->w-=woff;
-    hash=((hash<<5)|(hash>>(8*sizeof(UINT64)-5)))^(((UINT64)res->as)>>5)^((UINT64)res->w);
+    res->wq=(INT64)floor(res->w/LATWQ+.5);
+    hash=fsts_latmix(hash+(UINT64)res->as);
+    hash=fsts_latmix(hash+(UINT64)res->wq);
   }
   return hash;
 }
@@ -212,7 +330,7 @@ UINT64 fsts_lathash(struct fsts_latres *res,FLOAT64 woff){
 char fsts_latdseql(struct fsts_latds *dsa,struct fsts_latds *dsb){
   struct fsts_latres *resa=dsa->res, *resb=dsb->res;
   if(dsa->hash!=dsb->hash || dsa->nres!=dsb->nres) return 0;
-  while(resa && resb && resa->as==resb->as && resa->w==resb->w){ resa=resa->nxt; resb=resb->nxt; }
+  while(resa && resb && resa->as==resb->as && resa->wq==resb->wq){ resa=resa->nxt; resb=resb->nxt; }
   return !resa && !resb;
 }
 
@@ -227,6 +345,7 @@ char fsts_latdseql(struct fsts_latds *dsa,struct fsts_latds *dsb){
 struct fsts_latds *fsts_latdshins(struct fsts_latds *ds,struct fsts_lat *lat){
   struct fsts_latds  *dsh;
   INT32 ch;
+  ds->res=fsts_latressort(ds->res,ds->nres);
   ds->hash=fsts_lathash(ds->res,ds->w);
   ch=ds->hash&HMASK;
   for(dsh=lat->hds[ch];dsh && !fsts_latdseql(dsh,ds);) dsh=dsh->hnxt;
@@ -250,39 +369,40 @@ struct fsts_latds *fsts_latdshins(struct fsts_latds *ds,struct fsts_lat *lat){
  * @param wa      Total path weight
  * @param ds2     Output-Symbol-Hash for new determined states
  * @param lat     Lattice storage structure
- * @param ash     Propagate hash (holds all visited active states)
- * @param ashmem  Memory for propagate hash
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_latasprop(struct fsts_latas *as,FLOAT64 w,FLOAT64 wa,struct fsts_latds **ds2,struct fsts_lat *lat,struct fsts_latash **ash,struct fsts_mem *ashmem){
+const char *fsts_latasprop(struct fsts_latas *as,FLOAT64 w,FLOAT64 wa,struct fsts_latds **ds2,struct fsts_lat *lat){
   struct fsts_latash *ash1;
   INT32 ashch;
   const char *err;
   if(!as) return NULL;
   ashch=(((UINT64)as)>>5)&ASHMASK;
-  for(ash1=ash[ashch];ash1 && ash1->as!=as;) ash1=ash1->nxt;
+  for(ash1=lat->ash[ashch];ash1 && ash1->as!=as;) ash1=ash1->nxt;
   if(!ash1){
-    if(!(ash1=(struct fsts_latash *)fsts_memget(ashmem))) return FSTSERR("out of memory");
+    if(!(ash1=(struct fsts_latash *)fsts_memget(&lat->ashmem))) return FSTSERR("out of memory");
     ash1->as=as;
-    ash1->nxt=ash[ashch];
-    ash[ashch]=ash1;
+    ash1->nxt=lat->ash[ashch];
+    lat->ash[ashch]=ash1;
+    ash1->unxt=lat->ashu;
+    lat->ashu=ash1;
   }else if(w>=ash1->w) return NULL;
   ash1->w=w;
   if(as->pa && as->os<0){
-    if((err=fsts_latasprop(as->pa,w,wa,ds2,lat,ash,ashmem))) return err;
+    if((err=fsts_latasprop(as->pa,w,wa,ds2,lat))) return err;
     if(!lat->prn || wa+as->w<=lat->prn)
-      if((err=fsts_latasprop(as->paw,w+as->w,wa+as->w,ds2,lat,ash,ashmem))) return err;
+      if((err=fsts_latasprop(as->paw,w+as->w,wa+as->w,ds2,lat))) return err;
   }else{
     INT32 ch=as->pa?(as->os&OSMASK):OSMASK;
-    struct fsts_latds *ds=ds2[ch];
-    while(ds && ds->os!=as->os) ds=ds->qnxt;
-    if(!ds){
+    struct fsts_latds **pds=ds2+ch,*ds;
+    /* keep chain sorted by output symbol (state order independent of lattice structure) */
+    while(*pds && (*pds)->os<as->os) pds=&(*pds)->qnxt;
+    if(!(ds=*pds) || ds->os!=as->os){
       if(!(ds=fsts_latdsnew(&lat->dsmem))) return FSTSERR("out of memory");
       ds->os=as->os;
-      ds->qnxt=ds2[ch];
-      ds2[ch]=ds;
+      ds->qnxt=*pds;
+      *pds=ds;
     }
-    if((err=fsts_latdsaddres(ds,as->pa?as->pa:as,w,wa,&lat->resmem))) return err;
+    if((err=fsts_latdsaddres(ds,as->pa?as->pa:as,w,wa,&lat->resmem,lat->rsh,&lat->rshmem))) return err;
   }
   return NULL;
 }
@@ -299,15 +419,23 @@ const char *fsts_latasprop(struct fsts_latas *as,FLOAT64 w,FLOAT64 wa,struct fst
  */
 const char *fsts_latdsprop(struct fsts_latds *ds1,struct fsts_latds **ds2,struct fsts_lat *lat){
   struct fsts_latres *res;
-  struct fsts_mem ashmem;
-  struct fsts_latash *ash[ASHMASK+1];
+  struct fsts_latash *ash1;
+  struct fsts_latds *ds;
   INT32 i;
   const char *err;
   for(i=0;i<=OSMASK;i++) ds2[i]=NULL;
-  for(i=0;i<=ASHMASK;i++) ash[i]=NULL;
-  if((err=fsts_meminit(&ashmem,sizeof(struct fsts_latash),32768,0,0))) return err;
-  for(res=ds1->res;res;res=res->nxt) if((err=fsts_latasprop(res->as,res->w,res->wa,ds2,lat,ash,&ashmem))) return err;
-  fsts_memfree(&ashmem);
+  for(res=ds1->res;res;res=res->nxt) if((err=fsts_latasprop(res->as,res->w,res->wa,ds2,lat))) return err;
+  /* Clear the propagate hash (only chains of visited active states) */
+  while((ash1=lat->ashu)){
+    lat->ashu=ash1->unxt;
+    lat->ash[(((UINT64)ash1->as)>>5)&ASHMASK]=NULL;
+    fsts_memput(&lat->ashmem,ash1);
+  }
+  /* Clear the residual hash (only chains used by the new determined states) */
+  for(i=0;i<=OSMASK;i++) for(ds=ds2[i];ds;ds=ds->qnxt) for(res=ds->res;res;res=res->nxt){
+    struct fsts_latrsh **rsh=lat->rsh+RSHCH(ds,res->as), *rsh1;
+    while((rsh1=*rsh)){ *rsh=rsh1->nxt; fsts_memput(&lat->rshmem,rsh1); }
+  }
   return NULL;
 }
 
@@ -330,6 +458,24 @@ void fsts_latdsprt(const char *pre,struct fsts_latds *ds,struct fsts_lat *lat){
 #endif
 }
 
+/* Lattice destination grow function
+ *
+ * This function grows the state and transition table of the destination
+ * transducer by at least one eighth if they are full. This keeps adding
+ * states and transitions one by one linear for large lattices.
+ *
+ * @param itDst  Destination transducer
+ */
+void fsts_latgrow(CFst *itDst){
+  CData *idTab[2];
+  INT32 i;
+  idTab[0]=AS(CData,itDst->sd);
+  idTab[1]=AS(CData,itDst->td);
+  for(i=0;i<2;i++)
+    if(CData_GetMaxRecs(idTab[i])>0 && CData_GetNRecs(idTab[i])+1>CData_GetMaxRecs(idTab[i]))
+      CData_Realloc(idTab[i],CData_GetNRecs(idTab[i])+MAX(1+itDst->m_nGrany,CData_GetNRecs(idTab[i])/8));
+}
+
 /* Lattice backtrack function without determinization
  *
  * This function exports a subtree of the non-determined lattice to itDst.
@@ -344,6 +490,7 @@ void fsts_latdsprt(const char *pre,struct fsts_latds *ds,struct fsts_lat *lat){
  */
 void fsts_latbt1(struct fsts_latas *as,struct fsts_lat *lat,CFst *itDst,INT32 ui,INT32 st,INT32 os,FLOAT64 w){
   if(!as) return;
+  fsts_latgrow(itDst);
   if(as->s>=0) CFst_AddtransEx(itDst,ui,as->s,st,-1,os,w);
   else{
     as->s=UD_XS(itDst,ui);
@@ -376,12 +523,15 @@ const char *fsts_latbt(struct fsts_latas *as,struct fsts_lat *lat,CFst *itDst,IN
   fsts_latbt1(as->paw,lat,itDst,ui,1,-1,w+as->w);
 #else
   if(!(lat->hds=(struct fsts_latds**)calloc(HMASK+1,sizeof(struct fsts_latds*)))) return FSTSERR("out of memory");
+  if(!(lat->rsh=(struct fsts_latrsh**)calloc(RSHMASK+1,sizeof(struct fsts_latrsh*)))) return FSTSERR("out of memory");
+  if(!(lat->ash=(struct fsts_latash**)calloc(ASHMASK+1,sizeof(struct fsts_latash*)))) return FSTSERR("out of memory");
+  lat->ashu=NULL;
   lat->qds=fsts_latdsnew(&lat->dsmem);
   lat->qds->s=1;
-  fsts_latdsaddres(lat->qds,as,w,0.,&lat->resmem);
+  fsts_latdsaddres(lat->qds,as,w,0.,&lat->resmem,NULL,NULL);
   struct fsts_latds *ds=fsts_latdsnew(&lat->dsmem);
   ds->s=0;
-  fsts_latdsaddres(ds,lat->head,0.,0.,&lat->resmem);
+  fsts_latdsaddres(ds,lat->head,0.,0.,&lat->resmem,NULL,NULL);
   fsts_latdshins(ds,lat);
   while(lat->qds){
     struct fsts_latds *ds1=lat->qds,*ds2[OSMASK+1],*ds,*dsnxt;
@@ -393,6 +543,7 @@ const char *fsts_latbt(struct fsts_latas *as,struct fsts_lat *lat,CFst *itDst,IN
       INT32 os=ds->os;
       FLOAT64 w=ds->w;
       dsnxt=ds->qnxt;
+      fsts_latgrow(itDst);
       fsts_latdsprt("  =>",ds,lat);
       ds=fsts_latdshins(ds,lat);
       if(ds->s<0){
@@ -412,6 +563,8 @@ const char *fsts_latbt(struct fsts_latas *as,struct fsts_lat *lat,CFst *itDst,IN
   }
 end:
   free(lat->hds);
+  free(lat->rsh);
+  free(lat->ash);
 #endif
   return err;
 }
@@ -29,12 +29,17 @@
 #define HMASK   0x0000ffff
 #define OSMASK  0x000000ff
 #define ASHMASK 0x0000ffff
+#define RSHMASK 0x0000ffff
+
+/* Quantization of residual weights for comparing determined states */
+#define LATWQ   1.E-6
 
 /* Lattice propagate hash element */
 struct fsts_latash {
-  struct fsts_latash *nxt; /* Next hash element    */
-  struct fsts_latas  *as;  /* Current active state */
-  FLOAT64 w;               /* Remaining weight     */
+  struct fsts_latash *nxt;  /* Next hash element    */
+  struct fsts_latash *unxt; /* Next used element    */
+  struct fsts_latas  *as;   /* Current active state */
+  FLOAT64 w;                /* Remaining weight     */
 };
 
 /* Lattice residual for determinization */
@@ -43,13 +48,21 @@ struct fsts_latres {
   struct fsts_latas  *as;  /* Current lattice active state       */
   FLOAT64 w;               /* Remaining weight                   */
   FLOAT64 wa;              /* Total weight (for pruning)         */
+  INT64   wq;              /* Quantized remaining weight         */
+};
+
+/* Lattice residual hash element */
+struct fsts_latrsh {
+  struct fsts_latrsh *nxt; /* Next hash element                 */
+  struct fsts_latds  *ds;  /* Determined state of residual       */
+  struct fsts_latres *res; /* Residual                           */
 };
 
 /* Lattice determined state */
 struct fsts_latds {
   struct fsts_latds  *hnxt; /* Next hash element        */
   struct fsts_latds  *qnxt; /* Next queue element       */
-  struct fsts_latres *res;  /* Residuals for that state */
+  struct fsts_latres *res;  /* Residuals (sorted by as) */
   INT32   nres;             /* Number of residuals      */
   UINT64  hash;             /* Hash key                 */
   INT32   os;               /* Output symbol            */
@@ -72,6 +85,11 @@ struct fsts_lat {
   struct fsts_mem   asmem;  /* Memory for active states                */
   struct fsts_mem   dsmem;  /* Memory for determined states            */
   struct fsts_mem   resmem; /* Memory for residuals in determinization */
+  struct fsts_mem   ashmem; /* Memory for propagate hash               */
+  struct fsts_mem   rshmem; /* Memory for residual hash                */
+  struct fsts_latash **ash; /* Propagate hash (visited active states)  */
+  struct fsts_latash *ashu; /* Used elements of propagate hash         */
+  struct fsts_latrsh **rsh; /* Hash for residuals of new det. states   */
   struct fsts_latds **hds;  /* Hash for determined states              */
   struct fsts_latds *qds;   /* Queue for determined states             */
   FLOAT64            prn;   /* Lattice pruning threshold               */
@@ -80,13 +98,15 @@ struct fsts_lat {
 /* Return maximal amount of memory used for decoding */
 #define fsts_latmem1(lat)   fsts_memmem(&(lat)->asmem)
 /* Return maximal amount of memory used for backtracking */
-#define fsts_latmem2(lat)   fsts_memmem(&(lat)->dsmem) + fsts_memmem(&(lat)->resmem)
+#define fsts_latmem2(lat)   fsts_memmem(&(lat)->dsmem) + fsts_memmem(&(lat)->resmem) + fsts_memmem(&(lat)->ashmem) + fsts_memmem(&(lat)->rshmem)
 
-const char *fsts_latinit(struct fsts_lat *lat,FLOAT64 prn);
+const char *fsts_latinit(struct fsts_lat *lat,FLOAT64 prn,struct fsts_latas *head);
 void fsts_latfree(struct fsts_lat *lat);
 UINT32 fsts_latsize(struct fsts_lat *lat);
 struct fsts_latas *fsts_latgen(struct fsts_latas *asref,INT32 os,struct fsts_lat *lat);
 struct fsts_latas *fsts_latjoin(struct fsts_latas *as,struct fsts_latas *asref,FLOAT64 wd,struct fsts_lat *lat);
+struct fsts_latas *fsts_latanchor(struct fsts_latas *asref,struct fsts_lat *lat);
+const char *fsts_latjoinin(struct fsts_latas *as,struct fsts_latas *asref,FLOAT64 wd,struct fsts_lat *lat);
 const char *fsts_latbt(struct fsts_latas *as,struct fsts_lat *lat,CFst *itDst,INT32 ui,FLOAT64 w);
 
 #endif
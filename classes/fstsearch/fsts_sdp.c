@@ -38,9 +38,11 @@
  */
 const char *fsts_sdp_cfg(struct fsts_sdp_cfg *cfg,CFstsearch *_this){
   cfg->prn=_this->m_nSdpPrn;
+  cfg->prnh=(INT32)_this->m_nSdpPrnh;
   cfg->epsremove=_this->m_bSdpEpsremove;
   cfg->fwd=_this->m_bSdpFwd;
   if(cfg->prn<0. || cfg->prn>1.) return FSTSERR("pruning constant out of bounds");
+  if(cfg->prnh<0) return FSTSERR("histogram pruning threshold out of bounds");
   return NULL;
 }
 
@@ -92,9 +94,9 @@ const char *fsts_sdp_isearch(struct fsts_glob *glob,struct fsts_w *w){
   }
   if(glob->cfg.sdp.epsremove) itDst->m_bEpsremove=TRUE;
   if(glob->cfg.sdp.fwd)       itDst->m_bFwd=TRUE;
-  if(CFst_Sdp((CFst*)glob->algo,glob->src.itSrc,0,w->idW)!=O_K) return FSTSERR("sdp failed");
+  if(CFst_SdpEx((CFst*)glob->algo,glob->src.itSrc,0,w->idW,glob->cfg.sdp.prnh)!=O_K) return FSTSERR("sdp failed");
   glob->mem =
-    UD_XS(glob->src.itSrc,0)*2*sizeof(FST_LB_TYPE) + /* lpLBrd, lpLBwr */
+    UD_XS(glob->src.itSrc,0)*2*(sizeof(FST_LB_TYPE)+sizeof(FST_ITYPE)) + /* lpLBrd, lpLBwr, active state lists */
      sizeof(FST_BT_TYPE) + CData_GetDescr(AS(CData,((CFst*)glob->algo)->ud),DESCR4)*sizeof(BYTE*) /* BT */;
   return NULL;
 }
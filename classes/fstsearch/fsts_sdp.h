@@ -29,6 +29,7 @@
 /* DP deocoder config structure */
 struct fsts_sdp_cfg {
   FLOAT64 prn;       /* Pruning threshold */
+  INT32   prnh;      /* Maximal number of active states per layer */
   UINT8   epsremove; /* Perform eps removal after backtracking */
   UINT8   fwd;       /* Do forward algorihtm instead of DP */
 };
@@ -38,6 +38,44 @@
 #define FLG_EPS    0x1
 #define FLG_FWD    0x2
 
+/**
+ * Sparse store of forward sums. For each time the active states of the read
+ * layer buffer are appended, inactive states are implicitly the semiring zero.
+ */
+typedef struct
+{
+  INT32      nLen;                                                              /* Number of stored sums             */
+  INT32      nMax;                                                              /* Allocated number of sums          */
+  FST_ITYPE* lpS;                                                               /* State indices                     */
+  FST_WTYPE* lpD;                                                               /* Forward sums                      */
+  INT32*     lpF;                                                               /* First stored sum for each time    */
+} FST_FWD_TYPE;
+
+/**
+ * Active state list of a layer buffer. Only the listed states are visited
+ * when expanding, pruning and clearing a layer, so the cost of a layer is
+ * proportional to the number of active states.
+ */
+typedef struct
+{
+  FST_ITYPE* lpA;                                                               /* Active states (ascending)         */
+  INT32      nA;                                                                /* Number of active states           */
+} FST_AL_TYPE;
+
+int cf_comp_sdp_itype_up(const void* a, const void* b)
+{
+  if (*(const FST_ITYPE*)a > *(const FST_ITYPE*)b) return  1;
+  if (*(const FST_ITYPE*)a < *(const FST_ITYPE*)b) return -1;
+  return 0;
+}
+
+int cf_comp_sdp_wtype_up(const void* a, const void* b)
+{
+  if (*(const FST_WTYPE*)a > *(const FST_WTYPE*)b) return  1;
+  if (*(const FST_WTYPE*)a < *(const FST_WTYPE*)b) return -1;
+  return 0;
+}
+
 /**
  * Initialize backtracking tree.
  *
@@ -220,6 +258,129 @@ void GEN_PRIVATE CFst_Sdp_GetSWeights
   else *lpSW=NULL;                                                              /* No weights found                  */
 }
 
+/**
+ * Load synchroneous transition weights for time t converting them on the fly.
+ * Unless a conversion buffer is given this is {@link CFst_Sdp_GetSWeights}.
+ * Otherwise only record <code>t</code> of <code>idWeights</code> is converted
+ * into the buffer, so there is no need to convert the whole weight matrix.
+ *
+ * @param _this     Pointer to automaton instance to get weights for
+ * @param idWeights The synchroneous transition weights
+ * @param lpSWa     Pointer to matrix holding synchroneous weights
+ * @param lpSWb     Pointer to conversion buffer (<code>nXW</code> weights) or
+ *                  <code>NULL</code> if <code>lpSWa</code> is to be used
+ * @param bSWf      <code>idWeights</code> is homogeneous <code>T_FLOAT</code>
+ *                  and row-major (the record is converted without
+ *                  <code>CData_Dfetch</code>)
+ * @param t         Time (record index in <code>idWeights</code>)
+ * @param nXW       Number of weights
+ * @param lpSW      Pointer to array to be filled with synchroneous transition
+ *                  weights
+ */
+void GEN_PRIVATE CFst_Sdp_LoadSWeights
+(
+  CFst*         _this,
+  CData*        idWeights,
+  FST_WTYPE*    lpSWa,
+  FST_WTYPE*    lpSWb,
+  BOOL          bSWf,
+  INT32          t,
+  INT32          nXW,
+  FST_WTYPE**   lpSW
+)
+{
+  INT32 nC  = 0;                                                                /* Component counter                 */
+  INT32 nCa = 0;                                                                /* Numeric component counter         */
+  FLOAT32* lpW = NULL;                                                          /* Single precision record           */
+
+  if (!lpSWb) { CFst_Sdp_GetSWeights(_this,lpSWa,t,nXW,lpSW); return; }         /* Use weight matrix directly        */
+  IFCHECKEX(2) printf("\n     Convert sync. weights for time %ld",(long)t);     /* Protocol                          */
+  for (nCa=0; nCa<nXW; nCa++) lpSWb[nCa]=CFst_Wsr_NeMult(_this->m_nWsr);       /* Clear conversion buffer           */
+  if (bSWf)                                                                     /* Single precision weights          */
+  {                                                                             /* >>                                */
+    lpW = (FLOAT32*)CData_XAddr(idWeights,t,0);                                 /*   Get record pointer              */
+    for (nC=0; nC<CData_GetNComps(idWeights) && nC<nXW; nC++)                   /*   Loop over components            */
+      lpSWb[nC] = (FST_WTYPE)lpW[nC];                                           /*     Convert weight                */
+    *lpSW=lpSWb;                                                                /*   Use conversion buffer           */
+    return;                                                                     /*   Done                            */
+  }                                                                             /* <<                                */
+  for (nC=0,nCa=0; nC<CData_GetNComps(idWeights) && nCa<nXW; nC++)             /* Loop over idWeigths' components   */
+    if (dlp_is_numeric_type_code(CData_GetCompType(idWeights,nC)))              /*   The numeric ones ...            */
+      lpSWb[nCa++] = (FST_WTYPE)CData_Dfetch(idWeights,t,nC);                   /*     Convert weight                */
+  *lpSW=lpSWb;                                                                  /* Use conversion buffer             */
+}
+
+/**
+ * Appends the active states of a layer buffer to the sparse forward sums.
+ *
+ * @param _this Pointer to automaton instance
+ * @param lpFW  Pointer to sparse forward sums
+ * @param lpLB  Pointer to layer buffer to store
+ * @param lpAL  Pointer to active state list of <code>lpLB</code>
+ * @param t     Time index of the layer (0 for the initial layer)
+ */
+void GEN_PRIVATE CFst_Sdp_FwdStore
+(
+  CFst*         _this,
+  FST_FWD_TYPE* lpFW,
+  FST_LB_TYPE*  lpLB,
+  FST_AL_TYPE*  lpAL,
+  INT32          t
+)
+{
+  INT32     i  = 0;                                                             /* Active state counter              */
+  FST_ITYPE nS = 0;                                                             /* Current state                     */
+  INT32     nA = lpAL->nA;                                                      /* Number of active states           */
+
+  if (lpFW->nLen+nA>lpFW->nMax)                                                 /* Store too small                   */
+  {                                                                             /* >>                                */
+    lpFW->nMax = MAX(lpFW->nLen+nA,2*lpFW->nMax);                               /*   Double size                     */
+    lpFW->lpS  = (FST_ITYPE*)dlp_realloc(lpFW->lpS,lpFW->nMax,sizeof(FST_ITYPE));/*  Grow state indices             */
+    lpFW->lpD  = (FST_WTYPE*)dlp_realloc(lpFW->lpD,lpFW->nMax,sizeof(FST_WTYPE));/*  Grow forward sums              */
+  }                                                                             /* <<                                */
+  for (i=0; i<nA; i++)                                                          /* For all active states ...         */
+  {                                                                             /* >>                                */
+    nS = lpAL->lpA[i];                                                          /*   Get state index                 */
+    lpFW->lpS[lpFW->nLen] = nS;                                                 /*   Store state index               */
+    lpFW->lpD[lpFW->nLen] = lpLB[nS].nD;                                        /*   Store forward sum               */
+    lpFW->nLen++;                                                               /*   Count                           */
+  }                                                                             /* <<                                */
+  lpFW->lpF[t+1] = lpFW->nLen;                                                  /* Mark end of layer                 */
+}
+
+/**
+ * Writes the sparse forward sums to a dense data instance of
+ * <code>nXS</code> components and <code>nT</code> records.
+ *
+ * @param _this     Pointer to automaton instance
+ * @param lpFW      Pointer to sparse forward sums
+ * @param idWeights Destination data instance
+ * @param nXS       Number of states
+ * @param nT        Number of stored layers
+ */
+void GEN_PRIVATE CFst_Sdp_FwdWrite
+(
+  CFst*         _this,
+  FST_FWD_TYPE* lpFW,
+  CData*        idWeights,
+  INT32          nXS,
+  INT32          nT
+)
+{
+  INT32      i     = 0;                                                         /* Sum counter                       */
+  INT32      t     = 0;                                                         /* Time counter                      */
+  FST_WTYPE* lpD   = NULL;                                                      /* Pointer to destination record     */
+  FST_WTYPE  nZero = CFst_Wsr_NeAdd(_this->m_nWsr);                             /* Get semiring zero                 */
+
+  CData_Array(idWeights,DLP_TYPE(FST_WTYPE),nXS,nT);                            /* Set size of weight array          */
+  for (t=0; t<nT; t++)                                                          /* For all times ...                 */
+  {                                                                             /* >>                                */
+    if (!(lpD=(FST_WTYPE*)CData_XAddr(idWeights,t,0))) return;                  /*   Get destination record          */
+    for (i=0; i<nXS; i++) lpD[i]=nZero;                                         /*   Clear record                    */
+    for (i=lpFW->lpF[t]; i<lpFW->lpF[t+1]; i++) lpD[lpFW->lpS[i]]=lpFW->lpD[i]; /*   Store active states' sums       */
+  }                                                                             /* <<                                */
+}
+
 /**
  * Clears a DP layer buffer.
  *
@@ -253,10 +414,11 @@ void GEN_PRIVATE CFst_Sdp_ClearLB(CFst* _this, FST_LB_TYPE* lpLB, INT32 nXS)   /
  * @param t      Current time
  * @param nD     Distance of state <code>nS</code> from start state
  * @param lpLBwr Pointer to write layer buffer
+ * @param lpALwr Pointer to active state list of write layer buffer (may be <code>NULL</code>)
  * @param bFlags FLG_EPS: process epsilon-transitions (input symbol) only, FLG_FWD: do forward algorithm
  * @return       The number of newly found shortes distances to successing states
  */
-INT32 GEN_PRIVATE CFst_Sdp_ExpandState
+INT32 GEN_PRIVATE CFst_Sdp_ExpandStateEx
 (
   CFst*         _this,
   FST_TID_TYPE* lpTI,
@@ -265,6 +427,7 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandState
   FST_ITYPE     nS,
   FST_WTYPE     nD,
   FST_LB_TYPE*  lpLBwr,
+  FST_AL_TYPE*  lpALwr,
   INT16         bFlags
 )
 {
@@ -320,6 +483,7 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandState
         printf(" > %5.5lg *",lpLBwr[nTer].nD);                                  /*       Protocol beam update         */
         if (SD_FLG(lpTI->iFst,nTer+lpTI->nFS)&SD_FLG_FINAL) printf(" PATH END");/*       Protocol path ends           */
       }                                                                         /*     <<                             */
+      if (lpALwr && !lpLBwr[nTer].lpT) lpALwr->lpA[lpALwr->nA++]=nTer;          /*     Newly activated state -> list  */
       lpLBwr[nTer].lpT = lpT;                                                   /*     Remember current transition... */
       lpLBwr[nTer].nD  = nW;                                                    /*     ... and distance               */
       nCtr++;                                                                   /*     Count                          */
@@ -330,7 +494,29 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandState
 }                                                                               /*                                    */
 
 /**
- * Expand one layer during layer traversal.
+ * Expands one state during layer traversal (without active state list).
+ *
+ * @see CFst_Sdp_ExpandStateEx
+ */
+INT32 GEN_PRIVATE CFst_Sdp_ExpandState
+(
+  CFst*         _this,
+  FST_TID_TYPE* lpTI,
+  FST_WTYPE*    lpSW,
+  INT32          t,
+  FST_ITYPE     nS,
+  FST_WTYPE     nD,
+  FST_LB_TYPE*  lpLBwr,
+  INT16         bFlags
+)
+{
+  return CFst_Sdp_ExpandStateEx(_this,lpTI,lpSW,t,nS,nD,lpLBwr,NULL,bFlags);    /* Expand without active state list  */
+}
+
+/**
+ * Expand one layer during layer traversal. Only the states listed in
+ * <code>lpALrd</code> are visited, the write layer buffer must be clear and
+ * <code>lpALwr</code> empty.
  *
  * @param _this  Pointer to automaton instance
  * @param lpTI   Pointer to automaton iterator data struct
@@ -338,11 +524,14 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandState
  * @param t      Current time
  * @param lpLBrd Pointer to read layer buffer pointer
  * @param lpLBwr Pointer to write layer buffer pointer
+ * @param lpALrd Pointer to active state list of read layer buffer
+ * @param lpALwr Pointer to active state list of write layer buffer
+ * @param nPrnH  Maximal number of active states (histogram pruning, 0 for off)
  * @param lpBT   Pointer to backtracking tree
  * @param bFlags FLG_EPS: process epsilon-transitions (input symbol) only, FLG_FWD: do forward algorithm
  * @return       The new number of active states (beam width)
  */
-INT32 GEN_PRIVATE CFst_Sdp_ExpandLayer
+INT32 GEN_PRIVATE CFst_Sdp_ExpandLayerEx
 (
   CFst*         _this,
   FST_TID_TYPE* lpTI,
@@ -351,95 +540,136 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandLayer
   INT32          nTmax,
   FST_LB_TYPE** lpLBrd,
   FST_LB_TYPE** lpLBwr,
+  FST_AL_TYPE*  lpALrd,
+  FST_AL_TYPE*  lpALwr,
+  INT32          nPrnH,
   FST_BT_TYPE*  lpBT,
   INT16         bFlags
 )
 {
   /* Local variables */                                                         /* --------------------------------- */
+  INT32        i     = 0;                                                       /* Active state counter              */
+  INT32        nA0   = 0;                                                       /* Active states before expansion    */
   FST_ITYPE    nS    = 0;                                                       /* Current state                     */
-  FLOAT64       nAS   = 0.;                                                       /* Number of active states           */
-  INT32         nCtr  = 0;                                                       /* No. of succ. states (beamwidth)   */
-  INT32         nPrn  = 0;                                                       /* Pruned beams counter              */
+  FLOAT64      nAS   = 0.;                                                      /* Number of active states           */
+  INT32        nCtr  = 0;                                                       /* No. of succ. states (beamwidth)   */
+  INT32        nPrn  = 0;                                                       /* Pruned beams counter              */
   FST_WTYPE    nPrnT = 0.;                                                      /* Pruning threshold                 */
+  FST_WTYPE    nHstT = 0.;                                                      /* Histogram pruning threshold       */
+  BOOL         bHst  = FALSE;                                                   /* Histogram pruning active          */
+  FST_WTYPE    nZero = CFst_Wsr_NeAdd(_this->m_nWsr);                           /* Semiring zero                     */
   FST_LB_TYPE* lpAux = NULL;                                                    /* Swap buffer                       */
+  FST_AL_TYPE  iAux;                                                            /* Swap buffer (active states)       */
 
   /* Protocol */                                                                /* --------------------------------- */
   IFCHECKEX(1) printf("\n     Expanding %slayer: ",bFlags&FLG_EPS?"epsilon ":"");/* Protocol                         */
 
   /* Initialize epsilon layer */                                                /* --------------------------------- */
   if (bFlags&FLG_EPS)                                                           /* If epsilon layer                  */
-    for (nS=0; nS<lpTI->nXS; nS++)                                              /*   For all states                  */
+    for (i=0; i<lpALrd->nA; i++)                                                /*   For all active states           */
+    {                                                                           /*   >>                              */
+      nS = lpALrd->lpA[i];                                                      /*     Get state index               */
       dlp_memmove(&(*lpLBwr)[nS],&(*lpLBrd)[nS],sizeof(FST_LB_TYPE));           /*     Copy read layer buffer        */
+      lpALwr->lpA[lpALwr->nA++] = nS;                                           /*     Copy active state             */
+    }                                                                           /*   <<                              */
 
   /* Initialize pruning */                                                      /* --------------------------------- */
   if (_this->m_bPrune)                                                          /* Option /cprune set                */
   {                                                                             /* >>                                */
     FLOAT64 nMin = T_DOUBLE_MAX;                                                 /*   Maximum global weight           */
     FLOAT64 nMax = T_DOUBLE_MIN;                                                 /*   Minimum global weight           */
-    for (nS=0; nS<lpTI->nXS; nS++)                                              /*   For all states ...              */
-      if ((*lpLBrd)[nS].lpT!=NULL)                                              /*     Being active ...              */
-      {                                                                         /*     >>                            */
-        nAS++;                                                                  /*       Count active states         */
-        if ((*lpLBrd)[nS].nD>nMax) nMax = (*lpLBrd)[nS].nD;                     /*       Comp. maximum global weight */
-        if ((*lpLBrd)[nS].nD<nMin) nMin = (*lpLBrd)[nS].nD;                     /*       Comp. minimum global weight */
-      }                                                                         /*     <<                            */
+    for (i=0; i<lpALrd->nA; i++)                                                /*   For all active states ...       */
+    {                                                                           /*   >>                              */
+      nS = lpALrd->lpA[i];                                                      /*     Get state index               */
+      if ((*lpLBrd)[nS].nD>nMax) nMax = (*lpLBrd)[nS].nD;                       /*     Comp. maximum global weight   */
+      if ((*lpLBrd)[nS].nD<nMin) nMin = (*lpLBrd)[nS].nD;                       /*     Comp. minimum global weight   */
+    }                                                                           /*   <<                              */
+    nAS = lpALrd->nA;                                                           /*   Count active states             */
     if (nAS<FST_SDP_KEEPA) nAS=-1.; else nAS/=lpTI->nXS;                        /*   Enforce KEEPA, comp. % active   */
     nPrnT = nMax-_this->m_nPrnConst*(nMax-nMin);                                /*   Compute pruning threshold       */
     IFCHECKEX(1) printf("Prune @: %lg (min=%lg, max=%lg)",nPrnT,nMin,nMax);     /*   Protocol (pruning threshold)    */
   }                                                                             /* <<                                */
+  if (nPrnH>0 && lpALrd->nA>nPrnH && t>FST_SDP_DMZ && t<nTmax-FST_SDP_DMZ)      /* Histogram pruning                 */
+  {                                                                             /* >>                                */
+    FST_WTYPE* lpW = (FST_WTYPE*)dlp_calloc(lpALrd->nA,sizeof(FST_WTYPE));      /*   Weights of active states        */
+    for (i=0; i<lpALrd->nA; i++) lpW[i]=(*lpLBrd)[lpALrd->lpA[i]].nD;          /*   Copy weights                    */
+    qsort(lpW,lpALrd->nA,sizeof(FST_WTYPE),cf_comp_sdp_wtype_up);               /*   Sort weights                    */
+    if (_this->m_nWsr==FST_WSR_LOG || _this->m_nWsr==FST_WSR_TROP)              /*   Small weights are good          */
+      nHstT = lpW[nPrnH-1];                                                     /*     Keep nPrnH smallest ones      */
+    else                                                                        /*   Large weights are good          */
+      nHstT = lpW[lpALrd->nA-nPrnH];                                            /*     Keep nPrnH largest ones       */
+    dlp_free(lpW);                                                              /*   Free weights                    */
+    bHst = TRUE;                                                                /*   Prune by histogram threshold    */
+    IFCHECKEX(1) printf(" Histogram @: %lg",(double)nHstT);                     /*   Protocol (pruning threshold)    */
+  }                                                                             /* <<                                */
 
   /* Expand states */                                                           /* --------------------------------- */
-  for (nS=0; nS<lpTI->nXS; nS++)                                                /* For all states ...                */
-    if ((*lpLBrd)[nS].lpT!=NULL)                                                /*   Being active ...                */
+  nA0 = lpALwr->nA;                                                             /* Remember sorted part of list      */
+  for (i=0; i<lpALrd->nA; i++)                                                  /* For all active states ...         */
+  {                                                                             /* >>                                */
+    nS = lpALrd->lpA[i];                                                        /*   Get state index                 */
+    if                                                                          /*   Pruning state if ...            */
+    (                                                                           /*   |                               */
+      (                                                                         /*   | Beam pruning                  */
+        _this->m_bPrune                                                      && /*   | - Pruning is active           */
+        t>FST_SDP_DMZ && t<nTmax-FST_SDP_DMZ                                 && /*   | - Outside demilitarized zone  */
+        nAS>FST_SDP_KEEPR                                                    && /*   | - Enforce KEEPR               */
+        CFst_Wsr_Op(_this,(*lpLBrd)[nS].nD,nPrnT,OP_LESS)                       /*   | - Above pruning threshold     */
+      )                                                                      || /*   | or                            */
+      (bHst && CFst_Wsr_Op(_this,(*lpLBrd)[nS].nD,nHstT,OP_LESS))               /*   | Histogram pruning             */
+    )                                                                           /*   |                               */
     {                                                                           /*   >>                              */
-      if                                                                        /*     Pruning state if ...          */
-      (                                                                         /*     |                             */
-        _this->m_bPrune                                                      && /*     | Pruning is active           */
-        t>FST_SDP_DMZ && t<nTmax-FST_SDP_DMZ                                 && /*     | Outside demilitarized zone  */
-        nAS>FST_SDP_KEEPR                                                    && /*     | Enforce KEEPR               */
-        CFst_Wsr_Op(_this,(*lpLBrd)[nS].nD,nPrnT,OP_LESS)                       /*     | Above pruning threshold     */
-      )                                                                         /*     |                             */
-      {                                                                         /*     >>                            */
-        IFDOPRINT(2,t)                                                          /*       Protocol                    */
-          printf("\n       PRUNING state %3ld [%lg]",nS,(*lpLBrd)[nS].nD);      /*       |                           */
-        (*lpLBrd)[nS].lpT = NULL;                                               /*       Clear transition pointer    */
-        nPrn++;                                                                 /*       Count pruned beams          */
-      }                                                                         /*     <<                            */
-      else                                                                      /*     Keeping state...              */
-        nCtr+=                                                                  /*       expand                      */
-          CFst_Sdp_ExpandState(_this,lpTI,lpSW,t,nS,(*lpLBrd)[nS].nD,*lpLBwr,   /*       |                           */
-            bFlags);                                                            /*       |                           */
+      IFDOPRINT(2,t)                                                            /*     Protocol                      */
+        printf("\n       PRUNING state %3ld [%lg]",nS,(*lpLBrd)[nS].nD);        /*     |                             */
+      (*lpLBrd)[nS].lpT = NULL;                                                 /*     Clear transition pointer      */
+      nPrn++;                                                                   /*     Count pruned beams            */
     }                                                                           /*   <<                              */
-
-  /* Prune write layer buffer */                                                /* --------------------------------- */
-  /* TODO: cbw pruning! */
+    else                                                                        /*   Keeping state...                */
+      nCtr+=                                                                    /*     expand                        */
+        CFst_Sdp_ExpandStateEx(_this,lpTI,lpSW,t,nS,(*lpLBrd)[nS].nD,*lpLBwr,   /*     |                             */
+          lpALwr,bFlags);                                                       /*     |                             */
+  }                                                                             /* <<                                */
+  if (lpALwr->nA>nA0)                                                           /* New states appended to list       */
+  {                                                                             /* >>                                */
+    if (lpALwr->nA>lpTI->nXS/16)                                                /*   Dense layer: sweeping is cheaper*/
+    {                                                                           /*   >>                              */
+      for (nS=0,lpALwr->nA=0; nS<lpTI->nXS; nS++)                               /*     For all states ...            */
+        if ((*lpLBwr)[nS].lpT) lpALwr->lpA[lpALwr->nA++]=nS;                    /*       Re-list active ones         */
+    }                                                                           /*   <<                              */
+    else                                                                        /*   Sparse layer                    */
+      qsort(lpALwr->lpA,lpALwr->nA,sizeof(FST_ITYPE),cf_comp_sdp_itype_up);     /*     Sort active states ascending  */
+  }                                                                             /* <<                                */
 
   if(!(bFlags&FLG_FWD))                                                         /* Backtracking needed ?             */
   {                                                                             /* >>                                */
     /* Lay traces */                                                            /* --------------------------------- */
-    for (nS=0; nS<lpTI->nXS; nS++)                                              /* For all states...                 */
-      if ((*lpLBwr)[nS].lpT!=NULL)                                              /*   Being active...                 */
-        CFst_Sdp_BtStore(lpBT,(*lpLBwr)[nS].lpT,(*lpLBrd)[nS].lpT,bFlags&FLG_EPS);/*   Store trace                   */
+    for (i=0; i<lpALwr->nA; i++)                                                /* For all active states...          */
+    {                                                                           /*   >>                              */
+      nS = lpALwr->lpA[i];                                                      /*     Get state index               */
+      CFst_Sdp_BtStore(lpBT,(*lpLBwr)[nS].lpT,(*lpLBrd)[nS].lpT,bFlags&FLG_EPS);/*     Store trace                   */
+    }                                                                           /*   <<                              */
     CFst_Sdp_BtStore(lpBT,bFlags&FLG_EPS?(BYTE*)-2:(BYTE*)-1,NULL,bFlags&FLG_EPS);/* Store layer boundary            */
   }                                                                             /* <<                                */
 
-/*  printf("\n Expand layer %3i (%s): ",t,bFlags&FLG_EPS?"eps":"---");
-  printf("\n   "); for(nS=0;nS<lpTI->nXS;nS++) printf(" %9.4g",(*lpLBrd)[nS].nD);
-  printf("\n   "); for(nS=0;nS<lpTI->nXS;nS++) printf(" %9.4g",(*lpLBwr)[nS].nD);*/
-
   /* Switch layer */                                                           /* ---------------------------------- */
   lpAux   = *lpLBrd;                                                           /* Remember read layer buffer pointer */
   *lpLBrd = *lpLBwr;                                                           /* Set read to write                  */
   *lpLBwr = lpAux;                                                             /* Set write to read                  */
-  CFst_Sdp_ClearLB(_this,*lpLBwr,lpTI->nXS);                                   /* Clear write layer buffer           */
+  iAux    = *lpALrd;                                                           /* Remember read active state list    */
+  *lpALrd = *lpALwr;                                                           /* Set read to write                  */
+  *lpALwr = iAux;                                                              /* Set write to read                  */
+  for (i=0; i<lpALwr->nA; i++)                                                 /* Clear write layer buffer ...       */
+  {                                                                            /* >>                                 */
+    (*lpLBwr)[lpALwr->lpA[i]].lpT = NULL;                                      /*   No transition lead here          */
+    (*lpLBwr)[lpALwr->lpA[i]].nD  = nZero;                                     /*   Infinite distance from start     */
+  }                                                                            /* <<                                 */
+  lpALwr->nA = 0;                                                              /* ... and its active state list      */
 
   /* Protocol */                                                               /* ---------------------------------- */
   IFCHECKEX(1)                                                                 /* On verbose level 1                 */
   {                                                                            /* >>                                 */
-    INT32 nCtr2;                                                               /*   Auxilary counter                 */
-    for (nS=0,nCtr2=0; nS<lpTI->nXS; nS++) if ((*lpLBrd)[nS].lpT) nCtr2++;     /*   Count total beamwidth            */
     IFCHECKEX(2) printf("\n    ");                                             /*   Print protocol                   */
-    printf(" Beamwidth: %ld",(long)nCtr2);                                     /*   Print protocol                   */
+    printf(" Beamwidth: %ld",(long)lpALrd->nA);                                /*   Print protocol                   */
     if (nPrn) printf(" (pruned: %ld)",(long)nPrn);                             /*   Print protocol                   */
   }                                                                            /* <<                                 */
   IFDOPRINT(3,t)                                                               /* On verbose level 3 when printing   */
@@ -452,6 +682,42 @@ INT32 GEN_PRIVATE CFst_Sdp_ExpandLayer
   return (bFlags&FLG_EPS)&&(bFlags&FLG_FWD)?0:nCtr;  /* TODO: break criterion */         /* Return beamwidth                   */
 }
 
+/**
+ * Expand one layer during layer traversal (without active state lists). The
+ * lists are built from the layer buffers.
+ *
+ * @see CFst_Sdp_ExpandLayerEx
+ */
+INT32 GEN_PRIVATE CFst_Sdp_ExpandLayer
+(
+  CFst*         _this,
+  FST_TID_TYPE* lpTI,
+  FST_WTYPE*    lpSW,
+  INT32          t,
+  INT32          nTmax,
+  FST_LB_TYPE** lpLBrd,
+  FST_LB_TYPE** lpLBwr,
+  FST_BT_TYPE*  lpBT,
+  INT16         bFlags
+)
+{
+  FST_ITYPE   nS   = 0;                                                         /* Current state                     */
+  INT32       nCtr = 0;                                                         /* Beam width (return value)         */
+  FST_AL_TYPE iALrd;                                                            /* Read active state list            */
+  FST_AL_TYPE iALwr;                                                            /* Write active state list           */
+
+  iALrd.lpA = (FST_ITYPE*)dlp_calloc(MAX(lpTI->nXS,1),sizeof(FST_ITYPE));       /* Allocate read active state list   */
+  iALwr.lpA = (FST_ITYPE*)dlp_calloc(MAX(lpTI->nXS,1),sizeof(FST_ITYPE));       /* Allocate write active state list  */
+  iALrd.nA  = iALwr.nA = 0;                                                     /* Both empty                        */
+  for (nS=0; nS<lpTI->nXS; nS++)                                                /* For all states ...                */
+    if ((*lpLBrd)[nS].lpT!=NULL) iALrd.lpA[iALrd.nA++]=nS;                      /*   List active ones                */
+  nCtr = CFst_Sdp_ExpandLayerEx(_this,lpTI,lpSW,t,nTmax,lpLBrd,lpLBwr,&iALrd,   /* Expand layer                      */
+    &iALwr,0,lpBT,bFlags);                                                      /* |                                 */
+  dlp_free(iALrd.lpA);                                                          /* Free read active state list       */
+  dlp_free(iALwr.lpA);                                                          /* Free write active state list      */
+  return nCtr;                                                                  /* Return beamwidth                  */
+}
+
 /**
  *
  */
@@ -685,13 +951,16 @@ void GEN_PRIVATE CFst_Sdp_Epsremove(CFst* _this)
  *                  as many components as there are transitions in unit
  *                  <code>nUnit</code> of <code>itSrc</code>. The number of
  *                  records determines the number of search layers.
+ * @param nPrnH     Maximal number of active states per layer (histogram
+ *                  pruning, 0 for off)
  */
-INT16 GEN_PUBLIC CFst_SdpUnit
+INT16 GEN_PUBLIC CFst_SdpUnitEx
 (
   CFst*  _this,
   CFst*  itSrc,
   INT32   nUnit,
-  CData* idWeights
+  CData* idWeights,
+  INT32   nPrnH
 )
 {
   INT16         nWtype = T_IGNORE;                                              /* Default weight variable type code */
@@ -703,9 +972,13 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   FST_TID_TYPE* lpTI   = NULL;                                                  /* Source FST iterator               */
   FST_LB_TYPE*  lpLBrd = NULL;                                                  /* Read layer buffer                 */
   FST_LB_TYPE*  lpLBwr = NULL;                                                  /* Write layer buffer                */
+  FST_AL_TYPE   iALrd;                                                          /* Read active state list            */
+  FST_AL_TYPE   iALwr;                                                          /* Write active state list           */
   FST_BT_TYPE*  lpBT   = NULL;                                                  /* Backtracking tree                 */
   BOOL          bSWd   = FALSE;                                                 /* Aync. weights directly from input */
+  BOOL          bSWf   = FALSE;                                                 /* Sync. weights are all T_FLOAT     */
   FST_WTYPE*    lpSWa  = NULL;                                                  /* Synch. weights array (all times)  */
+  FST_WTYPE*    lpSWb  = NULL;                                                  /* Synch. weights conversion buffer  */
   FST_WTYPE*    lpSW   = NULL;                                                  /* Synch. weights array (at time t)  */
   FST_STYPE     nTis   = -1;                                                    /* Current input symbol              */
   INT32          nC     = 0;                                                     /* Component counter                 */
@@ -715,7 +988,7 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   INT32          nEL    = -1;                                                    /* End layer                         */
   INT32          nET    = -1;                                                    /* End time                          */
   INT16         bFlags = 0;                                                     /* Flags for expanding layers        */
-  FLOAT64       *lpSum  = NULL;                                                  /* Pointer to matrix for prob sums   */
+  FST_FWD_TYPE  iFW;                                                            /* Sparse forward sums               */
 
   if(!_this->m_bFwd) DLPASSERT(_this!=itSrc);                                   /* Source and dest. must be different*/
 
@@ -727,11 +1000,15 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   lpBT          = CFst_Sdp_BtInit(lpTI,_this->m_nGrany);                        /* Create backtracking tree          */
   lpLBrd        = (FST_LB_TYPE*)dlp_calloc(lpTI->nXS,sizeof(FST_LB_TYPE));      /* Allocate read layer buffer        */
   lpLBwr        = (FST_LB_TYPE*)dlp_calloc(lpTI->nXS,sizeof(FST_LB_TYPE));      /* Allocate write layer buffer       */
+  iALrd.lpA     = (FST_ITYPE*)dlp_calloc(MAX(lpTI->nXS,1),sizeof(FST_ITYPE));   /* Allocate read active state list   */
+  iALwr.lpA     = (FST_ITYPE*)dlp_calloc(MAX(lpTI->nXS,1),sizeof(FST_ITYPE));   /* Allocate write active state list  */
+  iALrd.nA      = iALwr.nA = 0;                                                 /* Both empty                        */
   IFCHECKEX(1) printf("\n Max. sync. time: %ld",(long)nTmax);                   /* Protocol                          */
   IFCHECKEX(1) printf("\n States         : %ld",(long)lpTI->nXS);               /* Protocol                          */
   if(_this->m_bFwd)                                                             /* If we should do forward algo.     */
   {                                                                             /* >>                                */
-    lpSum = (FLOAT64*)dlp_calloc(lpTI->nXS*(nTmax+1),sizeof(FLOAT64));          /*   Initialize sum matrix           */
+    dlp_memset(&iFW,0,sizeof(FST_FWD_TYPE));                                    /*   Initialize sparse sums          */
+    iFW.lpF = (INT32*)dlp_calloc(nTmax+2,sizeof(INT32));                        /*   Allocate time offsets           */
     bFlags |= FLG_FWD;                                                          /*   Set flag                        */
   }                                                                             /* <<                                */
 
@@ -752,6 +1029,7 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   nWtype = DLP_TYPE(FST_WTYPE);                                                 /* Get default weight variable type  */
   for (nC=0,bSWd=TRUE; nC<CData_GetNComps(idWeights); nC++)                     /* Loop over idWeights' components   */
     if (CData_GetCompType(idWeights,nC)!=nWtype) bSWd=FALSE;                    /*   and see if they're all FST_WTYPE*/
+  if (CData_IsColmajor(idWeights)) bSWd=FALSE;                                  /* Records must be contiguous        */
   IFCHECKEX(1) printf("\n Convert weights: %s",bSWd?"NO":"YES");                /* Protocol                          */
   if (bSWd)                                                                     /* Use sync. idWeights directly      */
   {                                                                             /* >>                                */
@@ -760,18 +1038,10 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   }                                                                             /* <<                                */
   else                                                                          /* Need to convert sync. weights     */
   {                                                                             /* >>                                */
-    INT32 nCa;                                                                  /*   Numeric component counter       */
-    INT32 nR;                                                                   /*   Record counter                  */
     nXW   = _this->m_nSymbols;                                                  /*   One weight for each symbol, pls.*/
-    lpSWa = (FST_WTYPE*)dlp_calloc(nXW*nTmax,sizeof(FST_WTYPE));                /*   Allocate converted weights array*/
-    for (nR=0; nR<nXW*nTmax; nR++) lpSWa[nR]=CFst_Wsr_NeMult(_this->m_nWsr);    /*   Clear                           */
-    for (nC=0,nCa=0; nC<CData_GetNComps(idWeights) && nCa<nXW; nC++)            /*   Loop over idWeigths' components */
-      if (dlp_is_numeric_type_code(CData_GetCompType(idWeights,nC)))            /*     The numeric ones ...          */
-      {                                                                         /*     >>                            */
-        for (nR=0; nR<MIN(CData_GetNRecs(idWeights),nTmax); nR++)               /*       Loop over idWeigths' rcorz  */
-          lpSWa[nR*nXW + nCa] = (FST_WTYPE)CData_Dfetch(idWeights,nR,nC);       /*         Convert weight            */
-        nCa++;                                                                  /*       Count numeric components    */
-      }                                                                         /*     <<                            */
+    lpSWb = (FST_WTYPE*)dlp_calloc(MAX(nXW,1),sizeof(FST_WTYPE));               /*   Allocate one converted record   */
+    bSWf  = CData_IsHomogen(idWeights)==T_FLOAT;                                /*   Single precision weights?       */
+    if (CData_IsColmajor(idWeights)) bSWf=FALSE;                                /*   Records must be contiguous      */
   }                                                                             /* <<                                */
 
   /* Plant beam seed and expand over epsilon transitions */                     /* - - - - - - - - - - - - - - - - - */
@@ -779,41 +1049,42 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   IFCHECKEX(1) printf("\n   Time -1, Layer %ld:",(long)nXL);                    /* Protocol                          */
   lpLBrd[0].lpT = (BYTE*)(-1);                                                  /* Search beam seed                  */
   lpLBrd[0].nD  = CFst_Wsr_NeMult(_this->m_nWsr);                               /* Search beam seed                  */
+  iALrd.lpA[iALrd.nA++] = 0;                                                    /* Search beam seed                  */
   for (i=0; i<nTmax; i++)                                                       /* Expand at most nTmax eps. layers  */
   {                                                                             /* >>                                */
     nXL++;                                                                      /*   Count layers                    */
-    if (CFst_Sdp_ExpandLayer(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,lpBT,      /*   If no new beams expanding layer */
-      FLG_EPS|bFlags)<=0)                                                       /*   |                               */
+    if (CFst_Sdp_ExpandLayerEx(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,&iALrd,  /*   If no new beams expanding layer */
+      &iALwr,nPrnH,lpBT,FLG_EPS|bFlags)<=0)                                     /*   |                               */
         break;                                                                  /*     Stop expanding                */
   }                                                                             /* <<                                */
-  if(_this->m_bFwd) for(i=0;i<lpTI->nXS;i++) lpSum[i]=lpLBrd[i].nD;             /* Copy sums                         */
+  if(_this->m_bFwd) CFst_Sdp_FwdStore(_this,&iFW,lpLBrd,&iALrd,0);             /* Store sums                        */
 
   /* Layer traversal of itSrc */                                                /* --------------------------------- */
   IFCHECKEX(1) printf("\n Layer traversal");                                    /* Protocol                          */
   for (t=0; t<nTmax; t++)                                                       /* For all times t ...               */
   {                                                                             /* >>                                */
     IFCHECKEX(1) printf("\n   Time %ld, Layer %ld:",(long)t,(long)nXL);         /*   Protocol                        */
-    CFst_Sdp_GetSWeights(_this,lpSWa,t,nXW,&lpSW);                              /*   Load weights for time t         */
+    CFst_Sdp_LoadSWeights(_this,idWeights,lpSWa,lpSWb,bSWf,t,nXW,&lpSW);        /*   Load weights for time t         */
 
     /* Expand states over all transitions */                                    /*   - - - - - - - - - - - - - - - - */
-    CFst_Sdp_ExpandLayer(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,lpBT,bFlags);  /*   Do one search step              */
+    CFst_Sdp_ExpandLayerEx(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,&iALrd,      /*   Do one search step              */
+      &iALwr,nPrnH,lpBT,bFlags);                                                /*   |                               */
     nXL++;                                                                      /*   Count layers                    */
 
     /* Expand states over epsilon transitions */                                /*   - - - - - - - - - - - - - - - - */
     for (i=0; i<nTmax; i++)                                                     /*   Expand at most nTmax eps. layers*/
     {                                                                           /*   >>                              */
       nXL++;                                                                    /*     Count layers                  */
-      if (CFst_Sdp_ExpandLayer(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,lpBT,    /*     If no new beams expandg.layer */
-        FLG_EPS|bFlags)<=0)                                                     /*     |                             */
+      if (CFst_Sdp_ExpandLayerEx(_this,lpTI,lpSW,t,nTmax,&lpLBrd,&lpLBwr,&iALrd,/*     If no new beams expandg.layer */
+        &iALwr,nPrnH,lpBT,FLG_EPS|bFlags)<=0)                                   /*     |                             */
           break;                                                                /*       Stop expanding              */
     }                                                                           /*   <<                              */
-    if(_this->m_bFwd) for(i=0;i<lpTI->nXS;i++)                                  /* Copy sums                         */
-      lpSum[ (t+1)*lpTI->nXS + i ] = lpLBrd[i].nD;                              /* |                                 */
+    if(_this->m_bFwd) CFst_Sdp_FwdStore(_this,&iFW,lpLBrd,&iALrd,t+1);         /* Store sums                        */
 
     /* Check for path ends */                                                   /* - - - - - - - - - - - - - - - - - */
     if (!idWeights || t==nTmax-1)                                               /* Async. search or last layer?      */
-      for (nS=0; nS<lpTI->nXS; nS++)                                            /*   For all states in read LB       */
-        if (lpLBrd[nS].lpT && (SD_FLG(lpTI->iFst,nS+lpTI->nFS)&SD_FLG_FINAL))   /*     State active and final?       */
+      for (i=0; i<iALrd.nA; i++)                                                /*   For all active states in read LB*/
+        if (SD_FLG(lpTI->iFst,(nS=iALrd.lpA[i])+lpTI->nFS)&SD_FLG_FINAL)        /*     State final?                  */
         {                                                                       /*     >>                            */
           IFCHECKEX(1)                                                          /*       Protocol                    */
             printf("\n   PATH END at state %ld [%5.5g]",                        /*       |                           */
@@ -831,13 +1102,16 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   /* Clean up */                                                                /* --------------------------------- */
   dlp_free(lpLBrd);                                                             /* Free read layer buffer            */
   dlp_free(lpLBwr);                                                             /* Free write layer buffer           */
-  if (!bSWd) dlp_free(lpSWa);                                                   /* Free converted sync.weights array */
+  dlp_free(iALrd.lpA);                                                          /* Free read active state list       */
+  dlp_free(iALwr.lpA);                                                          /* Free write active state list      */
+  dlp_free(lpSWb);                                                              /* Free sync. weights conv. buffer   */
 
   if(_this->m_bFwd)                                                             /* If we should do forward algo.     */
   {                                                                             /* >>                                */
-    CData_Array(idWeights,DLP_TYPE(FST_WTYPE),lpTI->nXS,nTmax+1);               /*   Set size of weight array        */
-    CData_DblockStore(idWeights,lpSum,0,lpTI->nXS,nTmax+1,-1);                  /*   Copy sums to weight array       */
-    dlp_free(lpSum);                                                            /*   Destroy sums                    */
+    CFst_Sdp_FwdWrite(_this,&iFW,idWeights,lpTI->nXS,nTmax+1);                  /*   Copy sums to weight array       */
+    dlp_free(iFW.lpS);                                                          /*   Destroy sums                    */
+    dlp_free(iFW.lpD);                                                          /*   ...                             */
+    dlp_free(iFW.lpF);                                                          /*   ...                             */
     /* Clean up */                                                              /*   ------------------------------- */
     CFst_Sdp_BtDone(lpBT);                                                      /*   Free backtracking tree          */
     CFst_STI_Done(lpTI);                                                        /*   Free automaton iterator         */
@@ -883,16 +1157,41 @@ INT16 GEN_PUBLIC CFst_SdpUnit
   return O_K;                                                                   /* All done...                       */
 }
 
-/*
- * Manual page at fst_man.def
+/**
+ * Synchroneous dynamic programming of one unit (without histogram pruning).
+ *
+ * @see CFst_SdpUnitEx
  */
-INT16 GEN_PUBLIC CFst_Sdp
+INT16 GEN_PUBLIC CFst_SdpUnit
 (
   CFst*  _this,
   CFst*  itSrc,
   INT32   nUnit,
   CData* idWeights
 )
+{
+  return CFst_SdpUnitEx(_this,itSrc,nUnit,idWeights,0);
+}
+
+/**
+ * Synchroneous dynamic programming with histogram pruning.
+ *
+ * @param _this     Pointer to destination automaton instance
+ * @param itSrc     Pointer to source automaton instance
+ * @param nUnit     The unit to process
+ * @param idWeights The synchroneous transition weights
+ * @param nPrnH     Maximal number of active states per layer (histogram
+ *                  pruning, 0 for off)
+ * @see CFst_Sdp
+ */
+INT16 GEN_PUBLIC CFst_SdpEx
+(
+  CFst*  _this,
+  CFst*  itSrc,
+  INT32   nUnit,
+  CData* idWeights,
+  INT32   nPrnH
+)
 {
   INT32   nIcW       = -1;
   INT16  nCheck     = 0;
@@ -946,6 +1245,8 @@ INT16 GEN_PUBLIC CFst_Sdp
       }                                                                         /*   ...                             */
     }                                                                           /*   ...                             */
     else printf("OFF");                                                         /*   ...                             */
+    printf("\n Histogram pr.  : ");                                             /*   ...                             */
+    if (nPrnH>0) printf("%ld",(long)nPrnH); else printf("OFF");                 /*   ...                             */
   }                                                                             /* <<                                */
   if (_this->m_nPrnConst<=0 || _this->m_nPrnConst>=1) _this->m_bPrune=FALSE;    /* Pruning auto-off                  */
 
@@ -971,7 +1272,7 @@ INT16 GEN_PUBLIC CFst_Sdp
     CData_Copy(_this->os,itSrc->os);                                            /*   Copy output symbol table        */
   }
 
-  CFst_SdpUnit(_this,itSrc,nUnit,idWeights);
+  CFst_SdpUnitEx(_this,itSrc,nUnit,idWeights,nPrnH);
 
   if(!_this->m_bFwd){
     DESTROYVIRTUAL(itSrc,_this);
@@ -988,4 +1289,18 @@ INT16 GEN_PUBLIC CFst_Sdp
   return O_K;
 }
 
+/*
+ * Manual page at fst_man.def
+ */
+INT16 GEN_PUBLIC CFst_Sdp
+(
+  CFst*  _this,
+  CFst*  itSrc,
+  INT32   nUnit,
+  CData* idWeights
+)
+{
+  return CFst_SdpEx(_this,itSrc,nUnit,idWeights,0);
+}
+
 /* EOF */
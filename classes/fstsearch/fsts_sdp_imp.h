@@ -27,5 +27,6 @@
 #define _FSTS_DP_IMP_H
 
 INT16 CFst_Sdp(CFst* _this, CFst* itSrc, INT32 nUnit, CData* idWeights);
+INT16 CFst_SdpEx(CFst* _this, CFst* itSrc, INT32 nUnit, CData* idWeights, INT32 nPrnH);
 
 #endif
@@ -0,0 +1,132 @@
+/* dLabPro class CFstsearch (fstsearch)
+ * - Pushdown stack memory
+ *
+ * AUTHOR : Frank Duckhorn
+ * PACKAGE: dLabPro/classes
+ * 
+ * Copyright 2013 dLabPro contributors and others (see COPYRIGHT file) 
+ * - Chair of System Theory and Speech Technology, TU Dresden
+ * - Chair of Communications Engineering, BTU Cottbus
+ * 
+ * This file is part of dLabPro.
+ * 
+ * dLabPro is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * dLabPro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fsts_glob.h"
+
+/* Number of initial elements in the stack node memory */
+#define STKMEMSIZE  1024
+/* Number of initial chains in the stack node hash */
+#define STKINITCHS  1024
+
+/* This macro gets the chain id of a stack node from it's parent and symbol */
+#define fsts_stkch(h,up,sym)  ((((up)?(up)->id*31:0)^(sym))&(h)->mask)
+
+/* Stack memory initialization function
+ *
+ * This function initializes the pushdown stack memory.
+ *
+ * @param h     Stack memory
+ * @param lock  If TRUE a mutex is locked in fsts_stkpush
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_stkinit(struct fsts_stkh *h,UINT8 lock){
+  const char *err;
+  h->mask=STKINITCHS-1;
+  h->num=0;
+  if(!(h->chs=(struct fsts_stk **)calloc(h->mask+1,sizeof(struct fsts_stk *)))) return FSTSERR("out of memory");
+  if((err=fsts_meminit(&h->mem,sizeof(struct fsts_stk),STKMEMSIZE,0,0))) return err;
+  if((h->lock=lock) && dlp_create_mutex(&h->mutex)!=O_K) return FSTSERR("create mutex failed");
+  return NULL;
+}
+
+/* Stack memory free function
+ *
+ * This function free's the pushdown stack memory
+ * with all stack nodes.
+ *
+ * @param h  Stack memory
+ */
+void fsts_stkfree(struct fsts_stkh *h){
+  if(!h->chs) return;
+  if(h->lock) dlp_destroy_mutex(&h->mutex);
+  fsts_memfree(&h->mem);
+  free(h->chs);
+  h->chs=NULL;
+}
+
+/* Stack memory resize function
+ *
+ * This function quadruples the number of chains
+ * in the stack node hash. Failure is not
+ * reported, than the old size is used.
+ *
+ * @param h  Stack memory
+ */
+void fsts_stkresize(struct fsts_stkh *h){
+  struct fsts_stkh hn=*h;
+  struct fsts_stk *stk;
+  UINT32 ch;
+  hn.mask=((h->mask+1)<<2)-1;
+  if(!(hn.chs=(struct fsts_stk **)calloc(hn.mask+1,sizeof(struct fsts_stk *)))) return;
+  for(ch=0;ch<=h->mask;ch++) for(stk=h->chs[ch];stk;){
+    struct fsts_stk *nxt=stk->nxt;
+    UINT32 chn=fsts_stkch(&hn,stk->up,stk->sym);
+    stk->nxt=hn.chs[chn]; hn.chs[chn]=stk;
+    stk=nxt;
+  }
+  free(h->chs);
+  h->chs=hn.chs;
+  h->mask=hn.mask;
+}
+
+/* Stack push function
+ *
+ * This function pushes a symbol onto a stack.
+ * The resulting stack node is looked up in the
+ * stack memory and only created if it does not
+ * exist yet. So equal stacks share one node.
+ *
+ * @param h    Stack memory
+ * @param stk  The stack (will be replaced by the new one)
+ * @param sym  The symbol to push
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_stkpush(struct fsts_stkh *h,struct fsts_stk **stk,UINT16 sym){
+  struct fsts_stk *up=*stk, *s;
+  UINT32 ch;
+  if(fsts_stkn(up)+1==MAXSTK) return FSTSERR("stk: out of memory");
+  if(h->lock && dlp_lock_mutex(&h->mutex)!=O_K) return FSTSERR("lock mutex failed");
+  ch=fsts_stkch(h,up,sym);
+  for(s=h->chs[ch];s && (s->up!=up || s->sym!=sym);) s=s->nxt;
+  if(!s){
+    if(h->num>h->mask){
+      fsts_stkresize(h);
+      ch=fsts_stkch(h,up,sym);
+    }
+    if(!(s=(struct fsts_stk *)fsts_memget(&h->mem))){
+      if(h->lock) dlp_unlock_mutex(&h->mutex);
+      return FSTSERR("out of memory");
+    }
+    s->up=up;
+    s->sym=sym;
+    s->n=fsts_stkn(up)+1;
+    s->id=++h->num;
+    s->nxt=h->chs[ch]; h->chs[ch]=s;
+  }
+  if(h->lock) dlp_unlock_mutex(&h->mutex);
+  *stk=s;
+  return NULL;
+}
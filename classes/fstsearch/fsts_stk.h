@@ -0,0 +1,76 @@
+/* dLabPro class CFstsearch (fstsearch)
+ * - Pushdown stack memory header
+ *
+ * AUTHOR : Frank Duckhorn
+ * PACKAGE: dLabPro/classes
+ * 
+ * Copyright 2013 dLabPro contributors and others (see COPYRIGHT file) 
+ * - Chair of System Theory and Speech Technology, TU Dresden
+ * - Chair of Communications Engineering, BTU Cottbus
+ * 
+ * This file is part of dLabPro.
+ * 
+ * dLabPro is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * dLabPro is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with dLabPro. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FSTS_STK_H
+#define _FSTS_STK_H
+
+/* Pushdown stack node
+ *
+ * Stack nodes are immutable and shared between all states.
+ * Each stack content exists only once, so two stacks are
+ * equal if and only if their node pointers are equal.
+ * The empty stack is represented by NULL. */
+struct fsts_stk {
+  struct fsts_stk *up;  /* Stack below the top symbol (NULL=empty) */
+  struct fsts_stk *nxt; /* Next node in this hash chain            */
+  UINT32           id;  /* Unique node id (>0)                     */
+  UINT16           sym; /* Top symbol                              */
+  UINT8            n;   /* Stack depth                             */
+};
+
+/* Pushdown stack memory */
+struct fsts_stkh {
+  UINT32            mask; /* Hash mask / Number of chains - 1 */
+  UINT32            num;  /* Number of stack nodes            */
+  struct fsts_stk **chs;  /* Hash chain array                 */
+  struct fsts_mem   mem;  /* Stack node memory                */
+  UINT8             lock; /* Lock mutex on push               */
+  MUTEXHANDLE       mutex;/* The mutex                        */
+};
+
+/* Top symbol of the stack (0 for the empty stack) */
+#define fsts_stktop(stk)  ((stk)?(stk)->sym:0)
+/* Stack depth */
+#define fsts_stkn(stk)    ((stk)?(stk)->n:0)
+/* Stack below the top symbol */
+#define fsts_stkpop(stk)  ((stk)?(stk)->up:NULL)
+/* Unique id of the stack (0 for the empty stack) */
+#define fsts_stkid(stk)   ((stk)?(stk)->id:0)
+/* State id component of the stack
+ * The value is XOR'ed into the state id to spread the states
+ * of different stacks over the hash chains. Equality of the
+ * stacks still has to be checked by the state stack compare
+ * functions fsts_as_scmpstk and fsts_tp_scmpstk. */
+#define fsts_stkkey(stk)  ((stk)?((uint64_t)(stk)->id)<<48:0)
+
+/* Return maximal amount of memory used */
+#define fsts_stkmem(h)    (fsts_memmem(&(h)->mem)+((h)->mask+1)*sizeof(struct fsts_stk*))
+
+const char *fsts_stkinit(struct fsts_stkh *h,UINT8 lock);
+void fsts_stkfree(struct fsts_stkh *h);
+const char *fsts_stkpush(struct fsts_stkh *h,struct fsts_stk **stk,UINT16 sym);
+
+#endif
@@ -46,12 +46,18 @@ const char *fsts_tp_cfg(struct fsts_cfg *cfg,CFstsearch *_this){
   cfg->tp.jobs =_this->m_nTpThreads;
   cfg->tp.prnw =_this->m_nTpPrnw;
   cfg->tp.prnh =_this->m_nTpPrnh;
-  if(cfg->bt==BT_LAT && cfg->tp.jobs>1) return FSTSERR("lattice backtracking not yet implemented with multiple threads");
+  cfg->tp.prnwe=_this->m_nTpPrnwe;
+  cfg->tp.prnos=_this->m_nTpPrnos;
+  cfg->tp.la   =_this->m_bTpLa;
+  cfg->tp.lmla =_this->m_bTpLmla;
+  cfg->tp.partkeep=(INT32)_this->m_nTpPartkeep;
   if(cfg->tp.prnw<0.)                   return FSTSERR("negative value for tp_prnw");
   if(cfg->tp.prnh<0 )                   return FSTSERR("negative value for tp_prnh");
+  if(cfg->tp.prnwe<0.)                  return FSTSERR("negative value for tp_prnwe");
+  if(cfg->tp.prnos<0 )                  return FSTSERR("negative value for tp_prnos");
   for(j=1;j<cfg->tp.jobs;) j<<=1;
   if(j!=cfg->tp.jobs)                   return FSTSERR("tp_threads is no power of two");
-  if(cfg->tp.jobs>1 && cfg->tp.prnh)    return FSTSERR("tp_prnh is not available with multiple threads");
+  if(cfg->tp.jobs>1 && cfg->tp.prnos)   return FSTSERR("tp_prnos is not available with multiple threads");
   return NULL;
 }
 
@@ -96,7 +102,11 @@ const char *fsts_tp_chksrc(struct fsts_fst *src){
 /* TP decoder generate initial state
  *
  * This function generates an initial state for the current
- * frame and adds it to the queue.
+ * frame and adds it to the queue. The history of the first
+ * initial state is held as anchor. Later initial states (/start)
+ * continue the history of the anchor which is the best final
+ * state of the previous frame after the first partial
+ * backtracking (see fsts_tp_partial).
  *
  * @param glob  Pointer to the global memory structure
  * @return <code>NULL</code> if successfull, the error string otherwise
@@ -105,7 +115,9 @@ const char *fsts_tp_geninitial(struct fsts_glob *glob){
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
   struct fsts_tp_s s;
   const char *err;
-  if((err=fsts_tp_sgen(&s,NULL,NULL,&glob->src,NULL,&algo->btm,0,0,&glob->cfg))) return err;
+  if((err=fsts_tp_sgen(&s,NULL,NULL,&glob->src,NULL,&algo->btm,&algo->stkh,0,0,&glob->cfg))) return err;
+  if(!algo->anchor.ti && !algo->anchor.os) fsts_btshold(&algo->anchor,&s.bt,&algo->btm);
+  else fsts_btslink(&s.bt,&algo->anchor);
   return fsts_tp_lsadd(glob->cfg.tp.jobs>1?&algo->jobs[0].ls1:&algo->ls1,&s,0);
 }
 
@@ -122,19 +134,23 @@ const char *fsts_tp_init(struct fsts_glob *glob){
   const char *err;
   if(glob->cfg.bt==BT_T && !glob->src.itSrc) return FSTSERR("fast loading not possible with tp_bt=\"t\"");
   if((err=fsts_tp_chksrc(&glob->src))) return err;
+  if(glob->cfg.tp.lmla && (err=fsts_fstla(&glob->src))) return err;
   if(!(algo=(struct fsts_tp_algo *)calloc(1,sizeof(struct fsts_tp_algo)))) return FSTSERR("out of memory");
   glob->algo=algo;
-  if((err=fsts_btm_init(&algo->btm,&glob->cfg))) return err;
+  if((err=fsts_btm_init(&algo->btm,&glob->cfg,NULL))) return err;
+  if((err=fsts_stkinit(&algo->stkh,glob->cfg.tp.jobs>1))) return err;
   if(glob->cfg.tp.jobs>1){
     INT32 j,jshf=0;
     struct fsts_tp_job *job;
     while((UINT32)(1<<(jshf+1))*glob->cfg.tp.jobs<=glob->src.units[0].ns) jshf++;
     if(dlp_create_mutex(&algo->mutex)!=O_K) return FSTSERR("mutex creation failed");
     if(dlp_create_cond(&algo->cond)!=O_K) return FSTSERR("condition creation failed");
+    if(dlp_create_mutex(&algo->fmutex)!=O_K) return FSTSERR("mutex creation failed");
     if(!(algo->jobs=(struct fsts_tp_job*)calloc(glob->cfg.tp.jobs,sizeof(struct fsts_tp_job)))) return FSTSERR("out of memory");
     for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++){
-      if((err=fsts_tp_lsinit(&job->ls1,&algo->btm,&glob->cfg,T_DOUBLE_MIN))) return err;
-      if((err=fsts_tp_lsinit(&job->ls2,&algo->btm,&glob->cfg,glob->cfg.tp.prnw?0.:T_DOUBLE_MIN))) return err;
+      if((err=fsts_btm_init(&job->btm,&glob->cfg,algo->btm.lat.head))) return err;
+      if((err=fsts_tp_lsinit(&job->ls1,&job->btm,&glob->cfg,T_DOUBLE_MIN))) return err;
+      if((err=fsts_tp_lsinit(&job->ls2,&job->btm,&glob->cfg,glob->cfg.tp.prnw?0.:T_DOUBLE_MIN))) return err;
       if((err=fsts_meminit(&job->smem,sizeof(struct fsts_tp_js),JOBSMEMSIZE,0,0))) return err;
       if(dlp_create_mutex(&job->mutex)!=O_K) return FSTSERR("mutex creation failed");
       if(dlp_create_cond(&job->cond)!=O_K) return FSTSERR("condition creation failed");
@@ -173,10 +189,12 @@ void fsts_tp_free(struct fsts_glob *glob){
       fsts_tp_lsfree(&job->ls1);
       fsts_tp_lsfree(&job->ls2);
       fsts_memfree(&job->smem);
+      fsts_btm_free(&job->btm);
       dlp_destroy_cond(&job->cond);
       dlp_destroy_mutex(&job->mutex);
     }
     free(algo->jobs);
+    dlp_destroy_mutex(&algo->fmutex);
     dlp_destroy_cond(&algo->cond);
     dlp_destroy_mutex(&algo->mutex);
   }else{
@@ -185,6 +203,7 @@ void fsts_tp_free(struct fsts_glob *glob){
   }
   fsts_tp_lsfree(&algo->lsf);
   fsts_btm_free(&algo->btm);
+  fsts_stkfree(&algo->stkh);
   free(glob->algo);
   glob->algo=NULL;
 }
@@ -276,13 +295,16 @@ UINT8 fsts_tp_rbput(struct fsts_tp_job *jobs,UINT8 ls,struct fsts_tp_s *s,INT32
 const char *fsts_tp_dbg(INT32 f,struct fsts_tp_s *s,struct fsts_glob *glob){
   static char buf[512];
   size_t l;
+  UINT16 stk[MAXSTK];
+  struct fsts_stk *st;
   INT8 i;
   l=snprintf(buf,512,"f %4i s %8lu wc %8.1f wn %6.3f l %4i",
     f,s->id,s->wc,s->wn,s->l);
   if(glob->cfg.numpaths>1) l+=snprintf(buf+l,512-l," os: 0x%08x",BTHASH(s->bt.os));
-  if(s->nstk){
+  if(s->stk){
     l+=snprintf(buf+l,512-l," stk: ");
-    for(i=0;i<s->nstk;i++) l+=snprintf(buf+l,512-l,"%s%i",i?",":"",s->stk[i]);
+    for(st=s->stk;st;st=st->up) stk[st->n-1]=st->sym;
+    for(i=0;i<s->stk->n;i++) l+=snprintf(buf+l,512-l,"%s%i",i?",":"",stk[i]);
   }
   return buf;
 }
@@ -291,16 +313,18 @@ const char *fsts_tp_dbg(INT32 f,struct fsts_tp_s *s,struct fsts_glob *glob){
  *
  * This function propagates one active state out of the first active state queue.
  *
- * @param ls1  First active state queue
- * @param ls2  Second active state queue
- * @param wprn Currnet pruning threshold
+ * @param ls1    First active state queue
+ * @param ls2    Second active state queue
+ * @param wprn   Currnet pruning threshold
+ * @param wprnwe Current word end pruning threshold
  * @param glob Pointer to the global memory structure
  * @param w    Pointer to the timevariant weight array
  * @param jid  Job id
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_tp_propagate(struct fsts_tp_ls *ls1,struct fsts_tp_ls *ls2,FLOAT64 wprn,struct fsts_glob *glob,struct fsts_w *w,INT32 jid){
+const char *fsts_tp_propagate(struct fsts_tp_ls *ls1,struct fsts_tp_ls *ls2,FLOAT64 wprn,FLOAT64 wprnwe,struct fsts_glob *glob,struct fsts_w *w,INT32 jid){
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
+  struct fsts_btm *btm=jid>=0?&algo->jobs[jid].btm:&algo->btm;
   struct fsts_tp_s *s1;
   const char *err;
   if((s1=fsts_tp_lsdel(ls1))){
@@ -308,16 +332,17 @@ const char *fsts_tp_propagate(struct fsts_tp_ls *ls1,struct fsts_tp_ls *ls2,FLOA
     INT32 u1i=s1->ds?s1->u[s1->ds-1]:0;
     struct fsts_unit *u=glob->src.units+u1i;
     struct fsts_t *t=u->tfroms[s1i];
-    if(!wprn || s1->wn<wprn){
+    if((!wprn || s1->wp<wprn) && !s1->prn && (!wprnwe || s1->os<0 || s1->wp<wprnwe)){
       algo->nstates++;
+      if(btm->lat.head && !(s1->bt.lat=fsts_latanchor(s1->bt.lat,&btm->lat))) return FSTSERR("out of memory");
       #ifdef _DEBUG
       if(glob->debug>=3) printf(" state: %s\n",fsts_tp_dbg(algo->f,s1,glob));
       #endif
       for(;t;t=t->nxt){
         struct fsts_tp_s s2;
         if(t->is>=0 && !u->sub && !w && algo->f) continue;
-        if(t->stk<0 && (!s1->nstk || s1->stk[s1->nstk-1]!=-t->stk)) continue;
-        if((err=fsts_tp_sgen(&s2,s1,t,&glob->src,w,&algo->btm,u->sub,u1i==0,&glob->cfg))) return err;
+        if(t->stk<0 && fsts_stktop(s1->stk)!=-t->stk) continue;
+        if((err=fsts_tp_sgen(&s2,s1,t,&glob->src,w,btm,&algo->stkh,u->sub,u1i==0,&glob->cfg))) return err;
         #ifdef _DEBUG
         #if 0
         { uint64_t id=s2.s[0],m=glob->src.units[0].ns; INT32 d;
@@ -340,7 +365,7 @@ const char *fsts_tp_propagate(struct fsts_tp_ls *ls1,struct fsts_tp_ls *ls2,FLOA
       if(u->sfin[s1i]){
         if(s1->ds){
           struct fsts_tp_s s2;
-          if((err=fsts_tp_sgen(&s2,s1,NULL,&glob->src,NULL,&algo->btm,0,0,&glob->cfg))) return err;
+          if((err=fsts_tp_sgen(&s2,s1,NULL,&glob->src,NULL,btm,&algo->stkh,0,0,&glob->cfg))) return err;
           #ifdef _DEBUG
           if(glob->debug>=4) printf("  => u: %s",fsts_tp_dbg(algo->f,&s2,glob));
           #endif
@@ -348,20 +373,23 @@ const char *fsts_tp_propagate(struct fsts_tp_ls *ls1,struct fsts_tp_ls *ls2,FLOA
           #ifdef _DEBUG
           if(glob->debug>=4) printf("\n");
           #endif
-        }else if(!s1->nstk){
+        }else if(!s1->stk){
           struct fsts_tp_s s2;
-          if((err=fsts_tp_sgen(&s2,s1,NULL,&glob->src,NULL,&algo->btm,0,0,&glob->cfg))) return err;
+          if((err=fsts_tp_sgen(&s2,s1,NULL,&glob->src,NULL,btm,&algo->stkh,0,0,&glob->cfg))) return err;
           #ifdef _DEBUG
           if(glob->debug>=4) printf("  >fin: %s",fsts_tp_dbg(algo->f,&s2,glob));
           #endif
-          if((err=fsts_tp_lsadd(&algo->lsf,&s2,glob->debug))) return err;
+          if(jid>=0 && dlp_lock_mutex(&algo->fmutex)!=O_K) return FSTSERR("lock mutex failed");
+          err=fsts_tp_lsadd(&algo->lsf,&s2,glob->debug);
+          if(jid>=0) dlp_unlock_mutex(&algo->fmutex);
+          if(err) return err;
           #ifdef _DEBUG
           if(glob->debug>=4) printf("\n");
           #endif
         }
       }
-    }
-    fsts_tp_sfree(s1,NULL,&algo->btm);
+    }else s1->bt.lat=NULL;
+    if((err=fsts_tp_sfree(s1,NULL,btm))) return err;
   }
   return NULL;
 }
@@ -378,18 +406,16 @@ void *fsts_tp_job(void *arg){
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)job->glob->algo;
   struct fsts_tp_js   *js;
   if(dlp_lock_mutex(&job->mutex)!=O_K){ job->ret=FSTSERR("lock mutex failed"); return NULL; }
-  dlp_wait_cond(&job->cond,&job->mutex);
   while(!job->fin){
-    job->run=1;
     if((js=job->js)){
       job->js=js->nxt;
       dlp_unlock_mutex(&job->mutex);
       fsts_tp_lsadd(js->ls?&job->ls2:&job->ls1,&js->s,0);
       if(dlp_lock_mutex(&job->mutex)!=O_K){ job->ret=FSTSERR("lock mutex failed"); return NULL; }
       fsts_memput(&job->smem,js);
-    }else if(job->ls1.qs){
+    }else if(job->run && job->ls1.qs){ /* run is set by the main thread or fsts_tp_rbput only */
       dlp_unlock_mutex(&job->mutex);
-      if((job->ret=fsts_tp_propagate(&job->ls1,&job->ls2,job->wprn,job->glob,job->w,job->jid))) break;
+      if((job->ret=fsts_tp_propagate(&job->ls1,&job->ls2,job->wprn,job->wprnwe,job->glob,job->w,job->jid))) break;
       if(dlp_lock_mutex(&job->mutex)!=O_K){ job->ret=FSTSERR("lock mutex failed"); return NULL; }
     }else{
       if(dlp_lock_mutex(&algo->mutex)!=O_K){ job->ret=FSTSERR("lock mutex failed"); return NULL; }
@@ -407,6 +433,25 @@ void *fsts_tp_job(void *arg){
   return NULL;
 }
 
+/* TP decoder backtrack memory synchronization function
+ *
+ * This function applies the reference counter changes
+ * deferred by all jobs while decoding the last frame.
+ * All increments are applied before the decrements so that
+ * no backtrack node is free'd while it is still in use.
+ * It must only be called while all jobs are waiting.
+ *
+ * @param glob  Pointer to the global memory structure
+ */
+void fsts_tp_btmsync(struct fsts_glob *glob){
+  struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
+  INT32 j;
+  fsts_btmref(&algo->btm);
+  for(j=0;j<glob->cfg.tp.jobs;j++) fsts_btmref(&algo->jobs[j].btm);
+  fsts_btmunref(&algo->btm);
+  for(j=0;j<glob->cfg.tp.jobs;j++) fsts_btmunref(&algo->jobs[j].btm);
+}
+
 /* TP decoder multithreading search function for one frame
  *
  * This function decodes over one frame with the
@@ -423,20 +468,32 @@ const char *fsts_tp_isearchj(struct fsts_glob *glob,struct fsts_w *w){
   INT32 j;
   const char *err;
   struct fsts_tp_job *job;
-  FLOAT64 wprn=0.;
-  if(w && glob->cfg.tp.prnw){
-    FLOAT64 wmin=algo->jobs[0].ls1.wmin;
+  FLOAT64 wprn=0., wprnwe=0., wmin;
+  if(w && glob->cfg.tp.prnh){
+    struct fsts_tp_hist hist=algo->jobs[0].ls1.hist;
+    for(j=1,job=algo->jobs+1;j<glob->cfg.tp.jobs;j++,job++) fsts_tp_histadd(&hist,&job->ls1.hist);
+    wprn=fsts_tp_histthr(&hist,glob->cfg.tp.prnh);
+  }
+  if(w && (glob->cfg.tp.prnw || glob->cfg.tp.prnwe)){
+    wmin=algo->jobs[0].ls1.wmin;
     for(j=1,job=algo->jobs+1;j<glob->cfg.tp.jobs;j++,job++)
       if(job->ls1.wmin<wmin) wmin=job->ls1.wmin;
-    wprn=wmin+glob->cfg.tp.prnw;
+    if(glob->cfg.tp.prnw && (!wprn || wmin+glob->cfg.tp.prnw>wprn)) wprn=wmin+glob->cfg.tp.prnw;
+    if(glob->cfg.tp.prnwe) wprnwe=wmin+glob->cfg.tp.prnwe;
+  }
+  if(w && glob->cfg.tp.la && glob->cfg.tp.prnw && !glob->cfg.wn){
+    FLOAT64 wlamin=T_DOUBLE_MAX;
+    for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++) fsts_tp_lslacalc(&job->ls1,&glob->src,w,&wlamin);
+    for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++) fsts_tp_lslaprn(&job->ls1,wlamin+glob->cfg.tp.prnw);
   }
   for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++){
     job->wprn=wprn;
+    job->wprnwe=wprnwe;
     job->w=w;
-    job->run=1;
   }
   for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++){
     if(dlp_lock_mutex(&job->mutex)!=O_K) return FSTSERR("lock mutex failed");
+    job->run=1;
     dlp_signal_cond(&job->cond);
     dlp_unlock_mutex(&job->mutex);
   }
@@ -447,14 +504,17 @@ const char *fsts_tp_isearchj(struct fsts_glob *glob,struct fsts_w *w){
     dlp_wait_cond(&algo->cond,&algo->mutex);
   }
   dlp_unlock_mutex(&algo->mutex);
+  wmin=T_DOUBLE_MIN;
   for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++){
     if(job->run) abort();
     if(job->ret) return job->ret;
-    fsts_tp_lsfree(&job->ls1);
+    if((err=fsts_tp_lsfree(&job->ls1))) return err;
     job->ls1=job->ls2;
-    if((err=fsts_tp_lsinit(&job->ls2,NULL,NULL,T_DOUBLE_MIN))) return err;
+    if(glob->cfg.tp.prnh && (wmin==T_DOUBLE_MIN || job->ls1.wmin<wmin)) wmin=job->ls1.wmin;
   }
-  fsts_memputdelay(&algo->btm.os);
+  for(j=0,job=algo->jobs;j<glob->cfg.tp.jobs;j++,job++)
+    if((err=fsts_tp_lsinit(&job->ls2,NULL,NULL,wmin))) return err;
+  fsts_tp_btmsync(glob);
   algo->f++;
   #ifdef _DEBUG
   if(glob->debug>=1)
@@ -493,15 +553,21 @@ const char *fsts_tp_isearchj(struct fsts_glob *glob,struct fsts_w *w){
  */
 const char *fsts_tp_isearch1(struct fsts_glob *glob,struct fsts_w *w){
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
-  FLOAT64 wprn=0.;
+  FLOAT64 wprn=0., wprnwe=0.;
   FLOAT64 mem;
   const char *err;
   if(w){
     if(glob->cfg.tp.prnh) wprn=fsts_tp_histthr(&algo->ls1.hist,glob->cfg.tp.prnh);
     if(glob->cfg.tp.prnw && (!wprn || algo->ls1.wmin+glob->cfg.tp.prnw>wprn))
        wprn=algo->ls1.wmin+glob->cfg.tp.prnw;
+    if(glob->cfg.tp.prnwe) wprnwe=algo->ls1.wmin+glob->cfg.tp.prnwe;
+    if(glob->cfg.tp.la && glob->cfg.tp.prnw && !glob->cfg.wn){
+      FLOAT64 wlamin=T_DOUBLE_MAX;
+      fsts_tp_lslacalc(&algo->ls1,&glob->src,w,&wlamin);
+      fsts_tp_lslaprn(&algo->ls1,wlamin+glob->cfg.tp.prnw);
+    }
   }
-  while(algo->ls1.qs) if((err=fsts_tp_propagate(&algo->ls1,&algo->ls2,wprn,glob,w,-1))) return err;
+  while(algo->ls1.qs) if((err=fsts_tp_propagate(&algo->ls1,&algo->ls2,wprn,wprnwe,glob,w,-1))) return err;
   #ifdef _DEBUG
   if(glob->debug>=1)
   #else
@@ -527,10 +593,11 @@ const char *fsts_tp_isearch1(struct fsts_glob *glob,struct fsts_w *w){
     sizeof(struct fsts_tp_algo) +
     fsts_hmem(&algo->ls1.h) +
     fsts_hmem(&algo->ls2.h) +
+    fsts_stkmem(&algo->stkh) +
     fsts_btmmem1(&algo->btm);
   if(mem>glob->mem) glob->mem=mem;
   fsts_memputdelay(&algo->btm.os);
-  fsts_tp_lsfree(&algo->ls1);
+  if((err=fsts_tp_lsfree(&algo->ls1))) return err;
   algo->ls1=algo->ls2;
   algo->f++;
   return fsts_tp_lsinit(&algo->ls2,NULL,NULL,glob->cfg.tp.prnh?algo->ls1.wmin:T_DOUBLE_MIN);
@@ -553,6 +620,7 @@ const char *fsts_tp_isearch(struct fsts_glob *glob,struct fsts_w *w,UINT8 final,
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
   const char *err;
   INT32 f;
+  if(start) algo->start=1;
   if(start && !glob->cfg.wn){
     glob->cfg.wn=1;
     fsts_tp_lswnorm(&algo->ls1,&glob->cfg);
@@ -563,6 +631,10 @@ const char *fsts_tp_isearch(struct fsts_glob *glob,struct fsts_w *w,UINT8 final,
     if(start) fsts_tp_geninitial(glob);
     fsts_wf(w,f,&wf);
     if((err=glob->cfg.tp.jobs>1 ? fsts_tp_isearchj(glob,&wf) : fsts_tp_isearch1(glob,&wf))) return err;
+    if(start && algo->btlink){
+      struct fsts_tp_s *s=fsts_tp_lsbest(&algo->lsf,0);
+      if(s) fsts_btshold(&algo->anchor,&s->bt,&algo->btm);
+    }
   }
   if(!final) return NULL;
   if((err=fsts_tp_lsreset(&algo->lsf))) return err;
@@ -581,6 +653,7 @@ const char *fsts_tp_isearch(struct fsts_glob *glob,struct fsts_w *w,UINT8 final,
     printf(" %s\n",fsts_hdbg(&algo->ls2.h,0));
     #endif
     printf("  %s\n",fsts_btmdbg(&algo->btm,1));
+    if(algo->stkh.num) printf("  stk %8u\n",algo->stkh.num);
   }
   return NULL;
 }
@@ -597,28 +670,91 @@ const char *fsts_tp_isearch(struct fsts_glob *glob,struct fsts_w *w,UINT8 final,
 const char *fsts_tp_backtrack(struct fsts_glob *glob,CFst *itDst,UINT8 final){
   struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
   struct fsts_btinfo bti;
-  struct fsts_tp_s *s;
+  struct fsts_tp_s *s=NULL;
   const char *err;
-  struct fsts_tp_ls *ls=&algo->lsf;
-  if(glob->state==FS_SEARCHING && !final){
-    ls=&algo->ls1;
-    if(glob->cfg.tp.jobs>1){
-      INT32 j;
-      for(j=0;j<glob->cfg.tp.jobs;j++) if(algo->jobs[j].ls1.qs){
-        if(algo->ls1.qe) algo->ls1.qe->nxt=algo->jobs[j].ls1.qs;
-        else algo->ls1.qs=algo->jobs[j].ls1.qs;
-        algo->ls1.qe=algo->jobs[j].ls1.qe;
-      }
-    }
-  }
+  INT32 j;
   if((err=fsts_btstart(&bti,glob,&algo->btm,itDst))) return err;
-  while((s=fsts_tp_lsbest(ls,glob->state!=FS_SEARCHING))){
-    fsts_btpath(&bti,s->wc,&s->bt);
-    if(glob->state==FS_SEARCHING) break;
-    fsts_tp_sfree(s,NULL,&algo->btm);
+  if(glob->state==FS_SEARCHING){
+    /* The job queues are not joined as they are used by the next frame */
+    if(final) s=fsts_tp_lsbest(&algo->lsf,0);
+    else if(glob->cfg.tp.jobs<=1) s=fsts_tp_lsbest(&algo->ls1,0);
+    else for(j=0;j<glob->cfg.tp.jobs;j++){
+      struct fsts_tp_s *sj=fsts_tp_lsbest(&algo->jobs[j].ls1,0);
+      if(sj && (!s || sj->wn<s->wn)) s=sj;
+    }
+    if(s && (err=fsts_btpath(&bti,s->wc,&s->bt))) return err;
+  }else while((s=fsts_tp_lsbest(&algo->lsf,1))){
+    if((err=fsts_btpath(&bti,s->wc,&s->bt))) return err;
+    if((err=fsts_tp_sfree(s,NULL,&algo->btm))) return err;
   }
   if(glob->debug>=1 && algo->btm.lat.head) printf("  lat %4iMB\n",FSTSMB(fsts_latsize(&algo->btm.lat)));
   glob->mem += fsts_btmmem2(&algo->btm);
   return NULL;
 }
 
+/* TP longest common prefix function
+ *
+ * This function updates the longest common prefix
+ * of the backtrack histories with one history.
+ *
+ * @param bt    The backtrack state node
+ * @param ti    Pointer to the common transition index node
+ * @param os    Pointer to the common output symbol node
+ * @param n     Pointer to the number of histories visited so far
+ */
+void fsts_tp_btlcp(struct fsts_bts *bt,struct fsts_bt **ti,struct fsts_bt **os,UINT32 *n){
+  if(!(*n)++){ *ti=bt->ti; *os=bt->os; return; }
+  if(*ti) *ti=fsts_btlcp(*ti,bt->ti);
+  if(*os) *os=fsts_btlcp(*os,bt->os);
+}
+
+/* TP queue longest common prefix function
+ *
+ * This function updates the longest common prefix of the
+ * backtrack histories with all active states of a queue.
+ * Pruned states are skipped as they will not be expanded.
+ *
+ * @param ls    The queue
+ * @param ti    Pointer to the common transition index node
+ * @param os    Pointer to the common output symbol node
+ * @param n     Pointer to the number of histories visited so far
+ */
+void fsts_tp_lslcp(struct fsts_tp_ls *ls,struct fsts_bt **ti,struct fsts_bt **os,UINT32 *n){
+  struct fsts_tp_s *s;
+  for(s=ls->qs;s;s=s->nxt) if(!s->prn && !s->btfree) fsts_tp_btlcp(&s->bt,ti,os,n);
+}
+
+/* TP decoder partial backtrack function
+ *
+ * This function performs incremental backtracking while
+ * iterative decoding. The longest common prefix of the
+ * histories of all active states is stable. Its new part
+ * is returned as one unit and the backtrack nodes are cut
+ * off (see fsts_btcut). Later calls to fsts_tp_backtrack
+ * prepend the stable prefix. From now on the anchor of new
+ * start states (/start) is the best final state of the
+ * previous frame which is part of the common prefix.
+ *
+ * @param glob  Pointer to the global memory structure
+ * @param itDst Destination transducer for the new stable prefix
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_tp_partial(struct fsts_glob *glob,CFst *itDst){
+  struct fsts_tp_algo *algo=(struct fsts_tp_algo *)glob->algo;
+  struct fsts_bt *ti=NULL,*os=NULL;
+  struct fsts_btinfo bti;
+  UINT32 n=0,p0=algo->btm.npre;
+  const char *err;
+  INT32 j;
+  if(glob->cfg.bt==BT_LAT) return FSTSERR("partial backtracking not possible with bt=\"lat\"");
+  fsts_tp_lslcp(&algo->ls1,&ti,&os,&n);
+  fsts_tp_lslcp(&algo->lsf,&ti,&os,&n);
+  if(glob->cfg.tp.jobs>1) for(j=0;j<glob->cfg.tp.jobs;j++) fsts_tp_lslcp(&algo->jobs[j].ls1,&ti,&os,&n);
+  if(algo->start) fsts_tp_btlcp(&algo->anchor,&ti,&os,&n);
+  algo->btlink=1;
+  if((err=fsts_btstart(&bti,glob,&algo->btm,itDst))) return err;
+  if(ti && (err=fsts_btcut(&algo->btm,ti,&algo->btm.ti,glob->cfg.bt==BT_T))) return err;
+  if(os && (err=fsts_btcut(&algo->btm,os,&algo->btm.os,glob->cfg.bt==BT_OS))) return err;
+  if(glob->debug>=1) printf("  stable %u (+%u)\n",algo->btm.npre,algo->btm.npre-p0);
+  return fsts_btpartial(&bti,p0);
+}
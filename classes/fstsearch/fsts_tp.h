@@ -31,6 +31,11 @@ struct fsts_tp_cfg {
   INT32   jobs;        /* Number of jobs                     */
   INT32   prnh;        /* Hypthesis number pruning threshold */
   FLOAT64 prnw;        /* Weight pruning threshold           */
+  FLOAT64 prnwe;       /* Word end weight pruning threshold  */
+  INT32   prnos;       /* Word end hyp. per output symbol    */
+  UINT8   la;          /* One frame look-ahead pruning       */
+  UINT8   lmla;        /* Language model look-ahead          */
+  INT32   partkeep;    /* Kept stable prefix elements        */
 };
 
 const char *fsts_tp_cfg(struct fsts_cfg *cfg,CFstsearch *_this);
@@ -38,5 +43,6 @@ const char *fsts_tp_init(struct fsts_glob *glob);
 void fsts_tp_free(struct fsts_glob *glob);
 const char *fsts_tp_isearch(struct fsts_glob *glob,struct fsts_w *w,UINT8 final,UINT8 start);
 const char *fsts_tp_backtrack(struct fsts_glob *glob,CFst *itDst,UINT8 final);
+const char *fsts_tp_partial(struct fsts_glob *glob,CFst *itDst);
 
 #endif
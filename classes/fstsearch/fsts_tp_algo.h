@@ -38,10 +38,15 @@ struct fsts_tp_algo {
   struct fsts_tp_ls ls1, ls2;    /* Active state queues        */
   struct fsts_tp_ls lsf;         /* Final state queue          */
   struct fsts_btm btm;           /* Backtrack memory           */
+  struct fsts_stkh stkh;         /* Pushdown stack memory      */
   INT64  nstates;                /* Number of expanded states  */
+  struct fsts_bts anchor;        /* History of start states    */
+  UINT8  btlink;                 /* Anchor at best final state */
+  UINT8  start;                  /* Start states in every frame*/
   struct fsts_tp_job *jobs;      /* Job specific memories      */
   MUTEXHANDLE mutex;             /* Mutex for job termination  */
   CONDHANDLE  cond;              /* Signal for job termination */
+  MUTEXHANDLE fmutex;            /* Mutex for final queue      */
   #ifdef _DEBUG
   UINT32 nlsmax;
   UINT32 hmax;
@@ -59,11 +64,13 @@ struct fsts_tp_job {
   UINT8             fin;      /* Job finished flag             */
   UINT8             run;      /* Job running flag              */
   struct fsts_mem   smem;     /* Active state memory           */
+  struct fsts_btm   btm;      /* Backtrack memory of the job   */
   MUTEXHANDLE       mutex;    /* Mutex for job running         */
   CONDHANDLE        cond;     /* Signal for job running        */
   struct fsts_tp_js *js;      /* List of pending active states */
   INT32             jshf;     /* State index offset            */
   FLOAT64           wprn;     /* Current pruning threshold     */
+  FLOAT64           wprnwe;   /* Current word end pruning thr. */
 };
 
 /* Pending active state */
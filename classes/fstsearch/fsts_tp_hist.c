@@ -45,6 +45,22 @@ void fsts_tp_histinit(struct fsts_tp_hist *hist,FLOAT64 wmin){
   }
 }
 
+/* TP histogram merge function
+ *
+ * This function adds the counters of a second histogram
+ * (e.g. from another decoding thread) to the first one.
+ * Both histograms must be initialized with the same minimal weight.
+ *
+ * @param hist  Histogram memory
+ * @param hadd  Histogram to add
+ */
+void fsts_tp_histadd(struct fsts_tp_hist *hist,struct fsts_tp_hist *hadd){
+  INT32 hi;
+  if(!hadd->on) return;
+  if(!hist->on){ *hist=*hadd; return; }
+  for(hi=0;hi<HISTSIZE;hi++) hist->h[hi]+=hadd->h[hi];
+}
+
 /* TP histogram finalization function
  *
  * This function finalizes the histogram used for hypothesis number pruning
@@ -45,6 +45,7 @@ struct fsts_tp_hist {
 }
 
 void fsts_tp_histinit(struct fsts_tp_hist *hist,FLOAT64 wmin);
+void fsts_tp_histadd(struct fsts_tp_hist *hist,struct fsts_tp_hist *hadd);
 double fsts_tp_histthr(struct fsts_tp_hist *hist,INT32 prnhyp);
 
 
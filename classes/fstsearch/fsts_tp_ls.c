@@ -27,6 +27,101 @@
 #include "fsts_glob.h"
 #include "fsts_tp_algo.h"
 
+/* Number of initial slots in the word end hypothesis table */
+#define OSRINIT 256
+
+/* TP word end hypothesis table initialization function
+ *
+ * This function allocates the slots of the word end hypothesis table.
+ *
+ * @param osr   The table
+ * @param mask  Number of slots - 1 (power of two - 1)
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_tp_osrinit(struct fsts_tp_osr *osr,UINT32 mask){
+  osr->mask=mask;
+  osr->used=0;
+  osr->os=NULL;
+  osr->n=NULL;
+  osr->s=NULL;
+  if(!osr->prnos) return NULL;
+  if(!(osr->os=(INT32*)malloc((mask+1)*sizeof(INT32)))) return FSTSERR("out of memory");
+  if(!(osr->n=(INT32*)calloc(mask+1,sizeof(INT32)))) return FSTSERR("out of memory");
+  if(!(osr->s=(struct fsts_tp_s**)calloc((size_t)(mask+1)*osr->prnos,sizeof(struct fsts_tp_s*)))) return FSTSERR("out of memory");
+  memset(osr->os,-1,(mask+1)*sizeof(INT32));
+  return NULL;
+}
+
+/* TP word end hypothesis table free function
+ *
+ * @param osr   The table
+ */
+void fsts_tp_osrfree(struct fsts_tp_osr *osr){
+  if(osr->os) free(osr->os);
+  if(osr->n)  free(osr->n);
+  if(osr->s)  free(osr->s);
+  osr->os=osr->n=NULL;
+  osr->s=NULL;
+}
+
+/* TP word end hypothesis table slot function
+ *
+ * This function returns the slot of an output symbol.
+ * A new slot is created if the symbol is not in the table.
+ * The table is expanded if more than half of the slots are used.
+ *
+ * @param osr   The table
+ * @param os    The output symbol
+ * @return      The slot index or -1 on failure
+ */
+INT32 fsts_tp_osrslot(struct fsts_tp_osr *osr,INT32 os){
+  UINT32 i=((UINT32)os*2654435761U)&osr->mask;
+  while(osr->os[i]!=os && osr->os[i]>=0) i=(i+1)&osr->mask;
+  if(osr->os[i]==os) return (INT32)i;
+  if((osr->used+1)*2>osr->mask+1){
+    struct fsts_tp_osr osrn=*osr;
+    UINT32 j;
+    if(fsts_tp_osrinit(&osrn,osr->mask*2+1)){ fsts_tp_osrfree(&osrn); return -1; }
+    for(j=0;j<=osr->mask;j++) if(osr->os[j]>=0){
+      INT32 k=fsts_tp_osrslot(&osrn,osr->os[j]);
+      osrn.n[k]=osr->n[j];
+      memcpy(osrn.s+(size_t)k*osr->prnos,osr->s+(size_t)j*osr->prnos,osr->n[j]*sizeof(struct fsts_tp_s*));
+    }
+    fsts_tp_osrfree(osr);
+    *osr=osrn;
+    return fsts_tp_osrslot(osr,os);
+  }
+  osr->os[i]=os;
+  osr->n[i]=0;
+  osr->used++;
+  return (INT32)i;
+}
+
+/* TP word end hypothesis add function
+ *
+ * This function registers a word end hypothesis in the table.
+ * If there are more than osr->prnos hypothesis with the same
+ * output symbol the worst one is marked as pruned.
+ * States in the table may have been replaced by recombination
+ * in the meantime. Such entries are removed before.
+ *
+ * @param osr   The table
+ * @param s     The word end hypothesis (stored in the hash)
+ */
+void fsts_tp_osradd(struct fsts_tp_osr *osr,struct fsts_tp_s *s){
+  INT32 k,i,imax;
+  struct fsts_tp_s **sk;
+  if((k=fsts_tp_osrslot(osr,s->os))<0) return;
+  sk=osr->s+(size_t)k*osr->prnos;
+  for(i=0;i<osr->n[k];i++)
+    if(sk[i]==s || sk[i]->os!=s->os || sk[i]->prn) sk[i--]=sk[--osr->n[k]];
+  if(osr->n[k]<osr->prnos){ sk[osr->n[k]++]=s; return; }
+  for(i=1,imax=0;i<osr->n[k];i++) if(sk[i]->wp>sk[imax]->wp) imax=i;
+  if(sk[imax]->wp<=s->wp){ s->prn=1; return; }
+  sk[imax]->prn=1;
+  sk[imax]=s;
+}
+
 /* TP active state queue initialization function
  *
  * This function initializes an active state queue.
@@ -38,12 +133,15 @@
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
 const char *fsts_tp_lsinit(struct fsts_tp_ls *ls,struct fsts_btm *btm,struct fsts_cfg *cfg,FLOAT64 wmin){
+  const char *err;
   if(btm) ls->btm=btm;
   if(cfg) ls->numpaths=cfg->numpaths;
+  if(cfg) ls->osr.prnos=cfg->tp.prnos;
   ls->qs=ls->qe=NULL;
   fsts_tp_histinit(&ls->hist,wmin);
   ls->wmax=0.;
   ls->wmin=T_DOUBLE_MAX;
+  if((err=fsts_tp_osrinit(&ls->osr,OSRINIT-1))) return err;
   return fsts_hinit(&ls->h,sizeof(struct fsts_tp_s),cfg?cfg->numpaths:0,cfg && !cfg->stkprn?fsts_tp_scmpstk:NULL);
 }
 
@@ -52,11 +150,15 @@ const char *fsts_tp_lsinit(struct fsts_tp_ls *ls,struct fsts_btm *btm,struct fst
  * This function free's the active state queue and all it's subordinated memories.
  *
  * @param ls  The queue
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */
-void fsts_tp_lsfree(struct fsts_tp_ls *ls){
+const char *fsts_tp_lsfree(struct fsts_tp_ls *ls){
   struct fsts_tp_s *s;
-  if(ls->qs) while((s=fsts_tp_lsdel(ls))) fsts_tp_sfree(s,NULL,ls->btm);
+  const char *err=NULL, *errs;
+  if(ls->qs) while((s=fsts_tp_lsdel(ls))) if((errs=fsts_tp_sfree(s,NULL,ls->btm)) && !err) err=errs;
   fsts_hfree(&ls->h);
+  fsts_tp_osrfree(&ls->osr);
+  return err;
 }
 
 /* TP active state queue reset function
@@ -67,7 +169,8 @@ void fsts_tp_lsfree(struct fsts_tp_ls *ls){
  * @param ls  The queue
  */
 const char *fsts_tp_lsreset(struct fsts_tp_ls *ls){
-  fsts_tp_lsfree(ls);
+  const char *err;
+  if((err=fsts_tp_lsfree(ls))) return err;
   return fsts_tp_lsinit(ls,NULL,NULL,T_DOUBLE_MIN);
 }
 
@@ -92,9 +195,11 @@ const char *fsts_tp_lsreset(struct fsts_tp_ls *ls){
  */
 const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
   struct fsts_hs *hs;
-  if(s->wn>ls->wmax) ls->wmax=s->wn;
-  if(s->wn<ls->wmin) ls->wmin=s->wn;
-  fsts_tp_histins(&ls->hist,s->wn);
+  struct fsts_tp_s *ins=NULL;
+  const char *err;
+  if(s->wp>ls->wmax) ls->wmax=s->wp;
+  if(s->wp<ls->wmin) ls->wmin=s->wp;
+  fsts_tp_histins(&ls->hist,s->wp);
   /* state visitied before ? */
   if((hs=fsts_hfind(&ls->h,s))) if(ls->numpaths==1){
     /* state visited before + only one path => replace state if weight improved */
@@ -102,11 +207,12 @@ const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
     #ifdef _DEBUG
     if(dbg>=4) printf(" => %s0 (wn: %6.3f os: 0x%08x)",sh->wn<=s->wn?"del":"rpl",sh->wn,sh->bt.os?BTHASH(sh->bt.os):0);
     #endif
-    if(sh->wn<=s->wn) fsts_tp_sfree(s,sh,ls->btm); else{
+    if(sh->wn<=s->wn){ if((err=fsts_tp_sfree(s,sh,ls->btm))) return err; }else{
       s->nxt=sh->nxt;
-      fsts_tp_sfree(sh,s,ls->btm);
+      if((err=fsts_tp_sfree(sh,s,ls->btm))) return err;
       *sh=*s;
       if(sh->nxt==SNXT_NONE) fsts_tp_lsins(ls,sh); /* insert in queue if not done */
+      ins=sh;
     }
   }else{
     /* state visited before + multiple paths */
@@ -118,11 +224,12 @@ const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
       #ifdef _DEBUG
       if(dbg>=4) printf(" => %s%i (wn: %6.3f os: 0x%08x)",sh->wn<=s->wn?"del":"rpl",i,sh->wn,BTHASH(sh->bt.os));
       #endif
-      if(sh->wn<=s->wn) fsts_tp_sfree(s,sh,ls->btm); else{
+      if(sh->wn<=s->wn){ if((err=fsts_tp_sfree(s,sh,ls->btm))) return err; }else{
         s->nxt=sh->nxt;
-        fsts_tp_sfree(sh,s,ls->btm);
+        if((err=fsts_tp_sfree(sh,s,ls->btm))) return err;
         *sh=*s;                                         /* insert the state */
         if(sh->nxt==SNXT_NONE) fsts_tp_lsins(ls,sh);    /* insert in queue if not done */
+        ins=sh;
       }
       break;
     }
@@ -136,6 +243,7 @@ const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
         *sh=*s;
         fsts_tp_lsins(ls,sh);
         hs->use++;
+        ins=sh;
       }else{
         /* full => replace maximal weight if possible */
         struct fsts_tp_s *sh=(struct fsts_tp_s*)fsts_hs2s(hs);
@@ -144,11 +252,12 @@ const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
         #ifdef _DEBUG
         if(dbg>=4) printf(" => %sX (wn: %6.3f os: 0x%08x)",shmax->wn<=s->wn?"del":"rpl",shmax->wn,BTHASH(shmax->bt.os));
         #endif
-        if(shmax->wn<=s->wn) fsts_tp_sfree(s,shmax,ls->btm); else {
+        if(shmax->wn<=s->wn){ if((err=fsts_tp_sfree(s,shmax,ls->btm))) return err; }else {
           s->nxt=shmax->nxt;
-          fsts_tp_sfree(shmax,s,ls->btm);
+          if((err=fsts_tp_sfree(shmax,s,ls->btm))) return err;
           *shmax=*s;                                         /* insert the state */
           if(shmax->nxt==SNXT_NONE) fsts_tp_lsins(ls,shmax);    /* insert in queue if not done */
+          ins=shmax;
         }
       }
     }
@@ -159,7 +268,10 @@ const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg){
     #endif
     if(!(s=(struct fsts_tp_s*)fsts_hins(&ls->h,s))) return FSTSERR("hmem: out of memory");
     fsts_tp_lsins(ls,s);
+    ins=s;
   }
+  /* word end => limit number of hypothesis per output symbol */
+  if(ins && ins->os>=0 && ls->osr.prnos) fsts_tp_osradd(&ls->osr,ins);
   return NULL;
 }
 
@@ -212,3 +324,50 @@ void fsts_tp_lswnorm(struct fsts_tp_ls *ls,struct fsts_cfg *cfg){
   for(s=ls->qs;s;s=s->nxt) fsts_tp_swnorm(s,cfg);
 }
 
+/* TP look-ahead weight calculation function
+ *
+ * This function calculates the look-ahead weight of all states in the queue.
+ * It is the best weight reachable by one transition including the
+ * timevariant weight of the current frame. States which may leave their
+ * unit, which are final or which have epsilon transitions get their
+ * current weight as look-ahead weight. States without any usable
+ * transition get T_DOUBLE_MAX.
+ *
+ * @param ls     Queue
+ * @param src    Source transducer
+ * @param w      Timevariant weight array of the current frame
+ * @param wlamin Pointer to the minimal look-ahead weight (will be updated)
+ */
+void fsts_tp_lslacalc(struct fsts_tp_ls *ls,struct fsts_fst *src,struct fsts_w *w,FLOAT64 *wlamin){
+  struct fsts_tp_s *s;
+  for(s=ls->qs;s;s=s->nxt){
+    INT32 si=s->s[s->ds];
+    struct fsts_unit *u=src->units+(s->ds?s->u[s->ds-1]:0);
+    struct fsts_t *t;
+    s->wla=s->wp;
+    if(!u->sub && !u->sfin[si]){
+      FLOAT64 wla=T_DOUBLE_MAX,wt;
+      for(t=u->tfroms[si];t;t=t->nxt){
+        if(t->stk<0 && fsts_stktop(s->stk)!=-t->stk) continue;
+        if(t->is<0){ wla=s->wp; break; }
+        if((wt=s->wp+t->w+fsts_wget(w,t->is))<wla) wla=wt;
+      }
+      s->wla=wla;
+    }
+    if(s->wla<*wlamin) *wlamin=s->wla;
+  }
+}
+
+/* TP look-ahead pruning function
+ *
+ * This function marks all states in the queue as pruned
+ * whose look-ahead weight is greater than the threshold.
+ *
+ * @param ls   Queue
+ * @param wprn Look-ahead pruning threshold
+ */
+void fsts_tp_lslaprn(struct fsts_tp_ls *ls,FLOAT64 wprn){
+  struct fsts_tp_s *s;
+  for(s=ls->qs;s;s=s->nxt) if(s->wla>wprn) s->prn=1;
+}
+
@@ -26,6 +26,16 @@
 #ifndef _FSTS_TP_LS_H
 #define _FSTS_TP_LS_H
 
+/* Word end hypothesis table (per output symbol) */
+struct fsts_tp_osr {
+  INT32  prnos;              /* Max. number of hypothesis per output symbol */
+  UINT32 mask;               /* Number of slots - 1                         */
+  UINT32 used;               /* Number of used slots                        */
+  INT32 *os;                 /* Output symbol of slot (-1: free)            */
+  INT32 *n;                  /* Number of hypothesis in slot                */
+  struct fsts_tp_s **s;      /* Hypothesis (prnos per slot)                 */
+};
+
 /* Internal active state queue */
 struct fsts_tp_ls {
   UINT32 numpaths;           /* Number of paths to decode                 */
@@ -34,14 +44,17 @@ struct fsts_tp_ls {
   struct fsts_tp_s *qs, *qe; /* Begin and End of the connected state list */
   struct fsts_h h;           /* Active state hash memory                  */
   struct fsts_tp_hist hist;  /* Histogram for hypothesis pruning          */
+  struct fsts_tp_osr osr;    /* Word end hypothesis table                 */
 };
 
 const char *fsts_tp_lsinit(struct fsts_tp_ls *ls,struct fsts_btm *btm,struct fsts_cfg *cfg,FLOAT64 wmin);
-void fsts_tp_lsfree(struct fsts_tp_ls *ls);
+const char *fsts_tp_lsfree(struct fsts_tp_ls *ls);
 const char *fsts_tp_lsreset(struct fsts_tp_ls *ls);
 const char *fsts_tp_lsadd(struct fsts_tp_ls *ls,struct fsts_tp_s *s,UINT8 dbg);
 struct fsts_tp_s *fsts_tp_lsdel(struct fsts_tp_ls *ls);
 struct fsts_tp_s *fsts_tp_lsbest(struct fsts_tp_ls *ls,UINT8 del);
 void fsts_tp_lswnorm(struct fsts_tp_ls *ls,struct fsts_cfg *cfg);
+void fsts_tp_lslacalc(struct fsts_tp_ls *ls,struct fsts_fst *src,struct fsts_w *w,FLOAT64 *wlamin);
+void fsts_tp_lslaprn(struct fsts_tp_ls *ls,FLOAT64 wprn);
 
 #endif
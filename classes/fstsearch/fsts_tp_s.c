@@ -34,11 +34,12 @@
  * @param s     Active state which will be free'd
  * @param sref  State with which s was recombinded (for lattice generation)
  * @param btm   Bactrack memory
+ * @return <code>NULL</code> if successfull, the error string otherwise
  */
-void fsts_tp_sfree(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_btm *btm){
-  if(s->btfree) return;
+const char *fsts_tp_sfree(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_btm *btm){
+  if(s->btfree) return NULL;
   s->btfree=1;
-  fsts_btsfree(&s->bt,sref?&sref->bt:NULL,sref?s->wc-sref->wc:0.,btm);
+  return fsts_btsfree(&s->bt,sref?&sref->bt:NULL,sref?s->wc-sref->wc:0.,sref && sref->btfree,btm);
 }
 
 /* TP active state generation function
@@ -51,22 +52,26 @@ void fsts_tp_sfree(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_btm *b
  * @param src   The source transducer
  * @param w     The timevariant weight array
  * @param btm   Bactrack memory
+ * @param stkh  Pushdown stack memory
  * @param sub   Switch indicating lowest level for on-the-fly composition
  * @param ui0   Switch indicating the highest level
  * @param cfg   Configuration
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_t *t,struct fsts_fst *src,struct fsts_w *w,struct fsts_btm *btm,UINT8 sub,UINT8 ui0,struct fsts_cfg *cfg){
+const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_t *t,struct fsts_fst *src,struct fsts_w *w,struct fsts_btm *btm,struct fsts_stkh *stkh,UINT8 sub,UINT8 ui0,struct fsts_cfg *cfg){
   INT32 d;
-  uint64_t mid;
+  uint64_t mid,id;
   const char *err;
   if(!sref){
     s->ds=s->s[0]=0;
-    s->nstk=0;
+    s->stk=NULL;
     s->wc=0.;
     s->l=0;
     s->id=0;
     s->btfree=0;
+    s->prn=0;
+    s->os=-1;
+    s->lmla=cfg->tp.lmla ? fsts_tp_slmla(s,src) : 0.;
     fsts_tp_swnorm(s,cfg);
 /*    s->mid=1;*/
     return fsts_btsgen(&s->bt,NULL,NULL,0,0.,btm);
@@ -78,8 +83,11 @@ const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_
   s->l=sref->l;
 /*  s->mid=sref->mid;*/
   s->btfree=0;
-  if((err=fsts_btsgen(&s->bt,&sref->bt,t,ui0,s->wc,btm))) return err;
-  s->nstk=sref->nstk;
+  s->prn=0;
+  s->os=t && ui0 && t->os>=0 ? t->os : -1;
+  s->stk=sref->stk;
+  /* The state id of a state with stack contains the stack key (see fsts_stkkey) */
+  id=cfg->stkprn ? sref->id : sref->id^fsts_stkkey(sref->stk);
   if(!t){
     if(--s->ds<0){
       s->id=0;
@@ -87,25 +95,25 @@ const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_
       mid=src->units[0].ns;
       for(d=0;d<s->ds;d++) mid*=src->nunits*src->units[s->u[d]].ns;
 /*      s->mid/=src->nunits;*/
-      s->id = sref->id%mid;
+      s->id = id%mid;
 /*      s->mid/=src->units[s->ds?s->u[s->ds-1]:0].ns;*/
     }
+    if(!cfg->stkprn) s->id^=fsts_stkkey(s->stk);
+    s->lmla=cfg->tp.lmla ? fsts_tp_slmla(s,src) : 0.;
     fsts_tp_swnorm(s,cfg);
-    return NULL;
+    return fsts_btsgen(&s->bt,&sref->bt,t,ui0,s->wc,btm);
   }
-  for(d=0;d<s->nstk;d++) s->stk[d]=sref->stk[d];
   if(t->stk>0){
-    if(s->nstk+1==MAXSTK) return FSTSERR("stk: out of memory");
-    s->stk[s->nstk++]=t->stk;
-  }else if(t->stk<0) s->nstk--;
+    if((err=fsts_stkpush(stkh,&s->stk,t->stk))) return err;
+  }else if(t->stk<0) s->stk=fsts_stkpop(s->stk);
   s->wc+=t->w;
   s->s[s->ds]=t->ter;
   mid=1;
   for(d=-1;d<s->ds-1;d++) mid*=src->nunits*src->units[d>=0?s->u[d]:0].ns;
-  s->id = sref->id%mid + s->s[s->ds]*mid;
+  s->id = id%mid + s->s[s->ds]*mid;
   if(t->is>=0){
     if(!sub){
-      if(w){ s->wc+=w->w[t->is]; s->l++; }
+      if(w){ s->wc+=fsts_wget(w,t->is); s->l++; }
     }else{
       if(++s->ds==MAXLAYER) return FSTSERR("out of layers");
       s->u[s->ds-1]=t->is;
@@ -116,26 +124,41 @@ const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_
 /*      s->mid*=src->nunits;*/
     }
   }
+  if(!cfg->stkprn) s->id^=fsts_stkkey(s->stk);
+  s->lmla=cfg->tp.lmla ? fsts_tp_slmla(s,src) : 0.;
   fsts_tp_swnorm(s,cfg);
-  return NULL;
+  /* The backtrack node stores the path weight after the transition */
+  return fsts_btsgen(&s->bt,&sref->bt,t,ui0,s->wc,btm);
+}
+
+/* TP active state language model look-ahead
+ *
+ * This function sums up the look-ahead potentials (see fsts_fstla)
+ * of the states on all layers of an active state.
+ *
+ * @param s    Active state
+ * @param src  The source transducer
+ * @return     The look-ahead weight
+ */
+FLOAT64 fsts_tp_slmla(struct fsts_tp_s *s,struct fsts_fst *src){
+  FLOAT64 lmla=0.;
+  INT32 d;
+  for(d=0;d<=s->ds;d++) lmla+=src->units[d?s->u[d-1]:0].pot[s->s[d]];
+  return lmla;
 }
 
 /* TP state stack compare function
  *
- * This function compares the pushdown memory
- * of two states.
+ * This function compares the pushdown stacks
+ * of two states. Stack nodes are shared, so
+ * equal stacks have equal node pointers.
  *
  * @param a  The first state
- * @param a  The second state
+ * @param b  The second state
  * @return   0: not equal, 1: equal
  */
 UINT8 fsts_tp_scmpstk(void *a,void *b){
-  struct fsts_tp_s *as=(struct fsts_tp_s *)a;
-  struct fsts_tp_s *bs=(struct fsts_tp_s *)b;
-  INT32 i;
-  if(bs->nstk!=as->nstk) return 0;
-  for(i=0;i<as->nstk;i++) if(as->stk[i]!=bs->stk[i]) return 0;
-  return 1;
+  return ((struct fsts_tp_s *)a)->stk==((struct fsts_tp_s *)b)->stk;
 }
 
 /* TP active state weight normalization
@@ -150,5 +173,6 @@ void fsts_tp_swnorm(struct fsts_tp_s *s,struct fsts_cfg *cfg){
   else
     if(!s->l) s->wn=s->wc+cfg->wnoff;
     else s->wn=s->wc/(FLOAT64)s->l+cfg->wnoff*exp((FLOAT64)s->l*cfg->wnexp);
+  s->wp=s->wn+s->lmla;
 }
 
@@ -33,17 +33,22 @@ struct fsts_tp_s {
   struct fsts_bts bt;      /* State backtrack node                   */
   FLOAT64 wc;              /* Current path weight                    */
   FLOAT64 wn;              /* Normalized current path weight         */
+  FLOAT64 lmla;            /* Language model look-ahead weight       */
+  FLOAT64 wp;              /* Pruning weight (wn+lmla)               */
   INT32   l;               /* Path length                            */
   INT8    ds;              /* Depth level for on-the-fly composition */
-  INT8    nstk;            /* Usage of pushdown stack memory         */
   INT8    btfree;
+  UINT8   prn;             /* Pruned before expansion                */
+  INT32   os;              /* Output symbol of last transition or -1 */
+  FLOAT64 wla;             /* Look-ahead weight (fsts_tp_lslacalc)   */
   INT32   s[MAXLAYER];     /* Transducer state index                 */
   INT32   u[MAXLAYER-1];   /* Transducer unit index                  */
-  UINT16  stk[MAXSTK];     /* Pushdown stack memory                  */
+  struct fsts_stk *stk;    /* Pushdown stack (shared, see fsts_stk)  */
 };
 
-void fsts_tp_sfree(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_btm *btm);
-const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_t *t,struct fsts_fst *src,struct fsts_w *w,struct fsts_btm *btm,UINT8 sub,UINT8 ui0,struct fsts_cfg *cfg);
+const char *fsts_tp_sfree(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_btm *btm);
+const char *fsts_tp_sgen(struct fsts_tp_s *s,struct fsts_tp_s *sref,struct fsts_t *t,struct fsts_fst *src,struct fsts_w *w,struct fsts_btm *btm,struct fsts_stkh *stkh,UINT8 sub,UINT8 ui0,struct fsts_cfg *cfg);
+FLOAT64 fsts_tp_slmla(struct fsts_tp_s *s,struct fsts_fst *src);
 UINT8 fsts_tp_scmpstk(void *a,void *b);
 void fsts_tp_swnorm(struct fsts_tp_s *s,struct fsts_cfg *cfg);
 
@@ -26,31 +26,100 @@
 
 #include "fsts_glob.h"
 
-/* Weight convert function
+/* Weight quantization function
  *
- * This function converts the timevariant weight array form
- * data instance to the internal structure.
+ * This function quantizes the timevariant weights from the
+ * data instance to 16-Bit. The range between the minimal and
+ * the maximal finite weight is mapped linearly to
+ * 0..T_USHORT_MAX-1. Infinite weights (T_DOUBLE_MAX and above)
+ * get the code FSTS_WQINF and are restored exactly by fsts_wget.
+ * Weights of -T_DOUBLE_MAX and below are mapped to the minimum.
  *
  * @param w          Destination weight array structure
  * @param idWeights  Source data instance
  * @return <code>NULL</code> if successfull, the error string otherwise
  */
-const char *fsts_wgen(struct fsts_w *w,CData *idWeights){
+const char *fsts_wquant(struct fsts_w *w,CData *idWeights){
   INT32 f,s;
+  FLOAT64 wmin=0.,wmax=0.,v;
+  UINT8 fin=0;
+  UINT16 *wq;
+  w->wi=T_DOUBLE_MAX;
+  for(f=0;f<w->nf;f++) for(s=0;s<w->ns;s++){
+    v=CData_Dfetch(idWeights,f,s);
+    if(v>-T_DOUBLE_MAX && v<T_DOUBLE_MAX){
+      if(!fin || v<wmin) wmin=v;
+      if(!fin || v>wmax) wmax=v;
+      fin=1;
+    }else if(v>w->wi) w->wi=v;
+  }
+  w->t=T_USHORT;
+  w->wo=wmin;
+  w->wq=(wmax-wmin)/(T_USHORT_MAX-1);
+  if(!(w->w=wq=(UINT16*)malloc(w->ns*w->nf*sizeof(UINT16)))) return FSTSERR("out of memory");
+  for(f=0;f<w->nf;f++) for(s=0;s<w->ns;s++){
+    v=CData_Dfetch(idWeights,f,s);
+    if(v>=T_DOUBLE_MAX || v!=v) wq[f*w->ns+s]=FSTS_WQINF;
+    else if(v<=-T_DOUBLE_MAX || w->wq<=0.) wq[f*w->ns+s]=0;
+    else wq[f*w->ns+s]=(UINT16)((v-wmin)/w->wq+0.5);
+  }
+  return NULL;
+}
+
+/* Weight reference function
+ *
+ * This function initializes the weight array structure with
+ * the dimensions of the data instance without converting the
+ * weights (w->w stays NULL). Decoders reading the weights
+ * directly from w->idW use this instead of fsts_wgen.
+ *
+ * @param w          Destination weight array structure
+ * @param idWeights  Source data instance (may be <code>NULL</code>)
+ */
+void fsts_winit(struct fsts_w *w,CData *idWeights){
   w->ns=w->nf=0; w->w=NULL;
+  w->t=T_DOUBLE;
+  w->wo=0.; w->wq=1.; w->wi=T_DOUBLE_MAX;
   w->w0=0.;
   w->idW=idWeights;
-  if(!idWeights) return NULL;
+  if(!idWeights) return;
   w->ns=CData_GetNComps(idWeights);
   w->nf=CData_GetNRecs(idWeights);
+}
+
+/* Weight convert function
+ *
+ * This function converts the timevariant weight array form
+ * data instance to the internal structure.
+ * Homogeneous row-major T_DOUBLE or T_FLOAT data is used without copying.
+ * Other data is converted to T_DOUBLE, or to T_FLOAT resp. 16-Bit
+ * quantized weights if selected by the configuration (see wtype).
+ *
+ * @param w          Destination weight array structure
+ * @param idWeights  Source data instance
+ * @param cfg        Configuration
+ * @return <code>NULL</code> if successfull, the error string otherwise
+ */
+const char *fsts_wgen(struct fsts_w *w,CData *idWeights,struct fsts_cfg *cfg){
+  INT32 f,s;
+  INT16 th;
+  fsts_winit(w,idWeights);
   if(!w->nf) return NULL;
-  if(CData_IsHomogen(idWeights)==T_DOUBLE){
-    w->w=(FLOAT64*)CData_XAddr(idWeights,0,0);
+  if(cfg->wt==WT_SHORT) return fsts_wquant(w,idWeights);
+  th=CData_IsHomogen(idWeights);
+  if(cfg->wt==WT_FLOAT || th==T_FLOAT) w->t=T_FLOAT;
+  if(th==w->t && !CData_IsColmajor(idWeights)){
+    w->w=CData_XAddr(idWeights,0,0);
     return NULL;
   }
-  if(!(w->w=(FLOAT64*)malloc(w->ns*w->nf*sizeof(FLOAT64)))) return FSTSERR("out of memory");
-  for(f=0;f<w->nf;f++) for(s=0;s<w->ns;s++)
-    w->w[f*w->ns+s]=CData_Dfetch(idWeights,f,s);
+  if(!(w->w=malloc(w->ns*w->nf*fsts_wsize(w)))) return FSTSERR("out of memory");
+  if(w->t==T_FLOAT){
+    for(f=0;f<w->nf;f++) for(s=0;s<w->ns;s++)
+      ((FLOAT32*)w->w)[f*w->ns+s]=(FLOAT32)CData_Dfetch(idWeights,f,s);
+  }else{
+    for(f=0;f<w->nf;f++) for(s=0;s<w->ns;s++)
+      ((FLOAT64*)w->w)[f*w->ns+s]=CData_Dfetch(idWeights,f,s);
+  }
   return NULL;
 }
 
@@ -68,7 +137,11 @@ void fsts_wf(struct fsts_w *w,INT32 f,struct fsts_w *wf){
   if(!w || !w->w || f>=w->nf) wf->w=NULL; else {
     wf->nf=1;
     wf->ns=w->ns;
-    wf->w=w->w+w->ns*f;
+    wf->t=w->t;
+    wf->wo=w->wo;
+    wf->wq=w->wq;
+    wf->wi=w->wi;
+    wf->w=(BYTE*)w->w+w->ns*f*fsts_wsize(w);
   }
 }
 
@@ -79,5 +152,5 @@ void fsts_wf(struct fsts_w *w,INT32 f,struct fsts_w *wf){
  * @param w   Weight array
  */
 void fsts_wfree(struct fsts_w *w){
-  if(w->w && w->w!=(FLOAT64*)CData_XAddr(w->idW,0,0)) free(w->w);
+  if(w->w && !fsts_wref(w)) free(w->w);
 }
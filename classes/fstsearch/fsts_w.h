@@ -28,13 +28,34 @@
 
 /* Internal weight array structure */
 struct fsts_w {
-  INT32 ns,nf; /* Number of states and frames  */
-  FLOAT64 *w;  /* Pointer to the weights       */
+  INT32 ns,nf; /* Number of states and frames               */
+  INT16 t;     /* Weight type (T_DOUBLE, T_FLOAT or T_USHORT) */
+  void *w;     /* Pointer to the weights (of type t)         */
+  FLOAT64 wo;  /* Quantization offset (T_USHORT only)        */
+  FLOAT64 wq;  /* Quantization step (T_USHORT only)          */
+  FLOAT64 wi;  /* Weight of code FSTS_WQINF (T_USHORT only)   */
   FLOAT64 w0;
   CData *idW;  /* Original source weight array */
 };
 
-const char *fsts_wgen(struct fsts_w *w,CData *idWeights);
+/* Quantization code reserved for infinite weights (T_USHORT only) */
+#define FSTS_WQINF T_USHORT_MAX
+
+/* This macro gets the size of one weight in a weight array */
+#define fsts_wsize(w)  ((w)->t==T_DOUBLE ? sizeof(FLOAT64) : (w)->t==T_FLOAT ? sizeof(FLOAT32) : sizeof(UINT16))
+
+/* This macro checks if a weight array uses the (row-major) source data without copying */
+#define fsts_wref(w)   (!CData_IsColmajor((w)->idW) && (w)->w==CData_XAddr((w)->idW,0,0))
+
+/* This macro gets the i'th weight from a weight array */
+#define fsts_wget(w,i) ( \
+  (w)->t==T_FLOAT  ? (FLOAT64)((FLOAT32*)(w)->w)[i] : \
+  (w)->t==T_DOUBLE ? ((FLOAT64*)(w)->w)[i] : \
+  ((UINT16*)(w)->w)[i]==FSTS_WQINF ? (w)->wi : \
+  (w)->wo+((UINT16*)(w)->w)[i]*(w)->wq )
+
+void fsts_winit(struct fsts_w *w,CData *idWeights);
+const char *fsts_wgen(struct fsts_w *w,CData *idWeights,struct fsts_cfg *cfg);
 void fsts_wf(struct fsts_w *w,INT32 f,struct fsts_w *wf);
 void fsts_wfree(struct fsts_w *w);
 
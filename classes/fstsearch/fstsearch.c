@@ -115,6 +115,7 @@ INT16 CFstsearch_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_METHOD("-backtrack","",LPMF(CFstsearch,OnBacktrack),"Backtrack from the current decoding state",0,"<fst itDst> <fstsearch this>","")
 	REGISTER_METHOD("-isearch","",LPMF(CFstsearch,OnIsearch),"Iterative search: decode frames in idWeights",0,"<data idWeights> <fstsearch this>","")
 	REGISTER_METHOD("-load","",LPMF(CFstsearch,OnLoad),"Load the source automaton",0,"<fst itSrc> <long nUnit> <fstsearch this>","")
+	REGISTER_METHOD("-partial","",LPMF(CFstsearch,OnPartial),"Incremental backtracking of the stable path prefix",0,"<fst itDst> <fstsearch this>","")
 	REGISTER_METHOD("-restart","",LPMF(CFstsearch,OnRestart),"Reset iterative search",0,"<fstsearch this>","")
 	REGISTER_METHOD("-search","",LPMF(CFstsearch,OnSearch),"All steps in one method",0,"<fst itSrc> <long nUnit> <data idWeights> <fst itDst> <fstsearch this>","")
 	REGISTER_METHOD("-status","",LPMF(CFstsearch,OnStatus),"Prints status information of the search processor.",0,"<fstsearch this>","")
@@ -140,13 +141,20 @@ INT16 CFstsearch_AutoRegisterWords(CDlpObject* __this)
 	REGISTER_FIELD("sdp_epsremove","",LPMV(m_bSdpEpsremove),LPMF(CFstsearch,OnSdpEpsremoveChanged),"Removes epsilon transitions",0,1000,1,"bool",(BOOL)FALSE)
 	REGISTER_FIELD("sdp_fwd","",LPMV(m_bSdpFwd),LPMF(CFstsearch,OnSdpFwdChanged),"Do forward algorithm instead of sdp",0,1000,1,"bool",(BOOL)FALSE)
 	REGISTER_FIELD("sdp_prn","",LPMV(m_nSdpPrn),LPMF(CFstsearch,OnSdpPrnChanged),"Pruning constant",0,3008,1,"double",(FLOAT64)0)
+	REGISTER_FIELD("sdp_prnh","",LPMV(m_nSdpPrnh),LPMF(CFstsearch,OnSdpPrnhChanged),"Active state number pruning threshold",0,2008,1,"long",(INT64)0)
 	REGISTER_FIELD("stkprn","",LPMV(m_bStkprn),LPMF(CFstsearch,OnStkprnChanged),"Prune hypothesis with different pushdown memory",0,1000,1,"bool",(BOOL)FALSE)
 	REGISTER_FIELD("time","",LPMV(m_nTime),NULL,"Time used for last decoding including backtracking in milliseconds (only Linux!)",FF_NOSET,3008,1,"double",(FLOAT64)0)
+	REGISTER_FIELD("tp_la","",LPMV(m_bTpLa),LPMF(CFstsearch,OnTpLaChanged),"One frame look-ahead pruning",0,1000,1,"bool",(BOOL)FALSE)
+	REGISTER_FIELD("tp_lmla","",LPMV(m_bTpLmla),LPMF(CFstsearch,OnTpLmlaChanged),"Language model look-ahead for on-the-fly composition",0,1000,1,"bool",(BOOL)FALSE)
+	REGISTER_FIELD("tp_partkeep","",LPMV(m_nTpPartkeep),LPMF(CFstsearch,OnTpPartkeepChanged),"Number of stable prefix elements kept after partial backtracking",0,2008,1,"long",(INT64)0)
 	REGISTER_FIELD("tp_prnh","",LPMV(m_nTpPrnh),LPMF(CFstsearch,OnTpPrnhChanged),"Hypothesis number pruning threshold",0,2008,1,"long",(INT64)0)
+	REGISTER_FIELD("tp_prnos","",LPMV(m_nTpPrnos),LPMF(CFstsearch,OnTpPrnosChanged),"Word end hypothesis number pruning threshold per output symbol",0,2008,1,"long",(INT64)0)
 	REGISTER_FIELD("tp_prnw","",LPMV(m_nTpPrnw),LPMF(CFstsearch,OnTpPrnwChanged),"Weight pruning threshold",0,3008,1,"double",(FLOAT64)0)
+	REGISTER_FIELD("tp_prnwe","",LPMV(m_nTpPrnwe),LPMF(CFstsearch,OnTpPrnweChanged),"Word end weight pruning threshold",0,3008,1,"double",(FLOAT64)0)
 	REGISTER_FIELD("tp_threads","",LPMV(m_nTpThreads),LPMF(CFstsearch,OnTpThreadsChanged),"Number of threads to use for decoding",0,2008,1,"long",(INT64)1)
 	REGISTER_FIELD("wnorm_dec","",LPMV(m_nWnormDec),LPMF(CFstsearch,OnWnormDecChanged),"Weight normalization decrement",0,3008,1,"double",(FLOAT64)0.5)
 	REGISTER_FIELD("wnorm_off","",LPMV(m_nWnormOff),LPMF(CFstsearch,OnWnormOffChanged),"Weight normalization offset",0,3008,1,"double",(FLOAT64)10)
+	REGISTER_FIELD("wtype","",LPMV(m_lpsWtype),LPMF(CFstsearch,OnWtypeChanged),"Storage type of the timevariant weights",0,5000,1,"string","auto")
 
 	/* Register errors */
 	REGISTER_ERROR("~e1_0_0__1",EL_ERROR,FSTS_STR,"%s")
@@ -409,6 +417,22 @@ INT16 CFstsearch_OnLoad(CDlpObject* __this)
 	return __nErr;
 }
 
+INT16 CFstsearch_OnPartial(CDlpObject* __this)
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	INT16 __nErr    = O_K;
+	INT32  __nErrCnt = 0;
+	fst* itDst;
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	MIC_CHECK;
+	__nErrCnt = CDlpObject_GetErrorCount();
+	itDst = MIC_GET_I_EX(itDst,fst,1,1);
+	if (CDlpObject_GetErrorCount()>__nErrCnt) return NOT_EXEC;
+	__nErr = CFstsearch_Partial(_this, itDst);
+	return __nErr;
+}
+
 INT16 CFstsearch_OnRestart(CDlpObject* __this)
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -598,6 +622,16 @@ INT16 CFstsearch_OnSdpPrnChanged(CDlpObject* __this)
 	return O_K;
 }
 
+INT16 CFstsearch_OnSdpPrnhChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
 INT16 CFstsearch_OnStkprnChanged(CDlpObject* __this)
 {
 	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
@@ -608,6 +642,36 @@ INT16 CFstsearch_OnStkprnChanged(CDlpObject* __this)
 	return O_K;
 }
 
+INT16 CFstsearch_OnTpLaChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
+INT16 CFstsearch_OnTpLmlaChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
+INT16 CFstsearch_OnTpPartkeepChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
 INT16 CFstsearch_OnTpPrnhChanged(CDlpObject* __this)
 {
 	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
@@ -618,6 +682,16 @@ INT16 CFstsearch_OnTpPrnhChanged(CDlpObject* __this)
 	return O_K;
 }
 
+INT16 CFstsearch_OnTpPrnosChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
 INT16 CFstsearch_OnTpPrnwChanged(CDlpObject* __this)
 {
 	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
@@ -628,6 +702,16 @@ INT16 CFstsearch_OnTpPrnwChanged(CDlpObject* __this)
 	return O_K;
 }
 
+INT16 CFstsearch_OnTpPrnweChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
 INT16 CFstsearch_OnTpThreadsChanged(CDlpObject* __this)
 {
 	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
@@ -658,6 +742,16 @@ INT16 CFstsearch_OnWnormOffChanged(CDlpObject* __this)
 	return O_K;
 }
 
+INT16 CFstsearch_OnWtypeChanged(CDlpObject* __this)
+{
+	GET_THIS_VIRTUAL_RV(CFstsearch,NOT_EXEC);
+	{
+  	CFstsearch_Restart(_this);
+	}
+
+	return O_K;
+}
+
 /*}}CGEN_CFCCF */
 
 
@@ -774,6 +868,13 @@ INT16 CFstsearch::OnLoad()
 	return CFstsearch_OnLoad(this);
 }
 
+INT16 CFstsearch::OnPartial()
+/* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
+/* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
+{
+	return CFstsearch_OnPartial(this);
+}
+
 INT16 CFstsearch::OnRestart()
 /* DO NOT CALL THIS FUNCTION FROM C++ SCOPE.     */
 /* IT MAY INTERFERE WITH THE INTERPRETER SESSION */
@@ -865,21 +966,51 @@ INT16 CFstsearch::OnSdpPrnChanged()
 	return CFstsearch_OnSdpPrnChanged(this);
 }
 
+INT16 CFstsearch::OnSdpPrnhChanged()
+{
+	return CFstsearch_OnSdpPrnhChanged(this);
+}
+
 INT16 CFstsearch::OnStkprnChanged()
 {
 	return CFstsearch_OnStkprnChanged(this);
 }
 
+INT16 CFstsearch::OnTpLaChanged()
+{
+	return CFstsearch_OnTpLaChanged(this);
+}
+
+INT16 CFstsearch::OnTpLmlaChanged()
+{
+	return CFstsearch_OnTpLmlaChanged(this);
+}
+
+INT16 CFstsearch::OnTpPartkeepChanged()
+{
+	return CFstsearch_OnTpPartkeepChanged(this);
+}
+
 INT16 CFstsearch::OnTpPrnhChanged()
 {
 	return CFstsearch_OnTpPrnhChanged(this);
 }
 
+INT16 CFstsearch::OnTpPrnosChanged()
+{
+	return CFstsearch_OnTpPrnosChanged(this);
+}
+
 INT16 CFstsearch::OnTpPrnwChanged()
 {
 	return CFstsearch_OnTpPrnwChanged(this);
 }
 
+INT16 CFstsearch::OnTpPrnweChanged()
+{
+	return CFstsearch_OnTpPrnweChanged(this);
+}
+
 INT16 CFstsearch::OnTpThreadsChanged()
 {
 	return CFstsearch_OnTpThreadsChanged(this);
@@ -895,6 +1026,11 @@ INT16 CFstsearch::OnWnormOffChanged()
 	return CFstsearch_OnWnormOffChanged(this);
 }
 
+INT16 CFstsearch::OnWtypeChanged()
+{
+	return CFstsearch_OnWtypeChanged(this);
+}
+
 /*}}CGEN_FCCF */
 
 /*{{CGEN_CXXWRAP */
@@ -918,6 +1054,11 @@ INT16 CFstsearch::Backtrack(CFst* itDst)
 	return CFstsearch_Backtrack(this, itDst);
 }
 
+INT16 CFstsearch::Partial(CFst* itDst)
+{
+	return CFstsearch_Partial(this, itDst);
+}
+
 INT16 CFstsearch::Unload()
 {
 	return CFstsearch_Unload(this);
@@ -166,7 +166,7 @@ INT16 CGEN_PROTECTED CFvrtools_CheckSeq(CFvrtools* _this, CFst* itSeq, CData* id
   INT16 nRet = O_K;                                                             /* The return value                  */
   INT32 nI,nC;                                                                  /* Symbol, character index           */
   INT32 nXI;                                                                    /* Number of input symbols           */
-  INT32 nOI;                                                                    /* Input symbol record length        */
+  INT32 nOI;                                                                    /* Input symbol stride               */
   INT32 nXC;                                                                    /* Number of characters per symbol   */
   INT32 nBO = -1;                                                               /* Opening bracket index             */
   INT32 nBC = -1;                                                               /* Closing bracket index             */
@@ -180,7 +180,7 @@ INT16 CGEN_PROTECTED CFvrtools_CheckSeq(CFvrtools* _this, CFst* itSeq, CData* id
     FVRT_EXCEPTION(ERR_NULLINST,"idS is empty",0,0);                            /*   Error message and exit          */
 
   nXI=CData_GetNRecs(idS);                                                      /* Get number of symbols             */
-  nOI=CData_GetRecLen(idS);                                                     /* Get input symbol record length    */
+  nOI=CData_GetCompStride(idS,0);                                               /* Get input symbol stride           */
   nXC=CData_GetCompType(idS,0);                                                 /* Get number of characters per symb.*/
 
   /* Check path integrity and get comments */                                   /* --------------------------------- */
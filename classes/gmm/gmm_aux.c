@@ -683,6 +683,11 @@ INT16 CGEN_PROTECTED CGmm_CheckPrecalc(CGmm* _this)
         IFCHECK printf("inv. cov. (field icov) table invalid -> FAIULURE");
         return NOT_EXEC;
       }
+      if (CData_IsColmajor(AS(CData,_this->m_idIcov)))
+      {
+        IFCHECK printf("inv. cov. (field icov) table column-major -> FAILURE");
+        return NOT_EXEC;
+      }
       for (k=0; k<K; k++)
         if (((BYTE**)_this->m_lpI)[k]<lp1 ||((BYTE**)_this->m_lpI)[k]>=lp1+nLen)
         {
@@ -723,6 +728,11 @@ INT16 CGEN_PROTECTED CGmm_CheckPrecalc(CGmm* _this)
       IFCHECK printf("inv. cov. (field ivar) table invalid -> FAIULURE");
       return NOT_EXEC;
     }
+    if (CData_IsColmajor(AS(CData,_this->m_idIvar)))
+    {
+      IFCHECK printf("inv. var. (field ivar) table column-major -> FAILURE");
+      return NOT_EXEC;
+    }
     for (k=0; k<K; k++)
       if (((BYTE**)_this->m_lpV)[k]<lp1 || ((BYTE**)_this->m_lpV)[k]>=lp1+nLen)
       {
@@ -90,7 +90,7 @@ INT16 CGmm_PrecalcD(CGmm* _this, BOOL bCleanup)
   INT32      N       = 0;                                                        /* Feature space dimensionality      */
   GMM_FTYPE nDelta1 = 0.;                                                       /* Class indep. term of delta const. */
 #ifdef __TMS
-  GMM_FTYPE *mean = (GMM_FTYPE*)CData_XAddr(AS(CData,_this->m_idMean),0,0);
+  GMM_FTYPE *mean = NULL;
 #endif
 
 
@@ -123,6 +123,19 @@ INT16 CGmm_PrecalcD(CGmm* _this, BOOL bCleanup)
   IF_NOK(CGmm_CheckIvar(_this)) DLPTHROW(GMM_NOTSETUP);                         /* Check inverse variance vectors    */
   IF_NOK(CGmm_CheckCdet(_this)) DLPTHROW(GMM_NOTSETUP);                         /* Check (co-)variance determinants  */
 
+  /* Row-major layout (maps below point to records) */                          /* --------------------------------- */
+  if                                                                            /* Parameter tables to row-major     */
+  (                                                                             /* |                                 */
+    CData_Rowmajor(AS(CData,_this->m_idMean))!=O_K ||                           /* |                                 */
+    CData_Rowmajor(AS(CData,_this->m_idIvar))!=O_K ||                           /* |                                 */
+    CData_Rowmajor(AS(CData,_this->m_idCdet))!=O_K ||                           /* |                                 */
+    (_this->m_idIcov && CData_Rowmajor(AS(CData,_this->m_idIcov))!=O_K)         /* |                                 */
+  )                                                                             /* |                                 */
+    DLPTHROW(ERR_NOMEM);                                                        /* Out of memory                     */
+#ifdef __TMS
+  mean = (GMM_FTYPE*)CData_XAddr(AS(CData,_this->m_idMean),0,0);
+#endif
+
   /* Basic dimensions */                                                        /* --------------------------------- */
   _this->m_nN = N;                                                              /* Feature space dimensionality      */
   _this->m_nK = K;                                                              /* Number of single Gaussians        */
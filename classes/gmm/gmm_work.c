@@ -237,6 +237,15 @@ INT16 CGEN_PROTECTED CGmm_Gauss
   C = CData_GetNComps(idX);                                                     /* Get number of input components    */
   if (CData_GetNNumericComps(idX)!=N)                                           /* Check feature dimensionality      */
     return IERROR(_this,GMM_DIM,"feature vector",N,0);                          /* |                                 */
+  if                                                                            /* Records are accessed as vectors   */
+  (                                                                             /* |                                 */
+    CData_Rowmajor(idX   )!=O_K ||                                              /* |                                 */
+    CData_Rowmajor(idXmap)!=O_K ||                                              /* |                                 */
+    CData_Rowmajor(idDest)!=O_K                                                 /* |                                 */
+  )                                                                             /* |                                 */
+  {                                                                             /* >> (Layout conversion failed)     */
+    return IERROR(_this,ERR_NOMEM,0,0,0);                                       /*   Error                           */
+  }                                                                             /* <<                                */
 
   /* Initialize */                                                              /* --------------------------------- */
   CREATEVIRTUAL(CData,idX,idDest);                                              /* idX and idDest may be identical   */
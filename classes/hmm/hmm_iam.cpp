@@ -587,6 +587,7 @@ static INT16 CHmm_GmmUnmixComp(CHmm *h){
   CData* tmx=h->m_iGm->m_iMmap->m_idTmx;
   if(!CTmx_IsCompressed(tmx)) return IERROR(h,GMM_INVALD,"mixture map is not compressed","","gmm");
   if(CData_GetNComps(h->is)!=3 || CData_IsHomogen(h->is)!=T_DOUBLE) return IERROR(h,GMM_INVALD,"only implemented with tid map","","gmm");
+  if(CData_Rowmajor(tmx)!=O_K || CData_Rowmajor(h->is)!=O_K || CData_Rowmajor(h->td)!=O_K) return IERROR(h,ERR_NOMEM,0,0,0);
 
   BYTE *bi0=(BYTE*)CData_XAddr(tmx,0,0),*bi;
   BYTE *bo0=(BYTE*)CData_XAddr(tmx,0,1),*bo;
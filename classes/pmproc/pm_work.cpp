@@ -69,6 +69,7 @@ INT16 CGEN_PUBLIC CPMproc::ExpandPm(CData *idSrc, CData* idDst, INT32 n)
 {
   if(CData_IsEmpty(idSrc) == TRUE) return NOT_EXEC;
   if(n <= 0)                       return NOT_EXEC;
+  if(CData_Rowmajor(idSrc) != O_K || CData_Rowmajor(idDst) != O_K) return IERROR(this,ERR_NOMEM,0,0,0);
 
   CREATEVIRTUAL(CData,idSrc,idDst);
 
@@ -107,6 +108,7 @@ INT16 CGEN_PUBLIC CPMproc::CompressPm(CData *idSrc, CData* idDst, INT32 n)
 {
   if(CData_IsEmpty(idSrc) == TRUE) return NOT_EXEC;
   if(n <= 0)                       return NOT_EXEC;
+  if(CData_Rowmajor(idSrc) != O_K || CData_Rowmajor(idDst) != O_K) return IERROR(this,ERR_NOMEM,0,0,0);
 
   CREATEVIRTUAL(CData,idSrc,idDst);
 
@@ -208,6 +210,7 @@ INT16 CGEN_PUBLIC CPMproc::Pm2f0(CData *idSrc, CData* idDst, INT32 n, INT32 srat
   if(n <= 0)                       return NOT_EXEC;
 
   DLPASSERT(CData_GetNComps(idSrc) == 2);
+  if(CData_Rowmajor(idSrc) != O_K || CData_Rowmajor(idDst) != O_K) return IERROR(this,ERR_NOMEM,0,0,0);
 
   CREATEVIRTUAL(CData,idSrc,idDst);
 
@@ -244,6 +247,7 @@ INT16 CGEN_PUBLIC CPMproc::F02pm(CData *idSrc, CData* idDst, INT32 n, INT32 srat
   if(n <= 0)                       return NOT_EXEC;
 
   DLPASSERT(CData_GetNComps(idSrc) == 1);
+  if(CData_Rowmajor(idSrc) != O_K || CData_Rowmajor(idDst) != O_K) return IERROR(this,ERR_NOMEM,0,0,0);
 
   CREATEVIRTUAL(CData,idSrc,idDst);
 
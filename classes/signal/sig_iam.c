@@ -1718,6 +1718,8 @@ INT16 CGEN_PUBLIC CSignal_MFilter(CData* idY, CData* idX, CData* idB, CData* idA
   CData* idS = NULL;
   CData* idL = NULL;
 
+  if (CData_Rowmajor(idB) != O_K || CData_Rowmajor(idA) != O_K || CData_Rowmajor(idM) != O_K)
+    return IERROR(idX,ERR_NOMEM,0,0,0); /* Coefficients are read by records  */
   FOP_PRECALC(idX, idY, idS, idR, idL);
 
   /* Validation *//* ---------------------------------*/
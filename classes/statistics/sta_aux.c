@@ -154,6 +154,7 @@ INT16 CGEN_PUBLIC CStatistics_FreqEx
   /* Validate */                                                                /* --------------------------------- */
   if (!idDst) return IERROR(_this,ERR_NULLARG,"idDst",0,0);                     /* Check output data instance        */
   CData_Reset(idDst,TRUE);                                                      /* Clear destination instance        */
+  CData_Rowmajor(idDst);                                                        /* Output vectors are records        */
   CHECK_THIS_RV(NOT_EXEC);                                                      /* Check this pointer                */
   IF_NOK(CStatistics_Check(_this))                                              /* Check instance data               */
     return IERROR(_this,STA_NOTSETUP," ( use -status for details)",0,0);        /* ...                               */
@@ -275,7 +276,8 @@ INT16 CGEN_PROTECTED CStatistics_CheckLtb(CStatistics* _this)
 /**
  * Performs a checkup of the CStatistics instances internal data. The method
  * calls {@link CheckDat CStatistics_CheckDat} and
- * {@link CheckLtb CStatistics_CheckLtb}.
+ * {@link CheckLtb CStatistics_CheckLtb}. The raw statistics data are accessed
+ * record by record and are converted to row-major layout if necessary.
  *
  * @param _this
  *           Pointer to CStatistics instance
@@ -286,6 +288,7 @@ INT16 CGEN_PUBLIC CStatistics_Check(CStatistics* _this)
 {
   CHECK_THIS_RV(NOT_EXEC);
   IF_NOK(CStatistics_CheckDat(_this)) return NOT_EXEC;
+  IF_NOK(CData_Rowmajor(AS(CData,_this->m_idDat))) return NOT_EXEC;
   IF_NOK(CStatistics_CheckLtb(_this)) return NOT_EXEC;
   return O_K;
 }
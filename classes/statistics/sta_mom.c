@@ -342,6 +342,7 @@ INT16 CGEN_PUBLIC CStatistics_MomentEx
   /* Validate */                                                                /* --------------------------------- */
   if (!idDst) return IERROR(_this,ERR_NULLARG,"idDst",0,0);                     /* Check output data instance        */
   CData_Reset(idDst,TRUE);                                                      /* Clear destination instance        */
+  CData_Rowmajor(idDst);                                                        /* Output vectors are records        */
   CHECK_THIS_RV(NOT_EXEC);                                                      /* Check this pointer                */
   IF_NOK(CStatistics_Check(_this))                                              /* Check instance data               */
     return IERROR(_this,STA_NOTSETUP," ( use -status for details)",0,0);        /* ...                               */
@@ -57,6 +57,7 @@
 void CGEN_SPRIVATE CStatistics_PoolInt(CData* idPool, CData* idSrc, INT32 nMode)
 {
   CData* idAux      = NULL;                                                     /* Auxilary data instance #1         */
+  INT32  nC         = 0;                                                        /* Current component index           */
 
   if (nMode==0)                                                                 /* Sum aggregation mode              */
   {                                                                             /* >>                                */
@@ -69,8 +70,8 @@ void CGEN_SPRIVATE CStatistics_PoolInt(CData* idPool, CData* idSrc, INT32 nMode)
     ICREATEEX(CData,idAux,"CStatistics_Pool_int.~idAux",NULL);                  /*   Create auxilary data instance #1*/
     ISETOPTION(idAux,"/block");                                                 /*   Switch target to block mode     */
     CData_Aggregate(idAux,idSrc,NULL,CMPLX(0),nMode==1?"min":"max");            /*   Aggregate (minimum or maximum)  */
-    dlp_memmove(CData_XAddr(idPool,nMode,0),CData_XAddr(idAux,nMode,0),         /*   Copy aggregated min. or max. ...*/
-      CData_GetRecLen(idAux));                                                  /*   | ... to target                 */
+    for (nC=0; nC<CData_GetNComps(idAux); nC++)                                 /*   Copy aggregated min. or max. ...*/
+      CData_Dstore(idPool,CData_Dfetch(idAux,nMode,nC),nMode,nC);               /*   | ... to target (any layout)    */
     IRESETOPTIONS(idAux);                                                       /*   Switch target to normal mode    */
     IDESTROY(idAux);                                                            /*   Destroy auxilary data inst. #1  */
   }                                                                             /* <<                                */
@@ -185,6 +186,8 @@ INT16 CGEN_PUBLIC CStatistics_Pool
     CStatistics_PoolInt(idAux,idPcd,2);                                         /*   Pool max data                   */
 
     /* - Store pooled raw statistics data block */                              /*   - - - - - - - - - - - - - - - - */
+    if (CData_Rowmajor(_this->m_idDat)!=O_K || CData_Rowmajor(idAux)!=O_K)      /*   Blocks are copied as a whole    */
+      DLPTHROW(ERR_NOMEM);                                                      /*   | Out of memory                 */
     dlp_memmove                                                                 /*   Copy pooled raw stats. data     */
     (                                                                           /*   |                               */
       CData_XAddr(_this->m_idDat,nC*nRpb,0),                                    /*   | To target statistics block    */
@@ -203,6 +206,7 @@ INT16 CGEN_PUBLIC CStatistics_Pool
   STA_PROTOCOL_FOOTER(1,"done");                                                /* Print protocol footer             */
   return O_K;                                                                   /* Ok                                */
 
+DLPCATCH(ERR_NOMEM)                                                             /* == Catch ERR_NOMEM exception      */
 DLPCATCH(STA_BADCOMP)                                                           /* == Catch STA_BADCOMP exception    */
   IDESTROY(idAux);                                                              /* Destroy auxilary data instance #1 */
   IDESTROY(idPmp);                                                              /* Destroy pooling map               */
@@ -58,7 +58,7 @@ INT32 CGEN_PUBLIC CVmap_GetInDim(CVmap* _this)
   if(CTmx_IsCompressed(AS(CData,_this->m_idTmx))){
     INT64 mx=0,n=CData_GetNRecs(AS(CData,_this->m_idTmx));
     BYTE *p=CData_XAddr(AS(CData,_this->m_idTmx),0,0);
-    INT32 nr=CData_GetRecLen(AS(CData,_this->m_idTmx));
+    INT32 nr=CData_GetCompStride(AS(CData,_this->m_idTmx),0);
     for(;n;n--,p+=nr) if(*(INT64*)p>mx) mx=*(INT64*)p;
     return mx+1;
   }
@@ -80,7 +80,7 @@ INT32 CGEN_PUBLIC CVmap_GetOutDim(CVmap* _this)
   if(CTmx_IsCompressed(AS(CData,_this->m_idTmx))){
     INT64 mx=0,n=CData_GetNRecs(AS(CData,_this->m_idTmx));
     BYTE *p=CData_XAddr(AS(CData,_this->m_idTmx),0,1);
-    INT32 nr=CData_GetRecLen(AS(CData,_this->m_idTmx));
+    INT32 nr=CData_GetCompStride(AS(CData,_this->m_idTmx),1);
     for(;n;n--,p+=nr) if(*(INT64*)p>mx) mx=*(INT64*)p;
     return mx+1;
   }
@@ -110,6 +110,8 @@ INT16 CGEN_PUBLIC CVmap_Setup
   CHECK_THIS_RV(NOT_EXEC);                                                      /* Check this pointer                */
   IFIELD_RESET(CData,"tmx");                                                    /* Create/reset transformation matrix*/
   IFIELD_RESET(CData,"weak_tmx");                                               /* Create/reset weak tmx             */
+  CData_Rowmajor(AS(CData,_this->m_idTmx));                                     /* Matrices are accessed by records  */
+  CData_Rowmajor(AS(CData,_this->m_idWeakTmx));                                 /* |                                 */
   _this->m_nAop  = dlp_scalop_code(sAop);                                       /* Get aggregation operation code    */
   _this->m_nWop  = dlp_scalop_code(sWop);                                       /* Get weighting operation code      */
   _this->m_nZero = nZero;                                                       /* Store aggregation neutral element */
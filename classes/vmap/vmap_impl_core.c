@@ -85,7 +85,7 @@ void CGEN_PUBLIC CVmap_MapVectorD
     BYTE *bo=(BYTE*)CData_XAddr(AS(CData,_this->m_idTmx),0,1);
     BYTE *bw=(BYTE*)CData_XAddr(AS(CData,_this->m_idTmx),0,2);
     INT64  n=CData_GetNRecs(AS(CData,_this->m_idTmx));
-    INT32 nr=CData_GetRecLen(AS(CData,_this->m_idTmx));
+    INT32 nr=CData_GetCompStride(AS(CData,_this->m_idTmx),0);
     for(;n;n--,bi+=nr,bo+=nr,bw+=nr)
       lpY[*(INT64*)bo] = DLP_SCALOP(lpY[*(INT64*)bo],DLP_SCALOP(*(FLOAT64*)bw,lpX[*(INT64*)bi],_this->m_nWop),_this->m_nAop);
   
@@ -105,7 +105,7 @@
 #define RWID      9906
 #define ROFS      9907
 #define CHECK_DATA(A) {DLPASSERT(A!=NULL); DLPASSERT(A->m_lpTable);}
-#define CDATA_XADDR(THIS,R,C)                    (THIS->m_lpTable->m_theDataPointer         +    (size_t)THIS->m_lpTable->m_reclen * (size_t)R             +    (size_t)THIS->m_lpTable->m_compDescrList[C].offset)
+#define CDATA_XADDR(THIS,R,C)                                                  (THIS->m_lpTable->m_theDataPointer                                       +    (THIS->m_lpTable->m_bColmajor                                                 ? (size_t)THIS->m_lpTable->m_compDescrList[C].offset *                         (size_t)THIS->m_lpTable->m_maxrec                                    +       (size_t)THIS->m_lpTable->m_compDescrList[C].size * (size_t)(R)             : (size_t)THIS->m_lpTable->m_reclen * (size_t)(R)                      +       (size_t)THIS->m_lpTable->m_compDescrList[C].offset))
 #define CDATA_SORT_UP    1
 #define CDATA_SORT_DOWN  2
 #define CDATA_MARK_RECS     0
@@ -196,6 +196,8 @@ public:
 	INT16 OnJoin();
 	INT16 OnLookup();
 	INT16 OnLookup2();
+	INT16 OnMap();
+	INT16 OnMapExport();
 	INT16 OnMark();
 	INT16 OnPfetch();
 	INT16 OnPrint();
@@ -213,6 +215,7 @@ public:
 	INT16 OnSelect();
 	INT16 OnSetCname();
 	INT16 OnSetCnames();
+	INT16 OnSetColmajor();
 	INT16 OnSfetch();
 	INT16 OnShift();
 	INT16 OnSortdown();
@@ -222,6 +225,7 @@ public:
 	INT16 OnStore();
 	INT16 OnStrop();
 	INT16 OnTconvert();
+	INT16 OnUnmap();
 	INT16 OnUnmark();
 	INT16 OnXfetch();
 	INT16 OnXstore();
@@ -261,6 +265,13 @@ public:
 	public: INT16 AllocUninitialized(INT32 nRecs);
 	public: INT16 AllocateUninitialized(INT32 nRecs);
 	public: INT16 Realloc(INT32 nRecs);
+	public: INT16 SetColmajor(BOOL bColmajor);
+	public: BOOL IsColmajor();
+	public: INT16 Rowmajor();
+	public: INT16 MapExport(const char* sFilename);
+	public: INT16 Map(const char* sFilename);
+	public: INT16 Unmap();
+	public: BOOL IsMapped();
 	public: INT32 AddRecs(INT32 nRecs, INT32 nRealloc);
 	public: INT32 InsertRecs(INT32 nInsertAt, INT32 nRecs, INT32 nRealloc);
 	public: INT32 GetNRecs();
@@ -276,6 +287,7 @@ public:
 	public: INT32 GetMaxRecs();
 	public: INT32 GetCompSize(INT32 nComp);
 	public: INT32 GetCompOffset(INT32 nComp);
+	public: INT32 GetCompStride(INT32 nComp);
 	public: INT32 GetRecLen();
 	public: INT32 FindRec(INT32 nComp, char* sWhat);
 	public: INT32 CcompFetch(COMPLEX64* dBuffer, INT32 nComp, INT32 nMaxRecs);
@@ -447,6 +459,7 @@ typedef struct CData
 	BOOL m_bNoise;
 	BOOL m_bNumeric;
 	BOOL m_bNz;
+	BOOL m_bRdonly;
 	BOOL m_bRec;
 /*}}CGEN_OPTIONS */
 }
@@ -515,6 +528,8 @@ INT16 CData_OnIsEmpty(CDlpObject*);
 INT16 CData_OnJoin(CDlpObject*);
 INT16 CData_OnLookup(CDlpObject*);
 INT16 CData_OnLookup2(CDlpObject*);
+INT16 CData_OnMap(CDlpObject*);
+INT16 CData_OnMapExport(CDlpObject*);
 INT16 CData_OnMark(CDlpObject*);
 INT16 CData_OnPfetch(CDlpObject*);
 INT16 CData_OnPrint(CDlpObject*);
@@ -532,6 +547,7 @@ INT16 CData_OnScopy(CDlpObject*);
 INT16 CData_OnSelect(CDlpObject*);
 INT16 CData_OnSetCname(CDlpObject*);
 INT16 CData_OnSetCnames(CDlpObject*);
+INT16 CData_OnSetColmajor(CDlpObject*);
 INT16 CData_OnSfetch(CDlpObject*);
 INT16 CData_OnShift(CDlpObject*);
 INT16 CData_OnSortdown(CDlpObject*);
@@ -541,6 +557,7 @@ INT16 CData_OnStatus(CDlpObject*);
 INT16 CData_OnStore(CDlpObject*);
 INT16 CData_OnStrop(CDlpObject*);
 INT16 CData_OnTconvert(CDlpObject*);
+INT16 CData_OnUnmap(CDlpObject*);
 INT16 CData_OnUnmark(CDlpObject*);
 INT16 CData_OnXfetch(CDlpObject*);
 INT16 CData_OnXstore(CDlpObject*);
@@ -577,6 +594,13 @@ INT16 CData_Alloc(CData*, INT32 nRecs);
 INT16 CData_AllocUninitialized(CData*, INT32 nRecs);
 INT16 CData_AllocateUninitialized(CData*, INT32 nRecs);
 INT16 CData_Realloc(CData*, INT32 nRecs);
+INT16 CData_SetColmajor(CData*, BOOL bColmajor);
+BOOL CData_IsColmajor(CData*);
+INT16 CData_Rowmajor(CData*);
+INT16 CData_MapExport(CData*, const char* sFilename);
+INT16 CData_Map(CData*, const char* sFilename);
+INT16 CData_Unmap(CData*);
+BOOL CData_IsMapped(CData*);
 INT32 CData_AddRecs(CData*, INT32 nRecs, INT32 nRealloc);
 INT32 CData_InsertRecs(CData*, INT32 nInsertAt, INT32 nRecs, INT32 nRealloc);
 INT32 CData_GetNRecs(CData*);
@@ -592,6 +616,7 @@ INT32 CData_SetNRecs(CData*, INT32 nRecs);
 INT32 CData_GetMaxRecs(CData*);
 INT32 CData_GetCompSize(CData*, INT32 nComp);
 INT32 CData_GetCompOffset(CData*, INT32 nComp);
+INT32 CData_GetCompStride(CData*, INT32 nComp);
 INT32 CData_GetRecLen(CData*);
 INT32 CData_FindRec(CData*, INT32 nComp, char* sWhat);
 INT32 CData_CcompFetch(CData*, COMPLEX64* dBuffer, INT32 nComp, INT32 nMaxRecs);
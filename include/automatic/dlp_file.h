@@ -124,6 +124,21 @@
   #endif
   }CFILE_FTYPE;
 
+  /* Chunked audio file reader (see CDlpFile_Snd_Init) */
+  typedef struct tagCFILE_SNDSTREAM
+  {
+    void*   lpSndfile;                                                          /* SNDFILE* or CData* (no libsndfile)*/
+    INT64   nFrames;                                                            /* Total number of frames in file    */
+    INT64   nPos;                                                               /* Current frame position            */
+    INT32   nChannels;                                                          /* Number of channels in file        */
+    INT32   nChannel;                                                           /* Selected channel                  */
+    INT16   nType;                                                              /* Sample type code in file          */
+    FLOAT32 nNorm;                                                              /* Normalization divisor             */
+    FLOAT64 nSrate;                                                             /* Sampling rate in Hz               */
+    BYTE*   lpBuf;                                                              /* Raw (interleaved) read buffer     */
+    INT32   nBufLen;                                                            /* Capacity of read buffer in frames */
+  }CFILE_SNDSTREAM;
+
 /*}}CGEN_HEADERCODE */
 
 /* Class CDlpFile */
@@ -214,6 +229,9 @@ public:
 	protected: INT16 ExportAsciiFromData(const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
 	protected: INT16 LibsndfileImport(const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 	protected: INT16 LibsndfileExport(const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
+	public: CFILE_SNDSTREAM* Snd_Init(const char* sFilename, INT32 nChannel);
+	public: static INT32 Snd_Read(CFILE_SNDSTREAM* lpSS, FLOAT32* lpBuf, INT32 nSamples);
+	public: static void Snd_Done(CFILE_SNDSTREAM* lpSS);
 	protected: INT16 ImportPhDToData(const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 	protected: INT16 ImportEspsLabToData(const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 	protected: INT16 ExportEspsLabFromData(const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
@@ -389,6 +407,9 @@ INT16 CDlpFile_ImportAsciiToData(CDlpFile*, const char* sFilename, CDlpObject* i
 INT16 CDlpFile_ExportAsciiFromData(CDlpFile*, const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
 INT16 CDlpFile_LibsndfileImport(CDlpFile*, const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 INT16 CDlpFile_LibsndfileExport(CDlpFile*, const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
+CFILE_SNDSTREAM* CDlpFile_Snd_Init(CDlpFile*, const char* sFilename, INT32 nChannel);
+INT32 CDlpFile_Snd_Read(CFILE_SNDSTREAM* lpSS, FLOAT32* lpBuf, INT32 nSamples);
+void CDlpFile_Snd_Done(CFILE_SNDSTREAM* lpSS);
 INT16 CDlpFile_ImportPhDToData(CDlpFile*, const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 INT16 CDlpFile_ImportEspsLabToData(CDlpFile*, const char* sFilename, CDlpObject* iDest, const char* sFiletype);
 INT16 CDlpFile_ExportEspsLabFromData(CDlpFile*, const char* sFilename, CDlpObject* iSrc, const char* sFiletype);
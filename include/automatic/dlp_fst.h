@@ -132,6 +132,7 @@
 #define FSTI_SORTTER   0x0002
 #define FSTI_SLOPPY    0x0004
 #define FSTI_PTR       0x0008
+#define FSTI_ADJ       0x0010
 #define FSTI_CADD      0x0001
 #define FSTI_CANY      0x0000
 #define FST_SDP_KEEPA  10
@@ -199,11 +200,36 @@
     INT32           nMode;             /* Operation mode, combination of the FSTI_XXX constants          */
     INT32           nDepth;            /* Recursion depth                                                */
     BOOL            bPathsClipped;     /* Paths were clipped for exceeding iFst->m_nMaxLen               */
+    FST_ITYPE*      lpAdjF;            /* FSTI_ADJ: Transitions ordered by initial state and input sym.  */
+    FST_ITYPE*      lpAdjB;            /* FSTI_ADJ: Transitions ordered by terminal state                */
+    FST_ITYPE*      lpAdjOf;           /* FSTI_ADJ: Offsets of states in lpAdjF (nXS+1 entries)          */
+    FST_ITYPE*      lpAdjOb;           /* FSTI_ADJ: Offsets of states in lpAdjB (nXS+1 entries)          */
+    FST_ITYPE*      lpAdjPf;           /* FSTI_ADJ: Positions of transitions in lpAdjF                   */
+    FST_ITYPE*      lpAdjPb;           /* FSTI_ADJ: Positions of transitions in lpAdjB                   */
     FST_TID_PT_TYPE **lpPTFwd;
     FST_TID_PT_TYPE **lpPTBwd;
     FST_TID_PT_TYPE *lpPTMem;
   } FST_TID_TYPE;
 
+  typedef struct tag_FST_CTS_TYPE      /* Compact transition store of a unit (CFst_Cts_XXX)              */
+  {
+    FST_CTYPE CFst* iFst;              /* Automaton the store was packed from                            */
+    INT32           nUnit;             /* Unit packed                                                    */
+    INT16           nMode;             /* Order of transitions (FSTI_SORTINI, FSTI_SORTTER or 0)         */
+    FST_ITYPE       nXS;               /* Number of states of unit                                       */
+    FST_ITYPE       nXT;               /* Number of transitions of unit                                  */
+    INT32           nIcTis;            /* Component index of input symbols in td (-1: none)              */
+    INT32           nIcTos;            /* Component index of output symbols in td (-1: none)             */
+    INT32           nIcW;              /* Component index of weights in td (-1: none)                    */
+    FST_ITYPE*      lpTid;             /* Transition table records (unit relative)                       */
+    FST_ITYPE*      lpIni;             /* Initial states                                                 */
+    FST_ITYPE*      lpTer;             /* Terminal states                                                */
+    FST_STYPE*      lpTis;             /* Input symbols (NULL if none)                                   */
+    FST_STYPE*      lpTos;             /* Output symbols (NULL if none)                                  */
+    FST_WTYPE*      lpW;               /* Weights (NULL if not weighted)                                 */
+    FST_ITYPE*      lpOfs;             /* Offsets of states (nXS+1 entries, NULL if unsorted)            */
+  } FST_CTS_TYPE;
+
   typedef struct tag_FST_SST_TYPE
   {
     CDlpTable*      iST;               /* Pointer to string (pointer) table                              */
@@ -261,9 +287,69 @@
     INT32           nMaxLen;           /* Maximum number of transitions to walk                          */
   } FST_EXCR_TYPE;
 
+  typedef struct tag_FST_PQU_TYPE      /* Priority queue entry used in CFst_BestNUnit                    */
+  {
+    FST_ITYPE       nXini;             /* Initial state in source                                        */
+    FST_ITYPE       nXter;             /* Terminal state in source                                       */
+    FST_ITYPE       nYini;             /* Initial state in path tree                                     */
+    FST_ITYPE       nYter;             /* Terminal state in path tree                                    */
+    FST_ITYPE       nTran;             /* Source transition                                              */
+    FST_ITYPE       nPlen;             /* Path length                                                    */
+    FST_WTYPE       nCacc;             /* Accumulated cost from start state                              */
+    FST_WTYPE       nCtot;             /* Total cost to final state                                      */
+    INT32           nSeq;              /* Insertion sequence number (tie breaking)                       */
+  } FST_PQU_TYPE;
+
+  typedef struct tag_FST_DET_RSH_TYPE  /* Residual set hash map used in CFst_DeterminizeUnit             */
+  {
+    FST_ITYPE*      lpHead;            /* Bucket heads (state or -1)                                     */
+    FST_ITYPE*      lpNext;            /* Next state in bucket (per state)                               */
+    UINT32*         lpSig;             /* Residual signature (per state)                                 */
+    UINT32*         lpKey;             /* Residual key buffer                                            */
+    INT32           nMask;             /* Bucket mask (number of buckets-1)                              */
+    INT32           nCount;            /* Number of stored states                                        */
+    INT32           nSSi;              /* Size of per state arrays                                       */
+    INT32           nKSi;              /* Size of residual key buffer                                    */
+  } FST_DET_RSH_TYPE;
+
+  typedef struct tag_FST_PRT_TYPE      /* Refinable set partition used in CFst_HopcroftUnit              */
+  {
+    INT32           nSets;             /* Number of sets                                                 */
+    INT32*          lpE;               /* Elements ordered by sets                                       */
+    INT32*          lpL;               /* Location of elements in lpE                                    */
+    INT32*          lpS;               /* Set of elements                                                */
+    INT32*          lpF;               /* First location of sets in lpE                                  */
+    INT32*          lpP;               /* Past-the-end location of sets in lpE                           */
+    INT32*          lpM;               /* Number of marked elements of sets                              */
+    INT32*          lpW;               /* Sets containing marked elements                                */
+    INT32           nW;                /* Number of sets containing marked elements                      */
+  } FST_PRT_TYPE;
+
+  typedef struct tag_FST_PRK_TYPE      /* Sort key for initial partitions in CFst_HopcroftUnit           */
+  {
+    BYTE*           lpK;               /* Pointer to key bytes                                           */
+    INT32           nLen;              /* Length of key                                                  */
+    INT32           nId;               /* Element index                                                  */
+  } FST_PRK_TYPE;
+
+  typedef struct tag_FST_UWS_TYPE      /* Per-chunk workspace of unit-wise operations (CFst_Units)       */
+  {
+    INT32           nUnit;             /* Index of current unit in source automaton                      */
+    FST_CTYPE CFst* itSrc;             /* Copy of current source unit                                    */
+    FST_CTYPE CFst* itDst;             /* Result of current unit                                         */
+    FST_CTYPE CFst* itRes;             /* Results of all units of chunk                                  */
+    FST_CTYPE CFst* itAux;             /* Auxiliary automaton                                            */
+    CData*          idDetRt;           /* Residual table (CFst_DeterminizeUnit)                          */
+    CData*          idDetAux;          /* Auxiliary table (CFst_DeterminizeUnit)                         */
+    INT16           nErr;              /* First error code of chunk                                      */
+  } FST_UWS_TYPE;
+
   /* Automaton walking callback function (CFst_STI_Walk) */
   typedef BOOL (FST_WALKFUNC_TYPE)(FST_TID_TYPE*,BYTE*,void*);
 
+  /* Unit operation callback function (CFst_Units) */
+  typedef INT16 (FST_UNITFUNC_TYPE)(FST_CTYPE CFst*,FST_CTYPE CFst*,FST_UWS_TYPE*,void*);
+
   /* Inline functions */
 /*
   static inline BYTE* CFst_STI_GetTransPtr(FST_TID_TYPE* lpTI, INT32 nTrans)
@@ -443,12 +529,19 @@ public:
 	public: INT16 Print();
 	public: void ResetStateFlag(INT32 nUnit, BYTE bMask);
 	public: INT16 Typerepair();
+	protected: INT16 Units(CFst* itSrc, FST_UNITFUNC_TYPE* lpFunc, void* lpArg, BOOL bSerial);
 
 /* Taken from 'fst_cps.c' */
 	public: INT16 Compose(CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 	public: INT16 Intersect(CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 	public: INT16 Product(CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 
+/* Taken from 'fst_cts.c' */
+	private: static BYTE* Cts_Col(FST_CTS_TYPE* lpCts, INT32 nIc, INT32* lpBs);
+	public: FST_CTS_TYPE* Cts_Pack(INT32 nUnit, INT16 nMode);
+	public: static INT16 Cts_Unpack(FST_CTS_TYPE* lpCts);
+	public: static void Cts_Done(FST_CTS_TYPE* lpCts);
+
 /* Taken from 'fst_edt.c' */
 	public: INT32 Addunit(const char* lpsName);
 	public: INT16 AddunitIam(const char* lpsName);
@@ -462,7 +555,9 @@ public:
 	public: INT16 Delunit(INT32 nUnit);
 	public: INT16 Delstate(INT32 nUnit, INT32 nState);
 	public: INT16 Deltrans(INT32 nUnit, INT32 nTrans);
+	protected: INT16 ReverseUnit(INT32 nU);
 	public: INT16 Reverse(INT32 nUnit);
+	protected: INT16 TrimUnit(INT32 nU, FLOAT64 nWlim);
 	public: INT16 Trim(INT32 nUnit, FLOAT64 nWlim);
 	public: INT16 Chain(INT32 nUnit);
 	public: INT16 Loops(INT32 nUnit);
@@ -472,9 +567,11 @@ public:
 
 /* Taken from 'fst_erm.c' */
 	private: void Edist_Fwd(FST_TID_TYPE* lpTI, FST_ITYPE nS, FST_WTYPE nDist, FST_WTYPE* lpW, FST_ITYPE* lpTos);
-	public: INT16 Epsdist(CFst* itSrc, INT32 nUnit);
+	protected: INT16 EpsdistUnit(CFst* itSrc, INT32 nUnit);
 	private: FST_ITYPE Erm_GetDestTerState(FST_TID_TYPE* lpTIsrc, FST_ITYPE nTerSrc);
 	private: static BOOL Erm_EpsDistFromStart(FST_TID_TYPE* lpTIedt, FST_ITYPE nSsrc, FST_WTYPE* lpEpsWFZ);
+	protected: INT16 EpsremoveUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
+	public: INT16 Epsdist(CFst* itSrc, INT32 nUnit);
 	public: INT16 Epsremove(CFst* itSrc, INT32 nUnit);
 
 /* Taken from 'fst_det.c' */
@@ -487,9 +584,17 @@ public:
 	private: void Det_AddResidual(FST_ITYPE nSdst, FST_ITYPE nSsrc, FST_ITYPE nResStr, FST_WTYPE nResW);
 	private: void Det_PrtResidual(FST_ITYPE nR);
 	private: BOOL Det_CmpResiduals(FST_ITYPE nS1, FST_ITYPE nS2, FST_ITYPE** lpMap, INT32* nMapSi);
-	protected: INT16 DeterminizeUnit(CFst* itSrc, INT32 nUnit);
+	private: UINT32 Det_SigResiduals(FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS);
+	private: FST_ITYPE Det_FindResiduals(FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS, FST_ITYPE** lpMap, INT32* nMapSi);
+	protected: INT16 DeterminizeUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
 	public: INT16 Determinize(CFst* itSrc, INT32 nUnit);
-	protected: INT16 MinimizeUnit(CFst* itSrc, INT32 nUnit);
+	protected: INT16 MinimizeUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
+	private: void Prt_Init(FST_PRT_TYPE* lpPrt, INT32 nElems, INT32* lpClass, INT32 nClasses);
+	private: void Prt_Done(FST_PRT_TYPE* lpPrt);
+	private: static void Prt_Mark(FST_PRT_TYPE* lpPrt, INT32 nE);
+	private: static void Prt_Split(FST_PRT_TYPE* lpPrt);
+	private: static INT32 Prt_Classify(FST_PRK_TYPE* lpKey, BYTE* lpData, INT32 nRecs, INT32 nRecLen, INT32 nOffs, INT32* lpClass);
+	protected: INT16 HopcroftUnit(CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
 	protected: INT16 Lazymin();
 	public: INT16 Minimize(CFst* itSrc, INT32 nUnit);
 
@@ -504,6 +609,7 @@ public:
 	public: static void STI_Done(FST_TID_TYPE* lpTI);
 	public: static BOOL STI_IsSorted(FST_TID_TYPE* lpTI, INT32 nMode, FST_ITYPE* lpFSunsrtd, FST_ITYPE* lpFTunsrtd);
 	public: static void STI_Sort(FST_TID_TYPE* lpTI);
+	private: static void STI_AdjIndex(FST_TID_TYPE* lpTI);
 	public: static BYTE* STI_GetTransPtr(FST_TID_TYPE* lpTI, INT32 nTrans);
 	public: static FST_ITYPE STI_GetTransId(FST_TID_TYPE* lpTI, BYTE* lpTrans);
 	public: static FST_ITYPE* STI_TIni(FST_TID_TYPE* lpTI, BYTE* lpTrans);
@@ -514,10 +620,12 @@ public:
 	public: static FST_WTYPE* STI_TW(FST_TID_TYPE* lpTI, BYTE* lpTrans);
 	public: static BYTE* STI_TfromS(FST_TID_TYPE* lpTI, FST_ITYPE nState, BYTE* lpTrans);
 	public: static BYTE* STI_TtoS(FST_TID_TYPE* lpTI, INT32 nState, BYTE* lpTrans);
+	public: static BYTE* STI_TfromSTis(FST_TID_TYPE* lpTI, FST_ITYPE nState, FST_STYPE nTis, BYTE* lpTrans);
 	public: static BOOL STI_Walk(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void* lpWalkFuncData, FST_ITYPE nState, BOOL bBwd);
 	private: static BOOL STI_WalkInt(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void* lpWalkFuncData, FST_ITYPE nState, BOOL bBwd, INT32 nDepth);
 
 /* Taken from 'fst_ixp.c' */
+	private: void Cat_CopyStructure(CFst* itSrc);
 	public: INT16 CatEx(CFst* itSrc, INT32 nFirstUnit, INT32 nCount);
 	public: INT16 Cat(CFst* itSrc);
 	public: INT16 CopyUi(CFst* itSrc, CData* idIndex, INT32 nPar);
@@ -546,12 +654,16 @@ public:
 
 /* Taken from 'fst_pth.c' */
 	public: INT16 Fslist(INT32 nUnit, CData* idDst);
+	protected: void FsunifyUnit(INT32 nU);
 	public: INT16 Fsunify(INT32 nUnit);
 	private: INT16 TreeUnit_Walk(FST_TID_TYPE* lpTI, FST_ITYPE nSsrc, FST_ITYPE nSdst, INT32 nDepth);
 	protected: INT16 TreeUnit(CFst* itSrc, INT32 nUnit);
 	public: INT16 Tree(CFst* itSrc, INT32 nUnit);
 	private: static BOOL ExcerptWalk(FST_TID_TYPE* lpTI, FST_EXCR_TYPE* lpED, FST_ITYPE nS, FST_ITYPE nIis, FST_ITYPE nDepth);
 	public: INT16 Excerpt(CFst* itSrc, INT32 nUnit, CData* idStates, INT32 nIcStates, CData* idIs, INT32 nParam);
+	private: void Sdist_Up(FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE i);
+	private: void Sdist_Down(FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE nSize, FST_ITYPE i);
+	protected: INT16 SdistUnit(INT32 nUnit, FST_WTYPE* lpD, INT32* lpCtr);
 	public: INT16 Potential(INT32 nUnit);
 	public: INT16 Rndwalk(CFst* itSrc, INT32 nUnit, INT32 nPaths, FLOAT64 nWInfluence);
 	public: INT16 PushWeights(CFst* itSrc, INT32 nUnit);
@@ -635,8 +747,12 @@ public:
 	private: void Cps_DelSdAux();
 	private: void Cps_SetSdAux(FST_ITYPE nS, FST_ITYPE nSX, FST_ITYPE nSY, BYTE nFlagXY);
 	private: FST_ITYPE Cps_FindState(FST_ITYPE nSX, FST_ITYPE nSY, BYTE nFlagXY);
-	private: static int Bsn_CompUp(const void* lpElem1, const void* lpElem2);
-	private: static int Bsn_CompDown(const void* lpElem1, const void* lpElem2);
+	private: static BOOL Bsn_Better(FST_PQU_TYPE* lpE1, FST_PQU_TYPE* lpE2, INT16 nWsr);
+	private: static void Bsn_Swap(FST_PQU_TYPE* lpPQ, INT32 i, INT32 j);
+	private: static void Bsn_PqDown(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, BOOL bMin, INT16 nWsr);
+	private: static void Bsn_PqPush(FST_PQU_TYPE* lpPQ, INT32 nSize, FST_PQU_TYPE* lpE, INT16 nWsr);
+	private: static INT32 Bsn_PqWorst(FST_PQU_TYPE* lpPQ, INT32 nSize, INT16 nWsr);
+	private: static void Bsn_PqRemove(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, INT16 nWsr);
 	protected: INT16 BestNUnit(CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength);
 	public: INT16 BestN(CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength);
 
@@ -649,6 +765,7 @@ public:
 /* Member variables */
 public:
 /*{{CGEN_ICXX_FIELDS */
+	data*            m_idAdj;
 	data*            m_idDetRt;
 	data*            is;
 	data*            os;
@@ -665,6 +782,7 @@ typedef struct CFst
   struct CDlpObject* m_lpBaseInstance;
 
 /*{{CGEN_IC_FIELDS */
+	CDlpObject*      m_idAdj;
 	CDlpObject*      m_idDetRt;
 	CDlpObject*      is;
 	CDlpObject*      os;
@@ -737,6 +855,7 @@ typedef struct CFst
 	BOOL m_bFst;
 	BOOL m_bFwd;
 	BOOL m_bGreedy;
+	BOOL m_bHopcroft;
 	BOOL m_bImplicit;
 	BOOL m_bIndex;
 	BOOL m_bLazy;
@@ -873,12 +992,19 @@ INT16 CFst_Status(CFst*);
 INT16 CFst_Print(CFst*);
 void CFst_ResetStateFlag(CFst*, INT32 nUnit, BYTE bMask);
 INT16 CFst_Typerepair(CFst*);
+INT16 CFst_Units(CFst*, CFst* itSrc, FST_UNITFUNC_TYPE* lpFunc, void* lpArg, BOOL bSerial);
 
 /* Taken from 'fst_cps.c' */
 INT16 CFst_Compose(CFst*, CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 INT16 CFst_Intersect(CFst*, CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 INT16 CFst_Product(CFst*, CFst* itSrc1, CFst* itSrc2, INT32 nUnit1, INT32 nUnit2);
 
+/* Taken from 'fst_cts.c' */
+BYTE* CFst_Cts_Col(FST_CTS_TYPE* lpCts, INT32 nIc, INT32* lpBs);
+FST_CTS_TYPE* CFst_Cts_Pack(CFst*, INT32 nUnit, INT16 nMode);
+INT16 CFst_Cts_Unpack(FST_CTS_TYPE* lpCts);
+void CFst_Cts_Done(FST_CTS_TYPE* lpCts);
+
 /* Taken from 'fst_edt.c' */
 INT32 CFst_Addunit(CFst*, const char* lpsName);
 INT16 CFst_AddunitIam(CFst*, const char* lpsName);
@@ -892,7 +1018,9 @@ INT32 CFst_AddtransCopy(CFst*, INT32 nUnit, FST_ITYPE nIni, FST_ITYPE nTer, CFst
 INT16 CFst_Delunit(CFst*, INT32 nUnit);
 INT16 CFst_Delstate(CFst*, INT32 nUnit, INT32 nState);
 INT16 CFst_Deltrans(CFst*, INT32 nUnit, INT32 nTrans);
+INT16 CFst_ReverseUnit(CFst*, INT32 nU);
 INT16 CFst_Reverse(CFst*, INT32 nUnit);
+INT16 CFst_TrimUnit(CFst*, INT32 nU, FLOAT64 nWlim);
 INT16 CFst_Trim(CFst*, INT32 nUnit, FLOAT64 nWlim);
 INT16 CFst_Chain(CFst*, INT32 nUnit);
 INT16 CFst_Loops(CFst*, INT32 nUnit);
@@ -902,9 +1030,11 @@ INT16 CFst_Unweight(CFst*);
 
 /* Taken from 'fst_erm.c' */
 void CFst_Edist_Fwd(CFst*, FST_TID_TYPE* lpTI, FST_ITYPE nS, FST_WTYPE nDist, FST_WTYPE* lpW, FST_ITYPE* lpTos);
-INT16 CFst_Epsdist(CFst*, CFst* itSrc, INT32 nUnit);
+INT16 CFst_EpsdistUnit(CFst*, CFst* itSrc, INT32 nUnit);
 FST_ITYPE CFst_Erm_GetDestTerState(CFst*, FST_TID_TYPE* lpTIsrc, FST_ITYPE nTerSrc);
 BOOL CFst_Erm_EpsDistFromStart(FST_TID_TYPE* lpTIedt, FST_ITYPE nSsrc, FST_WTYPE* lpEpsWFZ);
+INT16 CFst_EpsremoveUnit(CFst*, CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
+INT16 CFst_Epsdist(CFst*, CFst* itSrc, INT32 nUnit);
 INT16 CFst_Epsremove(CFst*, CFst* itSrc, INT32 nUnit);
 
 /* Taken from 'fst_det.c' */
@@ -917,9 +1047,17 @@ FST_ITYPE CFst_Det_AddPath(CFst*, FST_ITYPE nIni, FST_STYPE nTis, FST_ITYPE nTos
 void CFst_Det_AddResidual(CFst*, FST_ITYPE nSdst, FST_ITYPE nSsrc, FST_ITYPE nResStr, FST_WTYPE nResW);
 void CFst_Det_PrtResidual(CFst*, FST_ITYPE nR);
 BOOL CFst_Det_CmpResiduals(CFst*, FST_ITYPE nS1, FST_ITYPE nS2, FST_ITYPE** lpMap, INT32* nMapSi);
-INT16 CFst_DeterminizeUnit(CFst*, CFst* itSrc, INT32 nUnit);
+UINT32 CFst_Det_SigResiduals(CFst*, FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS);
+FST_ITYPE CFst_Det_FindResiduals(CFst*, FST_DET_RSH_TYPE* lpRsh, FST_ITYPE nS, FST_ITYPE** lpMap, INT32* nMapSi);
+INT16 CFst_DeterminizeUnit(CFst*, CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
 INT16 CFst_Determinize(CFst*, CFst* itSrc, INT32 nUnit);
-INT16 CFst_MinimizeUnit(CFst*, CFst* itSrc, INT32 nUnit);
+INT16 CFst_MinimizeUnit(CFst*, CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
+void CFst_Prt_Init(CFst*, FST_PRT_TYPE* lpPrt, INT32 nElems, INT32* lpClass, INT32 nClasses);
+void CFst_Prt_Done(CFst*, FST_PRT_TYPE* lpPrt);
+void CFst_Prt_Mark(FST_PRT_TYPE* lpPrt, INT32 nE);
+void CFst_Prt_Split(FST_PRT_TYPE* lpPrt);
+INT32 CFst_Prt_Classify(FST_PRK_TYPE* lpKey, BYTE* lpData, INT32 nRecs, INT32 nRecLen, INT32 nOffs, INT32* lpClass);
+INT16 CFst_HopcroftUnit(CFst*, CFst* itSrc, INT32 nUnit, FST_UWS_TYPE* lpWs);
 INT16 CFst_Lazymin(CFst*);
 INT16 CFst_Minimize(CFst*, CFst* itSrc, INT32 nUnit);
 
@@ -934,6 +1072,7 @@ void CFst_STI_UnitChanged(FST_TID_TYPE* lpTI, INT16 nMode);
 void CFst_STI_Done(FST_TID_TYPE* lpTI);
 BOOL CFst_STI_IsSorted(FST_TID_TYPE* lpTI, INT32 nMode, FST_ITYPE* lpFSunsrtd, FST_ITYPE* lpFTunsrtd);
 void CFst_STI_Sort(FST_TID_TYPE* lpTI);
+void CFst_STI_AdjIndex(FST_TID_TYPE* lpTI);
 BYTE* CFst_STI_GetTransPtr(FST_TID_TYPE* lpTI, INT32 nTrans);
 FST_ITYPE CFst_STI_GetTransId(FST_TID_TYPE* lpTI, BYTE* lpTrans);
 FST_ITYPE* CFst_STI_TIni(FST_TID_TYPE* lpTI, BYTE* lpTrans);
@@ -944,10 +1083,12 @@ FST_ITYPE* CFst_STI_TRc(FST_TID_TYPE* lpTI, BYTE* lpTrans);
 FST_WTYPE* CFst_STI_TW(FST_TID_TYPE* lpTI, BYTE* lpTrans);
 BYTE* CFst_STI_TfromS(FST_TID_TYPE* lpTI, FST_ITYPE nState, BYTE* lpTrans);
 BYTE* CFst_STI_TtoS(FST_TID_TYPE* lpTI, INT32 nState, BYTE* lpTrans);
+BYTE* CFst_STI_TfromSTis(FST_TID_TYPE* lpTI, FST_ITYPE nState, FST_STYPE nTis, BYTE* lpTrans);
 BOOL CFst_STI_Walk(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void* lpWalkFuncData, FST_ITYPE nState, BOOL bBwd);
 BOOL CFst_STI_WalkInt(FST_TID_TYPE* lpTI, FST_WALKFUNC_TYPE* lpWalkFunc, void* lpWalkFuncData, FST_ITYPE nState, BOOL bBwd, INT32 nDepth);
 
 /* Taken from 'fst_ixp.c' */
+void CFst_Cat_CopyStructure(CFst*, CFst* itSrc);
 INT16 CFst_CatEx(CFst*, CFst* itSrc, INT32 nFirstUnit, INT32 nCount);
 INT16 CFst_Cat(CFst*, CFst* itSrc);
 INT16 CFst_CopyUi(CFst*, CFst* itSrc, CData* idIndex, INT32 nPar);
@@ -976,12 +1117,16 @@ INT16 CFst_Order(CFst*, CFst* itSrc, CData* idMap, INT32 nComp, INT32 nUnit);
 
 /* Taken from 'fst_pth.c' */
 INT16 CFst_Fslist(CFst*, INT32 nUnit, CData* idDst);
+void CFst_FsunifyUnit(CFst*, INT32 nU);
 INT16 CFst_Fsunify(CFst*, INT32 nUnit);
 INT16 CFst_TreeUnit_Walk(CFst*, FST_TID_TYPE* lpTI, FST_ITYPE nSsrc, FST_ITYPE nSdst, INT32 nDepth);
 INT16 CFst_TreeUnit(CFst*, CFst* itSrc, INT32 nUnit);
 INT16 CFst_Tree(CFst*, CFst* itSrc, INT32 nUnit);
 BOOL CFst_ExcerptWalk(FST_TID_TYPE* lpTI, FST_EXCR_TYPE* lpED, FST_ITYPE nS, FST_ITYPE nIis, FST_ITYPE nDepth);
 INT16 CFst_Excerpt(CFst*, CFst* itSrc, INT32 nUnit, CData* idStates, INT32 nIcStates, CData* idIs, INT32 nParam);
+void CFst_Sdist_Up(CFst*, FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE i);
+void CFst_Sdist_Down(CFst*, FST_WTYPE* lpD, FST_ITYPE* lpH, FST_ITYPE* lpP, FST_ITYPE nSize, FST_ITYPE i);
+INT16 CFst_SdistUnit(CFst*, INT32 nUnit, FST_WTYPE* lpD, INT32* lpCtr);
 INT16 CFst_Potential(CFst*, INT32 nUnit);
 INT16 CFst_Rndwalk(CFst*, CFst* itSrc, INT32 nUnit, INT32 nPaths, FLOAT64 nWInfluence);
 INT16 CFst_PushWeights(CFst*, CFst* itSrc, INT32 nUnit);
@@ -1065,8 +1210,12 @@ void CFst_Cps_AddSdAux(CFst*);
 void CFst_Cps_DelSdAux(CFst*);
 void CFst_Cps_SetSdAux(CFst*, FST_ITYPE nS, FST_ITYPE nSX, FST_ITYPE nSY, BYTE nFlagXY);
 FST_ITYPE CFst_Cps_FindState(CFst*, FST_ITYPE nSX, FST_ITYPE nSY, BYTE nFlagXY);
-int CFst_Bsn_CompUp(const void* lpElem1, const void* lpElem2);
-int CFst_Bsn_CompDown(const void* lpElem1, const void* lpElem2);
+BOOL CFst_Bsn_Better(FST_PQU_TYPE* lpE1, FST_PQU_TYPE* lpE2, INT16 nWsr);
+void CFst_Bsn_Swap(FST_PQU_TYPE* lpPQ, INT32 i, INT32 j);
+void CFst_Bsn_PqDown(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, BOOL bMin, INT16 nWsr);
+void CFst_Bsn_PqPush(FST_PQU_TYPE* lpPQ, INT32 nSize, FST_PQU_TYPE* lpE, INT16 nWsr);
+INT32 CFst_Bsn_PqWorst(FST_PQU_TYPE* lpPQ, INT32 nSize, INT16 nWsr);
+void CFst_Bsn_PqRemove(FST_PQU_TYPE* lpPQ, INT32 nSize, INT32 i, INT16 nWsr);
 INT16 CFst_BestNUnit(CFst*, CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength);
 INT16 CFst_BestN(CFst*, CFst* itSrc, INT32 nUnit, INT32 nPaths, INT32 nPathlength);
 
@@ -98,6 +98,7 @@ public:
 	INT16 OnBacktrack();
 	INT16 OnIsearch();
 	INT16 OnLoad();
+	INT16 OnPartial();
 	INT16 OnRestart();
 	INT16 OnSearch();
 	INT16 OnStatus();
@@ -129,12 +130,19 @@ public:
 	INT16 OnSdpEpsremoveChanged();
 	INT16 OnSdpFwdChanged();
 	INT16 OnSdpPrnChanged();
+	INT16 OnSdpPrnhChanged();
 	INT16 OnStkprnChanged();
+	INT16 OnTpLaChanged();
+	INT16 OnTpLmlaChanged();
+	INT16 OnTpPartkeepChanged();
 	INT16 OnTpPrnhChanged();
+	INT16 OnTpPrnosChanged();
 	INT16 OnTpPrnwChanged();
+	INT16 OnTpPrnweChanged();
 	INT16 OnTpThreadsChanged();
 	INT16 OnWnormDecChanged();
 	INT16 OnWnormOffChanged();
+	INT16 OnWtypeChanged();
 /*}}CGEN_FCCF */
 
 /* Scanned member functions */
@@ -145,6 +153,7 @@ public:
 	public: INT16 Load(CFst* itSrc, long nUnit);
 	public: INT16 Isearch(CData* idWeights);
 	public: INT16 Backtrack(CFst* itDst);
+	public: INT16 Partial(CFst* itDst);
 	public: INT16 Unload();
 	public: INT16 Restart();
 	public: INT16 Search(CFst* itSrc, long nUnit, CData* idWeights, CFst* itDst);
@@ -163,6 +172,8 @@ public:
 
 /* Taken from 'fsts_h.c' */
 
+/* Taken from 'fsts_stk.c' */
+
 /* Taken from 'fsts_as.c' */
 
 /* Taken from 'fsts_as_ls.c' */
@@ -217,13 +228,20 @@ typedef struct CFstsearch
 	BOOL             m_bSdpEpsremove;
 	BOOL             m_bSdpFwd;
 	FLOAT64          m_nSdpPrn;
+	INT64            m_nSdpPrnh;
 	BOOL             m_bStkprn;
 	FLOAT64          m_nTime;
+	BOOL             m_bTpLa;
+	BOOL             m_bTpLmla;
+	INT64            m_nTpPartkeep;
 	INT64            m_nTpPrnh;
+	INT64            m_nTpPrnos;
 	FLOAT64          m_nTpPrnw;
+	FLOAT64          m_nTpPrnwe;
 	INT64            m_nTpThreads;
 	FLOAT64          m_nWnormDec;
 	FLOAT64          m_nWnormOff;
+	char*            m_lpsWtype;
 /*}}CGEN_FIELDS */
 
 /*{{CGEN_OPTIONS */
@@ -267,6 +285,7 @@ INT16 CFstsearch_ResetAllOptions(CDlpObject*, BOOL bInit);
 INT16 CFstsearch_OnBacktrack(CDlpObject*);
 INT16 CFstsearch_OnIsearch(CDlpObject*);
 INT16 CFstsearch_OnLoad(CDlpObject*);
+INT16 CFstsearch_OnPartial(CDlpObject*);
 INT16 CFstsearch_OnRestart(CDlpObject*);
 INT16 CFstsearch_OnSearch(CDlpObject*);
 INT16 CFstsearch_OnStatus(CDlpObject*);
@@ -295,12 +314,19 @@ INT16 CFstsearch_OnNumpathsChanged(CDlpObject*);
 INT16 CFstsearch_OnSdpEpsremoveChanged(CDlpObject*);
 INT16 CFstsearch_OnSdpFwdChanged(CDlpObject*);
 INT16 CFstsearch_OnSdpPrnChanged(CDlpObject*);
+INT16 CFstsearch_OnSdpPrnhChanged(CDlpObject*);
 INT16 CFstsearch_OnStkprnChanged(CDlpObject*);
+INT16 CFstsearch_OnTpLaChanged(CDlpObject*);
+INT16 CFstsearch_OnTpLmlaChanged(CDlpObject*);
+INT16 CFstsearch_OnTpPartkeepChanged(CDlpObject*);
 INT16 CFstsearch_OnTpPrnhChanged(CDlpObject*);
+INT16 CFstsearch_OnTpPrnosChanged(CDlpObject*);
 INT16 CFstsearch_OnTpPrnwChanged(CDlpObject*);
+INT16 CFstsearch_OnTpPrnweChanged(CDlpObject*);
 INT16 CFstsearch_OnTpThreadsChanged(CDlpObject*);
 INT16 CFstsearch_OnWnormDecChanged(CDlpObject*);
 INT16 CFstsearch_OnWnormOffChanged(CDlpObject*);
+INT16 CFstsearch_OnWtypeChanged(CDlpObject*);
 /*}}CGEN_CFCCF */
 
 /* Scanned C (member) functions */
@@ -311,6 +337,7 @@ INT16 CFstsearch_Status(CFstsearch*);
 INT16 CFstsearch_Load(CFstsearch*, CFst* itSrc, long nUnit);
 INT16 CFstsearch_Isearch(CFstsearch*, CData* idWeights);
 INT16 CFstsearch_Backtrack(CFstsearch*, CFst* itDst);
+INT16 CFstsearch_Partial(CFstsearch*, CFst* itDst);
 INT16 CFstsearch_Unload(CFstsearch*);
 INT16 CFstsearch_Restart(CFstsearch*);
 INT16 CFstsearch_Search(CFstsearch*, CFst* itSrc, long nUnit, CData* idWeights, CFst* itDst);
@@ -329,6 +356,8 @@ INT16 CFstsearch_Search(CFstsearch*, CFst* itSrc, long nUnit, CData* idWeights,
 
 /* Taken from 'fsts_h.c' */
 
+/* Taken from 'fsts_stk.c' */
+
 /* Taken from 'fsts_as.c' */
 
 /* Taken from 'fsts_as_ls.c' */
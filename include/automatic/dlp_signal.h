@@ -54,7 +54,7 @@
 #define signal CSignal
 
 /*{{CGEN_DEFINE */
-#define FOP_PRECALC(idX,idY,idS,idR,idL)                                              {                                                                                     DLPASSERT((idY!=NULL)&&(idX!=NULL));                                                if(idY==idX) { ICREATE(CData,idR,NULL); }                                           else           idR = idY;                                                           CSignal_GetData(idX,"lab",&idL);                                                    if(CData_GetNNumericComps(idX) == CData_GetNComps(idX)) idS = idX;                  else {                                                                                if(!idL) ICREATEEX(CData, idL, "~lab", NULL);                                       ICREATEEX(CData, idS, "~src", NULL);                                                CMatrix_CopyLabels(idL,idX);                                                        CData_Select(idS,idX,0,CData_GetNNumericComps(idX));                              }                                                                                 }
+#define FOP_PRECALC(idX,idY,idS,idR,idL)                                              {                                                                                     DLPASSERT((idY!=NULL)&&(idX!=NULL));                                                if(CData_Rowmajor(idX)!=O_K || CData_Rowmajor(idY)!=O_K)                              return IERROR(idX,ERR_NOMEM,0,0,0);                                               if(idY==idX) { ICREATE(CData,idR,NULL); }                                           else           idR = idY;                                                           CSignal_GetData(idX,"lab",&idL);                                                    if(CData_GetNNumericComps(idX) == CData_GetNComps(idX)) idS = idX;                  else {                                                                                if(!idL) ICREATEEX(CData, idL, "~lab", NULL);                                       ICREATEEX(CData, idS, "~src", NULL);                                                CMatrix_CopyLabels(idL,idX);                                                        CData_Select(idS,idX,0,CData_GetNNumericComps(idX));                              }                                                                                 }
 #define FOP_POSTCALC(idX,idY,idS,idR,idL)                                             {                                                                                     if(idR != idY) {                                                                      CData_Copy(BASEINST(idY),BASEINST(idR));                                            IDESTROY(idR);                                                                    }                                                                                   CData_CopyDescr(idY,idX);                                                           CDlpObject_CopySelective(BASEINST(idY),BASEINST(idX),WL_TYPE_INSTANCE);             if(idL && !strncmp(BASEINST(idL)->m_lpInstanceName,"~lab",5)){                        CData_Join(idY,idL);                                                                IDESTROY(idL);                                                                    }                                                                                   if(idS != idX) IDESTROY(idS);                                                     }
 /*}}CGEN_DEFINE */
 
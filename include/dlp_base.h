@@ -492,6 +492,20 @@ typedef struct { FLOAT64 x; FLOAT64 y; } COMPLEX64;
   #define dlp_broadcast_cond(cond)  NOT_EXEC
 #endif
 
+/* Worker pool (dlp_thread.c) */
+#if (defined HAVE_PTHREAD && defined __GNUC__)                                  /* Thread-local storage class (kernel*/
+  #define DLP_THREADLOCAL __thread                                              /* | state used by tasks of the      */
+#else                                                                           /* | worker pool)                    */
+  #define DLP_THREADLOCAL                                                       /* |                                 */
+#endif                                                                          /* |                                 */
+typedef void (*DLP_TASKFUNC)(void* lpArg);                                      /* Task function                     */
+typedef void (*DLP_PFORFUNC)(void* lpArg, INT32 nFirst, INT32 nEnd,             /* Parallel-for loop body (one chunk */
+  INT32 nChunk);                                                                /* |  nFirst...nEnd-1)               */
+typedef struct dlp_tgroup                                                       /* Task group                        */
+{                                                                               /* |                                 */
+  INT32 nPending;                                                               /* | Number of unfinished tasks      */
+} DLP_TGROUP;                                                                   /* |                                 */
+
 /* Process id */
 #ifdef pid_t
   #define PROCESSID pid_t
@@ -1083,6 +1097,14 @@ typedef struct zlib_file {
   char m_nCompressed;
 } DLP_FILE;
 
+/* Memory mapped file */
+typedef struct dlp_fmap {
+  BYTE* m_lpData;                                                               /* Start address of mapping          */
+  INT64 m_nSize;                                                                /* Size of mapping (bytes)           */
+  INT32 m_nFd;                                                                  /* File descriptor                   */
+  BOOL  m_bWrite;                                                               /* Changes are written to the file   */
+} DLP_FMAP;
+
 
 /**
  * This structure holds the description of generalized operations
@@ -1377,6 +1399,14 @@ THREADHANDLE  dlp_create_thread(THREADFUNC, void* lpThreadArg);
 INT16         dlp_join_thread(THREADHANDLE);
 INT16         dlp_terminate_thread(THREADHANDLE, INT32 nExitCode);
 UINT64        dlp_time();
+INT32         dlp_tpool_get_nthreads();
+void          dlp_tpool_set_nthreads(INT32 nThreads);
+void          dlp_tpool_done();
+void          dlp_tgroup_init(DLP_TGROUP* lpGroup);
+INT16         dlp_tgroup_run(DLP_TGROUP* lpGroup, DLP_TASKFUNC lpFunc, void* lpArg);
+void          dlp_tgroup_wait(DLP_TGROUP* lpGroup);
+INT32         dlp_parallel_for(INT32 nFirst, INT32 nCount, INT32 nGrain, DLP_PFORFUNC lpFunc, void* lpArg);
+INT32         dlp_pfor_nchunks(INT32 nCount, INT32 nGrain);
 
 /* Functions - dlp_file.c */
 DLP_FILE*     dlp_fopen(const char *path,const char *mode);
@@ -1392,6 +1422,10 @@ INT16         dlp_chdir(const char* lpsDirname, BOOL bCreate);
 BOOL          dlp_mkdirs(const char* lpsDirname);
 char*         dlp_tempnam(const char* lpsDir, const char* lpsPfx);
 char*         dlp_fullpath(char* lpsAbsPath, const char* lpsRelPath, INT32 nMaxLen);
+DLP_FMAP*     dlp_fmap_open(const char* lpsFilename, INT64 nSize, BOOL bWrite);
+INT16         dlp_fmap_resize(DLP_FMAP* lpMap, INT64 nSize);
+INT16         dlp_fmap_sync(DLP_FMAP* lpMap);
+INT16         dlp_fmap_close(DLP_FMAP* lpMap, INT64 nTruncate);
 
 #ifdef __cplusplus
 }
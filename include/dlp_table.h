@@ -33,6 +33,8 @@
 #define COMP_DESCR_LEN    255
 #define CDN3_XFERBUFLEN 20000
 #define COMP_ALLOC         20
+#define CDLPTABLE_MAPMAGIC "DLPTMAP1"
+#define CDLPTABLE_MAPALIGN 4096
 
 /* Force C linkage in C++ units */
 #ifdef __cplusplus
@@ -48,6 +50,21 @@ typedef struct tag_SDlpTableComp
   INT64  offset;
 } SDlpTableComp;
 
+/* Struct SDlpTableMapHdr - Header of memory mappable table files. The header is
+   followed by m_dim component descriptors (SDlpTableComp) and, starting at byte
+   nDataOfs, by the records in row-major layout. */
+typedef struct tag_SDlpTableMapHdr
+{
+  char    lpsMagic[8];
+  INT32   nDim;
+  INT32   nReclen;
+  INT64   nRecs;
+  INT64   nDataOfs;
+  FLOAT64 nFsr;
+  FLOAT64 nZf;
+  FLOAT64 nOfs;
+} SDlpTableMapHdr;
+
 /* Class CDlpTable - Fields */
 typedef struct tag_CDlpTable
 {
@@ -68,6 +85,8 @@ typedef struct tag_CDlpTable
   char*          m_vrtext;
   BYTE*          m_theDataPointer;
   SDlpTableComp* m_compDescrList;
+  BOOL           m_bColmajor;
+  DLP_FMAP*      m_lpFmap;
 } CDlpTable;
 
 /* Class CDlpTable - Methods */
@@ -91,6 +110,13 @@ INT16          CDlpTable_AllocateUninitialized(CDlpTable*, INT32 nRecs);
 INT16          CDlpTable_Alloc(CDlpTable*, INT32 nRecs);
 INT16          CDlpTable_AllocUninitialized(CDlpTable*, INT32 nRecs);
 INT16          CDlpTable_Realloc(CDlpTable*, INT32 nRecs);
+INT16          CDlpTable_SetColmajor(CDlpTable*, BOOL bColmajor);
+BOOL           CDlpTable_IsColmajor(CDlpTable*);
+INT16          CDlpTable_CopyRecs(CDlpTable*, INT32 nInsertAt, CDlpTable* lpiSrc, INT32 nFirstRec, INT32 nRecs);
+INT16          CDlpTable_MapExport(CDlpTable*, const char* lpsFilename);
+INT16          CDlpTable_Map(CDlpTable*, const char* lpsFilename, BOOL bWrite);
+INT16          CDlpTable_Unmap(CDlpTable*, BOOL bKeep);
+BOOL           CDlpTable_IsMapped(CDlpTable*);
 INT32          CDlpTable_AddRecs(CDlpTable*, INT32 nRecs, INT32 nRealloc);
 INT32          CDlpTable_InsertRecs(CDlpTable*, INT32 nInsertAt, INT32 nRecs, INT32 nRealloc);
 INT16          CDlpTable_Clear(CDlpTable*);
@@ -104,6 +130,7 @@ INT32          CDlpTable_GetRecLen(CDlpTable*);
 INT32          CDlpTable_GetNComps(CDlpTable*);
 INT32          CDlpTable_GetCompSize(CDlpTable*, INT32 nComp);
 INT64          CDlpTable_GetCompOffset(CDlpTable*, INT32 nComp);
+INT32          CDlpTable_GetCompStride(CDlpTable*, INT32 nComp);
 INT16          CDlpTable_GetCompType(CDlpTable*, INT32 nComp);
 char*          CDlpTable_GetCompName(CDlpTable*, INT32 nComp);
 INT16          CDlpTable_SetCompName(CDlpTable*, INT32 nComp, const char* lpsName);
@@ -299,6 +299,7 @@ int main(int nArgc, char** lpArgv)
   CDlpObject_UnregisterAllClasses();
   dlm_fft_cleanup();
   dlp_arith_cleanup();
+  dlp_tpool_done();
   dlp_xalloc_done(bTml);
 
   // That's it folks ...
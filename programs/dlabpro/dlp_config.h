@@ -39,6 +39,7 @@
 /*#define __NOLIBSNDFILE            / * Do not use Libsndfile library                */
 /*#define __MAX_TYPE_32BIT          / * Use maximum 32bit for numeric data types     */
 /*#define __DLP_DEPRECATED          / * Activate deprecated API (if any)             */
+/*#define __DLP_NTHREADS 4          / * Worker pool threads (default: CPU count)     */
 
 /* REMARKS */
 /* 1) Some object functions will not work correctly */
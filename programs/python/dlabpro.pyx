@@ -7,9 +7,16 @@ cdef void* dlp_malloc(int size):
 
 cdef extern from "dlabpro_init.hpp":
     cdef void dlabpro_init()
+    cdef void dlabpro_done()
 
 dlabpro_init()
 
+def _dlabpro_done():
+    dlabpro_done()
+
+import atexit
+atexit.register(_dlabpro_done)
+
 cdef extern from "dlp_base.h":
     cdef char dlp_xalloc_init(int flags)
 
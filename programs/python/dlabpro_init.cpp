@@ -25,3 +25,7 @@ void dlabpro_init(){
   setlocale(LC_NUMERIC,"C");
 }
 
+void dlabpro_done(){
+  dlp_tpool_done();
+}
+
@@ -2,5 +2,6 @@
 #define _DLABPRO_INIT
 
 void dlabpro_init();
+void dlabpro_done();
 
 #endif
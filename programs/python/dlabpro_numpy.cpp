@@ -12,6 +12,7 @@ void numpy2data(PyObject *np,CData *dat){
   INT16 t=0;
   PyArrayObject *na=(PyArrayObject*)np;
   CData_Reset(dat,TRUE);
+  if(CData_Rowmajor(dat)!=O_K){ printf("ERROR: out of memory\n"); return; }
   if(na->nd==1){
     c=1;
     r=na->dimensions[0];
@@ -59,6 +60,7 @@ PyObject* data2numpy(CData *dat){
   int b,c,r;
   PyObject *np;
   if(!t) return NULL; /* TODO: PyNone */
+  if(CData_Rowmajor(dat)!=O_K) return NULL; /* numpy arrays are row-major */
   switch(t){
   case T_DOUBLE: nt=NPY_DOUBLE; break;
   case T_FLOAT:  nt=NPY_FLOAT; break;
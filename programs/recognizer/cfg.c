@@ -425,6 +425,7 @@ void searchinit(){
     itSP->m_bStkprn=TRUE;
   }
   itSP->m_nTpThreads=rCfg.rSearch.nThreads;
+  if(!rCfg.rSearch.bPermanent) itSP->m_nTpPartkeep=-1; /* decode() needs the complete path */
   CFstsearch_Restart(itSP);
   searchload(rTmp.nFstSel);
   if(rCfg.rRej.eTyp!=RR_phn) return;
@@ -453,7 +454,6 @@ void tmpfileinit(){
 }
 
 void tmpinit(){
-  ICREATEEX(CData,rTmp.idSig,"tmp.sig",NULL);
   ICREATEEX(CData,rTmp.idFea,"tmp.fea",NULL);
   ICREATEEX(CData,rTmp.idNld,"tmp.nld",NULL);
   if(rCfg.rDVAD.nSfaDim){
@@ -469,7 +469,6 @@ void tmpinit(){
 
 void tmpdone(){
   if(rTmp.iFile)  IDESTROYFILE(rTmp.iFile);
-  if(rTmp.idSig)  IDESTROY(rTmp.idSig);
   if(rTmp.idFea)  IDESTROY(rTmp.idFea);
   if(rTmp.idNld)  IDESTROY(rTmp.idNld);
   if(rTmp.idVFea) IDESTROY(rTmp.idVFea);
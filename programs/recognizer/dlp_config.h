@@ -38,6 +38,7 @@
 /*#define __DEFAULT_FILEFORMAT_XML / * Set default file format for -save and -restore to xml */
 /*#define __NOLIBSNDFILE            / * Do not use Libsndfile library */
 #define __MAX_TYPE_32BIT   /* Use maximum 32bit for numeric data types */
+/*#define __DLP_NTHREADS 1  / * Worker pool threads (default: CPU count) */
 
 #ifndef __NOREADLINE
 #define __NOREADLINE    /* Do not use readline library*/
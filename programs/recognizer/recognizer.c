@@ -825,6 +825,32 @@ void audio_devlist()
 #endif
 }
 
+/* Get signal window [nPos,nPos+nWlen) from sound file stream.
+ * Samples overlapping the previous window are kept, only new ones are read.
+ * Samples between the previous window and nPos are skipped. The stream can
+ * not be read backwards, so NULL is returned if nPos is before the previous
+ * window or on read errors. */
+FLOAT32 *sigwindow(struct recosig *lpSig,INT64 nPos,INT32 nWlen)
+{
+  INT64 nEnd=lpSig->nWinPos+lpSig->nWinLen;
+  INT32 nKeep;
+  INT32 nRead;
+  if(nPos<lpSig->nWinPos) return NULL;
+  while(nEnd<nPos){
+    nRead=CDlpFile_Snd_Read(lpSig->lpStream,lpSig->lpWin,(INT32)MIN(nPos-nEnd,nWlen));
+    if(nRead<=0) return NULL;
+    nEnd+=nRead;
+  }
+  nKeep=(INT32)MIN(nEnd-nPos,nWlen);
+  if(nKeep>0) memmove(lpSig->lpWin,lpSig->lpWin+(nPos-lpSig->nWinPos),nKeep*sizeof(FLOAT32));
+  nRead=CDlpFile_Snd_Read(lpSig->lpStream,lpSig->lpWin+nKeep,nWlen-nKeep);
+  if(nRead<0) return NULL;
+  if(nKeep+nRead<nWlen) memset(lpSig->lpWin+nKeep+nRead,0,(nWlen-nKeep-nRead)*sizeof(FLOAT32));
+  lpSig->nWinPos=nPos;
+  lpSig->nWinLen=nKeep+nRead;
+  return lpSig->lpWin;
+}
+
 INT16 online(struct recosig *lpSig)
 {
   /* Local variables */
@@ -957,8 +983,9 @@ INT16 online(struct recosig *lpSig)
       /* Get new Frame */
       if(lpSig){
 		if(nSigPos<lpSig->nLen){
-	        lpDat=lpSig->lpSamples+nSigPos;
     	    nWlen=MIN(lpSig->nLen-nSigPos,rCfg.rPfa.lpFba.nWlen);
+	        lpDat=sigwindow(lpSig,nSigPos,nWlen);
+	        if(!lpDat){ routput(O_sta,1,"file read error (sample %i)\n",(INT32)nSigPos); break; }
 		}
         nSigPos+=nCrate;
       }else{
@@ -1101,15 +1128,14 @@ INT16 online(struct recosig *lpSig)
         }
         if(rCfg.sPostProc[0]) CData_Cat(rTmp.idNld,rTmp.idFea);
         CData_Array(rTmp.idFea,T_FLOAT,nMsf,1);
-        if(nFea%10==0){
+        { /* Live result */
           CFst *itDC;
           INT32 nT,nCTos,nCTis;
           ICREATEEX(CFst, itDC, "itDC", NULL);
-          rCfg.rDSession.itSP->m_bFinal=TRUE;
-          CFstsearch_Backtrack(rCfg.rDSession.itSP,itDC);
+          CFstsearch_Partial(rCfg.rDSession.itSP,itDC); /* Only the newly stable words */
           nCTos=CData_FindComp(AS(CData,itDC->td),"~TOS");
           nCTis=CData_FindComp(AS(CData,itDC->td),"~TIS");
-          if(nCTos>=0 && nCTis>=0 && !CData_IsEmpty(AS(CData,itDC->os))){
+          if(nCTos>=0 && nCTis>=0 && UD_XXU(itDC) && !CData_IsEmpty(AS(CData,itDC->os))){
             INT32 nLen=0;
             routput(O_sta,1,"liveres: ");
             for(nT=0;nT<CData_GetNRecs(AS(CData,itDC->td));nT++){
@@ -1119,7 +1145,7 @@ INT16 online(struct recosig *lpSig)
               if(nTis>=0) nLen++;
             }
             if(rCfg.rSearch.bPermanent){
-              routput(O_sta,0," [range %i-%i (%i) - max %i]\n",nFea-nLen,nFea,nLen,nSigMax); nSigMax=0;
+              routput(O_sta,0," [frame %i (%i) - max %i]\n",nFea,nLen,nSigMax); nSigMax=0;
             }else routput(O_sta,0,"\n");
           }
           IDESTROYFST(itDC);
@@ -1274,39 +1300,17 @@ void do_feastdin()
 
 void processfile(struct recofile lpF){
   struct recosig lpSig;
-  CData *idSig=rTmp.idSig;
-  INT32 nI;
   INT32 nSR;
-  INT32 nC;
-  FLOAT32 nNorm;
   const char *errstr="";
 
   rTmp.sSigFname=lpF.lpsFName;
-  IF_NOK(CDlpFile_LibsndfileImport(rTmp.iFile, lpF.lpsFName, BASEINST(idSig), "wav")) goto err;
-  nSR=1000./idSig->m_lpTable->m_fsr+.5;
-  nC=CData_GetNComps(idSig);
+  memset(&lpSig,0,sizeof(struct recosig));
+  if(!(lpSig.lpStream=CDlpFile_Snd_Init(rTmp.iFile,lpF.lpsFName,rCfg.nSigChannel))){ errstr="open failed"; goto err; }
+  nSR=(INT32)(lpSig.lpStream->nSrate+.5);
   if(nSR!=rCfg.nSigSampleRate){ errstr="sample rate missmatch"; goto err; }
-  if(nC>1){
-    if(rCfg.nSigChannel<0 || rCfg.nSigChannel>=nC){ errstr="not exisiting channel selected"; goto err; }
-    if(rCfg.nSigChannel)      CData_DeleteComps(idSig,0,rCfg.nSigChannel);
-    if(rCfg.nSigChannel<nC-1) CData_DeleteComps(idSig,rCfg.nSigChannel+1,nC-1-rCfg.nSigChannel);
-  }
-  switch(CData_GetCompType(idSig,0)){
-  case T_UCHAR:  nNorm=T_UCHAR_MAX; break;
-  case T_CHAR:   nNorm=T_CHAR_MAX;  break;
-  case T_USHORT: nNorm=T_USHORT_MAX;break;
-  case T_SHORT:  nNorm=T_SHORT_MAX; break;
-  case T_UINT:   nNorm=T_UINT_MAX;  break;
-  case T_INT:    nNorm=T_INT_MAX;   break;
-  case T_ULONG:  nNorm=T_ULONG_MAX; break;
-  case T_LONG:   nNorm=T_LONG_MAX;  break;
-  default:       nNorm=1.;          break;
-  }
-  CData_Tconvert(idSig, idSig, T_FLOAT);
-  lpSig.nLen=CData_GetNRecs(idSig);
-  lpSig.lpSamples=(FLOAT32*)CData_XAddr(idSig,0,0);
+  lpSig.nLen=(INT32)lpSig.lpStream->nFrames;
+  lpSig.lpWin=(FLOAT32*)dlp_calloc(rCfg.rPfa.lpFba.nWlen,sizeof(FLOAT32));
   lpSig.lpsLab=lpF.lpsLab[0] ? lpF.lpsLab : NULL;
-  if(nNorm!=1.) for(nI=0;nI<lpSig.nLen;nI++) lpSig.lpSamples[nI]/=nNorm;
   routput(O_sta,1,"processing %s %.1fs\n", strrchr(lpF.lpsFName,'/') ? strrchr(lpF.lpsFName,'/')+1 : lpF.lpsFName,(FLOAT32)lpSig.nLen/(FLOAT32)rCfg.nSigSampleRate);
   if(rCfg.bVADForce || rCfg.bFSTForce){
     char lpsFN[STR_LEN];
@@ -1322,9 +1326,13 @@ void processfile(struct recofile lpF){
     fclose(FD);
   }
   online(&lpSig);
+  CDlpFile_Snd_Done(lpSig.lpStream);
+  dlp_free(lpSig.lpWin);
   rTmp.sSigFname="";
   return;
 err:
+  CDlpFile_Snd_Done(lpSig.lpStream);
+  dlp_free(lpSig.lpWin);
   rTmp.sSigFname="";
   routput(O_sta,1,"file read error (%s)\n",errstr);
 }
@@ -1381,6 +1389,7 @@ end:
   cfgdone();
 
   CDlpObject_UnregisterAllClasses();
+  dlp_tpool_done();
 #ifdef _DEBUG                                                                  /* Clean up */
   dlp_xalloc_done(TRUE);
 #else
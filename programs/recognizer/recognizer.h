@@ -127,12 +127,15 @@ struct recofile {
 }; 
 
 struct recosig {
-  char*    lpsLab;
-  INT32    nLen;
-  FLOAT32* lpSamples;
-  INT32    nNldNum;
-  INT32    nNldDim;
-  FLOAT32* lpNld;
+  char*            lpsLab;
+  INT32            nLen;
+  CFILE_SNDSTREAM* lpStream;  /* Sound file stream */
+  FLOAT32*         lpWin;     /* Current signal window */
+  INT64            nWinPos;   /* Position of lpWin in signal */
+  INT32            nWinLen;   /* Number of valid samples in lpWin */
+  INT32            nNldNum;
+  INT32            nNldDim;
+  FLOAT32*         lpNld;
 };
 
 
@@ -197,7 +200,6 @@ struct recores {
 
 struct recotmp {
   CDlpFile*      iFile;
-  CData*         idSig;
   CData*         idFea;
   CData*         idNld;
   CData*         idVFea;